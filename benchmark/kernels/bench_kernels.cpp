@@ -0,0 +1,467 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    bench_kernels.cpp
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Standalone micro benchmarks of the numerical kernels
+ *
+ *  @section DESCRIPTION
+ *
+ *  Runs the kernels of compboost on synthetic data over a grid of the number
+ *  of observations `n`, the number of columns (or factories) `p`, and the
+ *  number of threads. Just the candidate search of the optimizer is
+ *  parallelized in compboost, hence the thread grid applies to
+ *  `findBestBaselearner` and all other kernels run with one thread. Each
+ *  configuration is repeated and the median runtime is reported. Results are written as JSON and can be compared against a
+ *  stored baseline:
+ *
+ *    bench_kernels --out results.json --baseline baseline.json --threshold 0.15
+ *
+ *  The program exits with status 1 if at least one kernel is slower than the
+ *  baseline by more than the threshold.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "binning.h"
+#include "splines.h"
+#include "tensors.h"
+#include "helper.h"
+#include "demmler_reinsch.h"
+#include "loss.h"
+#include "response.h"
+#include "baselearner_factory.h"
+#include "optimizer.h"
+
+#include "single_include/nlohmann/json.hpp"
+using json = nlohmann::json;
+
+// -------------------------------------------------------------------------- //
+// Settings and results:
+// -------------------------------------------------------------------------- //
+
+struct BenchSettings
+{
+  std::vector<unsigned int> n_grid       = { 1000, 10000, 100000 };
+  std::vector<unsigned int> p_grid       = { 8, 24 };
+  std::vector<unsigned int> factory_grid = { 10, 50 };
+  // Threads of the candidate search (`findBestBaselearner`):
+  std::vector<unsigned int> thread_grid  = { 1, 2, 4 };
+
+  unsigned int reps      = 7;
+  double       threshold = 0.15;
+  std::string  out_file  = "";
+  std::string  baseline  = "";
+  std::string  filter    = "";
+};
+
+struct BenchResult
+{
+  std::string  kernel;
+  unsigned int n;
+  unsigned int p;
+  unsigned int threads;
+  unsigned int reps;
+  double       median_ns;
+  double       min_ns;
+  double       max_ns;
+};
+
+// The result of each kernel is accumulated here to prevent the compiler from
+// removing the call:
+volatile double sink = 0;
+
+BenchResult runBench (const BenchSettings& settings, const std::string kernel, const unsigned int n,
+  const unsigned int p, const unsigned int threads, const std::function<double()>& fun)
+{
+  typedef std::chrono::steady_clock bclock;
+
+  // Warm up (page faults, caches, OpenMP thread pool):
+  sink = sink + fun();
+
+  std::vector<double> times;
+  for (unsigned int r = 0; r < settings.reps; r++) {
+    auto t1 = bclock::now();
+    sink = sink + fun();
+    auto t2 = bclock::now();
+    times.push_back(std::chrono::duration<double, std::nano>(t2 - t1).count());
+  }
+  std::sort(times.begin(), times.end());
+
+  BenchResult res;
+  res.kernel    = kernel;
+  res.n         = n;
+  res.p         = p;
+  res.threads   = threads;
+  res.reps      = settings.reps;
+  res.median_ns = times[times.size() / 2];
+  res.min_ns    = times.front();
+  res.max_ns    = times.back();
+
+  std::cout << std::left << std::setw(32) << kernel << " n = " << std::setw(8) << n
+            << " p = " << std::setw(5) << p << " threads = " << std::setw(3) << threads
+            << " median = " << std::setprecision(4) << res.median_ns / 1e6 << " ms" << std::endl;
+
+  return res;
+}
+
+bool useKernel (const BenchSettings& settings, const std::string kernel)
+{
+  return settings.filter.empty() || (kernel.find(settings.filter) != std::string::npos);
+}
+
+// -------------------------------------------------------------------------- //
+// Synthetic data:
+// -------------------------------------------------------------------------- //
+
+struct SplineSetup
+{
+  arma::vec    x;
+  arma::vec    x_bins;
+  arma::uvec   idx;
+  arma::vec    knots;
+  arma::sp_mat basis_t;  // p x n_bins, as stored by the P-spline factory
+  arma::mat    basis_bins;
+};
+
+SplineSetup createSplineSetup (const unsigned int n, const unsigned int p)
+{
+  const unsigned int degree  = 3;
+  const unsigned int n_knots = (p > degree + 2) ? p - degree - 1 : 1;
+
+  SplineSetup s;
+  s.x       = arma::randu<arma::vec>(n);
+  s.x_bins  = binning::binVector(s.x);
+  s.idx     = binning::calculateIndexVector(s.x, s.x_bins);
+  s.knots   = splines::createKnots(s.x, n_knots, degree);
+  s.basis_t = splines::createSparseSplineBasis(s.x_bins, degree, s.knots).t();
+
+  s.basis_bins = arma::mat(s.basis_t.t());
+  return s;
+}
+
+// -------------------------------------------------------------------------- //
+// Kernels:
+// -------------------------------------------------------------------------- //
+
+void benchBinning (const BenchSettings& settings, std::vector<BenchResult>& results)
+{
+  const arma::vec w_one(1, arma::fill::ones);
+
+  for (auto n : settings.n_grid) {
+    for (auto p : settings.p_grid) {
+      SplineSetup s = createSplineSetup(n, p);
+      arma::vec y   = arma::randn<arma::vec>(n);
+      arma::vec w   = arma::randu<arma::vec>(n);
+      arma::mat par = arma::randn<arma::mat>(s.basis_t.n_rows, 1);
+      unsigned int pb = s.basis_t.n_rows;
+
+      if (useKernel(settings, "binnedMatMult"))
+        results.push_back(runBench(settings, "binnedMatMult", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedMatMult(s.basis_bins, s.idx, w_one)); }));
+      if (useKernel(settings, "binnedMatMultWeighted"))
+        results.push_back(runBench(settings, "binnedMatMultWeighted", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedMatMult(s.basis_bins, s.idx, w)); }));
+      if (useKernel(settings, "binnedMatMultResponse"))
+        results.push_back(runBench(settings, "binnedMatMultResponse", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedMatMultResponse(s.basis_bins, y, s.idx, w_one)); }));
+      if (useKernel(settings, "binnedPrediction"))
+        results.push_back(runBench(settings, "binnedPrediction", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedPrediction(s.basis_bins, par, s.idx)); }));
+      if (useKernel(settings, "binnedSparseMatMult"))
+        results.push_back(runBench(settings, "binnedSparseMatMult", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedSparseMatMult(s.basis_t, s.idx, w_one)); }));
+      if (useKernel(settings, "binnedSparseMatMultResponse"))
+        results.push_back(runBench(settings, "binnedSparseMatMultResponse", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedSparseMatMultResponse(s.basis_t, y, s.idx, w_one)); }));
+      if (useKernel(settings, "binnedSparsePrediction"))
+        results.push_back(runBench(settings, "binnedSparsePrediction", n, pb, 1, [&]() {
+          return arma::accu(binning::binnedSparsePrediction(s.basis_t, par, s.idx)); }));
+    }
+  }
+}
+
+void benchSplinesAndTensors (const BenchSettings& settings, std::vector<BenchResult>& results)
+{
+  for (auto n : settings.n_grid) {
+    for (auto p : settings.p_grid) {
+      SplineSetup s = createSplineSetup(n, p);
+
+      if (useKernel(settings, "createSparseSplineBasis"))
+        results.push_back(runBench(settings, "createSparseSplineBasis", n, p, 1, [&]() {
+          return arma::accu(splines::createSparseSplineBasis(s.x, 3, s.knots)); }));
+
+      // Tensor of two features with sqrt(p) basis functions each:
+      unsigned int pt = std::max(2u, (unsigned int)std::ceil(std::sqrt((double)p)));
+      arma::mat A = arma::randu<arma::mat>(n, pt);
+      arma::mat B = arma::randu<arma::mat>(n, pt);
+      arma::sp_mat As = arma::sprandu<arma::sp_mat>(n, pt, 0.3);
+      arma::sp_mat Bs = arma::sprandu<arma::sp_mat>(n, pt, 0.3);
+
+      if (useKernel(settings, "rowWiseKronecker"))
+        results.push_back(runBench(settings, "rowWiseKronecker", n, pt * pt, 1, [&]() {
+          return arma::accu(tensors::rowWiseKronecker(A, B)); }));
+      if (useKernel(settings, "rowWiseKroneckerSparse"))
+        results.push_back(runBench(settings, "rowWiseKroneckerSparse", n, pt * pt, 1, [&]() {
+          return arma::accu(tensors::rowWiseKroneckerSparse(As, Bs)); }));
+    }
+  }
+}
+
+void benchSolver (const BenchSettings& settings, std::vector<BenchResult>& results)
+{
+  // Solver and Demmler-Reinsch just depend on p:
+  std::vector<unsigned int> p_grid = settings.p_grid;
+  p_grid.push_back(4 * settings.p_grid.back());
+
+  for (auto p : p_grid) {
+    SplineSetup s = createSplineSetup(settings.n_grid.front(), p);
+    arma::mat X   = arma::mat(s.basis_t.t());
+    arma::mat pen = splines::penaltyMat(X.n_cols, 2);
+    arma::mat xtx = X.t() * X + 2 * pen;
+    arma::mat y   = arma::randn<arma::mat>(X.n_cols, 1);
+    unsigned int pb = X.n_cols;
+
+    auto cache_chol = std::make_pair(std::string("cholesky"), arma::mat(arma::chol(xtx)));
+    auto cache_inv  = std::make_pair(std::string("inverse"),  arma::mat(arma::inv(xtx)));
+
+    if (useKernel(settings, "cboostSolverCholesky"))
+      results.push_back(runBench(settings, "cboostSolverCholesky", 0, pb, 1, [&]() {
+        return arma::accu(helper::cboostSolver(cache_chol, y)); }));
+    if (useKernel(settings, "cboostSolverInverse"))
+      results.push_back(runBench(settings, "cboostSolverInverse", 0, pb, 1, [&]() {
+        return arma::accu(helper::cboostSolver(cache_inv, y)); }));
+    if (useKernel(settings, "demmlerReinsch"))
+      results.push_back(runBench(settings, "demmlerReinsch", 0, pb, 1, [&]() {
+        return dro::demmlerReinsch(X.t() * X, pen, 5); }));
+  }
+}
+
+void benchLoss (const BenchSettings& settings, std::vector<BenchResult>& results)
+{
+  std::map<std::string, std::shared_ptr<loss::Loss>> losses = {
+    { "Quadratic", std::make_shared<loss::LossQuadratic>() },
+    { "Absolute",  std::make_shared<loss::LossAbsolute>() },
+    { "Huber",     std::make_shared<loss::LossHuber>(1.0) },
+    { "Binomial",  std::make_shared<loss::LossBinomial>() }
+  };
+  for (auto n : settings.n_grid) {
+    arma::mat f  = arma::randn<arma::mat>(n, 1);
+    arma::mat y  = arma::randn<arma::mat>(n, 1);
+    arma::mat yb = arma::sign(y);
+
+    for (auto& it : losses) {
+      std::string kernel = "lossGradient" + it.first;
+      const arma::mat& ytrue = (it.first == "Binomial") ? yb : y;
+      if (useKernel(settings, kernel))
+        results.push_back(runBench(settings, kernel, n, 1, 1, [&]() {
+          return arma::accu(it.second->gradient(ytrue, f)); }));
+    }
+  }
+}
+
+void benchFindBestBaselearner (const BenchSettings& settings, std::vector<BenchResult>& results)
+{
+  if (! useKernel(settings, "findBestBaselearner")) return;
+
+  for (auto n : settings.n_grid) {
+    for (auto n_factories : settings.factory_grid) {
+
+      // Half of the factories are P-splines, the other half linear base-learner:
+      blearner_factory_map factory_map;
+      for (unsigned int i = 0; i < n_factories; i++) {
+        std::string feat = "x" + std::to_string(i);
+        auto sh_ptr_data = std::make_shared<data::InMemoryData>(feat, arma::mat(arma::randu<arma::mat>(n, 1)));
+
+        std::shared_ptr<blearnerfactory::BaselearnerFactory> fac;
+        if (i % 2 == 0) {
+          fac = std::make_shared<blearnerfactory::BaselearnerPSplineFactory>("spline", sh_ptr_data,
+            3, 20, 2, 0, 2, true, 0, "cholesky");
+        } else {
+          fac = std::make_shared<blearnerfactory::BaselearnerPolynomialFactory>("linear", sh_ptr_data,
+            1, true, 0);
+        }
+        factory_map[fac->getFactoryId()] = fac;
+      }
+
+      auto sh_ptr_loss     = std::make_shared<loss::LossQuadratic>();
+      auto sh_ptr_response = std::make_shared<response::ResponseRegr>("y", arma::mat(arma::randn<arma::mat>(n, 1)));
+      sh_ptr_response->constantInitialization(sh_ptr_loss);
+      sh_ptr_response->initializePrediction();
+      sh_ptr_response->setIteration(1);
+      sh_ptr_response->updatePseudoResiduals(sh_ptr_loss);
+
+      for (auto threads : settings.thread_grid) {
+        optimizer::OptimizerCoordinateDescent opt(threads);
+        results.push_back(runBench(settings, "findBestBaselearner", n, n_factories, threads, [&]() {
+          return arma::accu(opt.findBestBaselearner("1", sh_ptr_response, factory_map)->getParameter()); }));
+      }
+    }
+  }
+}
+
+// -------------------------------------------------------------------------- //
+// Output and baseline comparison:
+// -------------------------------------------------------------------------- //
+
+std::string resultKey (const std::string kernel, const unsigned int n, const unsigned int p, const unsigned int threads)
+{
+  return kernel + "|" + std::to_string(n) + "|" + std::to_string(p) + "|" + std::to_string(threads);
+}
+
+json resultsToJson (const std::vector<BenchResult>& results, const BenchSettings& settings)
+{
+  json jres = json::array();
+  for (auto& r : results) {
+    jres.push_back({
+      {"kernel",    r.kernel},
+      {"n",         r.n},
+      {"p",         r.p},
+      {"threads",   r.threads},
+      {"reps",      r.reps},
+      {"median_ns", r.median_ns},
+      {"min_ns",    r.min_ns},
+      {"max_ns",    r.max_ns}
+    });
+  }
+  json j = {
+    {"arma_version", arma::arma_version::as_string()},
+    {"reps",         settings.reps},
+    {"results",      jres}
+  };
+  return j;
+}
+
+unsigned int compareToBaseline (const std::vector<BenchResult>& results, const json& jbase, const double threshold)
+{
+  std::map<std::string, double> base;
+  for (auto& jr : jbase["results"]) {
+    base[resultKey(jr["kernel"].get<std::string>(), jr["n"].get<unsigned int>(), jr["p"].get<unsigned int>(),
+      jr["threads"].get<unsigned int>())] = jr["median_ns"].get<double>();
+  }
+
+  unsigned int n_regressions = 0;
+  std::cout << std::endl << "Comparison with baseline (threshold = " << threshold * 100 << "%):" << std::endl;
+  for (auto& r : results) {
+    auto it = base.find(resultKey(r.kernel, r.n, r.p, r.threads));
+    if (it == base.end()) continue;
+
+    double ratio = r.median_ns / it->second;
+    bool is_regression = ratio > 1 + threshold;
+    if (is_regression) n_regressions++;
+
+    std::cout << (is_regression ? "  REGRESSION " : "  ok         ") << std::left << std::setw(32) << r.kernel
+              << " n = " << std::setw(8) << r.n << " p = " << std::setw(5) << r.p << " threads = " << std::setw(3)
+              << r.threads << " ratio = " << std::setprecision(3) << ratio << std::endl;
+  }
+  std::cout << n_regressions << " regression(s) found." << std::endl;
+  return n_regressions;
+}
+
+BenchSettings parseArgs (int argc, char* argv[])
+{
+  BenchSettings settings;
+  auto toGrid = [](const std::string s) {
+    std::vector<unsigned int> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) out.push_back(std::stoul(item));
+    return out;
+  };
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--quick") {
+      settings.n_grid       = { 1000, 10000 };
+      settings.p_grid       = { 8 };
+      settings.factory_grid = { 10 };
+      settings.reps         = 3;
+      continue;
+    }
+    if (i + 1 >= argc) throw std::invalid_argument("Missing value for argument '" + arg + "'.");
+    std::string val = argv[++i];
+
+    if      (arg == "--out")       settings.out_file     = val;
+    else if (arg == "--baseline")  settings.baseline     = val;
+    else if (arg == "--threshold") settings.threshold    = std::stod(val);
+    else if (arg == "--reps")      settings.reps         = std::stoul(val);
+    else if (arg == "--filter")    settings.filter       = val;
+    else if (arg == "--n")         settings.n_grid       = toGrid(val);
+    else if (arg == "--p")         settings.p_grid       = toGrid(val);
+    else if (arg == "--factories") settings.factory_grid = toGrid(val);
+    else if (arg == "--threads")   settings.thread_grid  = toGrid(val);
+    else throw std::invalid_argument("Unknown argument '" + arg + "'.");
+  }
+  if (settings.reps == 0) throw std::invalid_argument("At least one repetition is required.");
+  if (std::find(settings.thread_grid.begin(), settings.thread_grid.end(), 0u) != settings.thread_grid.end()) {
+    throw std::invalid_argument("The number of threads must be positive.");
+  }
+  return settings;
+}
+
+int main (int argc, char* argv[])
+{
+  BenchSettings settings;
+  try {
+    settings = parseArgs(argc, argv);
+  } catch (const std::exception& ex) {
+    std::cerr << ex.what() << std::endl;
+    std::cerr << "Usage: bench_kernels [--quick] [--out file] [--baseline file] [--threshold 0.15] [--reps 7]" << std::endl
+              << "                     [--filter kernel] [--n 1000,10000] [--p 8,24] [--factories 10,50] [--threads 1,2,4]" << std::endl;
+    return 2;
+  }
+  arma::arma_rng::set_seed(31415);
+
+  std::vector<BenchResult> results;
+  benchBinning(settings, results);
+  benchSplinesAndTensors(settings, results);
+  benchSolver(settings, results);
+  benchLoss(settings, results);
+  benchFindBestBaselearner(settings, results);
+
+  json jout = resultsToJson(results, settings);
+  if (! settings.out_file.empty()) {
+    std::ofstream out(settings.out_file);
+    out << jout.dump(2);
+  }
+  if (! settings.baseline.empty()) {
+    std::ifstream in(settings.baseline);
+    if (! in.is_open()) {
+      std::cerr << "Cannot open baseline '" << settings.baseline << "'." << std::endl;
+      return 2;
+    }
+    json jbase = json::parse(in);
+    if (compareToBaseline(results, jbase, settings.threshold) > 0) return 1;
+  }
+  return 0;
+}
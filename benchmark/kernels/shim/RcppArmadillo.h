@@ -0,0 +1,130 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    RcppArmadillo.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Minimal stand-in for RcppArmadillo to compile the kernels without R
+ *
+ *  @section DESCRIPTION
+ *
+ *  The sources in `src/` include `RcppArmadillo.h` and use a small part of the
+ *  Rcpp API (`stop`, `warning`, `Rcout`) plus some R objects for the custom
+ *  base-learner and losses. This header maps the first ones to plain C++ and
+ *  replaces all R objects by `RObject` which throws as soon as it is used. Hence,
+ *  everything except custom R base-learner and losses works as in the package.
+ *
+ *  This header is just used by the standalone benchmarks in `benchmark/kernels`
+ *  and is never part of the R package.
+ *
+ */
+
+#ifndef RCPPARMADILLO_SHIM_H_
+#define RCPPARMADILLO_SHIM_H_
+
+#include <armadillo>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef TRUE
+#define TRUE true
+#endif
+#ifndef FALSE
+#define FALSE false
+#endif
+
+namespace Rcpp
+{
+
+inline std::ostream& Rcout = std::cout;
+
+[[noreturn]] inline void stop (const std::string& msg)
+{
+  throw std::runtime_error(msg);
+}
+
+inline void warning (const std::string& msg)
+{
+  std::cerr << "Warning: " << msg << std::endl;
+}
+
+[[noreturn]] inline void noR ()
+{
+  throw std::logic_error("R objects are not available in the standalone build.");
+}
+
+// Placeholder for every R object (functions, lists, vectors). Constructing and
+// copying is fine, using it throws:
+class RObject
+{
+public:
+  RObject () { }
+
+  template<typename... Args>
+  RObject operator() (Args&&...) const { noR(); }
+
+  template<typename T>
+  RObject& operator[] (const T&) { noR(); }
+
+  template<typename T>
+  operator T () const { noR(); }
+
+  int  size         ()             const { noR(); }
+  bool hasAttribute (const char*)  const { noR(); }
+  RObject names     ()             const { noR(); }
+};
+
+typedef RObject Function;
+typedef RObject List;
+typedef RObject NumericVector;
+typedef RObject NumericMatrix;
+
+template<typename T>
+T as (const RObject&) { noR(); }
+
+template<typename T>
+class XPtr
+{
+public:
+  XPtr (void*) { }
+  T& operator* () const { noR(); }
+};
+
+} // namespace Rcpp
+
+typedef void* SEXP;
+
+inline int TYPEOF (const Rcpp::RObject&) { Rcpp::noR(); }
+
+[[noreturn]] inline void forward_exception_to_r (const std::exception& ex)
+{
+  throw std::runtime_error(ex.what());
+}
+
+[[noreturn]] inline void Rf_error (const char* msg)
+{
+  throw std::runtime_error(msg);
+}
+
+#endif // RCPPARMADILLO_SHIM_H_
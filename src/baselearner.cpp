@@ -69,11 +69,71 @@ arma::mat Baselearner::getParameter () const
   return _parameter;
 }
 
+void Baselearner::setParameter (const arma::mat& parameter)
+{
+  _parameter = parameter;
+}
+
 std::string Baselearner::getBaselearnerType () const
 {
   return _blearner_type;
 }
 
+/**
+ * \brief Norm of \f$X^Ty\f$ of the last training
+ *
+ * Just set by base learners that solve \f$(X^TX + P)\theta = X^Ty\f$ with the cache
+ * of the data object. Used to screen candidates (see `screening::SafeScreening`).
+ *
+ * \returns `double` Frobenius norm or -1 if not available.
+ */
+double Baselearner::getResponseCrossNorm () const
+{
+  return _xtr_norm;
+}
+
+/**
+ * \brief Heap memory of one base learner object
+ *
+ * The object itself (estimated as base class plus the shared pointer to data
+ * and attributes every implementation holds), the control block of the shared
+ * pointer, the parameter, and the type string. The data and attributes are
+ * shared with the factory and therefore not included.
+ */
+double Baselearner::getMemoryBytes () const
+{
+  return sizeof(Baselearner) + 2 * sizeof(std::shared_ptr<data::Data>) + memreport::SH_PTR_CTRL_BYTES
+    + memreport::matBytes(_parameter) + memreport::stringBytes(_blearner_type);
+}
+
+/**
+ * \brief Train the base learner on a subset of the training rows
+ *
+ * The cached cross products of the data objects are always computed on all
+ * observations. Hence, the cross product with the response on the subset
+ * \f$S\f$ is scaled by \f$n / |S|\f$ to get an unbiased estimate of the cross
+ * product on the full data. This default uses the response padded with zeros
+ * outside of the subset and therefore works for every base learner. The
+ * implementations override it to visit just the rows of the subset.
+ *
+ * \param response `arma::mat` Response (pseudo residuals) of all observations.
+ * \param idx `arma::uvec` Rows that are used for the fit.
+ */
+void Baselearner::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+
+  arma::mat response_padded(response.n_rows, response.n_cols, arma::fill::zeros);
+  response_padded.rows(idx) = scale * response.rows(idx);
+  train(response_padded);
+}
+
+arma::mat Baselearner::predictSubset (const arma::uvec& idx) const
+{
+  arma::mat pred = predict();
+  return pred.rows(idx);
+}
+
 json Baselearner::baseToJson (const std::string cln) const
 {
   json j = {
@@ -114,11 +174,11 @@ BaselearnerPolynomial::BaselearnerPolynomial (const json& j, const mdata& mdat)
 
 void BaselearnerPolynomial::train (const arma::mat& response)
 {
-  arma::vec temp_weight(1, arma::fill::ones);
   if (_attributes->degree == 1) {
-    double y_mean = 0;
+    // Closed form of the slope and intercept for each column of the response:
+    arma::rowvec y_mean(response.n_cols, arma::fill::zeros);
     if (_attributes->use_intercept) {
-      y_mean = arma::as_scalar(arma::accu(response) / response.size());
+      y_mean = arma::sum(response, 0) / response.n_rows;
     }
 
     arma::mat xtx_inv = _sh_ptr_bindata->getCacheMat();
@@ -129,16 +189,80 @@ void BaselearnerPolynomial::train (const arma::mat& response)
     } else {
       dcol = 0;
     }
-    arma::mat xmx = _sh_ptr_bindata->getDenseData().col(dcol) - xtx_inv(0,0);
-    arma::mat ymy = response - y_mean;
-    arma::mat xmxdymy;
-    if (_sh_ptr_bindata->usesBinning()) {
-      xmxdymy = binning::binnedMatMultResponse(xmx, ymy, _sh_ptr_bindata->getBinningIndex(), temp_weight);
+    arma::mat ymy = response.each_row() - y_mean;
+    arma::rowvec xmxdymy;
+    if (_sh_ptr_bindata->usesChunks()) {
+      // (x - c)^T (y - m) without the centered column of the streamed design:
+      xmxdymy = _sh_ptr_bindata->crossProduct(ymy).row(dcol) - xtx_inv(0,0) * arma::sum(ymy, 0);
+    } else if (_sh_ptr_bindata->usesBinning()) {
+      arma::mat xmx = _sh_ptr_bindata->getDenseData().col(dcol) - xtx_inv(0,0);
+      xmxdymy = xmx.t() * binning::accumulateBinRows(_sh_ptr_bindata->getBinningIndex(), ymy, xmx.n_rows);
+    } else {
+      arma::mat xmx = _sh_ptr_bindata->getDenseData().col(dcol) - xtx_inv(0,0);
+      xmxdymy = xmx.t() * ymy;
+    }
+
+    arma::rowvec slope = xmxdymy / xtx_inv(0,1);
+    arma::rowvec intercept = y_mean - slope * xtx_inv(0,0);
+
+    if (_attributes->use_intercept) {
+      _parameter = arma::join_cols(intercept, slope);
+    } else {
+      _parameter = slope;
+    }
+  } else {
+    arma::mat temp;
+    if (_sh_ptr_bindata->usesBinning() || _sh_ptr_bindata->usesChunks()) {
+      temp = _sh_ptr_bindata->crossProduct(response);
+    } else {
+      temp = (response.t() * _sh_ptr_bindata->getDenseData()).t();
+    }
+    _xtr_norm  = arma::norm(temp, "fro");
+    _parameter = helper::cboostSolver(_sh_ptr_bindata->getCache(), temp);
+  }
+}
+
+arma::mat BaselearnerPolynomial::predict () const
+{
+  if (_sh_ptr_bindata->usesBinning() || _sh_ptr_bindata->usesChunks()) {
+    return _sh_ptr_bindata->linearPredictor(_parameter);
+  } else {
+    return _sh_ptr_bindata->getDenseData() * _parameter;
+  }
+}
+
+void BaselearnerPolynomial::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+  arma::mat response_sub = response.rows(idx);
+
+  if (_attributes->degree == 1) {
+    double y_mean = 0;
+    if (_attributes->use_intercept) {
+      y_mean = arma::as_scalar(arma::accu(response_sub) / response_sub.size());
+    }
+
+    arma::mat xtx_inv = _sh_ptr_bindata->getCacheMat();
+
+    arma::uvec dcol(1);
+    if (_attributes->use_intercept) {
+      dcol(0) = 1;
+    } else {
+      dcol(0) = 0;
+    }
+    arma::mat ymy = response_sub - y_mean;
+    double xmxdymy;
+    if (_sh_ptr_bindata->usesChunks()) {
+      xmxdymy = _sh_ptr_bindata->getChunkedDesign()->crossProductSubset(ymy, idx)(dcol(0), 0) - xtx_inv(0,0) * arma::accu(ymy);
+    } else if (_sh_ptr_bindata->usesBinning()) {
+      arma::mat xmx = _sh_ptr_bindata->getDenseData().cols(dcol) - xtx_inv(0,0);
+      xmxdymy = arma::as_scalar(binning::binnedMatMultResponseSubset(xmx, ymy, _sh_ptr_bindata->getBinningIndex(), idx));
     } else {
+      arma::mat xmx = _sh_ptr_bindata->getDenseData().submat(idx, dcol) - xtx_inv(0,0);
       xmxdymy = arma::accu(xmx % ymy);
     }
 
-    double slope = arma::as_scalar(xmxdymy / arma::as_scalar(xtx_inv(0,1)));
+    double slope = scale * xmxdymy / arma::as_scalar(xtx_inv(0,1));
     double intercept = y_mean - slope * xtx_inv(0,0);
 
     if (_attributes->use_intercept) {
@@ -153,21 +277,25 @@ void BaselearnerPolynomial::train (const arma::mat& response)
     }
   } else {
     arma::mat temp;
-    if (_sh_ptr_bindata->usesBinning()) {
-      temp = binning::binnedMatMultResponse(_sh_ptr_bindata->getDenseData(), response, _sh_ptr_bindata->getBinningIndex(), temp_weight).t();
+    if (_sh_ptr_bindata->usesChunks()) {
+      temp = _sh_ptr_bindata->getChunkedDesign()->crossProductSubset(response_sub, idx);
+    } else if (_sh_ptr_bindata->usesBinning()) {
+      temp = binning::binnedMatMultResponseSubset(_sh_ptr_bindata->getDenseData(), response_sub, _sh_ptr_bindata->getBinningIndex(), idx).t();
     } else {
-      temp = (response.t() * _sh_ptr_bindata->getDenseData()).t();
+      temp = (response_sub.t() * _sh_ptr_bindata->getDenseData().rows(idx)).t();
     }
-    _parameter = helper::cboostSolver(_sh_ptr_bindata->getCache(), temp);
+    _parameter = helper::cboostSolver(_sh_ptr_bindata->getCache(), scale * temp);
   }
 }
 
-arma::mat BaselearnerPolynomial::predict () const
+arma::mat BaselearnerPolynomial::predictSubset (const arma::uvec& idx) const
 {
-  if (_sh_ptr_bindata->usesBinning()) {
-    return binning::binnedPrediction(_sh_ptr_bindata->getDenseData(), _parameter, _sh_ptr_bindata->getBinningIndex());
+  if (_sh_ptr_bindata->usesChunks()) {
+    return _sh_ptr_bindata->getChunkedDesign()->linearPredictorSubset(_parameter, idx);
+  } else if (_sh_ptr_bindata->usesBinning()) {
+    return binning::binnedPredictionSubset(_sh_ptr_bindata->getDenseData(), _parameter, _sh_ptr_bindata->getBinningIndex(), idx);
   } else {
-    return _sh_ptr_bindata->getDenseData() * _parameter;
+    return _sh_ptr_bindata->getDenseData().rows(idx) * _parameter;
   }
 }
 
@@ -239,22 +367,38 @@ void BaselearnerPSpline::train (const arma::mat& response)
 {
   arma::mat temp;
 
-  if (_sh_ptr_bindata->usesBinning()) {
-    arma::vec temp_weight(1, arma::fill::ones);
-    temp = binning::binnedSparseMatMultResponse(_sh_ptr_bindata->getSparseData(), response, _sh_ptr_bindata->getBinningIndex(), temp_weight);
+  if (_sh_ptr_bindata->usesBinning() || _sh_ptr_bindata->usesChunks()) {
+    temp = _sh_ptr_bindata->crossProduct(response);
   } else {
     temp = _sh_ptr_bindata->getSparseData() * response;
   }
+  _xtr_norm  = arma::norm(temp, "fro");
   _parameter = helper::cboostSolver(_sh_ptr_bindata->getCache(), temp);
 }
 
+void BaselearnerPSpline::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+  arma::mat response_sub = response.rows(idx);
+  arma::mat temp;
+
+  if (_sh_ptr_bindata->usesChunks()) {
+    temp = _sh_ptr_bindata->getChunkedDesign()->crossProductSubset(response_sub, idx);
+  } else if (_sh_ptr_bindata->usesBinning()) {
+    temp = binning::binnedSparseMatMultResponseSubset(_sh_ptr_bindata->getSparseData(), response_sub, _sh_ptr_bindata->getBinningIndex(), idx);
+  } else {
+    temp = helper::sparseMatMultResponseSubset(_sh_ptr_bindata->getSparseData(), response_sub, idx);
+  }
+  _parameter = helper::cboostSolver(_sh_ptr_bindata->getCache(), scale * temp);
+}
+
 arma::mat BaselearnerPSpline::predict () const
 {
   // Here we have a different handling than in predict(data) because of the possibility to use binning.
   // It does not make sense to also include binning into the prediction of new points! Binning is just
   // a method to fasten the fitting process.
-  if (_sh_ptr_bindata->usesBinning()) {
-    return binning::binnedSparsePrediction(_sh_ptr_bindata->getSparseData(), _parameter, _sh_ptr_bindata->getBinningIndex());
+  if (_sh_ptr_bindata->usesBinning() || _sh_ptr_bindata->usesChunks()) {
+    return _sh_ptr_bindata->linearPredictor(_parameter);
   } else {
     // Trick to speed up things. Try to avoid transposing the sparse matrix. The
     // original one (sh_ptr_data->sparse_data_mat * parameter) is about 4 or 5 times
@@ -263,6 +407,17 @@ arma::mat BaselearnerPSpline::predict () const
   }
 }
 
+arma::mat BaselearnerPSpline::predictSubset (const arma::uvec& idx) const
+{
+  if (_sh_ptr_bindata->usesChunks()) {
+    return _sh_ptr_bindata->getChunkedDesign()->linearPredictorSubset(_parameter, idx);
+  } else if (_sh_ptr_bindata->usesBinning()) {
+    return binning::binnedSparsePredictionSubset(_sh_ptr_bindata->getSparseData(), _parameter, _sh_ptr_bindata->getBinningIndex(), idx);
+  } else {
+    return helper::sparsePredictionSubset(_sh_ptr_bindata->getSparseData(), _parameter, idx);
+  }
+}
+
 arma::mat BaselearnerPSpline::predict (const std::shared_ptr<data::Data>& newdata) const
 {
   return (_parameter.t() * newdata->getSparseData()).t();
@@ -301,14 +456,32 @@ BaselearnerTensor::BaselearnerTensor (const json& j, const mdata& mdat)
 void BaselearnerTensor::train (const arma::mat& response)
 {
   arma::mat temp;
-  if (_sh_ptr_data->usesSparseMatrix()) {
+  if (_sh_ptr_data->usesChunks()) {
+    temp = _sh_ptr_data->crossProduct(response);
+  } else if (_sh_ptr_data->usesSparseMatrix()) {
     temp = _sh_ptr_data->getSparseData() * response;
   } else {
     temp = (response.t() * _sh_ptr_data->getDenseData()).t();
   }
+  _xtr_norm  = arma::norm(temp, "fro");
   _parameter = helper::cboostSolver(_sh_ptr_data->getCache(), temp);
 }
 
+void BaselearnerTensor::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+  arma::mat response_sub = response.rows(idx);
+  arma::mat temp;
+  if (_sh_ptr_data->usesChunks()) {
+    temp = _sh_ptr_data->getChunkedDesign()->crossProductSubset(response_sub, idx);
+  } else if (_sh_ptr_data->usesSparseMatrix()) {
+    temp = helper::sparseMatMultResponseSubset(_sh_ptr_data->getSparseData(), response_sub, idx);
+  } else {
+    temp = (response_sub.t() * _sh_ptr_data->getDenseData().rows(idx)).t();
+  }
+  _parameter = helper::cboostSolver(_sh_ptr_data->getCache(), scale * temp);
+}
+
 arma::mat BaselearnerTensor::predict () const
 {
   return predict(_sh_ptr_data);
@@ -319,9 +492,22 @@ arma::mat BaselearnerTensor::predict () const
   //}
 }
 
+arma::mat BaselearnerTensor::predictSubset (const arma::uvec& idx) const
+{
+  if (_sh_ptr_data->usesChunks()) {
+    return _sh_ptr_data->getChunkedDesign()->linearPredictorSubset(_parameter, idx);
+  } else if (_sh_ptr_data->usesSparseMatrix()) {
+    return helper::sparsePredictionSubset(_sh_ptr_data->getSparseData(), _parameter, idx);
+  } else {
+    return _sh_ptr_data->getDenseData().rows(idx) * _parameter;
+  }
+}
+
 arma::mat BaselearnerTensor::predict (const std::shared_ptr<data::Data>& newdata) const
 {
-  if (newdata->usesSparseMatrix()) {
+  if (newdata->usesChunks()) {
+    return newdata->linearPredictor(_parameter);
+  } else if (newdata->usesSparseMatrix()) {
     return (_parameter.t() * newdata->getSparseData()).t();
   } else {
     return newdata->getDenseData() * _parameter;
@@ -360,9 +546,8 @@ BaselearnerCentered::BaselearnerCentered (const json& j, const mdata& mdat)
 void BaselearnerCentered::train (const arma::mat& response)
 {
   arma::mat temp;
-  if (_sh_ptr_bindata->usesBinning()) {
-    arma::vec temp_weight(1, arma::fill::ones);
-    temp = binning::binnedMatMultResponse(_sh_ptr_bindata->getDenseData(), response, _sh_ptr_bindata->getBinningIndex(), temp_weight).t();
+  if (_sh_ptr_bindata->usesBinning() || _sh_ptr_bindata->usesChunks()) {
+    temp = _sh_ptr_bindata->crossProduct(response);
   } else {
     temp = (response.t() * _sh_ptr_bindata->getDenseData()).t();
   }
@@ -371,13 +556,39 @@ void BaselearnerCentered::train (const arma::mat& response)
 
 arma::mat BaselearnerCentered::predict () const
 {
-  if (_sh_ptr_bindata->usesBinning()) {
-    return binning::binnedPrediction(_sh_ptr_bindata->getDenseData(), _parameter, _sh_ptr_bindata->getBinningIndex());
+  if (_sh_ptr_bindata->usesBinning() || _sh_ptr_bindata->usesChunks()) {
+    return _sh_ptr_bindata->linearPredictor(_parameter);
   } else {
     return _sh_ptr_bindata->getDenseData() * _parameter;
   }
 }
 
+void BaselearnerCentered::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+  arma::mat response_sub = response.rows(idx);
+  arma::mat temp;
+  if (_sh_ptr_bindata->usesChunks()) {
+    temp = _sh_ptr_bindata->getChunkedDesign()->crossProductSubset(response_sub, idx);
+  } else if (_sh_ptr_bindata->usesBinning()) {
+    temp = binning::binnedMatMultResponseSubset(_sh_ptr_bindata->getDenseData(), response_sub, _sh_ptr_bindata->getBinningIndex(), idx).t();
+  } else {
+    temp = (response_sub.t() * _sh_ptr_bindata->getDenseData().rows(idx)).t();
+  }
+  _parameter = helper::cboostSolver(_sh_ptr_bindata->getCache(), scale * temp);
+}
+
+arma::mat BaselearnerCentered::predictSubset (const arma::uvec& idx) const
+{
+  if (_sh_ptr_bindata->usesChunks()) {
+    return _sh_ptr_bindata->getChunkedDesign()->linearPredictorSubset(_parameter, idx);
+  } else if (_sh_ptr_bindata->usesBinning()) {
+    return binning::binnedPredictionSubset(_sh_ptr_bindata->getDenseData(), _parameter, _sh_ptr_bindata->getBinningIndex(), idx);
+  } else {
+    return _sh_ptr_bindata->getDenseData().rows(idx) * _parameter;
+  }
+}
+
 arma::mat BaselearnerCentered::predict (const std::shared_ptr<data::Data>& newdata) const
 {
   return newdata->getDenseData() * _parameter;
@@ -415,7 +626,9 @@ BaselearnerCategoricalRidge::BaselearnerCategoricalRidge (const json& j, const m
 
 void BaselearnerCategoricalRidge::train (const arma::mat& response)
 {
-  _parameter = _sh_ptr_data->getCache().second % (_sh_ptr_data->getSparseData() * response);
+  arma::mat temp = _sh_ptr_data->getSparseData() * response;
+  _xtr_norm  = arma::norm(temp, "fro");
+  _parameter = temp.each_col() % _sh_ptr_data->getCache().second;
 }
 
 arma::mat BaselearnerCategoricalRidge::predict () const
@@ -423,6 +636,18 @@ arma::mat BaselearnerCategoricalRidge::predict () const
   return (_parameter.t() * _sh_ptr_data->getSparseData()).t();
 }
 
+void BaselearnerCategoricalRidge::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+  arma::mat response_sub = response.rows(idx);
+  _parameter = _sh_ptr_data->getCache().second % (scale * helper::sparseMatMultResponseSubset(_sh_ptr_data->getSparseData(), response_sub, idx));
+}
+
+arma::mat BaselearnerCategoricalRidge::predictSubset (const arma::uvec& idx) const
+{
+  return helper::sparsePredictionSubset(_sh_ptr_data->getSparseData(), _parameter, idx);
+}
+
 arma::mat BaselearnerCategoricalRidge::predict (const std::shared_ptr<data::Data>& newdata) const
 {
   return (_parameter.t() * newdata->getSparseData()).t();
@@ -468,7 +693,9 @@ BaselearnerCategoricalBinary::BaselearnerCategoricalBinary (const json& j, const
 
 void BaselearnerCategoricalBinary::train (const arma::mat& response)
 {
-  _parameter = _sh_ptr_data->getCache().second * (_sh_ptr_data->getSparseData() * response);
+  arma::mat temp = _sh_ptr_data->getSparseData() * response;
+  _xtr_norm  = arma::norm(temp, "fro");
+  _parameter = _sh_ptr_data->getCache().second * temp;
 
   // Calculate sum manually due to the idx format:
   //double sum_response = 0;
@@ -486,6 +713,18 @@ arma::mat BaselearnerCategoricalBinary::predict () const
   return (_parameter.t() * _sh_ptr_data->getSparseData()).t();
 }
 
+void BaselearnerCategoricalBinary::trainSubset (const arma::mat& response, const arma::uvec& idx)
+{
+  const double scale = response.n_rows / static_cast<double>(idx.size());
+  arma::mat response_sub = response.rows(idx);
+  _parameter = _sh_ptr_data->getCache().second * (scale * helper::sparseMatMultResponseSubset(_sh_ptr_data->getSparseData(), response_sub, idx));
+}
+
+arma::mat BaselearnerCategoricalBinary::predictSubset (const arma::uvec& idx) const
+{
+  return helper::sparsePredictionSubset(_sh_ptr_data->getSparseData(), _parameter, idx);
+}
+
 arma::mat BaselearnerCategoricalBinary::predict (const std::shared_ptr<data::Data>& newdata) const
 {
   return _parameter * newdata->getSparseData();
@@ -51,6 +51,9 @@ protected:
   arma::mat          _parameter;
   const std::string  _blearner_type;
 
+  // Norm of the cross product of design and response of the last `train()`, -1 if unknown:
+  double             _xtr_norm = -1;
+
 public:
   Baselearner (const std::string);
   Baselearner (const json&);
@@ -58,13 +61,22 @@ public:
   // Virtual methods
   virtual void         train             (const arma::mat&)       = 0;
   virtual arma::mat    predict           ()                 const = 0;
+
+  // Fit and predict on a subset of the training rows, e.g. for stochastic boosting:
+  virtual void         trainSubset       (const arma::mat&, const arma::uvec&);
+  virtual arma::mat    predictSubset     (const arma::uvec&)                   const;
   virtual arma::mat    predict           (const sdata&)     const = 0;
   virtual std::string  getDataIdentifier ()                 const = 0;
   virtual json         toJson            ()                 const = 0;
 
   // Getter/Setter
   arma::mat    getParameter        () const;
+
+  // Used by optimizers that solve the system of the base learner on their own:
+  void         setParameter        (const arma::mat&);
   std::string  getBaselearnerType  () const;
+  double       getResponseCrossNorm () const;
+  double       getMemoryBytes      () const;
 
   json baseToJson (const std::string) const;
 
@@ -93,7 +105,9 @@ public:
   BaselearnerPolynomial (const json&, const mdata&);
 
   void         train             (const arma::mat&);
+  void         trainSubset       (const arma::mat&, const arma::uvec&);
   arma::mat    predict           ()                  const;
+  arma::mat    predictSubset     (const arma::uvec&) const;
   arma::mat    predict           (const sdata&)      const;
   std::string  getDataIdentifier ()                  const;
   json         toJson            ()                  const;
@@ -123,7 +137,9 @@ public:
   BaselearnerPSpline (const json&, const mdata&);
 
   void         train             (const arma::mat&);
+  void         trainSubset       (const arma::mat&, const arma::uvec&);
   arma::mat    predict           ()                  const;
+  arma::mat    predictSubset     (const arma::uvec&) const;
   arma::mat    predict           (const sdata&)      const;
   std::string  getDataIdentifier ()                  const;
   json         toJson            ()                  const;
@@ -144,7 +160,9 @@ public:
   BaselearnerTensor (const json&, const mdata&);
 
   void         train             (const arma::mat&);
+  void         trainSubset       (const arma::mat&, const arma::uvec&);
   arma::mat    predict           ()                  const;
+  arma::mat    predictSubset     (const arma::uvec&) const;
   arma::mat    predict           (const sdata&)      const;
   std::string  getDataIdentifier ()                  const;
   json         toJson            ()                  const;
@@ -165,7 +183,9 @@ public:
   BaselearnerCentered (const json&, const mdata&);
 
   void         train             (const arma::mat&);
+  void         trainSubset       (const arma::mat&, const arma::uvec&);
   arma::mat    predict           ()                  const;
+  arma::mat    predictSubset     (const arma::uvec&) const;
   arma::mat    predict           (const sdata&)      const;
   std::string  getDataIdentifier ()                  const;
   json         toJson            ()                  const;
@@ -186,7 +206,9 @@ public:
   BaselearnerCategoricalRidge (const json&, const mdata&);
 
   void         train             (const arma::mat&);
+  void         trainSubset       (const arma::mat&, const arma::uvec&);
   arma::mat    predict           ()                  const;
+  arma::mat    predictSubset     (const arma::uvec&) const;
   arma::mat    predict           (const sdata&)      const;
   std::string  getDataIdentifier ()                  const;
   json         toJson            ()                  const;
@@ -209,7 +231,9 @@ public:
   BaselearnerCategoricalBinary (const json&, const mdata&);
 
   void         train             (const arma::mat&);
+  void         trainSubset       (const arma::mat&, const arma::uvec&);
   arma::mat    predict           ()                  const;
+  arma::mat    predictSubset     (const arma::uvec&) const;
   arma::mat    predict           (const sdata&)      const;
   std::string  getDataIdentifier ()                  const;
   json         toJson            ()                  const;
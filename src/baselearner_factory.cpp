@@ -116,6 +116,16 @@ std::vector<double> BaselearnerFactory::getMinMax () const
   return _sh_ptr_data_source->getMinMax();
 }
 
+bool BaselearnerFactory::supportsChunkedDesign () const
+{
+  return false;
+}
+
+sdata BaselearnerFactory::instantiateShardData (const mdata& data_map) const
+{
+  return instantiateData(data_map);
+}
+
 std::map<std::string, std::vector<std::string>> BaselearnerFactory::getValueNames () const
 {
   std::map<std::string, std::vector<std::string>> mout;
@@ -131,6 +141,30 @@ std::vector<sdata> BaselearnerFactory::getVecDataSource () const
   return out;
 }
 
+/**
+ * \brief Add the heap memory of the factory to the report
+ *
+ * Reports the data sources, the instantiated data (design, binning index,
+ * and cache) and the attributes like penalty matrices. Factories and data
+ * objects are visited just once.
+ */
+void BaselearnerFactory::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+
+  std::string component = "factory:" + getFactoryId();
+  for (auto& it : getVecDataSource()) {
+    if (it != nullptr) it->reportMemory(report, component);
+  }
+  sdata sh_ptr_inst = getInstantiatedData();
+  if (sh_ptr_inst != nullptr) sh_ptr_inst->reportMemory(report, component);
+
+  reportAttributesMemory(report, component);
+}
+
+void BaselearnerFactory::reportAttributesMemory (memreport::MemoryReport& report, const std::string& component) const
+{ }
+
 /// Destructor
 BaselearnerFactory::~BaselearnerFactory () {}
 
@@ -143,7 +177,7 @@ BaselearnerFactory::~BaselearnerFactory () {}
 
 BaselearnerPolynomialFactory::BaselearnerPolynomialFactory (const std::string blearner_type,
   std::shared_ptr<data::Data> data_source, const unsigned int degree, const bool intercept,
-  const unsigned int bin_root, const double df, const double penalty)
+  const unsigned int bin_root, const double df, const double penalty, const chunked::DesignBudget& budget)
   : BaselearnerFactory::BaselearnerFactory ( blearner_type, data_source )
 {
   _attributes->df            = df;
@@ -152,12 +186,19 @@ BaselearnerPolynomialFactory::BaselearnerPolynomialFactory (const std::string bl
   _attributes->use_intercept = intercept;
   _attributes->bin_root      = bin_root;
 
-  _sh_ptr_bindata = init::initPolynomialData(data_source, _attributes);
+  // Designs that exceed the budget are written in blocks of rows and are never in memory as a whole:
+  const double row_bytes = (degree + static_cast<double>(intercept)) * sizeof(double);
+  if ((bin_root == 0) && budget.streams(row_bytes * data_source->getNObs())) {
+    _sh_ptr_bindata = init::streamPolynomialData(data_source, _attributes,
+      budget.filePath(data_source->getDataIdentifier() + "_" + blearner_type, this), budget.blockRows(row_bytes, data_source->getNObs()));
+  } else {
+    _sh_ptr_bindata = init::initPolynomialData(data_source, _attributes);
+  }
   _attributes->penalty_mat = arma::diagmat( arma::vec(_sh_ptr_bindata->getNCols(), arma::fill::ones) );
 
   arma::mat temp_xtx;
   if (_attributes->degree == 1) {
-    arma::mat mraw = data_source->getDenseData();
+    arma::mat mraw = data_source->getData();
     arma::mat temp_mat(1, 2, arma::fill::zeros);
 
     if (_attributes->use_intercept) {
@@ -168,7 +209,9 @@ BaselearnerPolynomialFactory::BaselearnerPolynomialFactory (const std::string bl
     _sh_ptr_bindata->setCache("identity", temp_xtx);
   } else {
 
-    if (_sh_ptr_bindata->usesBinning()) {
+    if (_sh_ptr_bindata->usesChunks()) {
+      temp_xtx = _sh_ptr_bindata->weightedGram(arma::vec(_sh_ptr_bindata->getNDesignRows(), arma::fill::ones));
+    } else if (_sh_ptr_bindata->usesBinning()) {
       arma::vec temp_weight(1, arma::fill::ones);
       temp_xtx = binning::binnedMatMult(_sh_ptr_bindata->getDenseData(), _sh_ptr_bindata->getBinningIndex(), temp_weight);
     } else {
@@ -200,11 +243,25 @@ sdata BaselearnerPolynomialFactory::instantiateData (const mdata& data_map) cons
   return init::initPolynomialData(newdata, _attributes);
 }
 
+sdata BaselearnerPolynomialFactory::instantiateShardData (const mdata& data_map) const
+{
+  auto newdata   = data::extractDataFromMap(this->_sh_ptr_data_source, data_map);
+  auto attr_temp = std::make_shared<init::PolynomialAttributes>(*_attributes);
+  attr_temp->bin_root = _sh_ptr_bindata->getBinRoot();
+
+  return init::initPolynomialData(newdata, attr_temp);
+}
+
 bool BaselearnerPolynomialFactory::usesSparse () const
 {
   return false;
 }
 
+bool BaselearnerPolynomialFactory::supportsChunkedDesign () const
+{
+  return true;
+}
+
 sdata BaselearnerPolynomialFactory::getInstantiatedData () const
 {
   return _sh_ptr_bindata;
@@ -242,6 +299,7 @@ std::string BaselearnerPolynomialFactory::getFactoryId () const
 
 arma::mat BaselearnerPolynomialFactory::calculateLinearPredictor (const arma::mat& param) const
 {
+  if (_sh_ptr_bindata->usesChunks()) return _sh_ptr_bindata->linearPredictor(param);
   return _sh_ptr_bindata->getDenseData() * param;
 }
 
@@ -286,6 +344,11 @@ json BaselearnerPolynomialFactory::extractDataToJson (const bool save_source, co
   return j;
 }
 
+void BaselearnerPolynomialFactory::reportAttributesMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  report.add(component, getFactoryId(), "penalty_mat", memreport::matBytes(_attributes->penalty_mat));
+}
+
 
 // BaselearnerPSpline:
 // -----------------------
@@ -314,7 +377,7 @@ json BaselearnerPolynomialFactory::extractDataToJson (const bool save_source, co
 BaselearnerPSplineFactory::BaselearnerPSplineFactory (const std::string blearner_type,
   const std::shared_ptr<data::Data>& data_source, const unsigned int degree, const unsigned int n_knots,
   const double penalty, const double df, const unsigned int differences, const bool use_sparse_matrices,
-  const unsigned int bin_root, const std::string cache_type)
+  const unsigned int bin_root, const std::string cache_type, const chunked::DesignBudget& budget)
   : BaselearnerFactory::BaselearnerFactory ( blearner_type, data_source )
 {
   _attributes->degree      = degree;
@@ -323,15 +386,24 @@ BaselearnerPSplineFactory::BaselearnerPSplineFactory (const std::string blearner
   _attributes->df          = df;
   _attributes->differences = differences;
   _attributes->bin_root    = bin_root;
-  _attributes->knots       = splines::createKnots(data_source->getDenseData(), n_knots, degree);
+  _attributes->knots       = splines::createKnots(data_source->getData(), n_knots, degree);
 
-  _sh_ptr_bindata = init::initPSplineData(data_source, _attributes);
+  // Each row of the basis has `degree + 1` non-zero elements:
+  const double row_bytes = (degree + 1) * (sizeof(double) + sizeof(arma::uword)) + sizeof(arma::uword);
+  if ((bin_root == 0) && budget.streams(row_bytes * data_source->getNObs())) {
+    _sh_ptr_bindata = init::streamPSplineData(data_source, _attributes,
+      budget.filePath(data_source->getDataIdentifier() + "_" + blearner_type, this), budget.blockRows(row_bytes, data_source->getNObs()));
+  } else {
+    _sh_ptr_bindata = init::initPSplineData(data_source, _attributes);
+  }
 
   const arma::mat penalty_mat = splines::penaltyMat(_attributes->n_knots + (_attributes->degree + 1), _attributes->differences);
   _attributes->penalty_mat = penalty_mat;;
 
   arma::mat temp_xtx;
-  if (_sh_ptr_bindata->usesBinning()) {
+  if (_sh_ptr_bindata->usesChunks()) {
+    temp_xtx = _sh_ptr_bindata->weightedGram(arma::vec(_sh_ptr_bindata->getNDesignRows(), arma::fill::ones));
+  } else if (_sh_ptr_bindata->usesBinning()) {
     arma::vec temp_weight(1, arma::fill::ones);
     temp_xtx = binning::binnedSparseMatMult(_sh_ptr_bindata->getSparseData(), _sh_ptr_bindata->getBinningIndex(), temp_weight);
   } else {
@@ -364,6 +436,11 @@ bool BaselearnerPSplineFactory::usesSparse () const
   return true;
 }
 
+bool BaselearnerPSplineFactory::supportsChunkedDesign () const
+{
+  return true;
+}
+
 sdata BaselearnerPSplineFactory::getInstantiatedData () const
 {
   return _sh_ptr_bindata;
@@ -378,6 +455,15 @@ sdata BaselearnerPSplineFactory::instantiateData (const mdata& data_map) const
   return init::initPSplineData(newdata, attr_temp);
 }
 
+sdata BaselearnerPSplineFactory::instantiateShardData (const mdata& data_map) const
+{
+  auto newdata   = data::extractDataFromMap(this->_sh_ptr_data_source, data_map);
+  auto attr_temp = std::make_shared<init::PSplineAttributes>(*_attributes);
+  attr_temp->bin_root = _sh_ptr_bindata->getBinRoot();
+
+  return init::initPSplineData(newdata, attr_temp);
+}
+
 arma::mat BaselearnerPSplineFactory::getData () const
 {
   return arma::mat(_sh_ptr_bindata->getSparseData());
@@ -410,6 +496,7 @@ std::string BaselearnerPSplineFactory::getFactoryId () const
 
 arma::mat BaselearnerPSplineFactory::calculateLinearPredictor (const arma::mat& param) const
 {
+  if (_sh_ptr_bindata->usesChunks()) return _sh_ptr_bindata->linearPredictor(param);
   return (param.t() * _sh_ptr_bindata->getSparseData()).t();
 }
 
@@ -452,6 +539,12 @@ json BaselearnerPSplineFactory::extractDataToJson (const bool save_source, const
   return j;
 }
 
+void BaselearnerPSplineFactory::reportAttributesMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  report.add(component, getFactoryId(), "penalty_mat", memreport::matBytes(_attributes->penalty_mat));
+  report.add(component, getFactoryId(), "knots",       memreport::matBytes(_attributes->knots));
+}
+
 
 // BaselearnerTensorFactory:
 // ------------------------------------------------
@@ -515,6 +608,11 @@ bool BaselearnerTensorFactory::usesSparse () const
   return _blearner1->usesSparse() || _blearner2->usesSparse();
 }
 
+bool BaselearnerTensorFactory::supportsChunkedDesign () const
+{
+  return true;
+}
+
 sdata BaselearnerTensorFactory::getInstantiatedData () const
 {
   return _sh_ptr_data;
@@ -608,7 +706,9 @@ std::shared_ptr<blearnerfactory::BaselearnerFactory> BaselearnerTensorFactory::g
 
 arma::mat BaselearnerTensorFactory::calculateLinearPredictor (const arma::mat& param) const
 {
-  if (_sh_ptr_data->usesSparseMatrix()) {
+  if (_sh_ptr_data->usesChunks()) {
+    return _sh_ptr_data->linearPredictor(param);
+  } else if (_sh_ptr_data->usesSparseMatrix()) {
     return (param.t() * _sh_ptr_data->getSparseData()).t();
   } else  {
     return _sh_ptr_data->getDenseData() * param;
@@ -718,6 +818,14 @@ json BaselearnerTensorFactory::extractDataToJson (const bool save_source, const
   return j;
 }
 
+void BaselearnerTensorFactory::reportAttributesMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  // The marginal factories are reported as own components (if not already done
+  // because they are also registered):
+  _blearner1->reportMemory(report);
+  _blearner2->reportMemory(report);
+}
+
 
 // BaselearnerCenterFactory:
 // ------------------------------------------------
@@ -795,6 +903,11 @@ bool BaselearnerCenteredFactory::usesSparse () const
   return false;
 }
 
+bool BaselearnerCenteredFactory::supportsChunkedDesign () const
+{
+  return true;
+}
+
 sdata BaselearnerCenteredFactory::getInstantiatedData () const
 {
   return _sh_ptr_bindata;
@@ -840,6 +953,7 @@ std::string BaselearnerCenteredFactory::getFactoryId () const
 
 arma::mat BaselearnerCenteredFactory::calculateLinearPredictor (const arma::mat& param) const
 {
+  if (_sh_ptr_bindata->usesChunks()) return _sh_ptr_bindata->linearPredictor(param);
   return _sh_ptr_bindata->getDenseData() * param;
 }
 
@@ -933,6 +1047,13 @@ json BaselearnerCenteredFactory::extractDataToJson (const bool save_source, cons
   return j;
 }
 
+void BaselearnerCenteredFactory::reportAttributesMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  report.add(component, getFactoryId(), "rotation", memreport::matBytes(_attributes->rotation));
+  _blearner1->reportMemory(report);
+  _blearner2->reportMemory(report);
+}
+
 
 // BaselearnerCategoricalRidgeFactory:
 // -------------------------------------------
@@ -945,17 +1066,27 @@ BaselearnerCategoricalRidgeFactory::BaselearnerCategoricalRidgeFactory (const st
   _attributes->df      = df;
   _attributes->penalty = penalty;
 
-  auto          chr_classes = cdata_source->getRawData();
-  std::string   chr_class;
-  unsigned int  int_class;
-  for (unsigned int i = 0; i < chr_classes.size(); i++) {
-    chr_class = chr_classes.at(i);
-    auto it = _attributes->dictionary.find(chr_class);
-    // Add class into dictionary if not already there:
-    if (it == _attributes->dictionary.end()) {
-      int_class = _attributes->dictionary.size();
+  // Add each class into the dictionary if not already there. Codes are scanned for
+  // the first occurrence of each level, hence the classes get the same index:
+  auto addClass = [this] (const std::string& chr_class) {
+    if (_attributes->dictionary.find(chr_class) == _attributes->dictionary.end()) {
+      unsigned int int_class = _attributes->dictionary.size();
       _attributes->dictionary.insert(std::pair<std::string, unsigned int>(chr_class, int_class));
     }
+  };
+  if (cdata_source->usesCodes()) {
+    const std::vector<std::string> levels = cdata_source->getLevels();
+    std::vector<bool> is_seen(levels.size(), false);
+    for (unsigned int i = 0; i < cdata_source->getNObs(); i++) {
+      const unsigned int code = cdata_source->getCode(i);
+      if (! is_seen[code]) {
+        is_seen[code] = true;
+        addClass(levels[code]);
+      }
+    }
+  } else {
+    auto chr_classes = cdata_source->getRawData();
+    for (unsigned int i = 0; i < chr_classes.size(); i++) addClass(chr_classes.at(i));
   }
   _sh_ptr_data = init::initRidgeData(cdata_source, _attributes);
 
@@ -1099,6 +1230,17 @@ json BaselearnerCategoricalRidgeFactory::extractDataToJson (const bool save_sour
   return j;
 }
 
+void BaselearnerCategoricalRidgeFactory::reportAttributesMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  double dict_bytes = 0;
+  for (auto& it : _attributes->dictionary) {
+    // Node of the red-black tree (three pointer and color) plus key/value:
+    dict_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, unsigned int>) + memreport::stringBytes(it.first);
+  }
+  report.add(component, getFactoryId(), "penalty_mat", memreport::matBytes(_attributes->penalty_mat));
+  report.add(component, getFactoryId(), "dictionary",  dict_bytes);
+}
+
 
 // BaselearnerCategoricalBinary:
 // ----------------------------------
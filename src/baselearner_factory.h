@@ -99,12 +99,21 @@ public:
   virtual json toJson () const = 0;
   virtual json extractDataToJson (const bool, const bool = false) const = 0;
 
+  virtual void reportMemory           (memreport::MemoryReport&) const;
+  virtual void reportAttributesMemory (memreport::MemoryReport&, const std::string&) const;
+
   // Getter/Setter
   sdata                      getDataSource       () const;
   std::string                getBaselearnerType  () const;
 
   virtual std::vector<double> getMinMax        () const;
   virtual std::vector<sdata>  getVecDataSource () const;
+
+  // Design of a row shard, binned in the same way as the design of the factory:
+  virtual sdata instantiateShardData (const mdata&) const;
+
+  // Indicator whether `train()` and `predict()` of the base learners work on a streamed design:
+  virtual bool supportsChunkedDesign () const;
   virtual std::map<std::string, std::vector<std::string>> getValueNames () const;
 
   json dataSourceToJson (const bool = false) const;
@@ -130,13 +139,16 @@ private:
 
 public:
   BaselearnerPolynomialFactory (const std::string, std::shared_ptr<data::Data>,
-    const unsigned int, const bool, const unsigned int, const double = 0, const double = 0);
+    const unsigned int, const bool, const unsigned int, const double = 0, const double = 0,
+    const chunked::DesignBudget& = chunked::DesignBudget());
   BaselearnerPolynomialFactory (const json&, const mdata&, const mdata&);
 
   std::shared_ptr<init::PolynomialAttributes> _attributes = std::make_shared<init::PolynomialAttributes>();
 
   bool       usesSparse           ()                 const;
+  bool       supportsChunkedDesign ()                const;
   sdata      instantiateData      (const mdata&)     const;
+  sdata      instantiateShardData (const mdata&)     const;
 
   sdata       getInstantiatedData () const;
   arma::mat   getData             () const;
@@ -152,6 +164,7 @@ public:
   std::shared_ptr<blearner::Baselearner>  createBaselearner ();
   json toJson () const;
   json extractDataToJson (const bool, const bool = false) const;
+  void reportAttributesMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
@@ -166,13 +179,15 @@ private:
 public:
   BaselearnerPSplineFactory (const std::string, const std::shared_ptr<data::Data>&, const unsigned int,
     const unsigned int, const double, const double, const unsigned int, const bool, const unsigned int,
-    const std::string);
+    const std::string, const chunked::DesignBudget& = chunked::DesignBudget());
   BaselearnerPSplineFactory (const json&, const mdata&, const mdata&);
 
   std::shared_ptr<init::PSplineAttributes> _attributes = std::make_shared<init::PSplineAttributes>();
 
   bool       usesSparse           ()                 const;
+  bool       supportsChunkedDesign ()                const;
   sdata      instantiateData      (const mdata&)     const;
+  sdata      instantiateShardData (const mdata&)     const;
 
   sdata       getInstantiatedData () const;
   arma::mat   getData             () const;
@@ -188,6 +203,7 @@ public:
   std::shared_ptr<blearner::Baselearner>  createBaselearner ();
   json toJson () const;
   json extractDataToJson (const bool, const bool = false) const;
+  void reportAttributesMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
@@ -212,6 +228,7 @@ public:
   BaselearnerTensorFactory (const json&, const mdata&, const mdata&);
 
   bool       usesSparse           ()                 const;
+  bool       supportsChunkedDesign ()                const;
   sdata      instantiateData      (const mdata&)     const;
 
   sdata                    getInstantiatedData () const;
@@ -236,6 +253,7 @@ public:
 
   json toJson () const;
   json extractDataToJson (const bool, const bool = false) const;
+  void reportAttributesMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
@@ -259,6 +277,7 @@ public:
   std::shared_ptr<init::CenteredAttributes> _attributes = std::make_shared<init::CenteredAttributes>();
 
   bool       usesSparse           ()                 const;
+  bool       supportsChunkedDesign ()                const;
   sdata      instantiateData      (const mdata&)     const;
 
   sdata                    getInstantiatedData () const;
@@ -280,6 +299,7 @@ public:
   arma::mat getRotation () const;
   json toJson () const;
   json extractDataToJson (const bool, const bool = false) const;
+  void reportAttributesMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
@@ -320,6 +340,7 @@ public:
 
   json toJson () const;
   json extractDataToJson (const bool, const bool = false) const;
+  void reportAttributesMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
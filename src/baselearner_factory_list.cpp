@@ -20,6 +20,8 @@
 
 #include "baselearner_factory_list.h"
 
+#include <algorithm>
+
 namespace blearnerlist
 {
 
@@ -40,6 +42,7 @@ void BaselearnerFactoryList::registerBaselearnerFactory (const std::string facto
   } else {
     _factory_map[ factory_id ] = sh_ptr_blearner_factory;
   }
+  if (! _budget_dir.empty()) spillDesigns(_budget_dir, _budget);
 }
 
 void BaselearnerFactoryList::rmBaselearnerFactory (const std::string factory_id)
@@ -69,6 +72,105 @@ void BaselearnerFactoryList::printRegisteredFactories () const
   }
 }
 
+void BaselearnerFactoryList::reportMemory (memreport::MemoryReport& report) const
+{
+  for (auto& it : _factory_map) {
+    it.second->reportMemory(report);
+  }
+}
+
+/**
+ * \brief Stream designs from disk to keep the designs within a memory budget
+ *
+ * A quarter of the budget is reserved for the two buffered blocks of a
+ * streamed design (per thread), the rest for the designs that stay in memory.
+ * Binned designs and designs of base learners that need the full design
+ * (e.g. custom base learners) always stay in memory. Of the other designs,
+ * the smallest are kept in memory as long as they fit into the budget, all
+ * others are written into `dir` and streamed in blocks of rows.
+ *
+ * \param dir `std::string` Directory of the temporary design files.
+ * \param budget `double` Memory budget for the designs in bytes.
+ * \returns `std::vector<std::string>` Identifiers of the streamed factories.
+ */
+std::vector<std::string> BaselearnerFactoryList::spillDesigns (const std::string dir, const double budget)
+{
+  chunked::DesignBudget design_budget;
+  design_budget.dir          = dir;
+  design_budget.buffer_bytes = 0.25 * budget;
+
+  double resident  = 0;
+  double row_bytes = 0;
+  unsigned int nrows_max = 1;
+  std::vector<std::pair<double, std::string>> candidates;
+  for (auto& it : _factory_map) {
+    sdata sh_ptr_data = it.second->getInstantiatedData();
+    if ((sh_ptr_data == nullptr) || sh_ptr_data->usesChunks()) continue;
+
+    const double bytes = sh_ptr_data->getDesignBytes();
+    if (it.second->supportsChunkedDesign() && (! sh_ptr_data->usesBinning()) && (sh_ptr_data->getNDesignRows() > 0)) {
+      candidates.push_back(std::make_pair(bytes, it.first));
+      row_bytes = std::max(row_bytes, bytes / sh_ptr_data->getNDesignRows());
+      nrows_max = std::max(nrows_max, sh_ptr_data->getNDesignRows());
+    } else {
+      resident += bytes;
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+    [](const std::pair<double, std::string>& l, const std::pair<double, std::string>& r) { return l.first < r.first; });
+
+  const unsigned int block_rows = design_budget.blockRows(row_bytes, nrows_max);
+
+  std::vector<std::string> spilled;
+  for (auto& it : candidates) {
+    if (resident + it.first <= budget - design_budget.buffer_bytes) {
+      resident += it.first;
+      continue;
+    }
+    sdata sh_ptr_data = _factory_map[it.second]->getInstantiatedData();
+    sh_ptr_data->spillDesign(design_budget.filePath(it.second, sh_ptr_data.get()), block_rows);
+    spilled.push_back(it.second);
+  }
+  return spilled;
+}
+
+/**
+ * \brief Keep the designs of all factories within a memory budget
+ *
+ * The designs of the registered factories are spilled as by `spillDesigns()`.
+ * Factories that are instantiated afterwards get the remaining budget with
+ * `getDesignBudget()` and build designs that do not fit in blocks of rows
+ * directly on disk. Designs that are built from other designs (e.g. tensors)
+ * are spilled when they are registered.
+ *
+ * \param dir `std::string` Directory of the temporary design files.
+ * \param budget `double` Memory budget for the designs in bytes.
+ * \returns `std::vector<std::string>` Identifiers of the spilled factories.
+ */
+std::vector<std::string> BaselearnerFactoryList::setMemoryBudget (const std::string dir, const double budget)
+{
+  _budget_dir = dir;
+  _budget     = budget;
+  return spillDesigns(dir, budget);
+}
+
+/// Budget for the design of the next factory, nothing is streamed without a memory budget
+chunked::DesignBudget BaselearnerFactoryList::getDesignBudget () const
+{
+  chunked::DesignBudget design_budget;
+  if (_budget_dir.empty()) return design_budget;
+
+  double resident = 0;
+  for (auto& it : _factory_map) {
+    sdata sh_ptr_data = it.second->getInstantiatedData();
+    if ((sh_ptr_data != nullptr) && (! sh_ptr_data->usesChunks())) resident += sh_ptr_data->getDesignBytes();
+  }
+  design_budget.dir          = _budget_dir;
+  design_budget.buffer_bytes = 0.25 * _budget;
+  design_budget.free_bytes   = _budget - design_budget.buffer_bytes - resident;
+  return design_budget;
+}
+
 blearner_factory_map BaselearnerFactoryList::getFactoryMap () const
 {
   return _factory_map;
@@ -41,6 +41,10 @@ class BaselearnerFactoryList
 private:
   blearner_factory_map _factory_map;
 
+  // Memory budget of the designs, no budget without a directory:
+  std::string _budget_dir;
+  double      _budget = 0;
+
 public:
   BaselearnerFactoryList ();
   BaselearnerFactoryList (const json&, const mdata&, const mdata&);
@@ -56,6 +60,11 @@ public:
   void rmBaselearnerFactory       (const std::string);
   void printRegisteredFactories   () const;
   void clearMap                   ();
+  void reportMemory               (memreport::MemoryReport&) const;
+
+  std::vector<std::string> spillDesigns    (const std::string, const double);
+  std::vector<std::string> setMemoryBudget (const std::string, const double);
+  chunked::DesignBudget    getDesignBudget () const;
 
   json toJson () const;
   json factoryDataToJson (const bool = false, const bool = false) const;
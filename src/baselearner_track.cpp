@@ -23,15 +23,6 @@
 namespace blearnertrack
 {
 
-json blVecToJson (const std::vector<std::shared_ptr<blearner::Baselearner>>& blv)
-{
-  json j;
-  for (auto& it : blv) {
-    j.push_back(it->toJson());
-  }
-  return j;
-}
-
 std::vector<std::shared_ptr<blearner::Baselearner>> jsonToBlVec (const json& j, const mdata& mdat)
 {
   std::vector<std::shared_ptr<blearner::Baselearner>> blv;
@@ -51,107 +42,325 @@ BaselearnerTrack::BaselearnerTrack (const double learning_rate)
 
 BaselearnerTrack::BaselearnerTrack (const json& j, const mdata& mdat)
   : _learning_rate   ( j["_learning_rate"].get<double>() ),
-    _blearner_vector ( jsonToBlVec(j["_blearner_vector"], mdat) ),
-    _parameter_map   ( saver::jsonToMapMat(j["_parameter_map"]) ),
-    _step_sizes      ( j["_step_sizes"].get<std::vector<double>>() )
-{ }
+    _parameter_map   ( saver::jsonToMapMat(j["_parameter_map"]) )
+{
+  std::vector<double> step_sizes = j["_step_sizes"].get<std::vector<double>>();
+
+  if (j.contains("_blearner_vector")) {
+    // Models saved before the compact track was introduced store the full
+    // base learner objects. Copy their parameter into the arena:
+    auto blv = jsonToBlVec(j["_blearner_vector"], mdat);
+    for (unsigned int i = 0; i < blv.size(); i++) {
+      appendIteration(blv[i]->getDataIdentifier() + "_" + blv[i]->getBaselearnerType(),
+        blv[i]->getParameter(), step_sizes.at(i));
+      _iteration_end.push_back(_iter_factory.size());
+    }
+  } else {
+    auto factory_ids  = j["_factory_ids"].get<std::vector<std::string>>();
+    auto factory_dims = j["_factory_dims"].get<std::vector<std::pair<arma::uword, arma::uword>>>();
+    for (unsigned int i = 0; i < factory_ids.size(); i++) {
+      registerFactory(factory_ids[i], factory_dims[i].first, factory_dims[i].second);
+    }
+    _iter_factory = j["_iter_factory"].get<std::vector<unsigned int>>();
+    _param_arena  = j["_param_arena"].get<std::vector<double>>();
+    _step_sizes   = step_sizes;
+
+    // The offsets are not stored since they are fully defined by the
+    // parameter dimension of the selected factories:
+    arma::uword offset = 0;
+    _iter_offset.reserve(_iter_factory.size());
+    for (auto& it : _iter_factory) {
+      _iter_offset.push_back(offset);
+      offset += _factory_dims.at(it).first * _factory_dims.at(it).second;
+    }
+    if (offset != _param_arena.size()) {
+      Rcpp::stop("Parameter arena of the base learner track does not match the selected base learners.");
+    }
+    // Tracks without block updates have exactly one entry per iteration:
+    if (j.contains("_iteration_end")) {
+      _iteration_end = j["_iteration_end"].get<std::vector<unsigned int>>();
+    } else {
+      for (unsigned int i = 1; i <= _iter_factory.size(); i++) _iteration_end.push_back(i);
+    }
+    for (unsigned int i = 0; i < _iteration_end.size(); i++) {
+      if ((_iteration_end[i] <= (i > 0 ? _iteration_end[i - 1] : 0)) || (_iteration_end[i] > _iter_factory.size())) {
+        Rcpp::stop("Iteration index of the base learner track is not increasing.");
+      }
+    }
+    if ((_iteration_end.empty() ? 0 : _iteration_end.back()) != _iter_factory.size()) {
+      Rcpp::stop("Iteration index of the base learner track does not match the selected base learners.");
+    }
+    rebuildCheckpoints();
+  }
+}
+
+/**
+ * \brief Get the index of a factory in the factory table and add it if it is new
+ */
+unsigned int BaselearnerTrack::registerFactory (const std::string& factory_id, const arma::uword n_rows, const arma::uword n_cols)
+{
+  auto it = _factory_index.find(factory_id);
+  if (it != _factory_index.end()) {
+    return it->second;
+  }
+  unsigned int idx = _factory_ids.size();
+  _factory_ids.push_back(factory_id);
+  _factory_dims.push_back(std::make_pair(n_rows, n_cols));
+  _factory_index[ factory_id ] = idx;
 
-std::vector<std::shared_ptr<blearner::Baselearner>> BaselearnerTrack::getBaselearnerVector () const
+  return idx;
+}
+
+/**
+ * \brief Append factory index, parameter offset, and step size of one iteration
+ *
+ * The parameter is copied unscaled (column major) to the end of the arena.
+ */
+void BaselearnerTrack::appendIteration (const std::string& factory_id, const arma::mat& parameter, const double step_size)
 {
-  return _blearner_vector;
+  unsigned int idx = registerFactory(factory_id, parameter.n_rows, parameter.n_cols);
+  if ((_factory_dims[idx].first != parameter.n_rows) || (_factory_dims[idx].second != parameter.n_cols)) {
+    Rcpp::stop("Dimension of the parameter of " + factory_id + " changed during training.");
+  }
+  _iter_factory.push_back(idx);
+  _iter_offset.push_back(_param_arena.size());
+  _param_arena.insert(_param_arena.end(), parameter.begin(), parameter.end());
+  _step_sizes.push_back(step_size);
+
+  updateCheckpoints(_iter_factory.size() - 1);
 }
 
-std::map<std::string, arma::mat> BaselearnerTrack::getParameterMap () const
+/**
+ * \brief Add iteration `i` to the running aggregate and write a checkpoint if due
+ *
+ * The running aggregate stores the pruned parameter of all factories in the
+ * order of the factory table. Since factories are registered when they are
+ * selected the first time, a checkpoint just needs the prefix of the factories
+ * known at that iteration.
+ */
+void BaselearnerTrack::updateCheckpoints (const unsigned int i)
 {
-  return _parameter_map;
+  unsigned int idx = _iter_factory[i];
+  while (_factory_aggr_offset.size() <= idx) {
+    auto dims = _factory_dims[ _factory_aggr_offset.size() ];
+    _factory_aggr_offset.push_back(_running_aggr.size());
+    _running_aggr.resize(_running_aggr.size() + dims.first * dims.second, 0);
+  }
+  arma::uword n_elem = _factory_dims[idx].first * _factory_dims[idx].second;
+  double      weight = _learning_rate * _step_sizes[i];
+  double*       aggr = _running_aggr.data() + _factory_aggr_offset[idx];
+  const double* par  = _param_arena.data() + _iter_offset[i];
+  for (arma::uword l = 0; l < n_elem; l++) {
+    aggr[l] += weight * par[l];
+  }
+
+  if ((i + 1) % _checkpoint_interval == 0) {
+    _checkpoint_nfactories.push_back(_factory_aggr_offset.size());
+    _checkpoint_offset.push_back(_checkpoint_arena.size());
+    _checkpoint_arena.insert(_checkpoint_arena.end(), _running_aggr.begin(), _running_aggr.end());
+  }
 }
 
-std::map<std::string, arma::mat> BaselearnerTrack::getEstimatedParameterOfIteration (const unsigned int& k) const
+void BaselearnerTrack::rebuildCheckpoints ()
 {
-  if (k > _blearner_vector.size()) {
-    Rcpp::stop ("You can't get parameter of a state higher then the maximal iterations.");
+  _factory_aggr_offset.clear();
+  _running_aggr.clear();
+  _checkpoint_nfactories.clear();
+  _checkpoint_offset.clear();
+  _checkpoint_arena.clear();
+
+  for (unsigned int i = 0; i < _iter_factory.size(); i++) {
+    updateCheckpoints(i);
   }
+}
 
-  // Create new parameter map:
-  std::map<std::string, arma::mat> new_parameter_map;
+unsigned int BaselearnerTrack::getNumberOfIterations () const
+{
+  return _iteration_end.size();
+}
 
-  if (k <= _blearner_vector.size()) {
+unsigned int BaselearnerTrack::getNumberOfEntries () const
+{
+  return _iter_factory.size();
+}
 
-    for (unsigned int i = 0; i < k; i++) {
-      std::string insert_id = _blearner_vector[i]->getDataIdentifier() + "_" + _blearner_vector[i]->getBaselearnerType();
+/**
+ * \brief Number of entries (inserted base learners) after `k` iterations
+ */
+unsigned int BaselearnerTrack::getEntriesOfIteration (const unsigned int k) const
+{
+  if (k == 0) return 0;
+  return _iteration_end.at(k - 1);
+}
 
-      // Check if the baselearner is the first one. If so, the parameter
-      // has to be instantiated with a zero matrix:
-      std::map<std::string, arma::mat>::iterator it = new_parameter_map.find(insert_id);
+/**
+ * \brief First and one past the last entry of iteration `i` (counting from 0)
+ *
+ * The entry based getters below (`getFactoryIdOfIteration`, ...) take the entry
+ * index which is the iteration index if no block updates are used.
+ */
+std::pair<unsigned int, unsigned int> BaselearnerTrack::getEntryRangeOfIteration (const unsigned int i) const
+{
+  return std::make_pair(getEntriesOfIteration(i), _iteration_end.at(i));
+}
 
-      // Prune parameter by multiplying it with the learning rate:
-      arma::mat parameter_temp = _learning_rate * _step_sizes[i] * _blearner_vector[i]->getParameter();
+std::string BaselearnerTrack::getFactoryIdOfIteration (const unsigned int i) const
+{
+  return _factory_ids[ _iter_factory.at(i) ];
+}
 
-      // Check if this is the first parameter entry:
-      if (it == new_parameter_map.end()) {
-        // If this is the first entry, initialize it with zeros:
-        arma::mat init_parameter(parameter_temp.n_rows, parameter_temp.n_cols, arma::fill::zeros);
-        new_parameter_map.insert(std::pair<std::string, arma::mat>(insert_id, init_parameter));
-      }
-      // Accumulating parameter. If there is a nan, then this will be ignored and
-      // the non  nan entries are summed up:
-      new_parameter_map[ insert_id ] = parameter_temp + new_parameter_map.find(insert_id)->second;
-    }
-  }
-  return new_parameter_map;
+unsigned int BaselearnerTrack::getFactoryIndexOfIteration (const unsigned int i) const
+{
+  return _iter_factory.at(i);
 }
 
-std::pair<std::vector<std::string>, arma::mat> BaselearnerTrack::getParameterMatrix () const
+std::vector<std::string> BaselearnerTrack::getFactoryTable () const
 {
-  auto         new_parameter_map = _parameter_map;
-  unsigned int cols = 0;
+  return _factory_ids;
+}
 
-  // Set all parameter to zero in new map:
-  for (auto& it : new_parameter_map) {
-    arma::mat init_parameter (it.second.n_rows, it.second.n_cols, arma::fill::zeros);
-    new_parameter_map[ it.first ] = init_parameter;
+arma::mat BaselearnerTrack::getParameterOfIteration (const unsigned int i) const
+{
+  auto dims = _factory_dims[ _iter_factory.at(i) ];
+  return arma::mat(_param_arena.data() + _iter_offset[i], dims.first, dims.second);
+}
+
+double BaselearnerTrack::getStepSizeOfIteration (const unsigned int i) const
+{
+  return _step_sizes.at(i);
+}
 
-    // Note that parameter are stored as col vectors but in the matrix we want
-    // them as row vectors. Therefore we have to use rows to count the columns
-    // of the paraemter matrix.
-    cols += it.second.n_rows;
+std::vector<std::string> BaselearnerTrack::getSelectedFactoryIds () const
+{
+  std::vector<std::string> out;
+  out.reserve(_iter_factory.size());
+  for (auto& it : _iter_factory) {
+    out.push_back(_factory_ids[it]);
   }
+  return out;
+}
 
-  // Initialize matrix:
-  arma::mat parameters (_blearner_vector.size(), cols, arma::fill::zeros);
+std::shared_ptr<blearner::Baselearner> BaselearnerTrack::getLastBaselearner () const
+{
+  if (_sh_ptr_last_blearner == nullptr) {
+    Rcpp::stop("No base learner was inserted into the track in this session.");
+  }
+  return _sh_ptr_last_blearner;
+}
 
-  for (unsigned int i = 0; i < _blearner_vector.size(); i++) {
-    std::string insert_id = _blearner_vector[i]->getDataIdentifier() + "_" + _blearner_vector[i]->getBaselearnerType();
+/**
+ * \brief All base learners inserted in the last iteration (the block of a block update)
+ */
+std::vector<std::shared_ptr<blearner::Baselearner>> BaselearnerTrack::getBaselearnersOfLastIteration () const
+{
+  if (_last_iteration_blearners.empty()) {
+    Rcpp::stop("No base learner was inserted into the track in this session.");
+  }
+  return _last_iteration_blearners;
+}
 
-    // Prune parameter by multiplying it with the learning rate:
-    arma::mat parameter_temp = _learning_rate * _step_sizes.at(i) * _blearner_vector[i]->getParameter();
+std::map<std::string, arma::mat> BaselearnerTrack::getParameterMap () const
+{
+  return _parameter_map;
+}
 
-    // Accumulating parameter. If there is a nan, then this will be ignored and
-    // the non  nan entries are summed up:
-    new_parameter_map[ insert_id ] = parameter_temp + new_parameter_map.find(insert_id)->second;
+std::map<std::string, arma::mat> BaselearnerTrack::getEstimatedParameterOfIteration (const unsigned int& k) const
+{
+  if (k > _iteration_end.size()) {
+    Rcpp::stop ("You can't get parameter of a state higher then the maximal iterations.");
+  }
+  // Checkpoints are written every `_checkpoint_interval` entries:
+  const unsigned int n_entries = getEntriesOfIteration(k);
+
+  // Accumulate the parameter per factory first and create the map afterwards
+  // to avoid a map lookup per iteration. The accumulation starts at the
+  // nearest checkpoint:
+  std::vector<arma::mat> aggr(_factory_ids.size());
+  unsigned int n_checkpoints = std::min<unsigned int>(n_entries / _checkpoint_interval, _checkpoint_nfactories.size());
+  unsigned int start = 0;
+  if (n_checkpoints > 0) {
+    const double* checkpoint = _checkpoint_arena.data() + _checkpoint_offset[n_checkpoints - 1];
+    for (unsigned int idx = 0; idx < _checkpoint_nfactories[n_checkpoints - 1]; idx++) {
+      aggr[idx] = arma::mat(checkpoint + _factory_aggr_offset[idx], _factory_dims[idx].first, _factory_dims[idx].second);
+    }
+    start = n_checkpoints * _checkpoint_interval;
+  }
+  for (unsigned int i = start; i < n_entries; i++) {
+    unsigned int idx = _iter_factory[i];
+    if (aggr[idx].is_empty()) {
+      aggr[idx].zeros(_factory_dims[idx].first, _factory_dims[idx].second);
+    }
+    arma::mat parameter_temp(_param_arena.data() + _iter_offset[i], aggr[idx].n_rows, aggr[idx].n_cols);
+    aggr[idx] += _learning_rate * _step_sizes[i] * parameter_temp;
+  }
 
-    arma::mat param_insert;
+  std::map<std::string, arma::mat> new_parameter_map;
+  for (unsigned int idx = 0; idx < aggr.size(); idx++) {
+    if (! aggr[idx].is_empty()) {
+      new_parameter_map[ _factory_ids[idx] ] = aggr[idx];
+    }
+  }
+  return new_parameter_map;
+}
 
-    // Join columns to one huge column vector:
-    for (auto& it : new_parameter_map) {
-      param_insert = arma::join_cols(param_insert, it.second);
+// Names of the (column-major) elements of a parameter, with one suffix per
+// parameter row and, for more than one column (e.g. classes), per column:
+static std::vector<std::string> parameterNames (const std::string& id, const arma::uword n_rows, const arma::uword n_cols)
+{
+  std::vector<std::string> names;
+  for (arma::uword k = 0; k < n_cols; k++) {
+    for (arma::uword r = 0; r < n_rows; r++) {
+      std::string name = id;
+      if (n_rows > 1) name += "_x" + std::to_string(r + 1);
+      if (n_cols > 1) name += "_c" + std::to_string(k + 1);
+      names.push_back(name);
     }
-    // Insert this huge vector at row i, therefore transpose it:
-    parameters.row(i) = param_insert.t();
+  }
+  return names;
+}
+
+std::pair<std::vector<std::string>, arma::mat> BaselearnerTrack::getParameterMatrix () const
+{
+  // The columns of the matrix are the parameter of all ids of the parameter map
+  // and of all selected factories, ordered by id. A parameter with more than one
+  // column (one per class) takes the columns of its vectorized parameter:
+  std::map<std::string, std::pair<arma::uword, arma::uword>> dims;
+  for (auto& it : _parameter_map) {
+    dims[ it.first ] = std::make_pair(it.second.n_rows, it.second.n_cols);
+  }
+  for (unsigned int idx = 0; idx < _factory_ids.size(); idx++) {
+    dims[ _factory_ids[idx] ] = _factory_dims[idx];
   }
   std::pair<std::vector<std::string>, arma::mat> out_pair;
+  std::map<std::string, arma::uword> col_offsets;
+  arma::uword cols = 0;
+  for (auto& it : dims) {
+    std::vector<std::string> names = parameterNames(it.first, it.second.first, it.second.second);
+    out_pair.first.insert(out_pair.first.end(), names.begin(), names.end());
+
+    col_offsets[ it.first ] = cols;
+    cols += names.size();
+  }
+  std::vector<arma::uword> factory_cols;
+  for (auto& it : _factory_ids) {
+    factory_cols.push_back(col_offsets[it]);
+  }
 
-  // If a base-learner has more than one parameter, than we rename the parameter
-  // with a corresponding number (Note: In new_parameter_map is a list
-  // containing the last state of the parameter, that means a map with an
-  // identifier string and parameter matrix):
-  for (auto& it : new_parameter_map) {
-    if (it.second.n_rows > 1) {
-      for (unsigned int i = 0; i < it.second.n_rows; i++) {
-        out_pair.first.push_back(it.first + "_x" + std::to_string(i + 1));
+  // Each row is the previous row plus the update of the iteration. Note that
+  // parameter are stored as col vectors but in the matrix we want them as
+  // row vectors:
+  arma::mat parameters (_iteration_end.size(), cols, arma::fill::zeros);
+  for (unsigned int i = 0; i < _iteration_end.size(); i++) {
+    if (i > 0) parameters.row(i) = parameters.row(i - 1);
+
+    auto entries = getEntryRangeOfIteration(i);
+    for (unsigned int e = entries.first; e < entries.second; e++) {
+      unsigned int idx    = _iter_factory[e];
+      arma::uword  n_elem = _factory_dims[idx].first * _factory_dims[idx].second;
+      double       lr     = _learning_rate * _step_sizes[e];
+      for (arma::uword l = 0; l < n_elem; l++) {
+        parameters(i, factory_cols[idx] + l) += lr * _param_arena[_iter_offset[e] + l];
       }
-    } else {
-      out_pair.first.push_back(it.first);
     }
   }
   out_pair.second = parameters;
@@ -159,25 +368,204 @@ std::pair<std::vector<std::string>, arma::mat> BaselearnerTrack::getParameterMat
   return out_pair;
 }
 
+double BaselearnerTrack::getLearningRate () const
+{
+  return _learning_rate;
+}
+
+unsigned int BaselearnerTrack::getCheckpointInterval () const
+{
+  return _checkpoint_interval;
+}
+
+/**
+ * \brief Column of the first parameter of each factory in the path
+ *
+ * The path contains the factories in the given order. If no factory is given,
+ * all selected factories are used ordered by id. Factories that are not part of
+ * the path get the column -1. The number of columns is returned by reference.
+ */
+std::vector<long int> BaselearnerTrack::pathColumns (const std::vector<std::string>& factory_ids, arma::uword& n_cols) const
+{
+  std::vector<std::string> ids = factory_ids;
+  if (ids.size() == 0) {
+    std::map<std::string, unsigned int> sorted_ids(_factory_index.begin(), _factory_index.end());
+    for (auto& it : sorted_ids) ids.push_back(it.first);
+  }
+  std::vector<long int> cols(_factory_ids.size(), -1);
+  n_cols = 0;
+  for (auto& id : ids) {
+    auto it = _factory_index.find(id);
+    if (it == _factory_index.end()) {
+      Rcpp::stop("Factory " + id + " was not selected and has no coefficient path.");
+    }
+    if (cols[it->second] >= 0) {
+      Rcpp::stop("Factory " + id + " is requested more than once.");
+    }
+    cols[it->second] = n_cols;
+    n_cols += _factory_dims[it->second].first * _factory_dims[it->second].second;
+  }
+  return cols;
+}
+
+std::vector<std::string> BaselearnerTrack::getParameterPathNames (const std::vector<std::string>& factory_ids) const
+{
+  arma::uword n_cols;
+  std::vector<long int> cols = pathColumns(factory_ids, n_cols);
+
+  std::vector<std::string> names(n_cols);
+  for (unsigned int idx = 0; idx < cols.size(); idx++) {
+    if (cols[idx] < 0) continue;
+    std::vector<std::string> idx_names = parameterNames(_factory_ids[idx], _factory_dims[idx].first, _factory_dims[idx].second);
+    std::copy(idx_names.begin(), idx_names.end(), names.begin() + cols[idx]);
+  }
+  return names;
+}
+
+/**
+ * \brief Fill the coefficient path of iterations `from` to `to` into a buffer
+ *
+ * Row `r` of the buffer gets the (pruned) parameter after iteration `from + r`.
+ * The buffer must be preallocated with at least `to - from + 1` rows and as
+ * many columns as `getParameterPathNames` returns. The start state is taken
+ * from the nearest checkpoint, afterwards each row is the previous one plus the
+ * update of the iteration if the selected factory is part of the path. Hence,
+ * the costs are linear in the number of rows times the number of columns.
+ */
+void BaselearnerTrack::fillParameterPath (const std::vector<std::string>& factory_ids, const unsigned int from,
+  const unsigned int to, arma::mat& buffer) const
+{
+  if ((from < 1) || (from > to) || (to > _iteration_end.size())) {
+    Rcpp::stop("Iterations of the coefficient path must satisfy 1 <= from <= to <= " + std::to_string(_iteration_end.size()) + ".");
+  }
+  arma::uword n_cols;
+  std::vector<long int> cols = pathColumns(factory_ids, n_cols);
+  if ((buffer.n_rows < to - from + 1) || (buffer.n_cols != n_cols)) {
+    Rcpp::stop("Buffer of dimension " + std::to_string(buffer.n_rows) + "x" + std::to_string(buffer.n_cols)
+      + " cannot hold " + std::to_string(to - from + 1) + " iterations of " + std::to_string(n_cols) + " parameter.");
+  }
+
+  // State after iteration `from - 1`:
+  arma::rowvec state(n_cols, arma::fill::zeros);
+  auto pmap_start = getEstimatedParameterOfIteration(from - 1);
+  for (auto& it : pmap_start) {
+    unsigned int idx = _factory_index.find(it.first)->second;
+    if (cols[idx] < 0) continue;
+    for (arma::uword l = 0; l < it.second.n_elem; l++) {
+      state(cols[idx] + l) = it.second(l);
+    }
+  }
+
+  for (unsigned int i = from - 1; i < to; i++) {
+    auto entries = getEntryRangeOfIteration(i);
+    for (unsigned int e = entries.first; e < entries.second; e++) {
+      unsigned int idx = _iter_factory[e];
+      if (cols[idx] < 0) continue;
+
+      arma::uword n_elem = _factory_dims[idx].first * _factory_dims[idx].second;
+      double      weight = _learning_rate * _step_sizes[e];
+      for (arma::uword l = 0; l < n_elem; l++) {
+        state(cols[idx] + l) += weight * _param_arena[_iter_offset[e] + l];
+      }
+    }
+    buffer.row(i - from + 1) = state;
+  }
+}
+
+/**
+ * \brief Stream the coefficient path into a csv file
+ *
+ * The path is calculated in chunks of `chunk_size` rows that are appended to the
+ * file. Hence, at most one chunk is kept in memory.
+ */
+void BaselearnerTrack::writeParameterPath (const std::string& file, const std::vector<std::string>& factory_ids,
+  const unsigned int from, const unsigned int to, const unsigned int chunk_size) const
+{
+  if (chunk_size == 0) {
+    Rcpp::stop("The chunk size must be greater than zero.");
+  }
+  if ((from < 1) || (from > to) || (to > _iteration_end.size())) {
+    Rcpp::stop("Iterations of the coefficient path must satisfy 1 <= from <= to <= " + std::to_string(_iteration_end.size()) + ".");
+  }
+  std::vector<std::string> names = getParameterPathNames(factory_ids);
+
+  std::ofstream out(file);
+  if (! out.is_open()) {
+    Rcpp::stop("Cannot open file " + file + ".");
+  }
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+  out << "iteration";
+  for (auto& it : names) out << "," << it;
+  out << "\n";
+
+  arma::mat buffer(std::min(chunk_size, to - from + 1), names.size());
+  for (unsigned int chunk_from = from; chunk_from <= to; chunk_from += chunk_size) {
+    unsigned int chunk_to = std::min(to, chunk_from + chunk_size - 1);
+    fillParameterPath(factory_ids, chunk_from, chunk_to, buffer);
+    for (unsigned int r = 0; r <= chunk_to - chunk_from; r++) {
+      out << chunk_from + r;
+      for (arma::uword c = 0; c < buffer.n_cols; c++) out << "," << buffer(r, c);
+      out << "\n";
+    }
+  }
+}
+
 void BaselearnerTrack::setParameterMap (std::map<std::string, arma::mat> new_parameter_map)
 {
   _parameter_map = new_parameter_map;
 }
 
+void BaselearnerTrack::setCheckpointInterval (const unsigned int checkpoint_interval)
+{
+  if (checkpoint_interval == 0) {
+    Rcpp::stop("The checkpoint interval must be greater than zero.");
+  }
+  _checkpoint_interval = checkpoint_interval;
+  rebuildCheckpoints();
+}
+
 
+/**
+ * \brief Insert one base learner as new iteration
+ */
 void BaselearnerTrack::insertBaselearner (std::shared_ptr<blearner::Baselearner> sh_ptr_blearner, const double& step_size)
 {
-  _blearner_vector.push_back(sh_ptr_blearner);
-  _step_sizes.push_back(step_size);
+  appendBaselearner(sh_ptr_blearner, step_size);
+  _iteration_end.push_back(_iter_factory.size());
+  _last_iteration_blearners = { sh_ptr_blearner };
+}
+
+/**
+ * \brief Insert all base learners of a block update as one iteration
+ *
+ * The last base learner of the block is kept as last base learner.
+ */
+void BaselearnerTrack::insertBaselearnerBlock (const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double& step_size)
+{
+  if (blearners.size() == 0) {
+    Rcpp::stop("Cannot insert an empty block of base learners.");
+  }
+  for (auto& it : blearners) {
+    appendBaselearner(it, step_size);
+  }
+  _iteration_end.push_back(_iter_factory.size());
+  _last_iteration_blearners = blearners;
+}
 
+void BaselearnerTrack::appendBaselearner (std::shared_ptr<blearner::Baselearner> sh_ptr_blearner, const double step_size)
+{
   std::string insert_id = sh_ptr_blearner->getDataIdentifier() + "_" + sh_ptr_blearner->getBaselearnerType();
 
+  arma::mat parameter = sh_ptr_blearner->getParameter();
+  appendIteration(insert_id, parameter, step_size);
+  _sh_ptr_last_blearner = sh_ptr_blearner;
+
   // Check if the baselearner is the first one. If so, the parameter
   // has to be instantiated with a zero matrix:
   std::map<std::string, arma::mat>::iterator it = _parameter_map.find(insert_id);
 
   // Prune parameter by multiplying it with the learning rate:
-  arma::mat parameter_temp = _learning_rate * step_size * sh_ptr_blearner->getParameter();
+  arma::mat parameter_temp = _learning_rate * step_size * parameter;
 
   // Check if this is the first parameter entry:
   if (it == _parameter_map.end()) {
@@ -193,12 +581,25 @@ void BaselearnerTrack::insertBaselearner (std::shared_ptr<blearner::Baselearner>
 
 void BaselearnerTrack::clearBaselearnerVector ()
 {
-  _blearner_vector.clear();
+  _iter_factory.clear();
+  _iter_offset.clear();
+  _param_arena.clear();
+  _step_sizes.clear();
+  _iteration_end.clear();
+  _sh_ptr_last_blearner = nullptr;
+  _last_iteration_blearners.clear();
+
+  // Without iterations the factory table is empty, too. This keeps the table
+  // in the order in which the factories are selected:
+  _factory_ids.clear();
+  _factory_dims.clear();
+  _factory_index.clear();
+  rebuildCheckpoints();
 }
 
 void BaselearnerTrack::setToIteration (const unsigned int& k)
 {
-  if (k > _blearner_vector.size()) {
+  if (k > _iteration_end.size()) {
     Rcpp::stop ("You can't set the crrent iteration higher then the maximal trained iterations.");
   }
   _parameter_map = getEstimatedParameterOfIteration(k);
@@ -209,14 +610,54 @@ json BaselearnerTrack::toJson () const
   json j = {
     {"Class",          "BaselearnerTrack"},
     {"_learning_rate", _learning_rate},
-    {"_step_sizes",    _step_sizes}
+    {"_step_sizes",    _step_sizes},
+    {"_factory_ids",   _factory_ids},
+    {"_factory_dims",  _factory_dims},
+    {"_iter_factory",  _iter_factory},
+    {"_iteration_end", _iteration_end},
+    {"_param_arena",   _param_arena}
   };
-  j["_blearner_vector"] = blVecToJson(_blearner_vector);
   j["_parameter_map"] = saver::mapMatToJson(_parameter_map);
 
   return j;
 }
 
+/**
+ * \brief Add the heap memory of the track to the report
+ *
+ * The iteration index (factory index and arena offset) and the step sizes grow
+ * by a few bytes per iteration, the parameter arena by the parameter size of
+ * the selected factory. The last base learner is shared with the optimizer.
+ */
+void BaselearnerTrack::reportMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  if (! report.visit(this)) return;
+
+  double table_bytes = memreport::stringVecBytes(_factory_ids) + memreport::stdVecBytes(_factory_dims);
+  for (auto& it : _factory_index) {
+    table_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, unsigned int>) + memreport::stringBytes(it.first);
+  }
+  double pmap_bytes = 0;
+  for (auto& it : _parameter_map) {
+    pmap_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, arma::mat>)
+      + memreport::stringBytes(it.first) + memreport::matBytes(it.second);
+  }
+  // The last base learner is part of the base learners of the last iteration:
+  double last_bytes = 0;
+  for (auto& it : _last_iteration_blearners) last_bytes += it->getMemoryBytes();
+
+  report.add(component, "BaselearnerTrack", "factory_table",     table_bytes);
+  report.add(component, "BaselearnerTrack", "iteration_index",   memreport::stdVecBytes(_iter_factory) + memreport::stdVecBytes(_iter_offset)
+    + memreport::stdVecBytes(_iteration_end));
+  report.add(component, "BaselearnerTrack", "parameter_arena",   memreport::stdVecBytes(_param_arena));
+  report.add(component, "BaselearnerTrack", "last_baselearner",  last_bytes);
+  report.add(component, "BaselearnerTrack", "parameter_map",     pmap_bytes);
+  report.add(component, "BaselearnerTrack", "step_sizes",        memreport::stdVecBytes(_step_sizes));
+  report.add(component, "BaselearnerTrack", "checkpoints",       memreport::stdVecBytes(_checkpoint_arena)
+    + memreport::stdVecBytes(_checkpoint_offset) + memreport::stdVecBytes(_checkpoint_nfactories)
+    + memreport::stdVecBytes(_running_aggr) + memreport::stdVecBytes(_factory_aggr_offset));
+}
+
 BaselearnerTrack::~BaselearnerTrack ()
 {
   clearBaselearnerVector();
@@ -21,6 +21,10 @@
 #ifndef BASELEARNERTACK_H_
 #define BASELEARNERTACK_H_
 
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
 #include "baselearner.h"
 #include "baselearner_factory_list.h"
 
@@ -34,17 +38,61 @@ typedef std::shared_ptr<data::Data> sdata;
 typedef std::shared_ptr<data::BinnedData> sbindata;
 typedef std::map<std::string, sdata> mdata;
 
-// FOR SAVING AND LOADING JSON:
-json blVecToJson  (const std::vector<std::shared_ptr<blearner::Baselearner>>&);
+// FOR LOADING THE LEGACY JSON FORMAT:
 std::vector<std::shared_ptr<blearner::Baselearner>> jsonToBlVec (const json&, const mdata&);
 
+/**
+ * \brief Compact track of the selected base learners
+ *
+ * Instead of keeping one base learner object per iteration, the track is stored
+ * as struct of arrays. Each iteration is described by the index of the selected
+ * factory (into `_factory_ids`), the offset of its parameter into one contiguous
+ * parameter arena, and the step size. The parameter dimension is fixed per
+ * factory and therefore stored just once in `_factory_dims`.
+ *
+ * Only the most recently inserted base learner is kept as object since the
+ * logger and the out of bag update of the AGBM need it within the same iteration.
+ *
+ * Block updates insert more than one base learner per iteration. Therefore, the
+ * arrays above are indexed by entries and `_iteration_end` stores the cumulative
+ * number of entries after each iteration. Without block updates, entries and
+ * iterations are the same.
+ *
+ * Every `_checkpoint_interval` iterations the aggregated (pruned) parameter of
+ * all factories selected so far is copied into the checkpoint arena. The
+ * parameter of an arbitrary iteration is then reconstructed from the nearest
+ * checkpoint plus at most `_checkpoint_interval` deltas. Checkpoints are not
+ * serialized, they are rebuilt when loading the track.
+ */
 class BaselearnerTrack
 {
 private:
-  double                                               _learning_rate = 1;
-  std::vector<std::shared_ptr<blearner::Baselearner>>  _blearner_vector;
-  std::map<std::string, arma::mat>                     _parameter_map;
-  std::vector<double>                                  _step_sizes;
+  double                                            _learning_rate = 1;
+  std::vector<std::string>                          _factory_ids;
+  std::vector<std::pair<arma::uword, arma::uword>>  _factory_dims;
+  std::map<std::string, unsigned int>               _factory_index;
+  std::vector<unsigned int>                         _iter_factory;
+  std::vector<arma::uword>                          _iter_offset;
+  std::vector<double>                               _param_arena;
+  std::vector<double>                               _step_sizes;
+  std::vector<unsigned int>                         _iteration_end;
+  std::map<std::string, arma::mat>                  _parameter_map;
+  std::shared_ptr<blearner::Baselearner>            _sh_ptr_last_blearner;
+  std::vector<std::shared_ptr<blearner::Baselearner>> _last_iteration_blearners;
+
+  unsigned int                                      _checkpoint_interval = 500;
+  std::vector<arma::uword>                          _factory_aggr_offset;
+  std::vector<double>                               _running_aggr;
+  std::vector<unsigned int>                         _checkpoint_nfactories;
+  std::vector<arma::uword>                          _checkpoint_offset;
+  std::vector<double>                               _checkpoint_arena;
+
+  unsigned int registerFactory    (const std::string&, const arma::uword, const arma::uword);
+  void         appendIteration    (const std::string&, const arma::mat&, const double);
+  void         appendBaselearner  (std::shared_ptr<blearner::Baselearner>, const double);
+  void         updateCheckpoints  (const unsigned int);
+  void         rebuildCheckpoints ();
+  std::vector<long int> pathColumns (const std::vector<std::string>&, arma::uword&) const;
 
 public:
   BaselearnerTrack ();
@@ -52,18 +100,40 @@ public:
   BaselearnerTrack (const json&, const mdata&);
 
   // Getter/Setter
-  std::vector<std::shared_ptr<blearner::Baselearner>>  getBaselearnerVector             () const;
-  std::map<std::string, arma::mat>                     getParameterMap                  () const;
-  std::pair<std::vector<std::string>, arma::mat>       getParameterMatrix               () const;
-  std::map<std::string, arma::mat>                     getEstimatedParameterOfIteration (const unsigned int&) const;
+  unsigned int                                    getNumberOfIterations            () const;
+  unsigned int                                    getNumberOfEntries               () const;
+  unsigned int                                    getEntriesOfIteration            (const unsigned int) const;
+  std::pair<unsigned int, unsigned int>           getEntryRangeOfIteration         (const unsigned int) const;
+  std::string                                     getFactoryIdOfIteration          (const unsigned int) const;
+  unsigned int                                    getFactoryIndexOfIteration       (const unsigned int) const;
+  std::vector<std::string>                        getFactoryTable                  () const;
+  arma::mat                                       getParameterOfIteration          (const unsigned int) const;
+  double                                          getStepSizeOfIteration           (const unsigned int) const;
+  std::vector<std::string>                        getSelectedFactoryIds            () const;
+  std::shared_ptr<blearner::Baselearner>          getLastBaselearner               () const;
+  std::vector<std::shared_ptr<blearner::Baselearner>> getBaselearnersOfLastIteration () const;
+  std::map<std::string, arma::mat>                getParameterMap                  () const;
+  std::pair<std::vector<std::string>, arma::mat>  getParameterMatrix               () const;
+  std::vector<std::string>                        getParameterPathNames            (const std::vector<std::string>&) const;
+  std::map<std::string, arma::mat>                getEstimatedParameterOfIteration (const unsigned int&) const;
+  double                                          getLearningRate                  () const;
+  unsigned int                                    getCheckpointInterval            () const;
+
+  void setParameterMap       (std::map<std::string, arma::mat>);
+  void setCheckpointInterval (const unsigned int);
 
-  void setParameterMap (std::map<std::string, arma::mat>);
+  // Coefficient path for selected factories and iterations:
+  void fillParameterPath  (const std::vector<std::string>&, const unsigned int, const unsigned int, arma::mat&) const;
+  void writeParameterPath (const std::string&, const std::vector<std::string>&, const unsigned int, const unsigned int,
+    const unsigned int) const;
 
   // Other member functions
   void insertBaselearner      (std::shared_ptr<blearner::Baselearner>, const double& step_size);
+  void insertBaselearnerBlock (const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double& step_size);
   void clearBaselearnerVector ();
   void setToIteration         (const unsigned int&);
   json toJson                 () const;
+  void reportMemory           (memreport::MemoryReport&, const std::string&) const;
 
   // Destructor:
   ~BaselearnerTrack ();
@@ -136,22 +136,7 @@ arma::uvec calculateIndexVectorLin (const arma::vec& x, const arma::vec& x_bins)
  */
 arma::mat binnedMatMult (const arma::mat& X, const arma::uvec& k, const arma::vec& w)
 {
-  unsigned int n = k.size();
-  unsigned int ind;
-
-  arma::colvec wcum(X.n_rows, arma::fill::zeros);
-  if ( (w.size() == 1) && (w(0) == 1) ) {
-    for (unsigned int i = 0; i < n; i++) {
-      ind = k(i);
-      wcum(ind) += 1;
-    }
-  } else {
-    for (unsigned int i = 0; i < n; i++) {
-      ind = k(i);
-      wcum(ind) += w(i);
-    }
-  }
-  return arma::trans(X.each_col() % wcum) * X;
+  return binnedMatMultWeighted(X, accumulateBinWeights(k, w, X.n_rows));
 }
 
 
@@ -233,29 +218,7 @@ arma::mat binnedPrediction (const arma::mat& X, const arma::mat& param, const ar
  */
 arma::mat binnedSparseMatMult (const arma::sp_mat& X, const arma::uvec& k, const arma::vec& w)
 {
-  const unsigned int n = k.size();
-  const unsigned int n_unique = X.n_cols;
-  unsigned int ind;
-
-  arma::sp_mat sp_out(X);
-  arma::colvec wcum(n_unique, arma::fill::zeros);
-
-  if ( (w.size() == 1) && (w(0) == 1) ) {
-    for (unsigned int i = 0; i < n; i++) {
-      ind = k(i);
-      wcum(ind) += 1;
-    }
-  } else {
-    for (unsigned int i = 0; i < n; i++) {
-      ind = k(i);
-      wcum(ind) += w(i);
-    }
-  }
-  for (unsigned int i = 0; i < n_unique; i++) {
-    sp_out.col(i) *= wcum(i);
-  }
-  arma::mat out(X * arma::trans(sp_out));
-  return out;
+  return binnedSparseMatMultWeighted(X, accumulateBinWeights(k, w, X.n_cols));
 }
 
 
@@ -317,4 +280,175 @@ arma::mat binnedSparsePrediction (const arma::sp_mat& X, const arma::mat& param,
   return out;
 }
 
+
+/**
+ * \brief Accumulate the weights of the original rows per bin
+ *
+ * The accumulated weights just depend on the index vector. Hence, they can be
+ * computed once and shared between all design matrices that are binned with
+ * the same index vector (e.g. base learners of the same feature).
+ *
+ * \param k `arma::uvec` Index vector for mapping to original matrix $X_o(i,) = X(k(i),.)$.
+ *
+ * \param w `arma::vec` Vector of weights, a single one means all weights are one.
+ *
+ * \param n_bins `unsigned int` Number of bins (unique rows of X).
+ *
+ * \return `arma::vec` Sum of the weights per bin.
+ */
+arma::vec accumulateBinWeights (const arma::uvec& k, const arma::vec& w, const unsigned int n_bins)
+{
+  unsigned int n = k.size();
+
+  arma::colvec wcum(n_bins, arma::fill::zeros);
+  if ( (w.size() == 1) && (w(0) == 1) ) {
+    for (unsigned int i = 0; i < n; i++) {
+      wcum(k(i)) += 1;
+    }
+  } else {
+    for (unsigned int i = 0; i < n; i++) {
+      wcum(k(i)) += w(i);
+    }
+  }
+  return wcum;
+}
+
+/**
+ * \brief Accumulate the rows of a matrix per bin
+ *
+ * Multiplying the unique rows of the design with the accumulated matrix gives
+ * the product of the original design with all columns at once.
+ *
+ * \param k `arma::uvec` Index vector for mapping to original matrix $X_o(i,) = X(k(i),.)$.
+ *
+ * \param y `arma::mat` Matrix with one row per original row.
+ *
+ * \param n_bins `unsigned int` Number of bins (unique rows of X).
+ *
+ * \return `arma::mat` Sum of the rows of `y` per bin.
+ */
+arma::mat accumulateBinRows (const arma::uvec& k, const arma::mat& y, const unsigned int n_bins)
+{
+  unsigned int n = k.size();
+
+  arma::mat ycum(n_bins, y.n_cols, arma::fill::zeros);
+  for (unsigned int j = 0; j < y.n_cols; j++) {
+    for (unsigned int i = 0; i < n; i++) {
+      ycum(k(i), j) += y(i, j);
+    }
+  }
+  return ycum;
+}
+
+/**
+ * \brief Matrix product $X^TWX$ with the weights accumulated per bin
+ *
+ * Without binning, the weights are the weights of the rows.
+ */
+arma::mat binnedMatMultWeighted (const arma::mat& X, const arma::vec& wcum)
+{
+  return arma::trans(X.each_col() % wcum) * X;
+}
+
+/**
+ * \brief Sparse matrix product $XWX^T$ with the weights accumulated per bin
+ *
+ * The sparse matrix stores the observations (bins) as columns. Without binning,
+ * the weights are the weights of the rows.
+ */
+arma::mat binnedSparseMatMultWeighted (const arma::sp_mat& X, const arma::vec& wcum)
+{
+  arma::sp_mat sp_out(X);
+  for (unsigned int i = 0; i < X.n_cols; i++) {
+    sp_out.col(i) *= wcum(i);
+  }
+  arma::mat out(X * arma::trans(sp_out));
+  return out;
+}
+
+/**
+ * \brief Binned matrix product for the response term on a subset of rows
+ *
+ * Same as `binnedMatMultResponse` but the response is only accumulated into the bins
+ * for the rows in `idx`. The cost is therefore linear in the subset size and not in
+ * the number of observations.
+ *
+ * \param X `arma::mat` Matrix X of the unique bins.
+ *
+ * \param y `arma::vec` Response of the subset, `y(j)` belongs to the original row `idx(j)`.
+ *
+ * \param k `arma::uvec` Index vector for mapping to original matrix $X_o(i,) = X(k(i),.)$.
+ *
+ * \param idx `arma::uvec` Rows of the original matrix that are used.
+ *
+ * \return `arma::mat` Matrix Product $X_S^Ty$ (as row vector).
+ */
+arma::mat binnedMatMultResponseSubset (const arma::mat& X, const arma::vec& y, const arma::uvec& k, const arma::uvec& idx)
+{
+  unsigned int n = idx.size();
+  unsigned int ind;
+
+  arma::rowvec wcum(X.n_rows, arma::fill::zeros);
+  for (unsigned int j = 0; j < n; j++) {
+    ind = k(idx(j));
+    wcum(ind) += y(j);
+  }
+  return wcum * X;
+}
+
+arma::mat binnedPredictionSubset (const arma::mat& X, const arma::mat& param, const arma::uvec& k, const arma::uvec& idx)
+{
+  unsigned int n = idx.size();
+
+  arma::colvec out(n, arma::fill::zeros);
+  arma::mat temp = X * param;
+
+  for (unsigned int j = 0; j < n; j++) {
+    out(j) = temp(k(idx(j)));
+  }
+  return out;
+}
+
+/**
+ * \brief Sparse binned matrix product for the response term on a subset of rows
+ *
+ * Same as `binnedSparseMatMultResponse` but the response is only accumulated into the bins
+ * for the rows in `idx`.
+ *
+ * \param X `arma::sp_mat` Transposed sparse matrix X of the unique bins.
+ *
+ * \param y `arma::vec` Response of the subset, `y(j)` belongs to the original row `idx(j)`.
+ *
+ * \param k `arma::uvec` Index vector for mapping to original matrix $X_o(i,) = X(k(i),.)$.
+ *
+ * \param idx `arma::uvec` Rows of the original matrix that are used.
+ *
+ * \return `arma::mat` Matrix Product $X_S^Ty$.
+ */
+arma::mat binnedSparseMatMultResponseSubset (const arma::sp_mat& X, const arma::vec& y, const arma::uvec& k, const arma::uvec& idx)
+{
+  unsigned int n = idx.size();
+  unsigned int ind;
+
+  arma::colvec wcum(X.n_cols, arma::fill::zeros);
+  for (unsigned int j = 0; j < n; j++) {
+    ind = k(idx(j));
+    wcum(ind) += y(j);
+  }
+  return X * wcum;
+}
+
+arma::mat binnedSparsePredictionSubset (const arma::sp_mat& X, const arma::mat& param, const arma::uvec& k, const arma::uvec& idx)
+{
+  unsigned int n = idx.size();
+
+  arma::colvec out(n, arma::fill::zeros);
+  arma::mat temp = arma::trans(param) * X;
+
+  for (unsigned int j = 0; j < n; j++) {
+    out(j) = temp(k(idx(j)));
+  }
+  return out;
+}
+
 } // namespace binning
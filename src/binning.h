@@ -41,6 +41,18 @@ arma::mat binnedSparseMatMult          (const arma::sp_mat&, const arma::uvec&,
 arma::mat binnedSparseMatMultResponse  (const arma::sp_mat&, const arma::vec&, const arma::uvec&, const arma::vec&);
 arma::mat binnedSparsePrediction       (const arma::sp_mat&, const arma::mat&, const arma::uvec&);
 
+// Binned products with weights or rows that are already accumulated per bin:
+arma::vec accumulateBinWeights        (const arma::uvec&, const arma::vec&, const unsigned int);
+arma::mat accumulateBinRows           (const arma::uvec&, const arma::mat&, const unsigned int);
+arma::mat binnedMatMultWeighted       (const arma::mat&, const arma::vec&);
+arma::mat binnedSparseMatMultWeighted (const arma::sp_mat&, const arma::vec&);
+
+// Binned products restricted to a subset of the original rows:
+arma::mat binnedMatMultResponseSubset       (const arma::mat&, const arma::vec&, const arma::uvec&, const arma::uvec&);
+arma::mat binnedPredictionSubset            (const arma::mat&, const arma::mat&, const arma::uvec&, const arma::uvec&);
+arma::mat binnedSparseMatMultResponseSubset (const arma::sp_mat&, const arma::vec&, const arma::uvec&, const arma::uvec&);
+arma::mat binnedSparsePredictionSubset      (const arma::sp_mat&, const arma::mat&, const arma::uvec&, const arma::uvec&);
+
 } // namespace binning
 
 # endif // BINNING_H_
@@ -0,0 +1,370 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// ========================================================================== //
+
+
+#include "chunked_design.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+
+namespace chunked
+{
+
+static unsigned int numberOfBlocks (const unsigned int nrows, const unsigned int block_rows)
+{
+  return (nrows + block_rows - 1) / block_rows;
+}
+
+static void checkBlockRows (const unsigned int block_rows)
+{
+  if (block_rows == 0) Rcpp::stop("The number of rows per block must be positive.");
+}
+
+bool DesignBudget::streams (const double design_bytes) const
+{
+  return (! dir.empty()) && (design_bytes > free_bytes);
+}
+
+/// Rows per block such that two blocks with `row_bytes` per row fit into the buffer
+unsigned int DesignBudget::blockRows (const double row_bytes, const unsigned int nrows) const
+{
+  const double rows = std::floor(buffer_bytes / (2 * std::max(row_bytes, 1.0)));
+  return static_cast<unsigned int>(std::min(static_cast<double>(std::max(nrows, 1u)), std::max(1.0, rows)));
+}
+
+/// File of a design in `dir`, the address of the owner makes the name unique
+std::string DesignBudget::filePath (const std::string id, const void* owner) const
+{
+  std::string file = id;
+  std::replace_if(file.begin(), file.end(), [](const char c) { return ! std::isalnum(static_cast<unsigned char>(c)); }, '_');
+  return dir + "/" + file + "_" + std::to_string(reinterpret_cast<std::uintptr_t>(owner)) + ".cbchunk";
+}
+
+/**
+ * \brief Build a design in blocks of rows and write each block into the file
+ *
+ * Only one block is in memory at a time.
+ *
+ * \param path `std::string` Temporary file of the design, it is removed with the object.
+ * \param is_sparse `bool` Whether the blocks are sparse (and transposed).
+ * \param nrows `unsigned int` Number of rows of the design.
+ * \param ncols `unsigned int` Number of columns of the design.
+ * \param block_rows `unsigned int` Number of rows per block.
+ * \param build `BlockBuilder` Called with the first and last row of each block.
+ */
+ChunkedDesign::ChunkedDesign (const std::string path, const bool is_sparse, const unsigned int nrows,
+  const unsigned int ncols, const unsigned int block_rows, const BlockBuilder& build)
+  : _path       ( path ),
+    _is_sparse  ( is_sparse ),
+    _nrows      ( nrows ),
+    _ncols      ( ncols ),
+    _block_rows ( block_rows )
+{
+  checkBlockRows(block_rows);
+  std::ofstream out(_path, std::ios::binary | std::ios::trunc);
+  if (! out) Rcpp::stop("Cannot write the design to \"" + _path + "\".");
+
+  uint64_t offset = 0;
+  for (unsigned int b = 0; b < getNBlocks(); b++) {
+    const unsigned int first = b * _block_rows;
+    const unsigned int last  = std::min(first + _block_rows, _nrows) - 1;
+
+    Block blk = build(first, last);
+    uint64_t nbytes;
+    if (_is_sparse) {
+      if ((blk.sparse.n_rows != _ncols) || (blk.sparse.n_cols != last - first + 1)) Rcpp::stop("Block " + std::to_string(b) + " of \"" + _path + "\" has the wrong dimension.");
+      blk.sparse.sync();
+      nbytes = (blk.sparse.n_cols + 1) * sizeof(arma::uword) + blk.sparse.n_nonzero * (sizeof(arma::uword) + sizeof(double));
+      out.write(reinterpret_cast<const char*>(blk.sparse.col_ptrs), (blk.sparse.n_cols + 1) * sizeof(arma::uword));
+      out.write(reinterpret_cast<const char*>(blk.sparse.row_indices), blk.sparse.n_nonzero * sizeof(arma::uword));
+      out.write(reinterpret_cast<const char*>(blk.sparse.values), blk.sparse.n_nonzero * sizeof(double));
+      _nelem += blk.sparse.n_nonzero;
+    } else {
+      if ((blk.dense.n_rows != last - first + 1) || (blk.dense.n_cols != _ncols)) Rcpp::stop("Block " + std::to_string(b) + " of \"" + _path + "\" has the wrong dimension.");
+      nbytes = blk.dense.n_elem * sizeof(double);
+      out.write(reinterpret_cast<const char*>(blk.dense.memptr()), nbytes);
+      _nelem += blk.dense.n_elem;
+    }
+    _offsets.push_back(offset);
+    offset += nbytes;
+    _max_block_bytes = std::max(_max_block_bytes, static_cast<double>(nbytes));
+  }
+  _offsets.push_back(offset);
+
+  out.close();
+  if (out.fail()) Rcpp::stop("Failed to write the design to \"" + _path + "\".");
+  openReader();
+}
+
+/**
+ * \brief Write a dense design in blocks of rows
+ *
+ * \param path `std::string` Temporary file of the design, it is removed with the object.
+ * \param X `arma::mat` Design with one row per observation.
+ * \param block_rows `unsigned int` Number of rows per block.
+ */
+ChunkedDesign::ChunkedDesign (const std::string path, const arma::mat& X, const unsigned int block_rows)
+  : ChunkedDesign (path, false, X.n_rows, X.n_cols, block_rows, [&X](const unsigned int first, const unsigned int last) {
+      Block blk;
+      blk.dense = X.rows(first, last);
+      return blk;
+    })
+{ }
+
+/**
+ * \brief Write a sparse design in blocks of rows
+ *
+ * \param path `std::string` Temporary file of the design, it is removed with the object.
+ * \param X `arma::sp_mat` Transposed design with one column per observation.
+ * \param block_rows `unsigned int` Number of rows (columns of `X`) per block.
+ */
+ChunkedDesign::ChunkedDesign (const std::string path, const arma::sp_mat& X, const unsigned int block_rows)
+  : ChunkedDesign (path, true, X.n_cols, X.n_rows, block_rows, [&X](const unsigned int first, const unsigned int last) {
+      Block blk;
+      blk.sparse = X.cols(first, last);
+      return blk;
+    })
+{ }
+
+void ChunkedDesign::openReader ()
+{
+  _in.open(_path, std::ios::binary);
+  if (! _in) Rcpp::stop("Cannot read the design from \"" + _path + "\".");
+}
+
+/**
+ * \brief Read one block, called from the reader thread
+ *
+ * Errors are thrown as `std::runtime_error` since the R API must not be used
+ * outside the main thread. They are rethrown by `std::future::get()`.
+ */
+Block ChunkedDesign::readBlock (const unsigned int b) const
+{
+  Block blk;
+  blk.first_row = b * _block_rows;
+  blk.n_rows    = std::min(blk.first_row + _block_rows, _nrows) - blk.first_row;
+
+  const uint64_t nbytes = _offsets[b + 1] - _offsets[b];
+  _in.clear();
+  _in.seekg(_offsets[b]);
+
+  if (_is_sparse) {
+    const uint64_t nnz = (nbytes - (blk.n_rows + 1) * sizeof(arma::uword)) / (sizeof(arma::uword) + sizeof(double));
+    arma::uvec col_ptrs(blk.n_rows + 1);
+    arma::uvec row_indices(nnz);
+    arma::vec  values(nnz);
+    _in.read(reinterpret_cast<char*>(col_ptrs.memptr()), col_ptrs.n_elem * sizeof(arma::uword));
+    _in.read(reinterpret_cast<char*>(row_indices.memptr()), nnz * sizeof(arma::uword));
+    _in.read(reinterpret_cast<char*>(values.memptr()), nnz * sizeof(double));
+    if (! _in) throw std::runtime_error("Failed to read block " + std::to_string(b) + " of \"" + _path + "\".");
+    blk.sparse = arma::sp_mat(row_indices, col_ptrs, values, _ncols, blk.n_rows);
+  } else {
+    blk.dense.set_size(blk.n_rows, _ncols);
+    _in.read(reinterpret_cast<char*>(blk.dense.memptr()), nbytes);
+    if (! _in) throw std::runtime_error("Failed to read block " + std::to_string(b) + " of \"" + _path + "\".");
+  }
+  _bytes_read += nbytes;
+
+  return blk;
+}
+
+/**
+ * \brief Call `fun` for all blocks in order, the next block is read meanwhile
+ */
+void ChunkedDesign::forEachBlock (const std::function<void(const Block&)>& fun) const
+{
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  const unsigned int nblocks = getNBlocks();
+  if (nblocks == 0) return;
+
+  std::future<Block> next = std::async(std::launch::async, &ChunkedDesign::readBlock, this, 0u);
+  for (unsigned int b = 0; b < nblocks; b++) {
+    Block current = next.get();
+    if (b + 1 < nblocks) next = std::async(std::launch::async, &ChunkedDesign::readBlock, this, b + 1);
+    fun(current);
+  }
+}
+
+/**
+ * \brief Call `fun` for all blocks that contain rows of `idx`
+ *
+ * Besides the block, `fun` gets the rows within the block and the positions of
+ * these rows in `idx`. Blocks without rows of `idx` are skipped, but still read.
+ */
+void ChunkedDesign::forEachRow (const arma::uvec& idx,
+  const std::function<void(const Block&, const arma::uvec&, const arma::uvec&)>& fun) const
+{
+  if (idx.n_elem == 0) return;
+  if (idx.max() >= _nrows) Rcpp::stop("Row index out of bounds of the design in \"" + _path + "\".");
+
+  const arma::uvec order = arma::stable_sort_index(idx);
+  unsigned int k = 0;
+  forEachBlock([&idx, &order, &k, &fun](const Block& blk) {
+    const unsigned int k0 = k;
+    while ((k < order.n_elem) && (idx(order(k)) < blk.first_row + blk.n_rows)) k++;
+    if (k == k0) return;
+
+    const arma::uvec pos = order.subvec(k0, k - 1);
+    fun(blk, idx.elem(pos) - blk.first_row, pos);
+  });
+}
+
+/**
+ * \brief Cross product \f$X^Tr\f$ with one column per column of `r`
+ */
+arma::mat ChunkedDesign::crossProduct (const arma::mat& r) const
+{
+  arma::mat out(_ncols, r.n_cols, arma::fill::zeros);
+  forEachBlock([this, &out, &r](const Block& blk) {
+    const arma::mat rb = r.rows(blk.first_row, blk.first_row + blk.n_rows - 1);
+    if (_is_sparse) {
+      out += blk.sparse * rb;
+    } else {
+      out += blk.dense.t() * rb;
+    }
+  });
+  return out;
+}
+
+/**
+ * \brief Linear predictor \f$X\beta\f$, the parameter can have multiple columns
+ */
+arma::mat ChunkedDesign::linearPredictor (const arma::mat& param) const
+{
+  arma::mat out(_nrows, param.n_cols);
+  forEachBlock([this, &out, &param](const Block& blk) {
+    if (_is_sparse) {
+      out.rows(blk.first_row, blk.first_row + blk.n_rows - 1) = (param.t() * blk.sparse).t();
+    } else {
+      out.rows(blk.first_row, blk.first_row + blk.n_rows - 1) = blk.dense * param;
+    }
+  });
+  return out;
+}
+
+/**
+ * \brief Cross product \f$X_{idx}^Tr\f$ of the rows `idx`, row `j` of `r` belongs to row `idx(j)`
+ */
+arma::mat ChunkedDesign::crossProductSubset (const arma::mat& r, const arma::uvec& idx) const
+{
+  arma::mat out(_ncols, r.n_cols, arma::fill::zeros);
+  forEachRow(idx, [this, &out, &r](const Block& blk, const arma::uvec& rows, const arma::uvec& pos) {
+    if (_is_sparse) {
+      for (unsigned int j = 0; j < rows.n_elem; j++) {
+        for (arma::sp_mat::const_col_iterator it = blk.sparse.begin_col(rows(j)); it != blk.sparse.end_col(rows(j)); ++it) {
+          out.row(it.row()) += (*it) * r.row(pos(j));
+        }
+      }
+    } else {
+      out += blk.dense.rows(rows).t() * r.rows(pos);
+    }
+  });
+  return out;
+}
+
+/**
+ * \brief Linear predictor of the rows `idx`, row `j` of the result belongs to row `idx(j)`
+ */
+arma::mat ChunkedDesign::linearPredictorSubset (const arma::mat& param, const arma::uvec& idx) const
+{
+  arma::mat out(idx.n_elem, param.n_cols, arma::fill::zeros);
+  forEachRow(idx, [this, &out, &param](const Block& blk, const arma::uvec& rows, const arma::uvec& pos) {
+    if (_is_sparse) {
+      for (unsigned int j = 0; j < rows.n_elem; j++) {
+        for (arma::sp_mat::const_col_iterator it = blk.sparse.begin_col(rows(j)); it != blk.sparse.end_col(rows(j)); ++it) {
+          out.row(pos(j)) += (*it) * param.row(it.row());
+        }
+      }
+    } else {
+      out.rows(pos) = blk.dense.rows(rows) * param;
+    }
+  });
+  return out;
+}
+
+/**
+ * \brief Weighted Gram matrix \f$X^TWX\f$ with one weight per row
+ */
+arma::mat ChunkedDesign::weightedGram (const arma::vec& w) const
+{
+  arma::mat out(_ncols, _ncols, arma::fill::zeros);
+  forEachBlock([this, &out, &w](const Block& blk) {
+    const arma::vec wb = w.rows(blk.first_row, blk.first_row + blk.n_rows - 1);
+    if (_is_sparse) {
+      arma::sp_mat wdiag = arma::speye<arma::sp_mat>(blk.n_rows, blk.n_rows);
+      wdiag.diag() = wb;
+      out += arma::mat(blk.sparse * wdiag * blk.sparse.t());
+    } else {
+      out += blk.dense.t() * (blk.dense.each_col() % wb);
+    }
+  });
+  return out;
+}
+
+/// Read the full dense design (for the sparse design, the transposed design is densified)
+arma::mat ChunkedDesign::denseDesign () const
+{
+  if (_is_sparse) return arma::mat(sparseDesign());
+
+  arma::mat out(_nrows, _ncols);
+  forEachBlock([&out](const Block& blk) {
+    out.rows(blk.first_row, blk.first_row + blk.n_rows - 1) = blk.dense;
+  });
+  return out;
+}
+
+/// Read the full sparse (transposed) design, empty for dense designs
+arma::sp_mat ChunkedDesign::sparseDesign () const
+{
+  if (! _is_sparse) return arma::sp_mat();
+
+  arma::sp_mat out(_ncols, _nrows);
+  forEachBlock([&out](const Block& blk) {
+    out.cols(blk.first_row, blk.first_row + blk.n_rows - 1) = blk.sparse;
+  });
+  return out;
+}
+
+std::string  ChunkedDesign::getPath      () const { return _path; }
+bool         ChunkedDesign::isSparse     () const { return _is_sparse; }
+unsigned int ChunkedDesign::getNRows     () const { return _nrows; }
+unsigned int ChunkedDesign::getNCols     () const { return _ncols; }
+unsigned int ChunkedDesign::getBlockRows () const { return _block_rows; }
+unsigned int ChunkedDesign::getNBlocks   () const { return numberOfBlocks(_nrows, _block_rows); }
+double       ChunkedDesign::getNElem     () const { return _nelem; }
+double       ChunkedDesign::getFileBytes () const { return _offsets.back(); }
+double       ChunkedDesign::getBytesRead () const { return _bytes_read; }
+
+/// Memory of the two buffered blocks
+double ChunkedDesign::getBufferBytes () const { return 2 * _max_block_bytes; }
+
+ChunkedDesign::~ChunkedDesign ()
+{
+  _in.close();
+  std::remove(_path.c_str());
+}
+
+} // namespace chunked
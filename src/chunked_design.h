@@ -0,0 +1,154 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// ========================================================================== //
+
+
+/**
+ *  @file    chunked_design.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Designs streamed from disk in row blocks
+ *
+ *  @section DESCRIPTION
+ *
+ *  Without binning, a base learner touches the full design with `n` rows in
+ *  each `train()` and `predict()`. A `ChunkedDesign` writes the design into a
+ *  file in blocks of rows and releases the memory. The cross product
+ *  \f$X^Tr\f$, the linear predictor \f$X\beta\f$, and the weighted Gram matrix
+ *  are then computed block by block. The blocks are double-buffered: while
+ *  one block is used, the next one is read asynchronously. Hence, the memory
+ *  of a design is bounded by two blocks.
+ *
+ *  A design can also be built block by block, e.g. from the raw data of a
+ *  factory, such that the full design is never in memory. `DesignBudget`
+ *  decides whether a design is built this way when a factory is instantiated.
+ *
+ *  Dense blocks are stored column-major, sparse blocks (the design is stored
+ *  transposed as in `data::Data`) as compressed columns with the column
+ *  pointers, row indices, and values. The file is temporary, it is removed
+ *  when the object is destroyed.
+ *
+ */
+
+#ifndef CHUNKED_DESIGN_H_
+#define CHUNKED_DESIGN_H_
+
+#include <RcppArmadillo.h>
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace chunked
+{
+
+/// Rows `[first_row, first_row + n_rows)` of the design
+struct Block
+{
+  unsigned int first_row = 0;
+  unsigned int n_rows    = 0;
+  arma::mat    dense;
+  arma::sp_mat sparse;
+};
+
+/// Builds the block of rows `[first_row, last_row]` (the sparse block is transposed)
+typedef std::function<Block(const unsigned int, const unsigned int)> BlockBuilder;
+
+/**
+ * \class DesignBudget
+ *
+ * \brief Memory left for the designs when a factory is instantiated
+ *
+ * A design that does not fit into `free_bytes` is built in blocks of rows and
+ * written into `dir`, two blocks fit into `buffer_bytes`. Without a directory,
+ * all designs stay in memory.
+ */
+struct DesignBudget
+{
+  std::string dir;
+  double      free_bytes   = 0;
+  double      buffer_bytes = 0;
+
+  bool         streams   (const double)                     const;
+  unsigned int blockRows (const double, const unsigned int) const;
+  std::string  filePath  (const std::string, const void*)   const;
+};
+
+/**
+ * \class ChunkedDesign
+ *
+ * \brief Design matrix in a file that is read in blocks of rows
+ *
+ * All products iterate over all blocks, concurrent calls are serialized.
+ */
+class ChunkedDesign
+{
+private:
+  const std::string  _path;
+  const bool         _is_sparse;
+  const unsigned int _nrows;
+  const unsigned int _ncols;
+  const unsigned int _block_rows;
+
+  std::vector<uint64_t> _offsets;
+  double                _nelem = 0;
+  double                _max_block_bytes = 0;
+
+  mutable std::ifstream _in;
+  mutable std::mutex    _mtx;
+  mutable double        _bytes_read = 0;
+
+  void  openReader   ();
+  Block readBlock    (const unsigned int) const;
+  void  forEachBlock (const std::function<void(const Block&)>&) const;
+  void  forEachRow   (const arma::uvec&, const std::function<void(const Block&, const arma::uvec&, const arma::uvec&)>&) const;
+
+public:
+  ChunkedDesign (const std::string, const bool, const unsigned int, const unsigned int, const unsigned int, const BlockBuilder&);
+  ChunkedDesign (const std::string, const arma::mat&, const unsigned int);
+  ChunkedDesign (const std::string, const arma::sp_mat&, const unsigned int);
+
+  arma::mat    crossProduct          (const arma::mat&)                    const;
+  arma::mat    crossProductSubset    (const arma::mat&, const arma::uvec&) const;
+  arma::mat    linearPredictor       (const arma::mat&)                    const;
+  arma::mat    linearPredictorSubset (const arma::mat&, const arma::uvec&) const;
+  arma::mat    weightedGram          (const arma::vec&)                    const;
+  arma::mat    denseDesign     ()                 const;
+  arma::sp_mat sparseDesign    ()                 const;
+
+  std::string  getPath        () const;
+  bool         isSparse       () const;
+  unsigned int getNRows       () const;
+  unsigned int getNCols       () const;
+  unsigned int getBlockRows   () const;
+  unsigned int getNBlocks     () const;
+  double       getNElem       () const;
+  double       getFileBytes   () const;
+  double       getBufferBytes () const;
+  double       getBytesRead   () const;
+
+  ~ChunkedDesign ();
+};
+
+} // namespace chunked
+
+#endif // CHUNKED_DESIGN_H_
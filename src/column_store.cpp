@@ -0,0 +1,387 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// ========================================================================== //
+
+#include "column_store.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace colstore
+{
+
+static uint64_t alignOffset (const uint64_t offset)
+{
+  return ((offset + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+}
+
+// -------------------------------------------------------------------------- //
+// ColumnStore:
+// -------------------------------------------------------------------------- //
+
+ColumnStore::ColumnStore (const std::string path)
+  : _path ( path )
+{
+#ifdef _WIN32
+  Rcpp::stop("Memory-mapped column stores are not available on Windows.");
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    Rcpp::stop("Cannot open column store \"" + path + "\": " + std::string(std::strerror(errno)));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) < 0) {
+    ::close(fd);
+    Rcpp::stop("Cannot read the size of \"" + path + "\".");
+  }
+  _nbytes = st.st_size;
+  if (_nbytes < MAGIC.size() + sizeof(uint64_t)) {
+    ::close(fd);
+    Rcpp::stop("File \"" + path + "\" is not a column store.");
+  }
+
+  // Read-only shared mapping: pages of the page cache are shared with other
+  // processes, do not count against the commit charge, and writes fault:
+  void* ptr = ::mmap(nullptr, _nbytes, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    Rcpp::stop("Cannot map \"" + path + "\": " + std::string(std::strerror(errno)));
+  }
+  _ptr_map = static_cast<char*>(ptr);
+
+  // The destructor does not run if the constructor throws, hence the mapping
+  // is released on every error while the header is read:
+  try {
+    readHeader();
+  } catch (...) {
+    ::munmap(_ptr_map, _nbytes);
+    _ptr_map = nullptr;
+    throw;
+  }
+#endif
+}
+
+void ColumnStore::readHeader ()
+{
+  uint64_t header_bytes;
+  std::memcpy(&header_bytes, _ptr_map + MAGIC.size(), sizeof(uint64_t));
+  const uint64_t header_start = MAGIC.size() + sizeof(uint64_t);
+  if ((std::string(_ptr_map, MAGIC.size()) != MAGIC) || (header_start + header_bytes > _nbytes)) {
+    Rcpp::stop("File \"" + _path + "\" is not a column store.");
+  }
+  json header;
+  try {
+    header = json::parse(std::string(_ptr_map + header_start, header_bytes));
+
+    _nrows = header["n_rows"].get<uint64_t>();
+    for (auto& jc : header["columns"]) {
+      ColumnInfo info;
+      info.name   = jc["name"].get<std::string>();
+      info.type   = jc["type"].get<std::string>();
+      info.offset = jc["offset"].get<uint64_t>();
+      info.min    = jc["min"].get<double>();
+      info.max    = jc["max"].get<double>();
+      if (info.type == "categorical") info.levels = jc["levels"].get<std::vector<std::string>>();
+
+      _column_names.push_back(info.name);
+      _columns[info.name] = info;
+    }
+  } catch (const json::exception& ex) {
+    Rcpp::stop("The header of the column store \"" + _path + "\" is invalid: " + std::string(ex.what()));
+  }
+  for (auto& it : _columns) {
+    const uint64_t width = (it.second.type == "numeric") ? sizeof(double) : sizeof(uint32_t);
+    if (it.second.offset + _nrows * width > _nbytes) {
+      Rcpp::stop("Column \"" + it.first + "\" exceeds the file \"" + _path + "\", the file is truncated.");
+    }
+  }
+  // Codes are used to index the levels without further checks:
+  for (auto& it : _columns) {
+    if (it.second.type != "categorical") continue;
+
+    const uint32_t* codes = reinterpret_cast<const uint32_t*>(_ptr_map + it.second.offset);
+    uint32_t max_code = 0;
+    for (uint64_t i = 0; i < _nrows; i++) max_code = std::max(max_code, codes[i]);
+    if ((_nrows > 0) && (max_code >= it.second.levels.size())) {
+      Rcpp::stop("Column \"" + it.first + "\" of \"" + _path + "\" has codes without a level, the file is corrupt.");
+    }
+  }
+}
+
+const ColumnInfo& ColumnStore::getColumnChecked (const std::string& name, const std::string& type) const
+{
+  auto it = _columns.find(name);
+  if (it == _columns.end()) {
+    Rcpp::stop("Column \"" + name + "\" is not in the column store \"" + _path + "\".");
+  }
+  if ((type != "") && (it->second.type != type)) {
+    Rcpp::stop("Column \"" + name + "\" is " + it->second.type + ", not " + type + ".");
+  }
+  return it->second;
+}
+
+std::string              ColumnStore::getPath        () const { return _path; }
+unsigned int             ColumnStore::getNRows       () const { return _nrows; }
+std::vector<std::string> ColumnStore::getColumnNames () const { return _column_names; }
+double                   ColumnStore::getMappedBytes () const { return _nbytes; }
+
+ColumnInfo ColumnStore::getColumn (const std::string& name) const
+{
+  return getColumnChecked(name, "");
+}
+
+const double* ColumnStore::numericColumn (const std::string& name) const
+{
+  return reinterpret_cast<const double*>(_ptr_map + getColumnChecked(name, "numeric").offset);
+}
+
+const uint32_t* ColumnStore::codeColumn (const std::string& name) const
+{
+  return reinterpret_cast<const uint32_t*>(_ptr_map + getColumnChecked(name, "categorical").offset);
+}
+
+/**
+ * \brief Bytes of a column that are currently in the page cache
+ */
+double ColumnStore::residentBytes (const std::string& name) const
+{
+  double out = 0;
+#ifndef _WIN32
+  const ColumnInfo& info = getColumnChecked(name, "");
+  const uint64_t width = (info.type == "numeric") ? sizeof(double) : sizeof(uint32_t);
+  const uint64_t page  = ::sysconf(_SC_PAGESIZE);
+
+  const uint64_t start = (info.offset / page) * page;
+  const uint64_t end   = info.offset + _nrows * width;
+  if (end <= start) return 0;
+
+  std::vector<unsigned char> pages((end - start + page - 1) / page);
+  if (::mincore(_ptr_map + start, end - start, pages.data()) == 0) {
+    for (auto& it : pages) out += (it & 1) * page;
+  }
+  out = std::min(out, double(_nrows * width));
+#endif
+  return out;
+}
+
+/**
+ * \brief Advise the kernel about the access to a column
+ *
+ * \param advice `std::string` One of `"sequential"`, `"willneed"`, or `"dontneed"`.
+ */
+void ColumnStore::advise (const std::string& name, const std::string& advice) const
+{
+#ifndef _WIN32
+  const ColumnInfo& info = getColumnChecked(name, "");
+  const uint64_t width = (info.type == "numeric") ? sizeof(double) : sizeof(uint32_t);
+  const uint64_t page  = ::sysconf(_SC_PAGESIZE);
+  const uint64_t start = (info.offset / page) * page;
+  const uint64_t end   = info.offset + _nrows * width;
+
+  int flag;
+  if (advice == "sequential") {
+    flag = MADV_SEQUENTIAL;
+  } else if (advice == "willneed") {
+    flag = MADV_WILLNEED;
+  } else if (advice == "dontneed") {
+    flag = MADV_DONTNEED;
+  } else {
+    Rcpp::stop("Unknown advice \"" + advice + "\", use \"sequential\", \"willneed\", or \"dontneed\".");
+  }
+  if (end > start) ::madvise(_ptr_map + start, end - start, flag);
+#endif
+}
+
+ColumnStore::~ColumnStore ()
+{
+#ifndef _WIN32
+  if (_ptr_map != nullptr) ::munmap(_ptr_map, _nbytes);
+#endif
+}
+
+/**
+ * \brief Open a column store, stores are shared as long as they are in use
+ */
+static std::map<std::string, std::weak_ptr<ColumnStore>>& openStores ()
+{
+  static std::map<std::string, std::weak_ptr<ColumnStore>> open_stores;
+  return open_stores;
+}
+
+std::shared_ptr<ColumnStore> openColumnStore (const std::string path)
+{
+  std::map<std::string, std::weak_ptr<ColumnStore>>& open_stores = openStores();
+
+  std::shared_ptr<ColumnStore> sh_ptr_store = open_stores[path].lock();
+  if (sh_ptr_store == nullptr) {
+    sh_ptr_store = std::make_shared<ColumnStore>(path);
+    open_stores[path] = sh_ptr_store;
+  }
+  return sh_ptr_store;
+}
+
+
+// -------------------------------------------------------------------------- //
+// ColumnStoreWriter:
+// -------------------------------------------------------------------------- //
+
+/**
+ * \brief Create a new column store file
+ *
+ * The columns are written into a temporary file next to `path` that replaces
+ * `path` on `close()`. Stores that still map an existing file keep the old
+ * file, hence truncating it never invalidates their pages.
+ *
+ * \param path `std::string` File of the column store, an existing file is replaced.
+ * \param header_bytes `uint64_t` Bytes reserved for the header (names, levels, and
+ *   offsets of the columns).
+ */
+ColumnStoreWriter::ColumnStoreWriter (const std::string path, const uint64_t header_bytes)
+  : _path         ( path ),
+    _tmp_path     ( path + ".tmp" ),
+    _header_bytes ( header_bytes ),
+    _out          ( _tmp_path, std::ios::binary | std::ios::trunc )
+{
+  if (! _out) Rcpp::stop("Cannot write column store \"" + path + "\".");
+
+  _offset = alignOffset(MAGIC.size() + sizeof(uint64_t) + _header_bytes);
+  const std::vector<char> zeros(_offset, 0);
+  _out.write(zeros.data(), zeros.size());
+}
+
+void ColumnStoreWriter::addColumn (ColumnInfo& info, const char* bytes, const uint64_t nbytes)
+{
+  if (_is_closed) Rcpp::stop("The column store \"" + _path + "\" is already closed.");
+  for (auto& it : _columns) {
+    if (it.name == info.name) Rcpp::stop("Column \"" + info.name + "\" is already added.");
+  }
+  const uint64_t width = (info.type == "numeric") ? sizeof(double) : sizeof(uint32_t);
+  const unsigned int nrows = nbytes / width;
+  if (_columns.size() == 0) _nrows = nrows;
+  if (nrows != _nrows) {
+    Rcpp::stop("Column \"" + info.name + "\" has " + std::to_string(nrows) + " rows, expected " + std::to_string(_nrows) + ".");
+  }
+  info.offset = _offset;
+  _out.write(bytes, nbytes);
+
+  const uint64_t next = alignOffset(_offset + nbytes);
+  const std::vector<char> zeros(next - _offset - nbytes, 0);
+  _out.write(zeros.data(), zeros.size());
+  if (! _out) Rcpp::stop("Failed to write column \"" + info.name + "\" to \"" + _path + "\".");
+
+  _offset = next;
+  _columns.push_back(info);
+}
+
+void ColumnStoreWriter::addNumeric (const std::string name, const arma::vec& x)
+{
+  ColumnInfo info;
+  info.name = name;
+  info.type = "numeric";
+  info.min  = x.n_elem > 0 ? x.min() : 0;
+  info.max  = x.n_elem > 0 ? x.max() : 0;
+  addColumn(info, reinterpret_cast<const char*>(x.memptr()), x.n_elem * sizeof(double));
+}
+
+/**
+ * \brief Add a categorical column, the levels are sorted
+ */
+void ColumnStoreWriter::addCategorical (const std::string name, const std::vector<std::string>& x)
+{
+  ColumnInfo info;
+  info.name   = name;
+  info.type   = "categorical";
+  info.levels = x;
+  std::sort(info.levels.begin(), info.levels.end());
+  info.levels.erase(std::unique(info.levels.begin(), info.levels.end()), info.levels.end());
+
+  std::map<std::string, uint32_t> dictionary;
+  for (uint32_t i = 0; i < info.levels.size(); i++) dictionary[info.levels[i]] = i;
+
+  std::vector<uint32_t> codes(x.size());
+  for (unsigned int i = 0; i < x.size(); i++) codes[i] = dictionary[x[i]];
+
+  info.min = 0;
+  info.max = info.levels.size() > 0 ? info.levels.size() - 1 : 0;
+  addColumn(info, reinterpret_cast<const char*>(codes.data()), codes.size() * sizeof(uint32_t));
+}
+
+/**
+ * \brief Write the header and close the file
+ */
+void ColumnStoreWriter::close ()
+{
+  if (_is_closed) return;
+
+  json jcols = json::array();
+  for (auto& it : _columns) {
+    json jc = {
+      {"name",   it.name},
+      {"type",   it.type},
+      {"offset", it.offset},
+      {"min",    it.min},
+      {"max",    it.max}
+    };
+    if (it.type == "categorical") jc["levels"] = it.levels;
+    jcols.push_back(jc);
+  }
+  json jheader = { {"n_rows", _nrows}, {"columns", jcols} };
+  std::string header = jheader.dump();
+  if (header.size() > _header_bytes) {
+    _out.close();
+    _is_closed = true;
+    std::remove(_tmp_path.c_str());
+    Rcpp::stop("The header requires " + std::to_string(header.size()) + " bytes but just "
+      + std::to_string(_header_bytes) + " are reserved, increase the reserved bytes.");
+  }
+  // Pad the header with spaces, which is still valid JSON:
+  header.resize(_header_bytes, ' ');
+
+  _out.seekp(0);
+  _out.write(MAGIC.data(), MAGIC.size());
+  _out.write(reinterpret_cast<const char*>(&_header_bytes), sizeof(uint64_t));
+  _out.write(header.data(), header.size());
+  _out.close();
+  _is_closed = true;
+
+  if (_out.fail() || (std::rename(_tmp_path.c_str(), _path.c_str()) != 0)) {
+    std::remove(_tmp_path.c_str());
+    Rcpp::stop("Failed to write column store \"" + _path + "\".");
+  }
+  // Stores opened before map the replaced file, new ones must map the new file:
+  openStores().erase(_path);
+}
+
+ColumnStoreWriter::~ColumnStoreWriter ()
+{
+  try {
+    close();
+  } catch (...) { }
+}
+
+} // namespace colstore
@@ -0,0 +1,155 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// ========================================================================== //
+
+/**
+ *  @file    column_store.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Memory-mapped on-disk column store
+ *
+ *  @section DESCRIPTION
+ *
+ *  A column store file contains typed columns of the same length:
+ *
+ *    - 8 bytes magic `CBCOLST1`,
+ *    - 8 bytes (uint64) length of the header,
+ *    - the header as JSON with the number of rows and, per column, the name,
+ *      the type (`"numeric"` or `"categorical"`), the offset of the column
+ *      block, the minimum and maximum, and the levels of categorical columns,
+ *    - the column blocks, each aligned to 64 bytes. Numeric columns are
+ *      stored as doubles, categorical columns as uint32 codes (0-based index
+ *      of the level).
+ *
+ *  The file is mapped read-only and shared, hence all processes that map the
+ *  same file share the pages of the page cache and nothing is written. Pages
+ *  are loaded by the kernel on first access and can be evicted again, so
+ *  columns larger than the RAM can be used as long as the design of the base
+ *  learners fits (e.g. with binning). Not available on Windows.
+ *
+ */
+
+#ifndef COLUMN_STORE_H_
+#define COLUMN_STORE_H_
+
+#include <RcppArmadillo.h>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "single_include/nlohmann/json.hpp"
+using json = nlohmann::json;
+
+namespace colstore
+{
+
+const std::string  MAGIC     = "CBCOLST1";
+const unsigned int ALIGNMENT = 64;
+
+struct ColumnInfo
+{
+  std::string              name;
+  std::string              type;
+  uint64_t                 offset = 0;
+  double                   min    = 0;
+  double                   max    = 0;
+  std::vector<std::string> levels;
+};
+
+/**
+ * \class ColumnStore
+ *
+ * \brief Read-only view on a mapped column store file
+ */
+class ColumnStore
+{
+private:
+  const std::string _path;
+
+  char*    _ptr_map = nullptr;
+  uint64_t _nbytes  = 0;
+  uint64_t _nrows   = 0;
+
+  std::map<std::string, ColumnInfo> _columns;
+  std::vector<std::string>          _column_names;
+
+  void              readHeader       ();
+  const ColumnInfo& getColumnChecked (const std::string&, const std::string&) const;
+
+public:
+  ColumnStore (const std::string);
+
+  std::string              getPath        () const;
+  unsigned int             getNRows       () const;
+  std::vector<std::string> getColumnNames () const;
+  ColumnInfo               getColumn      (const std::string&) const;
+  double                   getMappedBytes () const;
+
+  const double*            numericColumn  (const std::string&) const;
+  const uint32_t*          codeColumn     (const std::string&) const;
+
+  double residentBytes (const std::string&) const;
+  void   advise        (const std::string&, const std::string&) const;
+
+  ~ColumnStore ();
+};
+
+/**
+ * \class ColumnStoreWriter
+ *
+ * \brief Write columns into a new column store file
+ *
+ * Each column is written when it is added, hence just one column has to fit
+ * into the RAM. The header is written into a reserved region at the start of
+ * the file by `close()`, which then moves the file to its path.
+ */
+class ColumnStoreWriter
+{
+private:
+  const std::string _path;
+  const std::string _tmp_path;
+  const uint64_t    _header_bytes;
+
+  std::ofstream           _out;
+  uint64_t                _offset = 0;
+  unsigned int            _nrows  = 0;
+  std::vector<ColumnInfo> _columns;
+  bool                    _is_closed = false;
+
+  void addColumn (ColumnInfo&, const char*, const uint64_t);
+
+public:
+  ColumnStoreWriter (const std::string, const uint64_t);
+
+  void addNumeric     (const std::string, const arma::vec&);
+  void addCategorical (const std::string, const std::vector<std::string>&);
+  void close          ();
+
+  ~ColumnStoreWriter ();
+};
+
+std::shared_ptr<ColumnStore> openColumnStore (const std::string);
+
+} // namespace colstore
+
+#endif // COLUMN_STORE_H_
@@ -55,7 +55,19 @@ Compboost::Compboost (const json& j, const mdata& mdsource, const mdata& mdinit)
     _risk              ( j["_risk"].get<std::vector<double>>() ),
     _sh_ptr_factory_list ( std::make_shared<blearnerlist::BaselearnerFactoryList>(j["_sh_ptr_factory_list"], mdsource, mdinit) ),
     _blearner_track      ( blearnertrack::BaselearnerTrack(j["_blearner_track"], mdinit) )
-{ }
+{
+  if (j.contains("_importance")) {
+    for (auto& it : j["_importance"].items()) {
+      FactoryImportance imp;
+      imp.risk_reduction  = it.value()["risk_reduction"].get<double>();
+      imp.selections      = it.value()["selections"].get<unsigned int>();
+      imp.l2_contribution = it.value()["l2_contribution"].get<double>();
+      _importance[ it.key() ] = imp;
+    }
+  } else {
+    rebuildImportance();
+  }
+}
     // LAMBDAS FOR DEBUGGING:
     //_is_global_stopper ( [](json j) -> bool {
         //std::cout << "Create '_is_global_stopper'" << std::endl;
@@ -96,24 +108,48 @@ void Compboost::train (const unsigned int trace, const std::shared_ptr<loggerlis
   }
 
   bool is_stopc_reached = false;
+
+  // Training updates the prediction scores directly:
+  _scores_match_parameter = false;
   unsigned int k = 1;
 
+  // The profiler is just available if a `LoggerProfile` is registered. Otherwise,
+  // all timer are no-ops:
+  auto sh_ptr_profiler = sh_ptr_loggerlist->getProfiler();
+  _sh_ptr_optimizer->setProfiler(sh_ptr_profiler);
+
   // Main Algorithm. While the stop criteria isn't fulfilled, run the
   // algorithm:
   while (! is_stopc_reached) {
 
-    _current_iter = _blearner_track.getBaselearnerVector().size() + 1;
-
-    _sh_ptr_response->setIteration(_current_iter);
-    _sh_ptr_response->updatePseudoResiduals(_sh_ptr_loss);
-    _sh_ptr_optimizer->optimize(_current_iter, _learning_rate, _sh_ptr_loss, _sh_ptr_response,
-      _blearner_track, _sh_ptr_factory_list);
-
-    sh_ptr_loggerlist->logCurrent(_current_iter, _sh_ptr_response, _blearner_track.getBaselearnerVector().back(),
-      _learning_rate, _sh_ptr_optimizer->getStepSize(_current_iter), _sh_ptr_optimizer, _sh_ptr_factory_list);
+    _current_iter = _blearner_track.getNumberOfIterations() + 1;
+    if (sh_ptr_profiler != nullptr) sh_ptr_profiler->setIteration(_current_iter);
+
+    {
+      profiler::ScopedTimer timer(sh_ptr_profiler, "pseudo_residuals", "train");
+      _sh_ptr_response->setIteration(_current_iter);
+      _sh_ptr_response->updatePseudoResiduals(_sh_ptr_loss);
+    }
+    {
+      profiler::ScopedTimer timer(sh_ptr_profiler, "optimize", "train");
+      _sh_ptr_optimizer->optimize(_current_iter, _learning_rate, _sh_ptr_loss, _sh_ptr_response,
+        _blearner_track, _sh_ptr_factory_list);
+    }
+    {
+      profiler::ScopedTimer timer(sh_ptr_profiler, "logging", "train");
+      sh_ptr_loggerlist->logCurrent(_current_iter, _sh_ptr_response, _blearner_track.getBaselearnersOfLastIteration(),
+        _learning_rate, _sh_ptr_optimizer->getStepSize(_current_iter), _sh_ptr_optimizer, _sh_ptr_factory_list);
+    }
 
     // Calculate and log risk:
-    _risk.push_back(_sh_ptr_response->calculateEmpiricalRisk(_sh_ptr_loss));
+    {
+      profiler::ScopedTimer timer(sh_ptr_profiler, "risk", "train");
+      _risk.push_back(_sh_ptr_response->calculateEmpiricalRisk(_sh_ptr_loss));
+    }
+    {
+      profiler::ScopedTimer timer(sh_ptr_profiler, "importance", "train");
+      updateImportance();
+    }
 
     // Get status of the algorithm (is the stopping criteria reached?). The negation here
     // seems a bit weird, but it makes the while loop easier to read:
@@ -134,6 +170,7 @@ void Compboost::trainCompboost (const unsigned int trace)
   // Make sure, that the selected baselearner and logger data is empty:
   _blearner_track.clearBaselearnerVector();
   _sh_ptr_loggerlist->clearLoggerData();
+  _importance.clear();
 
   // Calculate risk for initial model:
   _risk.push_back(_sh_ptr_response->calculateEmpiricalRisk(_sh_ptr_loss));
@@ -167,24 +204,24 @@ void Compboost::continueTraining (const unsigned int trace)
     Rcpp::stop("Initial training hasn't been done yet. Use 'train()' first.");
   }
   helper::debugPrint("| > Check if new base-learner needs to be trained");
-  if (_current_iter != _blearner_track.getBaselearnerVector().size()) {
-    unsigned int iter_max = _blearner_track.getBaselearnerVector().size();
+  if (_current_iter != _blearner_track.getNumberOfIterations()) {
+    unsigned int iter_max = _blearner_track.getNumberOfIterations();
     setToIteration(iter_max, -1);
   }
   helper::debugPrint("| > Train new base-learner");
   train(trace, _sh_ptr_loggerlist);
 
   // Update actual state:
-  _current_iter = _blearner_track.getBaselearnerVector().size();
+  _current_iter = _blearner_track.getNumberOfIterations();
   helper::debugPrint("| > Update iteration");
   helper::debugPrint("Finished 'Compboost::continueTraining'");
 }
 
-arma::vec Compboost::getPrediction (const bool& as_response) const
+arma::mat Compboost::getPrediction (const bool& as_response) const
 {
   assertPMode();
 
-  arma::vec pred;
+  arma::mat pred;
   if (as_response) {
     return _sh_ptr_response->getPredictionTransform();
   } else {
@@ -199,20 +236,42 @@ std::map<std::string, arma::mat> Compboost::getParameter () const
 
 std::vector<std::string> Compboost::getSelectedBaselearner () const
 {
+  // With block updates, all base learners of an iteration are returned:
+  unsigned int n_entries = _blearner_track.getEntriesOfIteration(_current_iter);
+
   std::vector<std::string> selected_blearner_names;
+  selected_blearner_names.reserve(n_entries);
+
+  for (unsigned int i = 0; i < n_entries; i++) {
+    selected_blearner_names.push_back(_blearner_track.getFactoryIdOfIteration(i));
+  }
+  return selected_blearner_names;
+}
 
-  auto bl_track = _blearner_track.getBaselearnerVector();
-  std::string id_data;
-  std::string bl_type;
+/**
+ * \brief One label per iteration, base learners of a block update are joined by " + "
+ */
+std::vector<std::string> Compboost::getSelectedBaselearnerPerIteration () const
+{
+  std::vector<std::string> selected_blearner_names;
+  selected_blearner_names.reserve(_current_iter);
 
   for (unsigned int i = 0; i < _current_iter; i++) {
-    id_data = bl_track[i]->getDataIdentifier();
-    bl_type = bl_track[i]->getBaselearnerType();
-    selected_blearner_names.push_back(id_data + "_" + bl_type);
+    auto entries = _blearner_track.getEntryRangeOfIteration(i);
+    std::string label = _blearner_track.getFactoryIdOfIteration(entries.first);
+    for (unsigned int e = entries.first + 1; e < entries.second; e++) {
+      label += " + " + _blearner_track.getFactoryIdOfIteration(e);
+    }
+    selected_blearner_names.push_back(label);
   }
   return selected_blearner_names;
 }
 
+unsigned int Compboost::getCurrentIteration () const
+{
+  return _current_iter;
+}
+
 std::shared_ptr<loggerlist::LoggerList> Compboost::getLoggerList () const
 {
   return _sh_ptr_loggerlist;
@@ -228,6 +287,60 @@ std::pair<std::vector<std::string>, arma::mat> Compboost::getParameterMatrix ()
   return _blearner_track.getParameterMatrix();
 }
 
+const blearnertrack::BaselearnerTrack& Compboost::getBaselearnerTrack () const
+{
+  return _blearner_track;
+}
+
+std::map<std::string, FactoryImportance> Compboost::getFeatureImportance () const
+{
+  return _importance;
+}
+
+/**
+ * \brief Add the last iteration to the importance of the selected factory
+ *
+ * Must be called after the risk of the iteration is appended to `_risk`. The
+ * L2 contribution is the norm of the update the optimizer added to the scores.
+ * The risk reduction is signed, an iteration that increases the risk lowers
+ * the importance. Both cannot be attributed to the base learners of a block
+ * update and are therefore shared equally.
+ */
+void Compboost::updateImportance ()
+{
+  auto   entries = _blearner_track.getEntryRangeOfIteration(_blearner_track.getNumberOfIterations() - 1);
+  double share   = 1.0 / (entries.second - entries.first);
+  double l2      = _sh_ptr_response->getLastUpdateNorm();
+  for (unsigned int e = entries.first; e < entries.second; e++) {
+    FactoryImportance& imp = _importance[ _blearner_track.getFactoryIdOfIteration(e) ];
+
+    imp.risk_reduction  += share * (_risk[_risk.size() - 2] - _risk.back());
+    imp.selections      += 1;
+    imp.l2_contribution += share * l2;
+  }
+}
+
+/**
+ * \brief Rebuild the importance from the risk and the track
+ *
+ * Used for models saved without importance. The L2 contribution requires the
+ * prediction scores of each iteration and is therefore not available.
+ */
+void Compboost::rebuildImportance ()
+{
+  _importance.clear();
+  unsigned int n_iter = std::min<unsigned int>(_blearner_track.getNumberOfIterations(), _risk.size() - 1);
+  for (unsigned int i = 0; i < n_iter; i++) {
+    auto   entries = _blearner_track.getEntryRangeOfIteration(i);
+    double share   = 1.0 / (entries.second - entries.first);
+    for (unsigned int e = entries.first; e < entries.second; e++) {
+      FactoryImportance& imp = _importance[ _blearner_track.getFactoryIdOfIteration(e) ];
+      imp.risk_reduction += share * (_risk[i] - _risk[i + 1]);
+      imp.selections     += 1;
+    }
+  }
+}
+
 arma::mat Compboost::predictFactory (const std::string& factory_id) const
 {
   assertPMode();
@@ -259,7 +372,7 @@ std::map<std::string, arma::mat> Compboost::predictIndividual () const
   return out;
 }
 
-arma::vec Compboost::predict () const
+arma::mat Compboost::predict () const
 {
   // Throw an error if production mode is on:
   assertPMode();
@@ -275,6 +388,50 @@ arma::vec Compboost::predict () const
   return pred;
 }
 
+/**
+ * \brief Prediction on the training data of the difference of two parameter maps
+ *
+ * Just factories with a changed parameter are predicted. Ids that are missing
+ * in one of the maps are treated as zero parameter.
+ */
+arma::mat Compboost::predictParameterDelta (const std::map<std::string, arma::mat>& pmap_old, const std::map<std::string, arma::mat>& pmap_new) const
+{
+  arma::mat scores = _sh_ptr_response->getPredictionScores();
+  arma::mat delta(scores.n_rows, scores.n_cols, arma::fill::zeros);
+
+  std::set<std::string> ids;
+  for (auto& it : pmap_old) ids.insert(it.first);
+  for (auto& it : pmap_new) ids.insert(it.first);
+
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+  for (auto& id : ids) {
+    auto it_old = pmap_old.find(id);
+    auto it_new = pmap_new.find(id);
+
+    arma::mat par_diff;
+    if (it_old == pmap_old.end()) {
+      par_diff = it_new->second;
+    } else if (it_new == pmap_new.end()) {
+      par_diff = -it_old->second;
+    } else {
+      par_diff = it_new->second - it_old->second;
+    }
+    if (! arma::any(arma::vectorise(par_diff) != 0)) continue;
+
+    auto it_fac = fac_map.find(id);
+    if (it_fac == fac_map.end()) {
+      throw std::range_error("Cannot find factory '" + id + "' in factory map.");
+    }
+    delta += it_fac->second->calculateLinearPredictor(par_diff);
+  }
+  return delta;
+}
+
+void Compboost::setCheckpointInterval (const unsigned int checkpoint_interval)
+{
+  _blearner_track.setCheckpointInterval(checkpoint_interval);
+}
+
 arma::mat Compboost::predictFactory(const std::string& factory_id, const std::map<std::string, std::shared_ptr<data::Data>>& data_map) const
 {
   auto parameter_map = _blearner_track.getParameterMap();
@@ -302,31 +459,217 @@ std::map<std::string, arma::mat> Compboost::predictIndividual (const std::map<st
   return out;
 }
 
-arma::vec Compboost::predict (const std::map<std::string, std::shared_ptr<data::Data>>& data_map, const bool& as_response) const
+arma::mat Compboost::predict (const std::map<std::string, std::shared_ptr<data::Data>>& data_map, const bool& as_response) const
 {
   if (data_map.size() == 0) {
     throw std::range_error("Require data in 'data_map' for prediction.");
   }
-  arma::mat pred(data_map.begin()->second->getNObs(), _sh_ptr_response->getResponse().n_cols, arma::fill::zeros);
+  arma::mat pred(data_map.begin()->second->getNObs(), _sh_ptr_response->getResponseNCols(), arma::fill::zeros);
+  predict(data_map, as_response, pred);
+
+  return pred;
+}
+
+/**
+ * \brief Predict new data into a preallocated matrix
+ *
+ * The matrix must have as many rows as the data and as many columns as the
+ * response, it may use external memory (e.g. of an R matrix). The prediction
+ * of each factory is added as soon as it is calculated, hence just one
+ * prediction of a factory is alive at a time.
+ */
+void Compboost::predict (const std::map<std::string, std::shared_ptr<data::Data>>& data_map, const bool& as_response,
+  arma::mat& pred) const
+{
+  if (data_map.size() == 0) {
+    throw std::range_error("Require data in 'data_map' for prediction.");
+  }
+  if ((pred.n_rows != data_map.begin()->second->getNObs()) || (pred.n_cols != _sh_ptr_response->getResponseNCols())) {
+    throw std::range_error("Prediction matrix must have " + std::to_string(data_map.begin()->second->getNObs())
+      + " rows and " + std::to_string(_sh_ptr_response->getResponseNCols()) + " columns.");
+  }
+  pred.zeros();
 
   if (_sh_ptr_response->getInitialization().n_rows == 1)
     pred = _sh_ptr_response->calculateInitialPrediction(pred);
 
-  auto ind_preds = predictIndividual(data_map);
-
-  for (auto& it : ind_preds)
-    pred += it.second;
+  auto parameter_map = _blearner_track.getParameterMap();
+  auto fac_map       = _sh_ptr_factory_list->getFactoryMap();
+  for (auto& it : parameter_map) {
+    auto it_fac = fac_map.find(it.first);
+    if (it_fac == fac_map.end()) {
+      throw std::range_error("Cannot find factory '" + it.first + "' in factory map.");
+    }
+    pred += it_fac->second->calculateLinearPredictor(it.second, data_map);
+  }
 
-   if (as_response)
+  if (as_response)
     pred = _sh_ptr_response->getPredictionTransform(pred);
+}
 
-  return pred;
+/**
+ * \brief Walk the track once and pass the prediction at the given iterations to `emit`
+ *
+ * The basis of each factory is instantiated once for the new data by predicting
+ * the identity matrix. Afterwards, the contribution of each iteration is added
+ * to the prediction. For the AGBM, the parameter of an iteration is not the sum
+ * of the selected base learners. Therefore, the parameter of each requested
+ * iteration is taken from the optimizer and predicted with the cached bases.
+ * Custom base learners define their own prediction and are not expanded into a
+ * basis. Their accumulated parameter is predicted at each requested iteration in
+ * the same way as by `predict`.
+ */
+void Compboost::stagedPass (const std::map<std::string, std::shared_ptr<data::Data>>& data_map, const std::vector<unsigned int>& iters,
+  const std::function<void(const unsigned int, const arma::mat&)>& emit) const
+{
+  if (data_map.size() == 0) {
+    throw std::range_error("Require data in 'data_map' for prediction.");
+  }
+  unsigned int n_iter = _blearner_track.getNumberOfIterations();
+  for (unsigned int j = 0; j < iters.size(); j++) {
+    if ((iters[j] < 1) || (iters[j] > n_iter)) {
+      throw std::range_error("Requested iteration " + std::to_string(iters[j]) + " is not between 1 and " + std::to_string(n_iter) + ".");
+    }
+    if ((j > 0) && (iters[j] <= iters[j - 1])) {
+      throw std::range_error("Requested iterations must be strictly increasing.");
+    }
+  }
+  if (iters.size() == 0) return;
+
+  arma::mat pred_init(data_map.begin()->second->getNObs(), _sh_ptr_response->getResponse().n_cols, arma::fill::zeros);
+  if (_sh_ptr_response->getInitialization().n_rows == 1)
+    pred_init = _sh_ptr_response->calculateInitialPrediction(pred_init);
+
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+  auto factoryOf = [&fac_map] (const std::string& id) -> const std::shared_ptr<blearnerfactory::BaselearnerFactory>& {
+    auto it_fac = fac_map.find(id);
+    if (it_fac == fac_map.end()) {
+      throw std::range_error("Cannot find factory '" + id + "' in factory map.");
+    }
+    return it_fac->second;
+  };
+  auto isCustom = [&factoryOf] (const std::string& id) -> bool {
+    const std::string model = factoryOf(id)->getBaseModelName();
+    return (model == "custom") || (model == "customcpp");
+  };
+
+  std::map<std::string, StagedBasis> bases;
+  auto basisOf = [&factoryOf, &bases, &data_map] (const std::string& id, const arma::uword n_params) -> const StagedBasis& {
+    auto it = bases.find(id);
+    if (it != bases.end()) return it->second;
+
+    StagedBasis basis;
+    arma::mat design = factoryOf(id)->calculateLinearPredictor(arma::eye<arma::mat>(n_params, n_params), data_map);
+    if (arma::accu(design != 0) < 0.3 * design.n_elem) {
+      basis.sparse     = arma::sp_mat(design);
+      basis.use_sparse = true;
+    } else {
+      basis.dense = design;
+    }
+    return bases.insert(std::make_pair(id, basis)).first->second;
+  };
+
+  if (_sh_ptr_optimizer->getType() != "agbm") {
+    std::vector<std::string>         factory_table = _blearner_track.getFactoryTable();
+    std::vector<const StagedBasis*>  factory_bases(factory_table.size(), nullptr);
+    std::vector<bool>                factory_custom(factory_table.size());
+    for (unsigned int idx = 0; idx < factory_table.size(); idx++) factory_custom[idx] = isCustom(factory_table[idx]);
+
+    // Accumulated parameters of the custom base learners:
+    std::map<unsigned int, arma::mat> custom_params;
+
+    arma::mat    pred = pred_init;
+    unsigned int j    = 0;
+    for (unsigned int i = 0; i < iters.back(); i++) {
+      auto entries = _blearner_track.getEntryRangeOfIteration(i);
+      for (unsigned int e = entries.first; e < entries.second; e++) {
+        unsigned int idx   = _blearner_track.getFactoryIndexOfIteration(e);
+        arma::mat    param = _learning_rate * _blearner_track.getStepSizeOfIteration(e) * _blearner_track.getParameterOfIteration(e);
+
+        if (factory_custom[idx]) {
+          auto it_param = custom_params.find(idx);
+          if (it_param == custom_params.end()) {
+            custom_params[idx] = param;
+          } else {
+            it_param->second += param;
+          }
+          continue;
+        }
+        if (factory_bases[idx] == nullptr) factory_bases[idx] = &basisOf(factory_table[idx], param.n_rows);
+        pred += factory_bases[idx]->linearPredictor(param);
+      }
+      if (iters[j] == i + 1) {
+        if (custom_params.empty()) {
+          emit(j, pred);
+        } else {
+          arma::mat pred_custom = pred;
+          for (auto& it : custom_params) {
+            pred_custom += factoryOf(factory_table[it.first])->calculateLinearPredictor(it.second, data_map);
+          }
+          emit(j, pred_custom);
+        }
+        j++;
+      }
+    }
+  } else {
+    for (unsigned int j = 0; j < iters.size(); j++) {
+      auto pmap = _sh_ptr_optimizer->getParameterAtIteration(iters[j], _learning_rate, _blearner_track);
+      arma::mat pred = pred_init;
+      for (auto& it : pmap) {
+        if (isCustom(it.first)) {
+          pred += factoryOf(it.first)->calculateLinearPredictor(it.second, data_map);
+        } else {
+          pred += basisOf(it.first, it.second.n_rows).linearPredictor(it.second);
+        }
+      }
+      emit(j, pred);
+    }
+  }
+}
+
+arma::mat Compboost::predictStaged (const std::map<std::string, std::shared_ptr<data::Data>>& data_map, const std::vector<unsigned int>& iters,
+  const bool as_response) const
+{
+  std::vector<unsigned int> iters_staged = iters;
+  if (iters_staged.size() == 0) {
+    for (unsigned int i = 1; i <= _blearner_track.getNumberOfIterations(); i++) iters_staged.push_back(i);
+  }
+  arma::mat out;
+  stagedPass(data_map, iters_staged, [this, &out, &iters_staged, as_response] (const unsigned int j, const arma::mat& pred) {
+    if (out.n_elem == 0) out.set_size(pred.n_elem, iters_staged.size());
+    if (as_response) {
+      out.col(j) = arma::vectorise(_sh_ptr_response->getPredictionTransform(pred));
+    } else {
+      out.col(j) = arma::vectorise(pred);
+    }
+  });
+  return out;
+}
+
+arma::vec Compboost::riskStaged (const std::map<std::string, std::shared_ptr<data::Data>>& data_map, const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::vector<unsigned int>& iters) const
+{
+  std::vector<unsigned int> iters_staged = iters;
+  if (iters_staged.size() == 0) {
+    for (unsigned int i = 1; i <= _blearner_track.getNumberOfIterations(); i++) iters_staged.push_back(i);
+  }
+  if ((data_map.size() > 0) && (data_map.begin()->second->getNObs() != sh_ptr_response->getResponse().n_rows)) {
+    throw std::range_error("Number of observations of the data and the response do not match.");
+  }
+  // The prediction scores of the given response are set to the staged
+  // prediction to use its (weighted) empirical risk:
+  arma::vec risk(iters_staged.size());
+  stagedPass(data_map, iters_staged, [&risk, &sh_ptr_response, &sh_ptr_loss, &iters_staged] (const unsigned int j, const arma::mat& pred) {
+    sh_ptr_response->setPredictionScores(pred, iters_staged[j]);
+    risk(j) = sh_ptr_response->calculateEmpiricalRisk(sh_ptr_loss);
+  });
+  return risk;
 }
 
 void Compboost::setToIteration (const unsigned int& k, const unsigned int& trace)
 {
   helper::debugPrint("From 'Compboost::setToIteration'");
-  unsigned int iter_max = _blearner_track.getBaselearnerVector().size();
+  unsigned int iter_max = _blearner_track.getNumberOfIterations();
 
   helper::debugPrint("| > Check if new base-learner needs to be trained");
   if (k > iter_max) {
@@ -341,11 +684,19 @@ void Compboost::setToIteration (const unsigned int& k, const unsigned int& trace
   }
   helper::debugPrint("| > Set base-learner track to the new iteration");
   auto tmp_param_map = _sh_ptr_optimizer->getParameterAtIteration(k, _learning_rate, _blearner_track);
-  _blearner_track.setParameterMap(tmp_param_map);
-  //
-  //_blearner_track.setToIteration(k);
-  helper::debugPrint("| > Set new prediction scores by calling predict()");
-  if (! _pmode) _sh_ptr_response->setPredictionScores(predict(), k);
+  if ((! _pmode) && _scores_match_parameter) {
+    helper::debugPrint("| > Update prediction scores by the prediction of the parameter difference");
+    arma::mat delta = predictParameterDelta(_blearner_track.getParameterMap(), tmp_param_map);
+    _blearner_track.setParameterMap(tmp_param_map);
+    _sh_ptr_response->setPredictionScores(_sh_ptr_response->getPredictionScores() + delta, k);
+  } else {
+    _blearner_track.setParameterMap(tmp_param_map);
+    helper::debugPrint("| > Set new prediction scores by calling predict()");
+    if (! _pmode) {
+      _sh_ptr_response->setPredictionScores(predict(), k);
+      _scores_match_parameter = true;
+    }
+  }
   _current_iter = k;
   helper::debugPrint("Finished 'Compboost::setToIteration'");
 }
@@ -360,6 +711,33 @@ std::vector<double> Compboost::getRiskVector () const
   return _risk;
 }
 
+/**
+ * \brief Heap memory of all model components
+ *
+ * The components are visited in the order response, factories (including the
+ * data), iteration track, optimizer, and logger. Objects shared between
+ * components are assigned to the first component that reports them.
+ */
+memreport::MemoryReport Compboost::memoryReport () const
+{
+  memreport::MemoryReport report;
+
+  _sh_ptr_response->reportMemory(report);
+  _sh_ptr_factory_list->reportMemory(report);
+  _blearner_track.reportMemory(report, "track");
+  _sh_ptr_optimizer->reportMemory(report);
+  _sh_ptr_loggerlist->reportMemory(report);
+  report.add("model", "Compboost", "risk", memreport::stdVecBytes(_risk));
+
+  double imp_bytes = 0;
+  for (auto& it : _importance) {
+    imp_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, FactoryImportance>) + memreport::stringBytes(it.first);
+  }
+  report.add("model", "Compboost", "importance", imp_bytes);
+
+  return report;
+}
+
 bool Compboost::useGlobalStopping () const
 {
   return _is_global_stopper;
@@ -398,7 +776,7 @@ void Compboost::summarizeCompboost () const
   Rcpp::Rcout << "\t- Are all logger used as stopper: " << _is_global_stopper << std::endl;
 
   if (_is_trained) {
-    Rcpp::Rcout << "\t- Model is already trained with " << _blearner_track.getBaselearnerVector().size() << " iterations/fitted baselearner" << std::endl;
+    Rcpp::Rcout << "\t- Model is already trained with " << _blearner_track.getNumberOfIterations() << " iterations/fitted baselearner" << std::endl;
     Rcpp::Rcout << "\t- Actual state is at iteration " << _current_iter << std::endl;
   }
   Rcpp::Rcout << std::endl;
@@ -427,6 +805,13 @@ void Compboost::saveJson (const std::string file, const bool rm_data)
     {"_sh_ptr_factory_list", _sh_ptr_factory_list->toJson()},
     {"_blearner_track",      _blearner_track.toJson()}
   };
+  for (auto& it : _importance) {
+    j["_importance"][it.first] = {
+      {"risk_reduction",  it.second.risk_reduction},
+      {"selections",      it.second.selections},
+      {"l2_contribution", it.second.l2_contribution}
+    };
+  }
 
 
   std::ofstream o(file);
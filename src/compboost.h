@@ -54,6 +54,7 @@
 #include <memory>
 #include <sstream>
 #include <fstream>
+#include <functional>
 
 #include "baselearner_track.h"
 #include "optimizer.h"
@@ -70,6 +71,38 @@ typedef std::map<std::string, sdata> mdata;
 
 namespace cboost {
 
+/**
+ * \brief Design matrix of a factory for new data used by staged prediction
+ *
+ * The basis is kept sparse if most of the entries are zero.
+ */
+struct StagedBasis
+{
+  arma::mat     dense;
+  arma::sp_mat  sparse;
+  bool          use_sparse = false;
+
+  arma::mat linearPredictor (const arma::mat& param) const
+  {
+    if (use_sparse) return arma::mat(sparse * param);
+    return dense * param;
+  }
+};
+
+/**
+ * \brief Importance of one factory accumulated during training
+ *
+ * The risk reduction is the difference of the empirical risk before and after
+ * the iteration, the L2 contribution the L2 norm of the change of the
+ * prediction scores on the training data.
+ */
+struct FactoryImportance
+{
+  double        risk_reduction  = 0;
+  unsigned int  selections      = 0;
+  double        l2_contribution = 0;
+};
+
 class Compboost
 {
 
@@ -83,6 +116,13 @@ private:
    */
   bool _pmode = false;
 
+  /**
+   * Indicates whether the prediction scores of the response are the prediction
+   * of the current parameter map. Then, `setToIteration` just adds the prediction
+   * of the parameter difference instead of predicting from scratch.
+   */
+  bool _scores_match_parameter = false;
+
   const double  _learning_rate;
   const bool    _is_global_stopper;
 
@@ -98,6 +138,11 @@ private:
   std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
   blearnertrack::BaselearnerTrack      _blearner_track;
 
+  std::map<std::string, FactoryImportance> _importance;
+
+  void updateImportance  ();
+  void rebuildImportance ();
+
 public:
   Compboost (std::shared_ptr<response::Response>, const double&, const bool&, std::shared_ptr<optimizer::Optimizer>, std::shared_ptr<loss::Loss>,
     std::shared_ptr<loggerlist::LoggerList>, std::shared_ptr<blearnerlist::BaselearnerFactoryList>);
@@ -106,12 +151,16 @@ public:
   Compboost (const std::string);
 
   // Getter/Setter
-  arma::vec                                       getPrediction (const bool&)                    const;
+  arma::mat                                       getPrediction (const bool&)                    const;
   std::map<std::string, arma::mat>                getParameter ()                                const;
   std::vector<std::string>                        getSelectedBaselearner ()                      const;
+  std::vector<std::string>                        getSelectedBaselearnerPerIteration ()          const;
+  unsigned int                                    getCurrentIteration ()                         const;
   std::shared_ptr<loggerlist::LoggerList>         getLoggerList ()                               const;
   std::map<std::string, arma::mat>                getParameterOfIteration (const unsigned int&)  const;
   std::pair<std::vector<std::string>, arma::mat>  getParameterMatrix ()                          const;
+  const blearnertrack::BaselearnerTrack&          getBaselearnerTrack ()                         const;
+  std::map<std::string, FactoryImportance>        getFeatureImportance ()                        const;
   arma::mat                                       getOffset ()                                   const;
   std::vector<double>                             getRiskVector ()                               const;
 
@@ -128,12 +177,16 @@ public:
   void       train              (const unsigned int, const std::shared_ptr<loggerlist::LoggerList>);
   void       trainCompboost     (const unsigned int);
   void       continueTraining   (const unsigned int);
-  arma::vec  predict            () const;
-  arma::vec  predict            (const std::map<std::string, std::shared_ptr<data::Data>>&, const bool&) const;
+  arma::mat  predict            () const;
+  arma::mat  predict            (const std::map<std::string, std::shared_ptr<data::Data>>&, const bool&) const;
+  void       predict            (const std::map<std::string, std::shared_ptr<data::Data>>&, const bool&, arma::mat&) const;
   void       setToIteration     (const unsigned int&, const unsigned int&);
+  void       setCheckpointInterval (const unsigned int);
   void       summarizeCompboost () const;
   void       assertPMode        () const;
 
+  memreport::MemoryReport memoryReport () const;
+
   // Save JSON, to load use the respective constructor:
   void saveJson (const std::string, const bool = false);
 
@@ -142,6 +195,14 @@ public:
 
   std::map<std::string, arma::mat> predictIndividual () const;
   std::map<std::string, arma::mat> predictIndividual (const std::map<std::string, std::shared_ptr<data::Data>>&) const;
+  arma::mat predictParameterDelta (const std::map<std::string, arma::mat>&, const std::map<std::string, arma::mat>&) const;
+
+  // Staged prediction, i.e. the prediction of new data after each of the given iterations:
+  arma::mat predictStaged (const std::map<std::string, std::shared_ptr<data::Data>>&, const std::vector<unsigned int>&, const bool) const;
+  arma::vec riskStaged    (const std::map<std::string, std::shared_ptr<data::Data>>&, const std::shared_ptr<response::Response>&,
+    const std::shared_ptr<loss::Loss>&, const std::vector<unsigned int>&) const;
+  void      stagedPass    (const std::map<std::string, std::shared_ptr<data::Data>>&, const std::vector<unsigned int>&,
+    const std::function<void(const unsigned int, const arma::mat&)>&) const;
 
   // Destructor:
   ~Compboost ();
@@ -33,6 +33,10 @@
 #include "response.h"
 #include "saver.h"
 #include "init.h"
+#include "planner.h"
+#include "resampling.h"
+#include "sweep.h"
+#include "distributed.h"
 
 #include "single_include/nlohmann/json.hpp"
 using json = nlohmann::json;
@@ -69,6 +73,37 @@ class DataWrapper
     std::shared_ptr<data::Data> sh_ptr_data;
 };
 
+// R objects that are used without a copy are marked as not mutable, hence R
+// duplicates them on modification instead of writing into the shared memory.
+// The returned owner keeps the object protected from the garbage collector:
+std::shared_ptr<void> protectRObject (SEXP x)
+{
+  MARK_NOT_MUTABLE(x);
+  return std::make_shared<Rcpp::RObject>(x);
+}
+
+unsigned int rNRows (SEXP x) { return Rf_isMatrix(x) ? Rf_nrows(x) : Rf_xlength(x); }
+unsigned int rNCols (SEXP x) { return Rf_isMatrix(x) ? Rf_ncols(x) : 1; }
+
+// Budget of a design as returned by `BlearnerFactoryList$getDesignBudget()`, an empty list means no budget:
+chunked::DesignBudget designBudget (const Rcpp::List& budget)
+{
+  chunked::DesignBudget design_budget;
+  if (budget.size() == 0) return design_budget;
+
+  design_budget.dir          = Rcpp::as<std::string>(budget["dir"]);
+  design_budget.free_bytes   = Rcpp::as<double>(budget["free_bytes"]);
+  design_budget.buffer_bytes = Rcpp::as<double>(budget["buffer_bytes"]);
+  return design_budget;
+}
+
+// Vectors are used as one column matrix, other types than double are converted into a copy:
+arma::mat copyRMatrix (SEXP x)
+{
+  Rcpp::NumericVector x_num(x);
+  return arma::mat(x_num.begin(), rNRows(x), rNCols(x));
+}
+
 //' @title Store data in RAM
 //'
 //' @description
@@ -85,8 +120,9 @@ class DataWrapper
 //' InMemoryData$new(data_mat, data_identifier, use_sparse)
 //' }
 //'
-//' @param data_mat (`matrix()`)\cr
-//' The data matrix.
+//' @param data_mat (`matrix()` | `numeric()`)\cr
+//' The data matrix or a numeric vector (used as one column matrix). Double
+//' vectors and matrices are used without a copy, other types are converted.
 //' @param data_identifier (`character(1)`)\cr
 //' Data id, e.g. a feature name.
 //'
@@ -122,9 +158,14 @@ class InMemoryDataWrapper : public DataWrapper
       : DataWrapper::DataWrapper(std::static_pointer_cast<data::InMemoryData>(dw.getDataObj()))
     { }
 
-    InMemoryDataWrapper (arma::mat data_mat, std::string data_identifier)
+    InMemoryDataWrapper (SEXP data_mat, std::string data_identifier)
     {
-      sh_ptr_data = std::make_shared<data::InMemoryData>(data_identifier, data_mat);
+      if (TYPEOF(data_mat) == REALSXP) {
+        sh_ptr_data = std::make_shared<data::InMemoryData>(data_identifier, REAL(data_mat), rNRows(data_mat),
+          rNCols(data_mat), protectRObject(data_mat));
+      } else {
+        sh_ptr_data = std::make_shared<data::InMemoryData>(data_identifier, copyRMatrix(data_mat));
+      }
     }
 
     InMemoryDataWrapper (arma::mat data_mat, std::string data_identifier, bool use_sparse)
@@ -135,7 +176,7 @@ class InMemoryDataWrapper : public DataWrapper
 
     arma::mat getData () const
     {
-      return sh_ptr_data->getDenseData();
+      return sh_ptr_data->getData();
     }
 
     std::string getIdentifier () const
@@ -145,6 +186,144 @@ class InMemoryDataWrapper : public DataWrapper
 };
 
 
+//' @title Memory-mapped column store
+//'
+//' @description
+//' [ColumnStore] opens a column store file written by [writeColumnStore()] or
+//' [ColumnStoreWriter]. The file is memory-mapped, the pages are loaded on first
+//' access and shared by all processes that open the same file. Columns are used as
+//' data source with [MappedData] (numeric) and [CategoricalDataRaw] (categorical).
+//' Not available on Windows.
+//'
+//' @format [S4] object.
+//' @name ColumnStore
+//'
+//' @section Usage:
+//' \preformatted{
+//' ColumnStore$new(path)
+//' }
+//'
+//' @param path (`character(1)`)\cr
+//' File of the column store.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getPath()`: `() -> character(1)`
+//' * `$getNRows()`: `() -> integer(1)`
+//' * `$getColumnNames()`: `() -> character()`
+//' * `$getColumnInfo()`: `character(1) -> list()` Type, minimum, maximum, and levels of a column.
+//' * `$getMappedBytes()`: `() -> numeric(1)` Size of the file.
+//' * `$getResidentBytes()`: `character(1) -> numeric(1)` Bytes of the column in the page cache.
+//' * `$advise()`: `character(1), character(1) -> ()` Advise the kernel about the access to
+//'   a column (`"sequential"`, `"willneed"`, or `"dontneed"`).
+//'
+//' @examples
+//' \dontrun{
+//' path = tempfile(fileext = ".cbcol")
+//' writeColumnStore(iris, path)
+//' store = ColumnStore$new(path)
+//' store$getColumnInfo("Species")
+//' }
+//' @export ColumnStore
+class ColumnStoreWrapper
+{
+  private:
+    std::shared_ptr<colstore::ColumnStore> sh_ptr_store;
+
+  public:
+    ColumnStoreWrapper (std::string path)
+      : sh_ptr_store ( colstore::openColumnStore(path) )
+    { }
+
+    std::shared_ptr<colstore::ColumnStore> getStore () const { return sh_ptr_store; }
+
+    std::string              getPath        () const { return sh_ptr_store->getPath(); }
+    unsigned int             getNRows       () const { return sh_ptr_store->getNRows(); }
+    std::vector<std::string> getColumnNames () const { return sh_ptr_store->getColumnNames(); }
+    double                   getMappedBytes () const { return sh_ptr_store->getMappedBytes(); }
+
+    double getResidentBytes (std::string column) const { return sh_ptr_store->residentBytes(column); }
+    void   advise (std::string column, std::string advice) const { sh_ptr_store->advise(column, advice); }
+
+    Rcpp::List getColumnInfo (std::string column) const
+    {
+      colstore::ColumnInfo info = sh_ptr_store->getColumn(column);
+      return Rcpp::List::create(
+        Rcpp::Named("name")   = info.name,
+        Rcpp::Named("type")   = info.type,
+        Rcpp::Named("min")    = info.min,
+        Rcpp::Named("max")    = info.max,
+        Rcpp::Named("levels") = info.levels
+      );
+    }
+};
+
+
+//' @title Write a column store
+//'
+//' @description
+//' [ColumnStoreWriter] writes columns into a column store file that can be
+//' opened with [ColumnStore]. Numeric columns are stored as doubles,
+//' categorical columns as integer codes with the sorted levels as dictionary.
+//' Each column is written to the file when it is added, hence tables larger
+//' than the RAM can be written column by column. The header is written by
+//' `$close()`, the file can't be opened before. See also [writeColumnStore()]
+//' to write a `data.frame`.
+//'
+//' @format [S4] object.
+//' @name ColumnStoreWriter
+//'
+//' @section Usage:
+//' \preformatted{
+//' ColumnStoreWriter$new(path)
+//' ColumnStoreWriter$new(path, header_bytes)
+//' }
+//'
+//' @section Arguments:
+//' \describe{
+//' \item{`path` (`character(1)`)}{
+//'   File of the column store. An existing file is replaced by `$close()`, stores that are
+//'   already open keep reading the old file.
+//' }
+//' \item{`header_bytes` (`numeric(1)`)}{
+//'   Bytes reserved for the header with the column names and levels, the
+//'   default is 1 MiB.
+//' }
+//' }
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$addNumeric()`: `character(1), numeric() -> ()`
+//' * `$addCategorical()`: `character(1), character() -> ()`
+//' * `$close()`: `() -> ()`
+//'
+//' @export ColumnStoreWriter
+class ColumnStoreWriterWrapper
+{
+  private:
+    colstore::ColumnStoreWriter writer;
+
+  public:
+    ColumnStoreWriterWrapper (std::string path) : writer ( path, 1048576 ) { }
+
+    ColumnStoreWriterWrapper (std::string path, double header_bytes)
+      : writer ( path, static_cast<uint64_t>(header_bytes) ) { }
+
+    void addNumeric (std::string name, arma::vec x) { writer.addNumeric(name, x); }
+
+    void addCategorical (std::string name, Rcpp::StringVector x)
+    {
+      writer.addCategorical(name, Rcpp::as< std::vector<std::string> >(x));
+    }
+
+    void close () { writer.close(); }
+};
+
+
 //' @title Data class for categorical variables
 //'
 //' @description
@@ -157,10 +336,16 @@ class InMemoryDataWrapper : public DataWrapper
 //' @section Usage:
 //' \preformatted{
 //' CategoricalDataRaw$new(x, data_identifier)
+//' CategoricalDataRaw$new(store, column, data_identifier)
 //' }
 //'
-//' @param x (`character()`)\cr
-//' Categorical vector.
+//' @param x (`character()` | `factor()`)\cr
+//' Categorical vector. The integer codes of a factor are used without a copy.
+//' @param store ([ColumnStore])\cr
+//' Column store with a categorical column. The codes are mapped and translated
+//' into classes when a factory is built.
+//' @param column (`character(1)`)\cr
+//' Name of the categorical column.
 //' @param data_identifier (`character(1)`)\cr
 //' Data id, e.g. a feature name.
 //'
@@ -198,10 +383,21 @@ class CategoricalDataRawWrapper : public DataWrapper
       sh_ptr_data = _sh_ptr_rawcdata;
     }
 
-    CategoricalDataRawWrapper (Rcpp::StringVector classes, std::string data_identifier)
+    CategoricalDataRawWrapper (SEXP classes, std::string data_identifier)
+    {
+      if (Rf_isFactor(classes)) {
+        std::vector<std::string> levels = Rcpp::as< std::vector<std::string> >(Rf_getAttrib(classes, R_LevelsSymbol));
+        _sh_ptr_rawcdata = std::make_shared<data::CategoricalDataRaw>(data_identifier, INTEGER(classes),
+          Rf_xlength(classes), levels, protectRObject(classes));
+      } else {
+        std::vector<std::string> str_classes = Rcpp::as< std::vector<std::string> >(Rcpp::StringVector(classes));
+        _sh_ptr_rawcdata = std::make_shared<data::CategoricalDataRaw>(data_identifier, str_classes);
+      }
+    }
+
+    CategoricalDataRawWrapper (ColumnStoreWrapper& store, std::string column, std::string data_identifier)
     {
-      std::vector<std::string> str_classes = Rcpp::as< std::vector<std::string> >(classes);
-      _sh_ptr_rawcdata = std::make_shared<data::CategoricalDataRaw>(data_identifier, str_classes);
+      _sh_ptr_rawcdata = std::make_shared<data::CategoricalDataRaw>(data_identifier, store.getStore(), column);
     }
 
     std::shared_ptr<data::CategoricalDataRaw> getCDataRawPtr () const
@@ -231,7 +427,84 @@ class CategoricalDataRawWrapper : public DataWrapper
 };
 
 
+//' @title Numeric column of a column store
+//'
+//' @description
+//' [MappedData] uses a numeric column of a [ColumnStore] as data source. The
+//' column is not copied into the R session, the factories read the mapped
+//' memory directly when they build the (binned) design. Use binning
+//' (`bin_root = 2`) to keep the design small for large columns.
+//'
+//' @format [S4] object.
+//' @name MappedData
+//'
+//' @section Usage:
+//' \preformatted{
+//' MappedData$new(store, column)
+//' MappedData$new(store, column, data_identifier)
+//' }
+//'
+//' @param store ([ColumnStore])\cr
+//' The opened column store.
+//' @param column (`character(1)`)\cr
+//' Name of the numeric column.
+//' @param data_identifier (`character(1)`)\cr
+//' Data id, by default the name of the column.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getData()`: `() -> matrix()`
+//' * `$getIdentifier()`: `() -> character(1)`
+//' * `$getColumn()`: `() -> character(1)`
+//' @template section-data-base-methods
+//'
+//' @examples
+//' \dontrun{
+//' path = tempfile(fileext = ".cbcol")
+//' writeColumnStore(mtcars, path)
+//' store = ColumnStore$new(path)
+//'
+//' fac = BaselearnerPSpline$new(MappedData$new(store, "hp"), list(bin_root = 2))
+//' }
+//' @export MappedData
+class MappedDataWrapper : public DataWrapper
+{
+  public:
+    MappedDataWrapper (DataWrapper& dw)
+      : DataWrapper::DataWrapper(std::static_pointer_cast<data::MappedData>(dw.getDataObj()))
+    { }
+
+    MappedDataWrapper (ColumnStoreWrapper& store, std::string column)
+    {
+      sh_ptr_data = std::make_shared<data::MappedData>(column, store.getStore(), column);
+    }
+
+    MappedDataWrapper (ColumnStoreWrapper& store, std::string column, std::string data_identifier)
+    {
+      sh_ptr_data = std::make_shared<data::MappedData>(data_identifier, store.getStore(), column);
+    }
+
+    arma::mat getData () const
+    {
+      return sh_ptr_data->getData();
+    }
+
+    std::string getIdentifier () const
+    {
+      return sh_ptr_data->getDataIdentifier();
+    }
+
+    std::string getColumn () const
+    {
+      return std::static_pointer_cast<data::MappedData>(sh_ptr_data)->getColumn();
+    }
+};
+
+
 RCPP_EXPOSED_CLASS(DataWrapper)
+RCPP_EXPOSED_CLASS(ColumnStoreWrapper)
 RCPP_EXPOSED_CLASS(CategoricalDataRawWrapper)
 RCPP_MODULE (data_module)
 {
@@ -247,7 +520,7 @@ RCPP_MODULE (data_module)
 
     .constructor ()
     .constructor<DataWrapper&> ()
-    .constructor<arma::mat, std::string> ()
+    .constructor<SEXP, std::string> ()
     .constructor<arma::mat, std::string, bool> ()
 
     .method("getData",       &InMemoryDataWrapper::getData)
@@ -258,12 +531,46 @@ RCPP_MODULE (data_module)
     .derives<DataWrapper> ("Data")
 
     .constructor<DataWrapper&> ()
-    .constructor<Rcpp::StringVector, std::string> ()
+    .constructor<SEXP, std::string> ()
+    .constructor<ColumnStoreWrapper&, std::string, std::string> ()
 
     .method("getData",       &CategoricalDataRawWrapper::getData)
     .method("getRawData",    &CategoricalDataRawWrapper::getRawData)
     .method("getIdentifier", &CategoricalDataRawWrapper::getIdentifier)
   ;
+
+  class_<ColumnStoreWrapper> ("ColumnStore")
+    .constructor<std::string> ()
+
+    .method("getPath",          &ColumnStoreWrapper::getPath)
+    .method("getNRows",         &ColumnStoreWrapper::getNRows)
+    .method("getColumnNames",   &ColumnStoreWrapper::getColumnNames)
+    .method("getColumnInfo",    &ColumnStoreWrapper::getColumnInfo)
+    .method("getMappedBytes",   &ColumnStoreWrapper::getMappedBytes)
+    .method("getResidentBytes", &ColumnStoreWrapper::getResidentBytes)
+    .method("advise",           &ColumnStoreWrapper::advise)
+  ;
+
+  class_<ColumnStoreWriterWrapper> ("ColumnStoreWriter")
+    .constructor<std::string> ()
+    .constructor<std::string, double> ()
+
+    .method("addNumeric",     &ColumnStoreWriterWrapper::addNumeric)
+    .method("addCategorical", &ColumnStoreWriterWrapper::addCategorical)
+    .method("close",          &ColumnStoreWriterWrapper::close)
+  ;
+
+  class_<MappedDataWrapper> ("MappedData")
+    .derives<DataWrapper> ("Data")
+
+    .constructor<DataWrapper&> ()
+    .constructor<ColumnStoreWrapper&, std::string> ()
+    .constructor<ColumnStoreWrapper&, std::string, std::string> ()
+
+    .method("getData",       &MappedDataWrapper::getData)
+    .method("getIdentifier", &MappedDataWrapper::getIdentifier)
+    .method("getColumn",     &MappedDataWrapper::getColumn)
+  ;
 }
 
 
@@ -325,8 +632,8 @@ class BaselearnerFactoryWrapper
 //'
 //' @section Usage:
 //' \preformatted{
-//' BaselearnerPolynomial$new(data_source, list(degree, intercept, bin_root))
-//' BaselearnerPolynomial$new(data_source, blearner_type, list(degree, intercept, bin_root))
+//' BaselearnerPolynomial$new(data_source, list(degree, intercept, bin_root, memory_budget))
+//' BaselearnerPolynomial$new(data_source, blearner_type, list(degree, intercept, bin_root, memory_budget))
 //' }
 //'
 //' @param data_source ([InMemoryData]) \cr
@@ -340,6 +647,7 @@ class BaselearnerFactoryWrapper
 //' @param intercept (`logical(1)`)\cr
 //' Polynomial degree.
 //' @template param-bin_root
+//' @template param-memory_budget
 //'
 //' @section Fields:
 //' This class doesn't contain public fields.
@@ -410,7 +718,8 @@ class BaselearnerPolynomialFactoryWrapper : public BaselearnerFactoryWrapper
     Rcpp::List internal_arg_list = Rcpp::List::create(
       Rcpp::Named("degree") = 1,
       Rcpp::Named("intercept") = true,
-      Rcpp::Named("bin_root") = 0);
+      Rcpp::Named("bin_root") = 0,
+      Rcpp::Named("memory_budget") = Rcpp::List());
 
   public:
     BaselearnerPolynomialFactoryWrapper (BaselearnerFactoryWrapper& blf)
@@ -429,7 +738,8 @@ class BaselearnerPolynomialFactoryWrapper : public BaselearnerFactoryWrapper
       std::string blearner_type_temp = "poly" + std::to_string(degree);
 
       sh_ptr_blearner_factory = std::make_shared<blearnerfactory::BaselearnerPolynomialFactory>(blearner_type_temp, data_source.getDataObj(),
-         internal_arg_list["degree"], internal_arg_list["intercept"], internal_arg_list["bin_root"]);
+         internal_arg_list["degree"], internal_arg_list["intercept"], internal_arg_list["bin_root"], 0, 0,
+         designBudget(internal_arg_list["memory_budget"]));
     }
 
     BaselearnerPolynomialFactoryWrapper (DataWrapper& data_source,
@@ -438,7 +748,8 @@ class BaselearnerPolynomialFactoryWrapper : public BaselearnerFactoryWrapper
       internal_arg_list = helper::argHandler(internal_arg_list, arg_list, TRUE);
 
       sh_ptr_blearner_factory = std::make_shared<blearnerfactory::BaselearnerPolynomialFactory>(blearner_type, data_source.getDataObj(),
-        internal_arg_list["degree"], internal_arg_list["intercept"], internal_arg_list["bin_root"]);
+        internal_arg_list["degree"], internal_arg_list["intercept"], internal_arg_list["bin_root"], 0, 0,
+        designBudget(internal_arg_list["memory_budget"]));
     }
 
     void summarizeFactory ()
@@ -498,8 +809,8 @@ class BaselearnerPolynomialFactoryWrapper : public BaselearnerFactoryWrapper
 //'
 //' @section Usage:
 //' \preformatted{
-//' BaselearnerPSpline$new(data_source, list(degree, n_knots, penalty, differences, df, bin_root))
-//' BaselearnerPSpline$new(data_source, blearner_type, list(degree, n_knots, penalty, differences, df, bin_root))
+//' BaselearnerPSpline$new(data_source, list(degree, n_knots, penalty, differences, df, bin_root, memory_budget))
+//' BaselearnerPSpline$new(data_source, blearner_type, list(degree, n_knots, penalty, differences, df, bin_root, memory_budget))
 //' }
 //'
 //' @param data_source ([InMemoryData]) \cr
@@ -519,6 +830,7 @@ class BaselearnerPolynomialFactoryWrapper : public BaselearnerFactoryWrapper
 //' The number of differences to are penalized. A higher value leads to smoother curves.
 //' @template param-df
 //' @template param-bin_root
+//' @template param-memory_budget
 //'
 //' @section Fields:
 //' This class doesn't contain public fields.
@@ -604,7 +916,8 @@ class BaselearnerPSplineFactoryWrapper : public BaselearnerFactoryWrapper
       Rcpp::Named("df") = 0,
       Rcpp::Named("differences") = 2,
       Rcpp::Named("bin_root") = 0,
-      Rcpp::Named("cache_type") = "cholesky"
+      Rcpp::Named("cache_type") = "cholesky",
+      Rcpp::Named("memory_budget") = Rcpp::List()
     );
 
   public:
@@ -625,7 +938,7 @@ class BaselearnerPSplineFactoryWrapper : public BaselearnerFactoryWrapper
       sh_ptr_blearner_factory = std::make_shared<blearnerfactory::BaselearnerPSplineFactory>(blearner_type_temp,
         data_source.getDataObj(), internal_arg_list["degree"], internal_arg_list["n_knots"], internal_arg_list["penalty"],
         internal_arg_list["df"], internal_arg_list["differences"], true, internal_arg_list["bin_root"],
-        internal_arg_list["cache_type"]);
+        internal_arg_list["cache_type"], designBudget(internal_arg_list["memory_budget"]));
     }
 
     BaselearnerPSplineFactoryWrapper (DataWrapper& data_source, const std::string& blearner_type, Rcpp::List arg_list)
@@ -634,7 +947,7 @@ class BaselearnerPSplineFactoryWrapper : public BaselearnerFactoryWrapper
 
       sh_ptr_blearner_factory = std::make_shared<blearnerfactory::BaselearnerPSplineFactory>(blearner_type, data_source.getDataObj(),
         internal_arg_list["degree"], internal_arg_list["n_knots"], internal_arg_list["penalty"], internal_arg_list["df"], internal_arg_list["differences"], true,
-        internal_arg_list["bin_root"], internal_arg_list["cache_type"]);
+        internal_arg_list["bin_root"], internal_arg_list["cache_type"], designBudget(internal_arg_list["memory_budget"]));
     }
 
     void summarizeFactory ()
@@ -1556,6 +1869,24 @@ RCPP_MODULE (baselearner_factory_module)
 //'   big matrix.}
 //' \item{\code{getNumberOfRegisteredFactories()}}{Get the number of registered
 //'   factories.}
+//' \item{\code{spillDesigns(dir, budget)}}{Stream the designs of non-binned
+//'   factories from files in \code{dir} to keep the designs within
+//'   \code{budget} bytes. A quarter of the budget is used for the two buffered
+//'   blocks of rows of a streamed design, the smallest designs are kept in memory
+//'   as long as the rest of the budget allows. Binned designs and designs of
+//'   custom base learners stay in memory. Returns a \code{data.frame} with the
+//'   streamed factories, the rows per block, the number of blocks, and the
+//'   bytes of the file and of the buffers.}
+//' \item{\code{setMemoryBudget(dir, budget)}}{Spill the designs as
+//'   \code{spillDesigns()} and keep the budget for the factories that are
+//'   registered later. Returns \code{getStreamedDesigns()}.}
+//' \item{\code{getDesignBudget()}}{Get the budget that is left for the design
+//'   of the next factory as \code{list(dir, free_bytes, buffer_bytes)}, see
+//'   the \code{memory_budget} argument of [BaselearnerPSpline]. Factories that
+//'   get the budget build a design that does not fit in blocks of rows directly
+//'   on disk. The list is empty without a budget.}
+//' \item{\code{getStreamedDesigns()}}{Get the streamed designs of all factories
+//'   as \code{data.frame} as returned by \code{spillDesigns()}.}
 //' }
 //' @examples
 //' # Sample data:
@@ -1594,6 +1925,31 @@ class BlearnerFactoryListWrapper
   private:
     std::shared_ptr<blearnerlist::BaselearnerFactoryList> obj;
 
+    Rcpp::DataFrame describeDesigns (const std::vector<std::string>& factories) const
+    {
+      blearner_factory_map factory_map = obj->getFactoryMap();
+
+      std::vector<unsigned int> block_rows;
+      std::vector<unsigned int> blocks;
+      std::vector<double>       file_bytes;
+      std::vector<double>       buffer_bytes;
+      for (auto& it : factories) {
+        std::shared_ptr<chunked::ChunkedDesign> sh_ptr_chunks = factory_map[it]->getInstantiatedData()->getChunkedDesign();
+        block_rows.push_back(sh_ptr_chunks->getBlockRows());
+        blocks.push_back(sh_ptr_chunks->getNBlocks());
+        file_bytes.push_back(sh_ptr_chunks->getFileBytes());
+        buffer_bytes.push_back(sh_ptr_chunks->getBufferBytes());
+      }
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("factory")          = factories,
+        Rcpp::Named("block_rows")       = block_rows,
+        Rcpp::Named("blocks")           = blocks,
+        Rcpp::Named("file_bytes")       = file_bytes,
+        Rcpp::Named("buffer_bytes")     = buffer_bytes,
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
+
   public:
 
     BlearnerFactoryListWrapper ()
@@ -1644,6 +2000,39 @@ class BlearnerFactoryListWrapper
     std::vector<std::string> getRegisteredFactoryNames () { return obj->getRegisteredFactoryNames(); }
     std::vector<std::string> getDataNames () { return obj->getDataNames(); }
 
+    Rcpp::DataFrame spillDesigns (const std::string dir, const double budget)
+    {
+      return describeDesigns(obj->spillDesigns(dir, budget));
+    }
+
+    Rcpp::DataFrame setMemoryBudget (const std::string dir, const double budget)
+    {
+      obj->setMemoryBudget(dir, budget);
+      return getStreamedDesigns();
+    }
+
+    Rcpp::List getDesignBudget () const
+    {
+      chunked::DesignBudget design_budget = obj->getDesignBudget();
+      if (design_budget.dir.empty()) return Rcpp::List();
+
+      return Rcpp::List::create(
+        Rcpp::Named("dir")          = design_budget.dir,
+        Rcpp::Named("free_bytes")   = design_budget.free_bytes,
+        Rcpp::Named("buffer_bytes") = design_budget.buffer_bytes
+      );
+    }
+
+    Rcpp::DataFrame getStreamedDesigns () const
+    {
+      std::vector<std::string> factories;
+      for (auto& it : obj->getFactoryMap()) {
+        std::shared_ptr<data::Data> sh_ptr_data = it.second->getInstantiatedData();
+        if ((sh_ptr_data != nullptr) && sh_ptr_data->usesChunks()) factories.push_back(it.first);
+      }
+      return describeDesigns(factories);
+    }
+
     // Nothing needs to be done since we allocate the object on the stack
     ~BlearnerFactoryListWrapper () {}
 };
@@ -1664,6 +2053,10 @@ RCPP_MODULE (baselearner_list_module)
     .method("getNumberOfRegisteredFactories", &BlearnerFactoryListWrapper::getNumberOfRegisteredFactories, "Get number of registered factories. Main purpose is for testing.")
     .method("getRegisteredFactoryNames", &BlearnerFactoryListWrapper::getRegisteredFactoryNames, "Get names of registered factories")
     .method("getDataNames", &BlearnerFactoryListWrapper::getDataNames, "Get names of data of registered factories")
+    .method("spillDesigns", &BlearnerFactoryListWrapper::spillDesigns, "Stream designs from disk within a memory budget")
+    .method("setMemoryBudget", &BlearnerFactoryListWrapper::setMemoryBudget, "Keep the designs of all factories within a memory budget")
+    .method("getDesignBudget", &BlearnerFactoryListWrapper::getDesignBudget, "Get the memory budget for the design of the next factory")
+    .method("getStreamedDesigns", &BlearnerFactoryListWrapper::getStreamedDesigns, "Get the designs that are streamed from disk")
   ;
 }
 
@@ -2026,6 +2419,63 @@ class LossBinomialWrapper : public LossWrapper
 };
 
 
+//' Multinomial loss for multiclass classification
+//'
+//' This loss can be used for multiclass classification with a response
+//' created by \code{ResponseMulticlass}. The model has one score
+//' \eqn{f_k(x)} per class and \eqn{y} is the one-hot encoded label.
+//'
+//' \strong{Loss Function:}
+//' \deqn{
+//'   L(y, f(x)) = \log\left(\sum_{k=1}^K \exp(f_k(x))\right) - \sum_{k=1}^K y_k f_k(x)
+//' }
+//' \strong{Gradient:}
+//' \deqn{
+//'   \frac{\delta}{\delta f_k(x)}\ L(y, f(x)) = p_k(x) - y_k
+//' }
+//' with the softmax probabilities \eqn{p_k(x)}.
+//' \strong{Initialization:}
+//' \deqn{
+//'   \hat{f}_k^{[0]}(x) = \log(\pi_k) - \frac{1}{K}\sum_{l=1}^K \log(\pi_l)
+//' }
+//' with the relative class frequencies \eqn{\pi_k}.
+//'
+//' @format [S4] object.
+//' @name LossMultinomial
+//'
+//' @section Usage:
+//' \preformatted{
+//' LossMultinomial$new()
+//' LossMultinomial$new(offset, TRUE)
+//' }
+//'
+//' @template section-loss-base-methods
+//' @template param-offset
+//'
+//' @examples
+//'
+//' # Create new loss object:
+//' mn_loss = LossMultinomial$new()
+//' mn_loss
+//'
+//' @export LossMultinomial
+class LossMultinomialWrapper : public LossWrapper
+{
+  public:
+    LossMultinomialWrapper ()
+      : LossWrapper::LossWrapper ( std::make_shared<loss::LossMultinomial>() )
+    { }
+
+    LossMultinomialWrapper (arma::mat custom_offset, bool temp)
+      : LossWrapper::LossWrapper ( std::make_shared<loss::LossMultinomial>(custom_offset) )
+    { }
+
+    LossMultinomialWrapper (LossWrapper l, bool b1, bool b2)
+      : LossWrapper::LossWrapper ( std::static_pointer_cast<loss::LossMultinomial>(l.getLossObj()) )
+    { }
+};
+
+
 //' Create LossCustom by using R functions.
 //'
 //' \code{LossCustom} creates a custom loss by using
@@ -2195,6 +2645,13 @@ RCPP_MODULE (loss_module)
     .constructor <LossWrapper, bool, bool> ()
   ;
 
+  class_<LossMultinomialWrapper> ("LossMultinomial")
+    .derives<LossWrapper> ("Loss")
+    .constructor ()
+    .constructor <arma::mat, bool> ()
+    .constructor <LossWrapper, bool, bool> ()
+  ;
+
   class_<LossCustomWrapper> ("LossCustom")
     .derives<LossWrapper> ("Loss")
     .constructor<Rcpp::Function, Rcpp::Function, Rcpp::Function> ()
@@ -2239,7 +2696,7 @@ class ResponseWrapper
 //' Create response object for regression.
 //'
 //' \code{ResponseRegr} creates a response object that are used as target during the
-//' fitting process.
+//' fitting process. A double response (vector or matrix) is used without a copy.
 //'
 //' @format [S4] object.
 //' @name ResponseRegr
@@ -2267,9 +2724,14 @@ class ResponseRegrWrapper : public ResponseWrapper
       Rcpp::stop("Cannot initialize empty response object. See `?ResponseRegr` for help.");
     }
 
-    ResponseRegrWrapper (std::string target_name, arma::mat response)
+    ResponseRegrWrapper (std::string target_name, SEXP response)
     {
-      sh_ptr_response = std::make_shared<response::ResponseRegr>(target_name, response);
+      if (TYPEOF(response) == REALSXP) {
+        sh_ptr_response = std::make_shared<response::ResponseRegr>(target_name, REAL(response), rNRows(response),
+          rNCols(response), protectRObject(response));
+      } else {
+        sh_ptr_response = std::make_shared<response::ResponseRegr>(target_name, copyRMatrix(response));
+      }
     }
     ResponseRegrWrapper (std::string target_name, arma::mat response, arma::mat weights)
     {
@@ -2352,36 +2814,188 @@ class ResponseBinaryClassifWrapper : public ResponseWrapper
     }
 };
 
-RCPP_EXPOSED_CLASS(ResponseWrapper)
-RCPP_MODULE (response_module)
+//' Create response object for multiclass classification.
+//'
+//' \code{ResponseMulticlass} creates a response object with one column per
+//' class. The labels are one-hot encoded and the model is fitted on a matrix
+//' of prediction scores (one score per class) which are transformed to class
+//' probabilities by the softmax function.
+//'
+//' @format [S4] object.
+//' @name ResponseMulticlass
+//'
+//' @section Usage:
+//' \preformatted{
+//' ResponseMulticlass$new(target_name, response)
+//' ResponseMulticlass$new(target_name, response, weights)
+//' }
+//'
+//' @examples
+//'
+//' response_mc = ResponseMulticlass$new("target", sample(c("A", "B", "C"), 10, TRUE))
+//' response_mc$getResponse()               # One-hot encoded labels
+//' response_mc$getPredictionTransform()    # Applies softmax to prediction scores
+//' response_mc$getPredictionResponse()     # Index of the most probable class
+//' response_mc$getClasses()
+//' response_mc$getClassTable()
+//'
+//' @export ResponseMulticlass
+class ResponseMulticlassWrapper : public ResponseWrapper
 {
-  using namespace Rcpp;
-
-  class_<ResponseWrapper> ("Response")
-    .constructor ("Create Response class")
+  public:
+    ResponseMulticlassWrapper () {
+      Rcpp::stop("Cannot initialize empty response object. See `?ResponseMulticlass` for help.");
+    }
 
-    .method("getTargetName",          &ResponseWrapper::getTargetName, "Get the name of the target variable")
-    .method("getResponse",            &ResponseWrapper::getResponse, "Get the original response")
-    .method("getResponseType",        &ResponseWrapper::getResponseType, "Get the original response")
-    .method("getWeights",             &ResponseWrapper::getWeights, "Get the weights")
-    .method("getPrediction",          &ResponseWrapper::getPrediction, "Get prediction scores")
-    .method("getPredictionTransform", &ResponseWrapper::getPredictionTransform, "Get transformed prediction scores")
-    .method("getPredictionResponse",  &ResponseWrapper::getPredictionResponse, "Get transformed prediction as response")
-    .method("filter",                 &ResponseWrapper::filter, "Filter response elements")
-    .method("calculateEmpiricalRisk", &ResponseWrapper::calculateEmpiricalRisk, "Calculates the empirical list given a specific loss")
-  ;
+    ResponseMulticlassWrapper (std::string target_name, std::vector<std::string> response)
+    {
+      sh_ptr_response = std::make_shared<response::ResponseMulticlass>(target_name, response);
+    }
+    ResponseMulticlassWrapper (std::string target_name, std::vector<std::string> response, arma::mat weights)
+    {
+      sh_ptr_response = std::make_shared<response::ResponseMulticlass>(target_name, response, weights);
+    }
 
-  class_<ResponseRegrWrapper> ("ResponseRegr")
-    .derives<ResponseWrapper> ("Response")
+    ResponseMulticlassWrapper (ResponseWrapper r)
+      : ResponseWrapper::ResponseWrapper(std::static_pointer_cast<response::ResponseMulticlass>(r.getResponseObj()))
+    { }
 
-    .constructor ()
-    .constructor<std::string, arma::mat> ()
-    .constructor<std::string, arma::mat, arma::mat> ()
-    .constructor<ResponseWrapper> ()
-  ;
+    std::vector<std::string> getClasses () const
+    {
+      return std::static_pointer_cast<response::ResponseMulticlass>(sh_ptr_response)->getClasses();
+    }
+    std::map<std::string, unsigned int> getClassTable () const
+    {
+      return std::static_pointer_cast<response::ResponseMulticlass>(sh_ptr_response)->getClassTable();
+    }
+};
 
-  class_<ResponseBinaryClassifWrapper> ("ResponseBinaryClassif")
-    .derives<ResponseWrapper> ("Response")
+//' Create response object for functional regression.
+//'
+//' \code{ResponseFDA} creates a response of curves that are observed on a
+//' common grid. The time axis is modeled by a fixed P-spline basis which is
+//' combined with the base learners in array form. The pseudo residuals are
+//' smoothed over time once per iteration and each base learner is fitted for
+//' all grid points at once. Hence, the estimated parameters are matrices with
+//' one column per grid point (the coefficient surface on the grid).
+//'
+//' @format [S4] object.
+//' @name ResponseFDA
+//'
+//' @section Usage:
+//' \preformatted{
+//' ResponseFDA$new(target_name, response, grid, list(degree, n_knots, penalty, df, differences))
+//' ResponseFDA$new(target_name, response, weights, grid, list(degree, n_knots, penalty, df, differences))
+//' }
+//'
+//' @param target_name (`character(1)`)\cr
+//'   Name of the target.
+//' @param response (`matrix()`)\cr
+//'   Matrix with one curve per row and one column per grid point.
+//' @param weights (`matrix()`)\cr
+//'   Observation weights with one column.
+//' @param grid (`numeric()`)\cr
+//'   Strictly increasing grid of the curves.
+//' @param degree (`integer(1)`)\cr
+//'   Degree of the time basis (default `3`).
+//' @param n_knots (`integer(1)`)\cr
+//'   Number of inner knots of the time basis (default `10`).
+//' @param penalty (`numeric(1)`)\cr
+//'   Penalty of the time basis (default `2`), ignored if `df > 0`.
+//' @param df (`numeric(1)`)\cr
+//'   Degrees of freedom of the time basis (default `0`).
+//' @param differences (`integer(1)`)\cr
+//'   Order of the difference penalty of the time basis (default `2`).
+//'
+//' @examples
+//'
+//' grid = seq(0, 1, length.out = 50)
+//' x = runif(20)
+//' curves = t(sapply(x, function(xi) sin(2 * pi * grid) * xi + rnorm(50, 0, 0.1)))
+//' response_fda = ResponseFDA$new("y", curves, grid, list(n_knots = 8))
+//' dim(response_fda$getTimeBasis())
+//' response_fda$getTimePenalty()
+//'
+//' @export ResponseFDA
+class ResponseFDAWrapper : public ResponseWrapper
+{
+  private:
+    Rcpp::List internal_arg_list = Rcpp::List::create(
+      Rcpp::Named("degree") = 3,
+      Rcpp::Named("n_knots") = 10,
+      Rcpp::Named("penalty") = 2,
+      Rcpp::Named("df") = 0,
+      Rcpp::Named("differences") = 2
+    );
+
+  public:
+    ResponseFDAWrapper () {
+      Rcpp::stop("Cannot initialize empty response object. See `?ResponseFDA` for help.");
+    }
+
+    ResponseFDAWrapper (std::string target_name, arma::mat response, arma::vec grid, Rcpp::List arg_list)
+    {
+      internal_arg_list = helper::argHandler(internal_arg_list, arg_list, true);
+      sh_ptr_response = std::make_shared<response::ResponseFDA>(target_name, response, grid,
+        internal_arg_list["degree"], internal_arg_list["n_knots"], internal_arg_list["penalty"],
+        internal_arg_list["df"], internal_arg_list["differences"]);
+    }
+    ResponseFDAWrapper (std::string target_name, arma::mat response, arma::mat weights, arma::vec grid, Rcpp::List arg_list)
+    {
+      internal_arg_list = helper::argHandler(internal_arg_list, arg_list, true);
+      sh_ptr_response = std::make_shared<response::ResponseFDA>(target_name, response, weights, grid,
+        internal_arg_list["degree"], internal_arg_list["n_knots"], internal_arg_list["penalty"],
+        internal_arg_list["df"], internal_arg_list["differences"]);
+    }
+
+    ResponseFDAWrapper (ResponseWrapper r)
+      : ResponseWrapper::ResponseWrapper(std::static_pointer_cast<response::ResponseFDA>(r.getResponseObj()))
+    { }
+
+    arma::vec getGrid () const
+    {
+      return std::static_pointer_cast<response::ResponseFDA>(sh_ptr_response)->getGrid();
+    }
+    arma::mat getTimeBasis () const
+    {
+      return std::static_pointer_cast<response::ResponseFDA>(sh_ptr_response)->getTimeBasis();
+    }
+    double getTimePenalty () const
+    {
+      return std::static_pointer_cast<response::ResponseFDA>(sh_ptr_response)->getTimePenalty();
+    }
+};
+
+RCPP_EXPOSED_CLASS(ResponseWrapper)
+RCPP_MODULE (response_module)
+{
+  using namespace Rcpp;
+
+  class_<ResponseWrapper> ("Response")
+    .constructor ("Create Response class")
+
+    .method("getTargetName",          &ResponseWrapper::getTargetName, "Get the name of the target variable")
+    .method("getResponse",            &ResponseWrapper::getResponse, "Get the original response")
+    .method("getResponseType",        &ResponseWrapper::getResponseType, "Get the original response")
+    .method("getWeights",             &ResponseWrapper::getWeights, "Get the weights")
+    .method("getPrediction",          &ResponseWrapper::getPrediction, "Get prediction scores")
+    .method("getPredictionTransform", &ResponseWrapper::getPredictionTransform, "Get transformed prediction scores")
+    .method("getPredictionResponse",  &ResponseWrapper::getPredictionResponse, "Get transformed prediction as response")
+    .method("filter",                 &ResponseWrapper::filter, "Filter response elements")
+    .method("calculateEmpiricalRisk", &ResponseWrapper::calculateEmpiricalRisk, "Calculates the empirical list given a specific loss")
+  ;
+
+  class_<ResponseRegrWrapper> ("ResponseRegr")
+    .derives<ResponseWrapper> ("Response")
+
+    .constructor ()
+    .constructor<std::string, SEXP> ()
+    .constructor<std::string, arma::mat, arma::mat> ()
+    .constructor<ResponseWrapper> ()
+  ;
+
+  class_<ResponseBinaryClassifWrapper> ("ResponseBinaryClassif")
+    .derives<ResponseWrapper> ("Response")
 
     .constructor ()
     .constructor<std::string, std::string, std::vector<std::string>> ()
@@ -2393,6 +3007,31 @@ RCPP_MODULE (response_module)
     .method("getPositiveClass",       &ResponseBinaryClassifWrapper::getPositiveClass, "Get string of the positive class")
     .method("getClassTable",          &ResponseBinaryClassifWrapper::getClassTable, "Get table of response used for modeling")
   ;
+
+  class_<ResponseMulticlassWrapper> ("ResponseMulticlass")
+    .derives<ResponseWrapper> ("Response")
+
+    .constructor ()
+    .constructor<std::string, std::vector<std::string>> ()
+    .constructor<std::string, std::vector<std::string>, arma::mat> ()
+    .constructor<ResponseWrapper> ()
+
+    .method("getClasses",             &ResponseMulticlassWrapper::getClasses, "Get the sorted class labels, one per score column")
+    .method("getClassTable",          &ResponseMulticlassWrapper::getClassTable, "Get table of response used for modeling")
+  ;
+
+  class_<ResponseFDAWrapper> ("ResponseFDA")
+    .derives<ResponseWrapper> ("Response")
+
+    .constructor ()
+    .constructor<std::string, arma::mat, arma::vec, Rcpp::List> ()
+    .constructor<std::string, arma::mat, arma::mat, arma::vec, Rcpp::List> ()
+    .constructor<ResponseWrapper> ()
+
+    .method("getGrid",                &ResponseFDAWrapper::getGrid, "Get the grid of the curves")
+    .method("getTimeBasis",           &ResponseFDAWrapper::getTimeBasis, "Get the spline basis of the time axis evaluated on the grid")
+    .method("getTimePenalty",         &ResponseFDAWrapper::getTimePenalty, "Get the penalty of the time basis")
+  ;
 }
 
 
@@ -2779,6 +3418,179 @@ class LoggerTimeWrapper : public LoggerWrapper
 
 
 
+Rcpp::DataFrame profilerToDataFrame (const std::shared_ptr<profiler::Profiler>& sh_ptr_profiler)
+{
+  if (sh_ptr_profiler == nullptr) {
+    Rcpp::stop("No profiler available. Register a 'LoggerProfile' before training.");
+  }
+  arma::mat pmat = sh_ptr_profiler->getPhaseMatrix();
+
+  return Rcpp::DataFrame::create(
+    Rcpp::Named("phase")       = sh_ptr_profiler->getPhaseNames(),
+    Rcpp::Named("category")    = sh_ptr_profiler->getPhaseCategories(),
+    Rcpp::Named("calls")       = Rcpp::NumericVector(pmat.colptr(0), pmat.colptr(0) + pmat.n_rows),
+    Rcpp::Named("total_us")    = Rcpp::NumericVector(pmat.colptr(1), pmat.colptr(1) + pmat.n_rows),
+    Rcpp::Named("mean_us")     = Rcpp::NumericVector(pmat.colptr(2), pmat.colptr(2) + pmat.n_rows),
+    Rcpp::Named("min_us")      = Rcpp::NumericVector(pmat.colptr(3), pmat.colptr(3) + pmat.n_rows),
+    Rcpp::Named("max_us")      = Rcpp::NumericVector(pmat.colptr(4), pmat.colptr(4) + pmat.n_rows),
+    Rcpp::Named("evaluations") = Rcpp::NumericVector(pmat.colptr(5), pmat.colptr(5) + pmat.n_rows),
+    Rcpp::Named("bytes")       = Rcpp::NumericVector(pmat.colptr(6), pmat.colptr(6) + pmat.n_rows),
+    Rcpp::Named("stringsAsFactors") = false
+  );
+}
+
+//' @title Logger class to profile the training
+//'
+//' @description
+//' This class profiles the phases of each iteration (pseudo residuals,
+//' candidate training per factory, step size, model update, logging, and
+//' risk computation). The timings are measured with a steady clock in
+//' microseconds. Additionally, counters for the number of evaluations and the
+//' (estimated) bytes touched are tracked per phase. The logged data is the elapsed time in microseconds. The logger
+//' cannot be used as stopper.
+//'
+//' @format [S4] object.
+//' @name LoggerProfile
+//'
+//' @section Usage:
+//' \preformatted{
+//' LoggerProfile$new(logger_id, use_as_stopper, max_events)
+//' }
+//'
+//' @template param-logger_id
+//' @param use_as_stopper (`logical(1)`)\cr
+//' Must be `FALSE`, the profiler is never used as stopper.
+//' @param max_events (`integer(1)`)\cr
+//' Maximal number of events stored for the timeline export. The phase table
+//' is not affected by this number.
+//'
+//' @section Fields:
+//'   This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$summarizeLogger()`: `() -> ()`
+//' * `$getProfile()`: `() -> data.frame()`
+//' * `$exportTrace()`: `character(1) -> ()`\cr Write the timeline as Chrome trace event JSON.
+//'
+//' @examples
+//' # Define logger:
+//' log_profile = LoggerProfile$new("profile", FALSE, 10000)
+//'
+//' # Summarize logger:
+//' log_profile$summarizeLogger()
+//'
+//' @export LoggerProfile
+class LoggerProfileWrapper : public LoggerWrapper
+{
+  private:
+    unsigned int max_events;
+
+  public:
+    LoggerProfileWrapper () {
+      Rcpp::stop("Cannot create empty logger");
+    }
+
+    LoggerProfileWrapper (std::string logger_id0, bool use_as_stopper, unsigned int max_events)
+      : max_events ( max_events )
+    {
+      if (use_as_stopper) Rcpp::stop("The profile logger cannot be used as stopper.");
+
+      logger_id = logger_id0;
+      sh_ptr_logger = std::make_shared<logger::LoggerProfile>(logger_id, max_events);
+    }
+
+    void summarizeLogger ()
+    {
+      Rcpp::Rcout << "Profile logger:" << std::endl;
+      Rcpp::Rcout << "\t- Profiles the phases of each iteration (steady clock, microseconds)" << std::endl;
+      Rcpp::Rcout << "\t- Maximal number of stored trace events: " << max_events << std::endl;
+    }
+
+    Rcpp::DataFrame getProfile () const
+    {
+      return profilerToDataFrame(std::static_pointer_cast<logger::LoggerProfile>(sh_ptr_logger)->getProfiler());
+    }
+
+    void exportTrace (const std::string file) const
+    {
+      std::static_pointer_cast<logger::LoggerProfile>(sh_ptr_logger)->getProfiler()->exportTrace(file);
+    }
+};
+
+
+
+//' @title Log missed base learners of the candidate sampling
+//'
+//' @description
+//' If the optimizer evaluates just a share of the base learners per iteration
+//' (see `$setCandidateSampling()` of the optimizer), this logger evaluates all
+//' base learners every `check_every` iterations and logs if the best one was
+//' missed (1) or not (0). Iterations that are not checked are logged as `NaN`.
+//' Each check costs one iteration with all base learners. The logger cannot be
+//' used as stopper or with [OptimizerAGBM].
+//'
+//' @format [S4] object.
+//' @name LoggerCandidateMiss
+//'
+//' @section Usage:
+//' \preformatted{
+//' LoggerCandidateMiss$new(logger_id, use_as_stopper, check_every)
+//' }
+//'
+//' @template param-logger_id
+//' @param use_as_stopper (`logical(1)`)\cr
+//' Must be `FALSE`.
+//' @param check_every (`integer(1)`)\cr
+//' Check every `check_every` iterations.
+//'
+//' @section Fields:
+//'   This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$summarizeLogger()`: `() -> ()`
+//' * `$getMissRate()`: `() -> numeric(1)`
+//'
+//' @examples
+//' # Define logger:
+//' log_miss = LoggerCandidateMiss$new("miss", FALSE, 10)
+//'
+//' # Summarize logger:
+//' log_miss$summarizeLogger()
+//'
+//' @export LoggerCandidateMiss
+class LoggerCandidateMissWrapper : public LoggerWrapper
+{
+  private:
+    unsigned int check_every;
+
+  public:
+    LoggerCandidateMissWrapper () {
+      Rcpp::stop("Cannot create empty logger");
+    }
+
+    LoggerCandidateMissWrapper (std::string logger_id0, bool use_as_stopper, unsigned int check_every)
+      : check_every ( check_every )
+    {
+      if (use_as_stopper) Rcpp::stop("The candidate miss logger cannot be used as stopper.");
+
+      logger_id = logger_id0;
+      sh_ptr_logger = std::make_shared<logger::LoggerCandidateMiss>(logger_id, check_every);
+    }
+
+    void summarizeLogger ()
+    {
+      Rcpp::Rcout << "Candidate miss logger:" << std::endl;
+      Rcpp::Rcout << "\t- Checks the candidate sampling every " << check_every << " iterations" << std::endl;
+    }
+
+    double getMissRate () const
+    {
+      return std::static_pointer_cast<logger::LoggerCandidateMiss>(sh_ptr_logger)->getMissRate();
+    }
+};
+
+
+
 //' @title Collect loggers
 //'
 //' @description
@@ -2924,6 +3736,23 @@ RCPP_MODULE(logger_module)
     .method("summarizeLogger", &LoggerTimeWrapper::summarizeLogger)
   ;
 
+  class_<LoggerProfileWrapper> ("LoggerProfile")
+    .derives<LoggerWrapper> ("Logger")
+    .constructor ()
+    .constructor<std::string, bool, unsigned int> ()
+    .method("summarizeLogger", &LoggerProfileWrapper::summarizeLogger)
+    .method("getProfile",      &LoggerProfileWrapper::getProfile)
+    .method("exportTrace",     &LoggerProfileWrapper::exportTrace)
+  ;
+
+  class_<LoggerCandidateMissWrapper> ("LoggerCandidateMiss")
+    .derives<LoggerWrapper> ("Logger")
+    .constructor ()
+    .constructor<std::string, bool, unsigned int> ()
+    .method("summarizeLogger", &LoggerCandidateMissWrapper::summarizeLogger)
+    .method("getMissRate",     &LoggerCandidateMissWrapper::getMissRate)
+  ;
+
   class_<LoggerListWrapper> ("LoggerList")
     .constructor ()
     .method("registerLogger", &LoggerListWrapper::registerLogger)
@@ -2936,6 +3765,78 @@ RCPP_MODULE(logger_module)
 }
 
 
+// Transports of the distributed training, used by the optimizer and the
+// compboost module:
+
+class TransportWrapper
+{
+  public:
+    TransportWrapper () { }
+
+    std::shared_ptr<distributed::Transport> getTransport ()
+    {
+      return sh_ptr_transport;
+    }
+
+    unsigned int getRank          () const { return sh_ptr_transport->getRank(); }
+    unsigned int getSize          () const { return sh_ptr_transport->getSize(); }
+    double       getBytesSent     () const { return sh_ptr_transport->getBytesSent(); }
+    double       getBytesReceived () const { return sh_ptr_transport->getBytesReceived(); }
+
+    virtual ~TransportWrapper () { }
+
+  protected:
+    std::shared_ptr<distributed::Transport> sh_ptr_transport;
+};
+
+//' @title Unix socket transport for distributed training
+//'
+//' @description
+//' [SocketTransport] connects the processes of a distributed training on one
+//' host with a Unix domain socket. The coordinator has rank 0 and binds the
+//' socket, the workers have the ranks 1 to `size - 1` and connect to it. The
+//' constructor blocks until all processes are connected or the timeout is reached.
+//' Not available on Windows.
+//'
+//' @format [S4] object.
+//' @name SocketTransport
+//'
+//' @section Usage:
+//' \preformatted{
+//' SocketTransport$new(path, rank, size, timeout)
+//' }
+//'
+//' @param path (`character(1)`)\cr
+//' File of the socket, e.g. from `tempfile()`.
+//' @param rank (`integer(1)`)\cr
+//' Rank of the process, 0 for the coordinator.
+//' @param size (`integer(1)`)\cr
+//' Number of processes, i.e. the number of workers plus one.
+//' @param timeout (`numeric(1)`)\cr
+//' Seconds to wait for the connections.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getRank()`: `() -> integer(1)`
+//' * `$getSize()`: `() -> integer(1)`
+//' * `$getBytesSent()`: `() -> numeric(1)`
+//' * `$getBytesReceived()`: `() -> numeric(1)`
+//'
+//' @export SocketTransport
+class SocketTransportWrapper : public TransportWrapper
+{
+  public:
+    SocketTransportWrapper (std::string path, unsigned int rank, unsigned int size, double timeout)
+    {
+      sh_ptr_transport = std::make_shared<distributed::SocketTransport>(path, rank, size, timeout);
+    }
+};
+
+RCPP_EXPOSED_CLASS(TransportWrapper)
+
+
 // -------------------------------------------------------------------------- //
 //                                 OPTIMIZER                                  //
 // -------------------------------------------------------------------------- //
@@ -2960,6 +3861,46 @@ class OptimizerWrapper
       return sh_ptr_optimizer->getType();
     }
 
+    unsigned int getNumThreads () const
+    {
+      return sh_ptr_optimizer->getNumThreads();
+    }
+
+    void setCandidateSampling (double fraction, std::string weighting, unsigned int full_sweep_every, unsigned int seed)
+    {
+      sh_ptr_optimizer->setCandidateSampling(fraction, weighting, full_sweep_every, seed);
+    }
+
+    Rcpp::List getCandidateSampling () const
+    {
+      return Rcpp::List::create(
+        Rcpp::Named("fraction")         = sh_ptr_optimizer->getCandidateFraction(),
+        Rcpp::Named("weighting")        = sh_ptr_optimizer->getCandidateWeighting(),
+        Rcpp::Named("full_sweep_every") = sh_ptr_optimizer->getFullSweepEvery(),
+        Rcpp::Named("seed")             = sh_ptr_optimizer->getCandidateSeed()
+      );
+    }
+
+    void setSafeScreening (bool use_screening)
+    {
+      sh_ptr_optimizer->setSafeScreening(use_screening);
+    }
+
+    Rcpp::List getScreeningStats () const
+    {
+      std::shared_ptr<screening::SafeScreening> sh_ptr_screening = sh_ptr_optimizer->getSafeScreening();
+      if (sh_ptr_screening == nullptr) return Rcpp::List::create();
+
+      double ncand = sh_ptr_screening->getNumberOfCandidates();
+      double neval = sh_ptr_screening->getNumberOfEvaluated();
+      return Rcpp::List::create(
+        Rcpp::Named("candidates")           = ncand,
+        Rcpp::Named("evaluated")            = neval,
+        Rcpp::Named("pruned_fraction")      = (ncand > 0) ? 1 - neval / ncand : 0,
+        Rcpp::Named("pruned_per_iteration") = sh_ptr_screening->getPrunedShare()
+      );
+    }
+
     virtual ~OptimizerWrapper () {}
 
   protected:
@@ -2989,6 +3930,16 @@ class OptimizerWrapper
 //'
 //' @section Methods:
 //' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
+//' * `$setSafeScreening()`: `logical(1) -> ()`\cr
+//'   Skip base learners that provably cannot have the smallest SSE. The bound uses the
+//'   norm of the last cross product with the residuals and the smallest eigenvalue of the
+//'   penalized system. The selected base learners are the same as without screening.
+//' * `$getScreeningStats()`: `() -> list()`
 //' * `$getStepSize()`: `() -> numeric()`
 //'
 //' @examples
@@ -3047,6 +3998,16 @@ class OptimizerCoordinateDescent : public OptimizerWrapper
 //'
 //' @section Methods:
 //' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
+//' * `$setSafeScreening()`: `logical(1) -> ()`\cr
+//'   Skip base learners that provably cannot have the smallest SSE. The bound uses the
+//'   norm of the last cross product with the residuals and the smallest eigenvalue of the
+//'   penalized system. The selected base learners are the same as without screening.
+//' * `$getScreeningStats()`: `() -> list()`
 //' * `$getStepSize()`: `() -> numeric()`
 //'
 //' @examples
@@ -3101,6 +4062,16 @@ public:
 //'
 //' @section Methods:
 //' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
+//' * `$setSafeScreening()`: `logical(1) -> ()`\cr
+//'   Skip base learners that provably cannot have the smallest SSE. The bound uses the
+//'   norm of the last cross product with the residuals and the smallest eigenvalue of the
+//'   penalized system. The selected base learners are the same as without screening.
+//' * `$getScreeningStats()`: `() -> list()`
 //' * `$getStepSize()`: `() -> numeric()`
 //'
 //' @examples
@@ -3126,32 +4097,299 @@ public:
 };
 
 
-//' @title Nesterovs momentum
+//' @title Stochastic coordinate descent
 //'
 //' @description
-//' This class defines a new object to conduct Nesterovs momentum in function space.
+//' Same as [OptimizerCoordinateDescent] but the base learners are fitted and
+//' compared on a subset of the rows in each iteration. The update of the selected
+//' base learner is applied to all rows. The subset is either drawn at random
+//' or taken as next block of a permutation of the rows (`sampling = "cycle"`).
+//' Binned base learners accumulate the bins just over the subset.
 //'
 //' @format [S4] object.
-//' @name OptimizerAGBM
+//' @name OptimizerStochasticCoordinateDescent
 //'
 //' @section Usage:
 //' \preformatted{
-//' OptimizerAGBM$new(momentum)
-//' OptimizerAGBM$new(momentum, ncores)
+//' OptimizerStochasticCoordinateDescent$new()
+//' OptimizerStochasticCoordinateDescent$new(sample_fraction)
+//' OptimizerStochasticCoordinateDescent$new(sample_fraction, seed)
+//' OptimizerStochasticCoordinateDescent$new(sample_fraction, seed, sampling)
+//' OptimizerStochasticCoordinateDescent$new(sample_fraction, seed, sampling, ncores)
 //' }
 //'
 //' @template param-ncores
-//' @param momentum (`numeric(1)`)\cr
-//' Momentum term used to accelerate the fitting process. If chosen large, the algorithm trains
-//' faster but also tends to overfit faster.
+//' @param sample_fraction (`numeric(1)`)\cr
+//' Share of rows used per iteration, default is `0.2`.
+//' @param seed (`integer(1)`)\cr
+//' Seed of the row sampling. The sampling does not use R's random number generator
+//' and is the same for every number of cores.
+//' @param sampling (`character(1)`)\cr
+//' Either `"random"` (default) to draw the rows in each iteration or `"cycle"` to
+//' visit the blocks of a random permutation of the rows.
 //'
 //' @section Fields:
 //' This class doesn't contain public fields.
 //'
 //' @section Methods:
 //' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
 //' * `$getStepSize()`: `() -> numeric()`
-//' * `$getMomentumParameter()`: `() -> numeric(1)`
+//' * `$getSampleFraction()`: `() -> numeric(1)`
+//' * `$getSeed()`: `() -> integer(1)`
+//' * `$getSampling()`: `() -> character(1)`
+//'
+//' @examples
+//'
+//' # Define optimizer:
+//' optimizer = OptimizerStochasticCoordinateDescent$new(0.1, 31415)
+//'
+//' @export OptimizerStochasticCoordinateDescent
+class OptimizerStochasticCoordinateDescent : public OptimizerWrapper
+{
+public:
+  OptimizerStochasticCoordinateDescent () {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerStochasticCoordinateDescent>();
+  }
+  OptimizerStochasticCoordinateDescent (double sample_fraction) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerStochasticCoordinateDescent>(sample_fraction, 0, "random", 1);
+  }
+  OptimizerStochasticCoordinateDescent (double sample_fraction, unsigned int seed) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerStochasticCoordinateDescent>(sample_fraction, seed, "random", 1);
+  }
+  OptimizerStochasticCoordinateDescent (double sample_fraction, unsigned int seed, std::string sampling) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerStochasticCoordinateDescent>(sample_fraction, seed, sampling, 1);
+  }
+  OptimizerStochasticCoordinateDescent (double sample_fraction, unsigned int seed, std::string sampling,
+      unsigned int num_threads) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerStochasticCoordinateDescent>(sample_fraction, seed, sampling,
+      num_threads);
+  }
+  // Include bool arguments to have a unique constructor that can be used by the RCPP modules:
+  OptimizerStochasticCoordinateDescent (OptimizerWrapper op, bool b1, bool b2, bool b3, bool b4)
+    : OptimizerWrapper::OptimizerWrapper ( std::static_pointer_cast<optimizer::OptimizerStochasticCoordinateDescent>(op.getOptimizer()) )
+  { }
+
+  std::vector<double> getStepSize() { return sh_ptr_optimizer->getStepSize(); }
+
+  double getSampleFraction () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerStochasticCoordinateDescent>(sh_ptr_optimizer)->getSampleFraction();
+  }
+  unsigned int getSeed () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerStochasticCoordinateDescent>(sh_ptr_optimizer)->getSeed();
+  }
+  std::string getSampling () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerStochasticCoordinateDescent>(sh_ptr_optimizer)->getSampling();
+  }
+};
+
+
+//' @title Block coordinate descent
+//'
+//' @description
+//' Same as [OptimizerCoordinateDescent] but up to `block_size` base learners are updated
+//' in each iteration. The block consists of the best base learners (by SSE) whose
+//' predictions have an absolute cosine similarity of at most `max_correlation` to each other.
+//' With `backtracking`, base learners are removed from the block as long as the risk
+//' of the block update is larger than the risk of updating just the best base learner.
+//' All base learners of a block are stored for the same iteration, hence
+//' `$getSelectedBaselearner()` may return more names than iterations.
+//'
+//' @format [S4] object.
+//' @name OptimizerBlockCoordinateDescent
+//'
+//' @section Usage:
+//' \preformatted{
+//' OptimizerBlockCoordinateDescent$new()
+//' OptimizerBlockCoordinateDescent$new(block_size)
+//' OptimizerBlockCoordinateDescent$new(block_size, max_correlation)
+//' OptimizerBlockCoordinateDescent$new(block_size, max_correlation, backtracking)
+//' OptimizerBlockCoordinateDescent$new(block_size, max_correlation, backtracking, ncores)
+//' }
+//'
+//' @template param-ncores
+//' @param block_size (`integer(1)`)\cr
+//' Maximal number of base learners updated per iteration, default is `2`.
+//' @param max_correlation (`numeric(1)`)\cr
+//' Maximal absolute cosine similarity of the predictions of two base learners of
+//' a block, default is `0.5`.
+//' @param backtracking (`logical(1)`)\cr
+//' Shrink the block if it increases the risk compared to the best base learner,
+//' default is `TRUE`.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
+//' * `$getStepSize()`: `() -> numeric()`
+//' * `$getBlockSize()`: `() -> integer(1)`
+//' * `$getMaxCorrelation()`: `() -> numeric(1)`
+//' * `$getBacktracking()`: `() -> logical(1)`
+//'
+//' @examples
+//'
+//' # Define optimizer:
+//' optimizer = OptimizerBlockCoordinateDescent$new(4, 0.3)
+//'
+//' @export OptimizerBlockCoordinateDescent
+class OptimizerBlockCoordinateDescent : public OptimizerWrapper
+{
+public:
+  OptimizerBlockCoordinateDescent () {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerBlockCoordinateDescent>();
+  }
+  OptimizerBlockCoordinateDescent (unsigned int block_size) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerBlockCoordinateDescent>(block_size, 0.5, true, 1);
+  }
+  OptimizerBlockCoordinateDescent (unsigned int block_size, double max_correlation) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerBlockCoordinateDescent>(block_size, max_correlation, true, 1);
+  }
+  OptimizerBlockCoordinateDescent (unsigned int block_size, double max_correlation, bool backtracking) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerBlockCoordinateDescent>(block_size, max_correlation, backtracking, 1);
+  }
+  OptimizerBlockCoordinateDescent (unsigned int block_size, double max_correlation, bool backtracking,
+      unsigned int num_threads) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerBlockCoordinateDescent>(block_size, max_correlation, backtracking,
+      num_threads);
+  }
+  // Include bool arguments to have a unique constructor that can be used by the RCPP modules:
+  OptimizerBlockCoordinateDescent (OptimizerWrapper op, bool b1, bool b2, bool b3, bool b4)
+    : OptimizerWrapper::OptimizerWrapper ( std::static_pointer_cast<optimizer::OptimizerBlockCoordinateDescent>(op.getOptimizer()) )
+  { }
+
+  std::vector<double> getStepSize() { return sh_ptr_optimizer->getStepSize(); }
+
+  unsigned int getBlockSize () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerBlockCoordinateDescent>(sh_ptr_optimizer)->getBlockSize();
+  }
+  double getMaxCorrelation () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerBlockCoordinateDescent>(sh_ptr_optimizer)->getMaxCorrelation();
+  }
+  bool getBacktracking () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerBlockCoordinateDescent>(sh_ptr_optimizer)->getBacktracking();
+  }
+};
+
+
+//' @title Newton boosting
+//'
+//' @description
+//' Second-order boosting: In each iteration the base learners are fitted to the
+//' Newton step of the loss, i.e. to the pseudo residuals divided by the Hessian,
+//' weighted by the Hessian. The penalty of the base learners is kept. The Hessian
+//' weights are accumulated per bin once per iteration and shared between all base
+//' learners of the same binned feature. Requires a loss that provides a Hessian
+//' ([LossQuadratic], [LossBinomial], [LossHuber]). With [LossQuadratic] the optimizer
+//' selects the same base learners as [OptimizerCoordinateDescent]. Custom base
+//' learners are fitted to the unweighted Newton step.
+//'
+//' @format [S4] object.
+//' @name OptimizerNewton
+//'
+//' @section Usage:
+//' \preformatted{
+//' OptimizerNewton$new()
+//' OptimizerNewton$new(min_hessian)
+//' OptimizerNewton$new(min_hessian, ncores)
+//' }
+//'
+//' @template param-ncores
+//' @param min_hessian (`numeric(1)`)\cr
+//' Lower bound for the Hessian of each observation to keep the Newton step
+//' bounded, default is `1e-4`.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
+//' * `$getStepSize()`: `() -> numeric()`
+//' * `$getMinHessian()`: `() -> numeric(1)`
+//'
+//' @examples
+//'
+//' # Define optimizer:
+//' optimizer = OptimizerNewton$new(1e-3)
+//'
+//' @export OptimizerNewton
+class OptimizerNewton : public OptimizerWrapper
+{
+public:
+  OptimizerNewton () {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerNewton>();
+  }
+  OptimizerNewton (double min_hessian) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerNewton>(min_hessian, 1);
+  }
+  OptimizerNewton (double min_hessian, unsigned int num_threads) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerNewton>(min_hessian, num_threads);
+  }
+  // Include bool arguments to have a unique constructor that can be used by the RCPP modules:
+  OptimizerNewton (OptimizerWrapper op, bool b1, bool b2)
+    : OptimizerWrapper::OptimizerWrapper ( std::static_pointer_cast<optimizer::OptimizerNewton>(op.getOptimizer()) )
+  { }
+
+  std::vector<double> getStepSize() { return sh_ptr_optimizer->getStepSize(); }
+
+  double getMinHessian () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerNewton>(sh_ptr_optimizer)->getMinHessian();
+  }
+};
+
+
+//' @title Nesterovs momentum
+//'
+//' @description
+//' This class defines a new object to conduct Nesterovs momentum in function space.
+//'
+//' @format [S4] object.
+//' @name OptimizerAGBM
+//'
+//' @section Usage:
+//' \preformatted{
+//' OptimizerAGBM$new(momentum)
+//' OptimizerAGBM$new(momentum, ncores)
+//' }
+//'
+//' @template param-ncores
+//' @param momentum (`numeric(1)`)\cr
+//' Momentum term used to accelerate the fitting process. If chosen large, the algorithm trains
+//' faster but also tends to overfit faster.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$setCandidateSampling()`: `numeric(1), character(1), integer(1), integer(1) -> ()`\cr
+//'   Evaluate just a share (`fraction`) of the base learners per iteration. The candidates are
+//'   drawn `"uniform"` or by `"importance"` (proportional to the number of selections plus one).
+//'   All base learners are evaluated in the first and every `full_sweep_every` iteration.
+//' * `$getCandidateSampling()`: `() -> list()`
+//' * `$getStepSize()`: `() -> numeric()`
+//' * `$getMomentumParameter()`: `() -> numeric(1)`
 //' * `$getSelectedMomentumBaselearner()`: `() -> character()`
 //' * `$getParameterMatrix()`: `() -> list(matrix()`
 //' * `$getErrorCorrectedPseudoResiduals()`: `() -> matrix()`
@@ -3210,6 +4448,66 @@ public:
 };
 
 
+//' @title Feature parallel coordinate descent
+//'
+//' @description
+//' This class defines a coordinate descent where the base learners are evaluated
+//' in multiple processes. The factories are assigned round-robin (in the order of
+//' the factory list) to the processes, including the coordinator. Each iteration, the pseudo residuals are sent to all
+//' processes, each process returns the best base learner of its factories, and
+//' just the process of the winner sends its prediction. The selected base learners
+//' are the same as for [OptimizerCoordinateDescent].
+//'
+//' The optimizer is used in the coordinator process (rank 0), the other processes
+//' run a [FeatureParallelWorker] with the same factories. After `$stopWorkers()`
+//' (called by `Compboost$trainFeatureParallel()`), all factories are evaluated in
+//' the coordinator. A model saved to JSON is loaded with [OptimizerCoordinateDescent].
+//'
+//' @format [S4] object.
+//' @name OptimizerFeatureParallel
+//'
+//' @section Usage:
+//' \preformatted{
+//' OptimizerFeatureParallel$new(transport)
+//' }
+//'
+//' @param transport ([SocketTransport])\cr
+//' The transport with rank 0.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$getOptimizerType()`: `() -> character(1)`
+//' * `$getStepSize()`: `() -> numeric()`
+//' * `$stopWorkers()`: `() -> ()` Release the workers.
+//' * `$isStopped()`: `() -> logical(1)`
+//'
+//' @export OptimizerFeatureParallel
+class OptimizerFeatureParallel : public OptimizerWrapper
+{
+public:
+  OptimizerFeatureParallel (TransportWrapper& transport) {
+    sh_ptr_optimizer = std::make_shared<optimizer::OptimizerFeatureParallel>(transport.getTransport());
+  }
+  // Include bool arguments to have a unique constructor that can be used by the RCPP modules:
+  OptimizerFeatureParallel (OptimizerWrapper op, bool b1)
+    : OptimizerWrapper::OptimizerWrapper ( std::static_pointer_cast<optimizer::OptimizerFeatureParallel>(op.getOptimizer()) )
+  { }
+
+  std::vector<double> getStepSize() { return sh_ptr_optimizer->getStepSize(); }
+
+  void stopWorkers ()
+  {
+    std::static_pointer_cast<optimizer::OptimizerFeatureParallel>(sh_ptr_optimizer)->stopWorkers();
+  }
+  bool isStopped () const
+  {
+    return std::static_pointer_cast<optimizer::OptimizerFeatureParallel>(sh_ptr_optimizer)->isStopped();
+  }
+};
+
+
 RCPP_EXPOSED_CLASS(OptimizerWrapper)
 RCPP_MODULE(optimizer_module)
 {
@@ -3217,7 +4515,12 @@ RCPP_MODULE(optimizer_module)
 
   class_<OptimizerWrapper> ("Optimizer")
     .constructor ()
-    .method("getOptimizerType", &OptimizerWrapper::getOptimizerType)
+    .method("getOptimizerType",     &OptimizerWrapper::getOptimizerType)
+    .method("getNumThreads",        &OptimizerWrapper::getNumThreads)
+    .method("setCandidateSampling", &OptimizerWrapper::setCandidateSampling)
+    .method("getCandidateSampling", &OptimizerWrapper::getCandidateSampling)
+    .method("setSafeScreening", &OptimizerWrapper::setSafeScreening)
+    .method("getScreeningStats", &OptimizerWrapper::getScreeningStats)
   ;
 
   class_<OptimizerCoordinateDescent> ("OptimizerCoordinateDescent")
@@ -3245,6 +4548,44 @@ RCPP_MODULE(optimizer_module)
     .method("getStepSize", &OptimizerCoordinateDescentLineSearch::getStepSize)
   ;
 
+  class_<OptimizerStochasticCoordinateDescent> ("OptimizerStochasticCoordinateDescent")
+    .derives<OptimizerWrapper> ("Optimizer")
+    .constructor ()
+    .constructor <double> ()
+    .constructor <double, unsigned int> ()
+    .constructor <double, unsigned int, std::string> ()
+    .constructor <double, unsigned int, std::string, unsigned int> ()
+    .constructor <OptimizerWrapper, bool, bool, bool, bool> ()
+    .method("getStepSize",       &OptimizerStochasticCoordinateDescent::getStepSize)
+    .method("getSampleFraction", &OptimizerStochasticCoordinateDescent::getSampleFraction)
+    .method("getSeed",           &OptimizerStochasticCoordinateDescent::getSeed)
+    .method("getSampling",       &OptimizerStochasticCoordinateDescent::getSampling)
+  ;
+
+  class_<OptimizerBlockCoordinateDescent> ("OptimizerBlockCoordinateDescent")
+    .derives<OptimizerWrapper> ("Optimizer")
+    .constructor ()
+    .constructor <unsigned int> ()
+    .constructor <unsigned int, double> ()
+    .constructor <unsigned int, double, bool> ()
+    .constructor <unsigned int, double, bool, unsigned int> ()
+    .constructor <OptimizerWrapper, bool, bool, bool, bool> ()
+    .method("getStepSize",       &OptimizerBlockCoordinateDescent::getStepSize)
+    .method("getBlockSize",      &OptimizerBlockCoordinateDescent::getBlockSize)
+    .method("getMaxCorrelation", &OptimizerBlockCoordinateDescent::getMaxCorrelation)
+    .method("getBacktracking",   &OptimizerBlockCoordinateDescent::getBacktracking)
+  ;
+
+  class_<OptimizerNewton> ("OptimizerNewton")
+    .derives<OptimizerWrapper> ("Optimizer")
+    .constructor ()
+    .constructor <double> ()
+    .constructor <double, unsigned int> ()
+    .constructor <OptimizerWrapper, bool, bool> ()
+    .method("getStepSize",   &OptimizerNewton::getStepSize)
+    .method("getMinHessian", &OptimizerNewton::getMinHessian)
+  ;
+
   class_<OptimizerAGBM> ("OptimizerAGBM")
     .derives<OptimizerWrapper> ("Optimizer")
     .constructor  ()
@@ -3258,6 +4599,15 @@ RCPP_MODULE(optimizer_module)
     .method("getParameterMatrix", &OptimizerAGBM::getParameterMatrix)
     .method("getErrorCorrectedPseudoResiduals", &OptimizerAGBM::getErrorCorrectedPseudoResiduals)
   ;
+
+  class_<OptimizerFeatureParallel> ("OptimizerFeatureParallel")
+    .derives<OptimizerWrapper> ("Optimizer")
+    .constructor <TransportWrapper&> ()
+    .constructor <OptimizerWrapper, bool> ()
+    .method("getStepSize", &OptimizerFeatureParallel::getStepSize)
+    .method("stopWorkers", &OptimizerFeatureParallel::stopWorkers)
+    .method("isStopped",   &OptimizerFeatureParallel::isStopped)
+  ;
 }
 
 
@@ -3310,14 +4660,19 @@ RCPP_MODULE(optimizer_module)
 //' * `$getEstimatedParameter()`: `() -> list(matrix())`
 //' * `$getParameterAtIteration()`: `() -> list(matrix())`
 //' * `$getParameterMatrix()`: `() -> matrix()`
+//' * `$getParameterPath()`: `character(), integer(1), integer(1) -> list(character(), matrix())` Coefficient path of the given factories (all selected if empty) for iterations `from` to `to`.
+//' * `$writeParameterPath()`: `character(1), character(), integer(1), integer(1), integer(1) -> ()` Write the coefficient path in chunks of rows into a csv file.
 //' * `$predictFactoryTrainData()`: `() -> matrix()`
 //' * `$predictFactoryNewData()`: `list(Data*) -> matrix()`
 //' * `$predictIndividualTrainData()`: `() -> list(matrix())` Get the linear contribution of each base learner for the training data.
 //' * `$predictIndividual()`: `list(Data*) -> list(matrix())` Get the linear contribution of each base learner for new data.
 //' * `$predict()`: `list(Data*), logical(1) -> matrix()`
+//' * `$predictStaged()`: `list(Data*), integer(), logical(1) -> matrix()` Prediction after each of the given (increasing) iterations, one column per iteration. All iterations if empty.
+//' * `$getStagedRisk()`: `list(Data*), Response*, Loss*, integer() -> numeric()` Empirical risk of new data after each of the given iterations.
 //' * `$summarizeCompboost()`: `() -> ()`
 //' * `$isTrained()`: `() -> logical(1)`
 //' * `$setToIteration()`: `() -> ()`
+//' * `$setCheckpointInterval()`: `integer(1) -> ()` Store the aggregated parameter every `m` iterations (default 500) to speed up `$setToIteration()`.
 //' * `$saveJson()`: `() -> ()`
 //' * `$getOffset()`: `() -> numeric(1) | matrix()`
 //' * `$getRiskVector()`: `() -> numeric()`
@@ -3329,6 +4684,10 @@ RCPP_MODULE(optimizer_module)
 //' * `$useGlobalStopping()`: `() -> logical(1)*`
 //' * `$getFactoryMap()`: `() -> list(Baselearner*)`
 //' * `$getDataMap()`: `() -> list(Data*)`
+//' * `$getProfile()`: `() -> data.frame()` Phase table of a registered [LoggerProfile].
+//' * `$exportProfileTrace()`: `character(1) -> ()` Write the timeline of a registered [LoggerProfile] as Chrome trace event JSON.
+//' * `$getMemoryReport()`: `() -> data.frame()` Heap memory in bytes per component, object, and part. Shared objects are counted once.
+//' * `$getFeatureImportance()`: `() -> data.frame()` Risk reduction, number of selections, and L2 norm of the prediction updates per base learner accumulated during training.
 //' @examples
 //'
 //' # Some data:
@@ -3474,7 +4833,7 @@ class CompboostWrapper
       unique_ptr_cboost->continueTraining(trace);
     }
 
-    arma::vec getPrediction (bool as_response)
+    arma::mat getPrediction (bool as_response)
     {
       return unique_ptr_cboost->getPrediction(as_response);
     }
@@ -3489,6 +4848,16 @@ class CompboostWrapper
       return unique_ptr_cboost->getSelectedBaselearner();
     }
 
+    std::vector<std::string> getSelectedBaselearnerPerIteration ()
+    {
+      return unique_ptr_cboost->getSelectedBaselearnerPerIteration();
+    }
+
+    unsigned int getCurrentIteration ()
+    {
+      return unique_ptr_cboost->getCurrentIteration();
+    }
+
     Rcpp::List getLoggerData ()
     {
       Rcpp::List out_list;
@@ -3535,6 +4904,30 @@ class CompboostWrapper
     }
 
 
+    Rcpp::List getParameterPath (const std::vector<std::string>& factory_ids, const unsigned int from, const unsigned int to)
+    {
+      if (from > to) {
+        Rcpp::stop("Iterations of the coefficient path must satisfy from <= to.");
+      }
+      const blearnertrack::BaselearnerTrack& track = unique_ptr_cboost->getBaselearnerTrack();
+
+      std::vector<std::string> names = track.getParameterPathNames(factory_ids);
+      arma::mat path(to - from + 1, names.size());
+      track.fillParameterPath(factory_ids, from, to, path);
+
+      return Rcpp::List::create(
+        Rcpp::Named("parameter_names")   = names,
+        Rcpp::Named("parameter_matrix")  = path,
+        Rcpp::Named("iterations")        = arma::regspace<arma::uvec>(from, to)
+      );
+    }
+
+    void writeParameterPath (const std::string& file, const std::vector<std::string>& factory_ids, const unsigned int from,
+      const unsigned int to, const unsigned int chunk_size)
+    {
+      unique_ptr_cboost->getBaselearnerTrack().writeParameterPath(file, factory_ids, from, to, chunk_size);
+    }
+
     arma::mat predictFactoryTrainData (const std::string& factory_id) { return unique_ptr_cboost->predictFactory(factory_id); }
 
     arma::mat predictFactoryNewData (const std::string& factory_id, const Rcpp::List& newdata) {
@@ -3562,7 +4955,36 @@ class CompboostWrapper
     }
 
 
-    arma::vec predict (Rcpp::List& newdata, bool as_response)
+    Rcpp::NumericMatrix predict (Rcpp::List& newdata, bool as_response)
+    {
+      std::map<std::string, std::shared_ptr<data::Data>> data_map;
+
+      for (unsigned int i = 0; i < newdata.size(); i++) {
+        DataWrapper* temp = newdata[i];
+        data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
+      }
+      if (data_map.size() == 0) Rcpp::stop("Require data in 'newdata' for prediction.");
+
+      // The prediction is written into the memory of the returned R matrix:
+      Rcpp::NumericMatrix out(data_map.begin()->second->getNObs(), unique_ptr_cboost->getResponse()->getResponseNCols());
+      arma::mat pred(out.begin(), out.nrow(), out.ncol(), false, true);
+      unique_ptr_cboost->predict(data_map, as_response, pred);
+
+      return out;
+    }
+
+    arma::mat predictStaged (Rcpp::List& newdata, const std::vector<unsigned int>& iters, bool as_response)
+    {
+      std::map<std::string, std::shared_ptr<data::Data>> data_map;
+
+      for (unsigned int i = 0; i < newdata.size(); i++) {
+        DataWrapper* temp = newdata[i];
+        data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
+      }
+      return unique_ptr_cboost->predictStaged(data_map, iters, as_response);
+    }
+
+    arma::vec getStagedRisk (Rcpp::List& newdata, ResponseWrapper& response, LossWrapper& loss, const std::vector<unsigned int>& iters)
     {
       std::map<std::string, std::shared_ptr<data::Data>> data_map;
 
@@ -3570,12 +4992,13 @@ class CompboostWrapper
         DataWrapper* temp = newdata[i];
         data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
       }
-      return unique_ptr_cboost->predict(data_map, as_response);
+      return unique_ptr_cboost->riskStaged(data_map, response.getResponseObj(), loss.getLoss(), iters);
     }
 
     void summarizeCompboost () const { unique_ptr_cboost->summarizeCompboost(); }
     bool isTrained () const { return is_trained; }
     void setToIteration (const unsigned int& k, const unsigned int& trace) { unique_ptr_cboost->setToIteration(k, trace); }
+    void setCheckpointInterval (const unsigned int m) { unique_ptr_cboost->setCheckpointInterval(m); }
 
     void saveJson(std::string file, bool rm_data) { unique_ptr_cboost->saveJson(file, rm_data); }
 
@@ -3640,36 +5063,866 @@ class CompboostWrapper
       return out;
     }
 
-    ~CompboostWrapper () {}
-};
+    Rcpp::DataFrame getProfile () const
+    {
+      return profilerToDataFrame(unique_ptr_cboost->getLoggerList()->getProfiler());
+    }
 
+    void exportProfileTrace (const std::string file) const
+    {
+      auto sh_ptr_profiler = unique_ptr_cboost->getLoggerList()->getProfiler();
+      if (sh_ptr_profiler == nullptr) {
+        Rcpp::stop("No profiler available. Register a 'LoggerProfile' before training.");
+      }
+      sh_ptr_profiler->exportTrace(file);
+    }
 
-RCPP_EXPOSED_CLASS(CompboostWrapper)
-RCPP_MODULE (compboost_module)
-{
-  using namespace Rcpp;
+    Rcpp::DataFrame getFeatureImportance () const
+    {
+      std::vector<std::string>  baselearner;
+      std::vector<double>       risk_reduction;
+      std::vector<unsigned int> selections;
+      std::vector<double>       l2_contribution;
+      for (auto& it : unique_ptr_cboost->getFeatureImportance()) {
+        baselearner.push_back(it.first);
+        risk_reduction.push_back(it.second.risk_reduction);
+        selections.push_back(it.second.selections);
+        l2_contribution.push_back(it.second.l2_contribution);
+      }
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("baselearner")      = baselearner,
+        Rcpp::Named("risk_reduction")   = risk_reduction,
+        Rcpp::Named("selections")       = selections,
+        Rcpp::Named("l2_contribution")  = l2_contribution,
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
 
-  class_<CompboostWrapper> ("Compboost_internal")
-    .constructor<ResponseWrapper&, double, bool, BlearnerFactoryListWrapper&, LossWrapper&, LoggerListWrapper&, OptimizerWrapper&> ()
-    .constructor<std::string> ()
+    Rcpp::DataFrame getMemoryReport () const
+    {
+      memreport::MemoryReport report = unique_ptr_cboost->memoryReport();
+      arma::vec bytes = report.getBytes();
+
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("component") = report.getComponents(),
+        Rcpp::Named("object")    = report.getObjects(),
+        Rcpp::Named("part")      = report.getParts(),
+        Rcpp::Named("bytes")     = Rcpp::NumericVector(bytes.begin(), bytes.end()),
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
 
-    .method("train",                      &CompboostWrapper::train)
-    .method("continueTraining",           &CompboostWrapper::continueTraining)
-    .method("getLearningRate",            &CompboostWrapper::getLearningRate)
-    .method("getPrediction",              &CompboostWrapper::getPrediction)
-    .method("getSelectedBaselearner",     &CompboostWrapper::getSelectedBaselearner)
-    .method("getLoggerData",              &CompboostWrapper::getLoggerData)
-    .method("getEstimatedParameter",      &CompboostWrapper::getEstimatedParameter)
-    .method("getParameterAtIteration",    &CompboostWrapper::getParameterAtIteration)
+    ~CompboostWrapper () {}
+};
+
+
+//' @title Estimate the cost of a training
+//'
+//' @description
+//' [CostPlanner] predicts the time per iteration, the setup time of the
+//' factories, and the peak memory of a training before it is started. The
+//' prediction uses the registered factories (number of parameters, design
+//' size, sparse or binned design) and the time of elementary kernel
+//' operations, which are measured on the host by `$calibrate()`.
+//' The factories can be defined on a subsample of the data, the cost is
+//' scaled to `n_obs` observations.
+//'
+//' @format [S4] object.
+//' @name CostPlanner
+//'
+//' @section Usage:
+//' \preformatted{
+//' CostPlanner$new(factory_list, optimizer, n_obs, num_logger)
+//' }
+//'
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The registered factories.
+//' @template param-optimizer
+//' @param n_obs (`integer(1)`)\cr
+//' Number of observations of the training.
+//' @param num_logger (`integer(1)`)\cr
+//' Number of logger used while training.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$calibrate()`: `integer(1) -> ()` Time the kernels with the given number of repetitions.
+//' * `$getKernelCosts()`: `() -> list()` Nanoseconds per elementary operation.
+//' * `$getFactoryPlans()`: `() -> data.frame()`
+//' * `$getIterationTime()`: `integer(1) -> numeric()` Microseconds per iteration and component for the given number of threads.
+//' * `$getSetupTime()`: `() -> numeric()` Microseconds per factory.
+//' * `$getPeakMemory()`: `integer(1) -> numeric()` Bytes per component for the given number of iterations.
+//' * `$recommendThreads()`: `() -> integer(1)`
+//' * `$getRecommendations()`: `() -> character()`
+//' @examples
+//' data_source = InMemoryData$new(as.matrix(mtcars$hp), "hp")
+//' fac = BaselearnerPSpline$new(data_source, list(n_knots = 10, df = 4))
+//' factory_list = BlearnerFactoryList$new()
+//' factory_list$registerFactory(fac)
+//'
+//' planner = CostPlanner$new(factory_list, OptimizerCoordinateDescent$new(), 1e6, 1)
+//' planner$calibrate(5)
+//' planner$getIterationTime(1)
+//' planner$getRecommendations()
+//' @export CostPlanner
+class CostPlannerWrapper
+{
+  private:
+    std::shared_ptr<planner::CostPlanner> sh_ptr_planner;
+
+  public:
+    CostPlannerWrapper (BlearnerFactoryListWrapper& factory_list, OptimizerWrapper& optimizer,
+      unsigned int n_obs, unsigned int num_logger)
+    {
+      sh_ptr_planner = std::make_shared<planner::CostPlanner>(factory_list.getFactoryList(),
+        optimizer.getOptimizer(), n_obs, num_logger);
+    }
+
+    void calibrate (unsigned int reps)
+    {
+      sh_ptr_planner->calibrate(reps);
+    }
+
+    Rcpp::List getKernelCosts () const
+    {
+      planner::KernelCosts costs = sh_ptr_planner->getKernelCosts();
+      return Rcpp::List::create(
+        Rcpp::Named("dense_mv")   = costs.dense_mv,
+        Rcpp::Named("sparse_mv")  = costs.sparse_mv,
+        Rcpp::Named("bin")        = costs.bin,
+        Rcpp::Named("solve")      = costs.solve,
+        Rcpp::Named("elem")       = costs.elem,
+        Rcpp::Named("chol")       = costs.chol,
+        Rcpp::Named("eig")        = costs.eig,
+        Rcpp::Named("fork")       = costs.fork,
+        Rcpp::Named("calibrated") = costs.calibrated
+      );
+    }
+
+    Rcpp::DataFrame getFactoryPlans () const
+    {
+      std::vector<std::string> id, model;
+      std::vector<double> n_obs, n_params, n_elem, bytes;
+      std::vector<bool> sparse, binning;
+      for (auto& fp : sh_ptr_planner->getFactoryPlans()) {
+        id.push_back(fp.factory_id);
+        model.push_back(fp.model_name);
+        n_obs.push_back(fp.n_obs);
+        n_params.push_back(fp.n_params);
+        n_elem.push_back(fp.n_elem);
+        bytes.push_back(fp.bytes);
+        sparse.push_back(fp.uses_sparse);
+        binning.push_back(fp.uses_binning);
+      }
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("factory")          = id,
+        Rcpp::Named("model")            = model,
+        Rcpp::Named("n_obs")            = n_obs,
+        Rcpp::Named("n_params")         = n_params,
+        Rcpp::Named("n_elem")           = n_elem,
+        Rcpp::Named("bytes")            = bytes,
+        Rcpp::Named("sparse")           = sparse,
+        Rcpp::Named("binning")          = binning,
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
+
+    Rcpp::NumericVector getIterationTime (unsigned int num_threads) const
+    {
+      return Rcpp::wrap(sh_ptr_planner->iterationTime(num_threads));
+    }
+
+    Rcpp::NumericVector getSetupTime () const
+    {
+      return Rcpp::wrap(sh_ptr_planner->setupTime());
+    }
+
+    Rcpp::NumericVector getPeakMemory (unsigned int iterations) const
+    {
+      return Rcpp::wrap(sh_ptr_planner->peakMemory(iterations));
+    }
+
+    unsigned int recommendThreads () const
+    {
+      return sh_ptr_planner->recommendThreads();
+    }
+
+    std::vector<std::string> getRecommendations () const
+    {
+      return sh_ptr_planner->recommendations();
+    }
+};
+
+
+//' @title Cross validation on shared factory data
+//'
+//' @description
+//' [CrossValidation] trains one model per fold with the coordinate descent. The
+//' factories are built once on the full data and shared by all folds. A fold just
+//' holds its own decomposition of the penalized system of each base learner, its
+//' prediction scores, and its parameters. Hence, the setup of the spline bases,
+//' binning, and penalties is done once instead of once per fold. The folds are
+//' trained in parallel. The out of bag risk is recorded in each iteration.
+//' Custom base learners are not supported.
+//'
+//' @format [S4] object.
+//' @name CrossValidation
+//'
+//' @section Usage:
+//' \preformatted{
+//' CrossValidation$new(response, factory_list, loss, learning_rate, folds, ncores)
+//' }
+//'
+//' @param response ([ResponseRegr] | [ResponseBinaryClassif])\cr
+//' The response of all observations.
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The registered factories.
+//' @template param-loss
+//' @param learning_rate (`numeric(1)`)\cr
+//' Learning rate of the models.
+//' @param folds (`integer()`)\cr
+//' Fold of each observation, numbered from `1` to the number of folds.
+//' @template param-ncores
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$train()`: `integer(1) -> ()` Train all folds for the given number of further iterations.
+//' * `$getNumberOfFolds()`: `() -> integer(1)`
+//' * `$getCurrentIteration()`: `() -> integer(1)`
+//' * `$getInbagRisk()`: `() -> matrix()` Risk of the offset and after each iteration (rows) per fold (columns).
+//' * `$getOobRisk()`: `() -> matrix()` Same as `$getInbagRisk()` for the held out observations.
+//' * `$getOptimalIteration()`: `() -> integer(1)` Iteration with the smallest mean out of bag risk.
+//' * `$getOobPrediction()`: `() -> matrix()` Score of each observation predicted by the model it is held out from.
+//' * `$getSelectedBaselearner()`: `() -> list()` Selected factories per fold.
+//' * `$getEstimatedParameter()`: `integer(1) -> list()` Parameters of the given fold.
+//' * `$getMemoryReport()`: `() -> data.frame()`
+//'
+//' @examples
+//' data_source = InMemoryData$new(as.matrix(mtcars$hp), "hp")
+//' fac = BaselearnerPSpline$new(data_source, list(n_knots = 10, df = 4))
+//' factory_list = BlearnerFactoryList$new()
+//' factory_list$registerFactory(fac)
+//'
+//' response = ResponseRegr$new("mpg", as.matrix(mtcars$mpg))
+//' folds = rep_len(1:4, nrow(mtcars))
+//' cv = CrossValidation$new(response, factory_list, LossQuadratic$new(), 0.1, folds, 1)
+//' cv$train(100)
+//' cv$getOptimalIteration()
+//' @export CrossValidation
+class CrossValidationWrapper
+{
+  private:
+    std::shared_ptr<resampling::CrossValidation> sh_ptr_cv;
+
+  public:
+    CrossValidationWrapper (ResponseWrapper& response, BlearnerFactoryListWrapper& factory_list,
+      LossWrapper& loss, double learning_rate, arma::uvec folds, unsigned int num_threads)
+    {
+      if (folds.min() < 1) Rcpp::stop("Folds must be numbered starting with 1.");
+      sh_ptr_cv = std::make_shared<resampling::CrossValidation>(response.getResponseObj(), loss.getLoss(),
+        factory_list.getFactoryList(), learning_rate, folds - 1, num_threads);
+    }
+
+    void train (unsigned int iterations)
+    {
+      sh_ptr_cv->train(iterations);
+    }
+
+    unsigned int getNumberOfFolds    () const { return sh_ptr_cv->getNumberOfFolds(); }
+    unsigned int getCurrentIteration () const { return sh_ptr_cv->getCurrentIteration(); }
+    unsigned int getOptimalIteration () const { return sh_ptr_cv->getOptimalIteration(); }
+    arma::mat    getInbagRisk        () const { return sh_ptr_cv->getInbagRisk(); }
+    arma::mat    getOobRisk          () const { return sh_ptr_cv->getOobRisk(); }
+    arma::mat    getOobPrediction    () const { return sh_ptr_cv->getOobPrediction(); }
+
+    Rcpp::List getSelectedBaselearner () const
+    {
+      Rcpp::List out;
+      for (auto& it : sh_ptr_cv->getSelectedBaselearner()) {
+        out.push_back(Rcpp::wrap(it));
+      }
+      return out;
+    }
+
+    Rcpp::List getEstimatedParameter (unsigned int fold) const
+    {
+      if (fold < 1) Rcpp::stop("Folds are numbered starting with 1.");
+      Rcpp::List out;
+      for (auto& it : sh_ptr_cv->getParameter(fold - 1)) {
+        out[it.first] = it.second;
+      }
+      return out;
+    }
+
+    Rcpp::DataFrame getMemoryReport () const
+    {
+      memreport::MemoryReport report;
+      sh_ptr_cv->reportMemory(report);
+      arma::vec bytes = report.getBytes();
+
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("component") = report.getComponents(),
+        Rcpp::Named("object")    = report.getObjects(),
+        Rcpp::Named("part")      = report.getParts(),
+        Rcpp::Named("bytes")     = Rcpp::NumericVector(bytes.begin(), bytes.end()),
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
+};
+
+
+//' @title Bagged ensemble on shared factory data
+//'
+//' @description
+//' [BaggedEnsemble] trains one model per bootstrap sample with the coordinate
+//' descent. A bootstrap sample is represented by the number of times each
+//' observation is drawn. These counts are used as weights, which is the same as
+//' training on the duplicated observations. Hence, the factories are built once on
+//' the full data and shared by all members, while a member just holds its counts,
+//' the decomposition of its penalized systems, its scores, and its parameters.
+//' The members are trained in parallel. Because all members use the same
+//' factories, the mean prediction is the prediction with the averaged parameters.
+//' Custom base learners are not supported.
+//'
+//' @format [S4] object.
+//' @name BaggedEnsemble
+//'
+//' @section Usage:
+//' \preformatted{
+//' BaggedEnsemble$new(response, factory_list, loss, learning_rate, replicates, seed, ncores)
+//' }
+//'
+//' @param response ([ResponseRegr] | [ResponseBinaryClassif])\cr
+//' The response of all observations.
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The registered factories.
+//' @template param-loss
+//' @param learning_rate (`numeric(1)`)\cr
+//' Learning rate of the members.
+//' @param replicates (`integer(1)`)\cr
+//' Number of bootstrap samples.
+//' @param seed (`integer(1)`)\cr
+//' Seed used to draw the bootstrap samples.
+//' @template param-ncores
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$train()`: `integer(1) -> ()` Train all members for the given number of further iterations.
+//' * `$getNumberOfReplicates()`: `() -> integer(1)`
+//' * `$getCurrentIteration()`: `() -> integer(1)`
+//' * `$getSeed()`: `() -> integer(1)`
+//' * `$getCounts()`: `() -> matrix()` Number of draws of each observation (rows) per member (columns).
+//' * `$getInbagRisk()`: `() -> matrix()` Risk of the offset and after each iteration (rows) per member (columns).
+//' * `$getOobRisk()`: `() -> matrix()` Same as `$getInbagRisk()` for the observations not drawn.
+//' * `$getOobPrediction()`: `() -> matrix()` Mean score of each observation over the members it is not drawn by.
+//' * `$getSelectedBaselearner()`: `() -> list()` Selected factories per member.
+//' * `$getEstimatedParameter()`: `integer(1) -> list()` Parameters of the given member.
+//' * `$predict()`: `list(Data*), logical(1) -> matrix()` Mean prediction of the members.
+//' * `$predictMembers()`: `list(Data*), logical(1) -> matrix()` Prediction of each member (columns).
+//' * `$getMemoryReport()`: `() -> data.frame()`
+//'
+//' @examples
+//' data_source = InMemoryData$new(as.matrix(mtcars$hp), "hp")
+//' fac = BaselearnerPSpline$new(data_source, list(n_knots = 10, df = 4))
+//' factory_list = BlearnerFactoryList$new()
+//' factory_list$registerFactory(fac)
+//'
+//' response = ResponseRegr$new("mpg", as.matrix(mtcars$mpg))
+//' ens = BaggedEnsemble$new(response, factory_list, LossQuadratic$new(), 0.1, 20, 31415, 1)
+//' ens$train(100)
+//' ens$predict(list(data_source), FALSE)
+//' @export BaggedEnsemble
+class BaggedEnsembleWrapper
+{
+  private:
+    std::shared_ptr<resampling::BaggedEnsemble> sh_ptr_ens;
+
+    static mdata toDataMap (Rcpp::List& newdata)
+    {
+      mdata data_map;
+      for (unsigned int i = 0; i < newdata.size(); i++) {
+        DataWrapper* temp = newdata[i];
+        data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
+      }
+      return data_map;
+    }
+
+  public:
+    BaggedEnsembleWrapper (ResponseWrapper& response, BlearnerFactoryListWrapper& factory_list,
+      LossWrapper& loss, double learning_rate, unsigned int replicates, unsigned int seed, unsigned int num_threads)
+    {
+      sh_ptr_ens = std::make_shared<resampling::BaggedEnsemble>(response.getResponseObj(), loss.getLoss(),
+        factory_list.getFactoryList(), learning_rate, replicates, seed, num_threads);
+    }
+
+    void train (unsigned int iterations)
+    {
+      sh_ptr_ens->train(iterations);
+    }
+
+    unsigned int getNumberOfReplicates () const { return sh_ptr_ens->getNumberOfReplicates(); }
+    unsigned int getCurrentIteration   () const { return sh_ptr_ens->getCurrentIteration(); }
+    unsigned int getSeed               () const { return sh_ptr_ens->getSeed(); }
+    arma::mat    getCounts             () const { return sh_ptr_ens->getCounts(); }
+    arma::mat    getInbagRisk          () const { return sh_ptr_ens->getInbagRisk(); }
+    arma::mat    getOobRisk            () const { return sh_ptr_ens->getOobRisk(); }
+    arma::mat    getOobPrediction      () const { return sh_ptr_ens->getOobPrediction(); }
+
+    arma::mat predict (Rcpp::List& newdata, bool as_response)
+    {
+      return sh_ptr_ens->predict(toDataMap(newdata), as_response);
+    }
+
+    arma::mat predictMembers (Rcpp::List& newdata, bool as_response)
+    {
+      return sh_ptr_ens->predictMembers(toDataMap(newdata), as_response);
+    }
+
+    Rcpp::List getSelectedBaselearner () const
+    {
+      Rcpp::List out;
+      for (auto& it : sh_ptr_ens->getSelectedBaselearner()) {
+        out.push_back(Rcpp::wrap(it));
+      }
+      return out;
+    }
+
+    Rcpp::List getEstimatedParameter (unsigned int replicate) const
+    {
+      if (replicate < 1) Rcpp::stop("Replicates are numbered starting with 1.");
+      Rcpp::List out;
+      for (auto& it : sh_ptr_ens->getParameter(replicate - 1)) {
+        out[it.first] = it.second;
+      }
+      return out;
+    }
+
+    Rcpp::DataFrame getMemoryReport () const
+    {
+      memreport::MemoryReport report;
+      sh_ptr_ens->reportMemory(report);
+      arma::vec bytes = report.getBytes();
+
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("component") = report.getComponents(),
+        Rcpp::Named("object")    = report.getObjects(),
+        Rcpp::Named("part")      = report.getParts(),
+        Rcpp::Named("bytes")     = Rcpp::NumericVector(bytes.begin(), bytes.end()),
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
+};
+
+
+//' @title Train multiple model configurations in lockstep
+//'
+//' @description
+//' [ModelSweep] trains one model per configuration (loss and learning rate) with
+//' the coordinate descent on the same factories. The pseudo residuals of all models
+//' are stacked into a matrix. Each factory computes the cross product with all models
+//' in one matrix product and solves its shared system for all of them at once. Each
+//' model selects its own base learner and keeps its own track of parameters. Hence,
+//' a sweep of \eqn{M} configurations costs much less than \eqn{M} separate fits.
+//' Custom base learners are not supported.
+//'
+//' @format [S4] object.
+//' @name ModelSweep
+//'
+//' @section Usage:
+//' \preformatted{
+//' ModelSweep$new(response, factory_list, losses, learning_rates, ncores)
+//' }
+//'
+//' @param response ([ResponseRegr] | [ResponseBinaryClassif])\cr
+//' The response with one column.
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The registered factories.
+//' @param losses (`list()`)\cr
+//' The loss of each model, e.g. [LossQuadratic] or [LossHuber].
+//' @param learning_rates (`numeric()`)\cr
+//' The learning rate of each model.
+//' @template param-ncores
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$train()`: `integer(1) -> ()` Train all models for the given number of further iterations.
+//' * `$getNumberOfModels()`: `() -> integer(1)`
+//' * `$getCurrentIteration()`: `() -> integer(1)`
+//' * `$getLearningRates()`: `() -> numeric()`
+//' * `$getOffset()`: `() -> list()` Offset of each model.
+//' * `$getRisk()`: `() -> matrix()` Risk of the offset and after each iteration (rows) per model (columns).
+//' * `$getPrediction()`: `() -> matrix()` Scores of the training data per model (columns).
+//' * `$getSelectedBaselearner()`: `() -> list()` Selected factories per model.
+//' * `$getEstimatedParameter()`: `integer(1) -> list()` Parameters of the given model.
+//' * `$predict()`: `list(Data*), logical(1) -> matrix()` Prediction of each model (columns).
+//' * `$getMemoryReport()`: `() -> data.frame()`
+//'
+//' @examples
+//' data_source = InMemoryData$new(as.matrix(mtcars$hp), "hp")
+//' fac = BaselearnerPSpline$new(data_source, list(n_knots = 10, df = 4))
+//' factory_list = BlearnerFactoryList$new()
+//' factory_list$registerFactory(fac)
+//'
+//' response = ResponseRegr$new("mpg", as.matrix(mtcars$mpg))
+//' losses = list(LossQuadratic$new(), LossQuadratic$new(), LossHuber$new(2))
+//' sweep = ModelSweep$new(response, factory_list, losses, c(0.05, 0.1, 0.1), 1)
+//' sweep$train(100)
+//' sweep$getRisk()[101, ]
+//' @export ModelSweep
+class ModelSweepWrapper
+{
+  private:
+    std::shared_ptr<sweep::ModelSweep> sh_ptr_sweep;
+
+  public:
+    ModelSweepWrapper (ResponseWrapper& response, BlearnerFactoryListWrapper& factory_list,
+      Rcpp::List losses, std::vector<double> learning_rates, unsigned int num_threads)
+    {
+      std::vector<std::shared_ptr<loss::Loss>> loss_vec;
+      for (unsigned int i = 0; i < losses.size(); i++) {
+        LossWrapper* temp = losses[i];
+        loss_vec.push_back(temp->getLoss());
+      }
+      sh_ptr_sweep = std::make_shared<sweep::ModelSweep>(response.getResponseObj(), loss_vec, learning_rates,
+        factory_list.getFactoryList(), num_threads);
+    }
+
+    void train (unsigned int iterations)
+    {
+      sh_ptr_sweep->train(iterations);
+    }
+
+    unsigned int        getNumberOfModels   () const { return sh_ptr_sweep->getNumberOfModels(); }
+    unsigned int        getCurrentIteration () const { return sh_ptr_sweep->getCurrentIteration(); }
+    std::vector<double> getLearningRates    () const { return sh_ptr_sweep->getLearningRates(); }
+    arma::mat           getRisk             () const { return sh_ptr_sweep->getRisk(); }
+    arma::mat           getPrediction       () const { return sh_ptr_sweep->getPredictionScores(); }
+
+    Rcpp::List getOffset () const
+    {
+      Rcpp::List out;
+      for (auto& it : sh_ptr_sweep->getOffsets()) {
+        out.push_back(it);
+      }
+      return out;
+    }
+
+    arma::mat predict (Rcpp::List& newdata, bool as_response)
+    {
+      std::map<std::string, std::shared_ptr<data::Data>> data_map;
+
+      for (unsigned int i = 0; i < newdata.size(); i++) {
+        DataWrapper* temp = newdata[i];
+        data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
+      }
+      return sh_ptr_sweep->predict(data_map, as_response);
+    }
+
+    Rcpp::List getSelectedBaselearner () const
+    {
+      Rcpp::List out;
+      for (auto& it : sh_ptr_sweep->getSelectedBaselearner()) {
+        out.push_back(Rcpp::wrap(it));
+      }
+      return out;
+    }
+
+    Rcpp::List getEstimatedParameter (unsigned int model) const
+    {
+      if (model < 1) Rcpp::stop("Models are numbered starting with 1.");
+      Rcpp::List out;
+      for (auto& it : sh_ptr_sweep->getParameter(model - 1)) {
+        out[it.first] = it.second;
+      }
+      return out;
+    }
+
+    Rcpp::DataFrame getMemoryReport () const
+    {
+      memreport::MemoryReport report;
+      sh_ptr_sweep->reportMemory(report);
+      arma::vec bytes = report.getBytes();
+
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("component") = report.getComponents(),
+        Rcpp::Named("object")    = report.getObjects(),
+        Rcpp::Named("part")      = report.getParts(),
+        Rcpp::Named("bytes")     = Rcpp::NumericVector(bytes.begin(), bytes.end()),
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
+};
+
+
+//' @title Worker of a distributed training
+//'
+//' @description
+//' [DistributedWorker] owns a row shard of the data and the response. Per
+//' iteration, it sends the cross products of the pseudo residuals with the
+//' design of each factory to the coordinator ([DistributedCoordinator]) and
+//' updates the scores of its rows with the selected base learner. The design
+//' of the shard is created by the factories in the same way as for predictions,
+//' hence the factories must be the same as those of the coordinator.
+//'
+//' @format [S4] object.
+//' @name DistributedWorker
+//'
+//' @section Usage:
+//' \preformatted{
+//' DistributedWorker$new(factory_list, data, response, loss, transport)
+//' }
+//'
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The registered factories.
+//' @param data (`list()`)\cr
+//' The data objects of the shard (e.g. [InMemoryData]).
+//' @param response ([ResponseRegr] | [ResponseBinaryClassif] | [ResponseMulticlass])\cr
+//' The response of the shard.
+//' @param loss ([LossQuadratic] | [LossBinomial] | ...)\cr
+//' The loss.
+//' @param transport ([SocketTransport])\cr
+//' The transport with a rank greater than 0.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$train()`: `integer(1) -> ()` Train for the given number of further iterations.
+//' * `$getCurrentIteration()`: `() -> integer(1)`
+//' * `$getPrediction()`: `() -> matrix()` Scores of the shard.
+//'
+//' @export DistributedWorker
+class DistributedWorkerWrapper
+{
+  private:
+    std::shared_ptr<distributed::ShardWorker> sh_ptr_worker;
+
+  public:
+    DistributedWorkerWrapper (BlearnerFactoryListWrapper& factory_list, Rcpp::List data, ResponseWrapper& response,
+      LossWrapper& loss, TransportWrapper& transport)
+    {
+      mdata data_map;
+      for (unsigned int i = 0; i < data.size(); i++) {
+        DataWrapper* temp = data[i];
+        data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
+      }
+      sh_ptr_worker = std::make_shared<distributed::ShardWorker>(transport.getTransport(),
+        factory_list.getFactoryList(), data_map, response.getResponseObj(), loss.getLoss());
+    }
+
+    void train (unsigned int iterations)
+    {
+      sh_ptr_worker->train(iterations);
+    }
+
+    unsigned int getCurrentIteration () const { return sh_ptr_worker->getCurrentIteration(); }
+    arma::mat    getPrediction       () const { return sh_ptr_worker->getPredictionScores(); }
+};
+
+
+//' @title Worker of a feature parallel training
+//'
+//' @description
+//' [FeatureParallelWorker] evaluates its share of the factories for an
+//' [OptimizerFeatureParallel] in another process. `$serve()` blocks until the
+//' coordinator stops the workers. The factory at position `i` of `factory_ids`
+//' is owned by the worker with rank `(i - 1) %% size`. The factory list just
+//' needs the owned factories, hence a worker instantiates only their data.
+//'
+//' @format [S4] object.
+//' @name FeatureParallelWorker
+//'
+//' @section Usage:
+//' \preformatted{
+//' FeatureParallelWorker$new(factory_list, factory_ids, transport)
+//' }
+//'
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The owned factories (further factories are ignored).
+//' @param factory_ids (`character()`)\cr
+//' Ids of all factories of the coordinator (`getRegisteredFactoryNames()`).
+//' @param transport ([SocketTransport])\cr
+//' The transport with a rank greater than 0.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$serve()`: `() -> ()` Answer the coordinator until it stops the workers.
+//' * `$getOwnedFactories()`: `() -> character()`
+//' * `$getNumberOfIterations()`: `() -> integer(1)`
+//'
+//' @export FeatureParallelWorker
+class FeatureParallelWorkerWrapper
+{
+  private:
+    std::shared_ptr<distributed::FeatureWorker> sh_ptr_worker;
+
+  public:
+    FeatureParallelWorkerWrapper (BlearnerFactoryListWrapper& factory_list, std::vector<std::string> factory_ids,
+      TransportWrapper& transport)
+    {
+      sh_ptr_worker = std::make_shared<distributed::FeatureWorker>(transport.getTransport(), factory_list.getFactoryList(), factory_ids);
+    }
+
+    void serve () { sh_ptr_worker->serve(); }
+
+    std::vector<std::string> getOwnedFactories     () const { return sh_ptr_worker->getOwnedFactories(); }
+    unsigned int             getNumberOfIterations () const { return sh_ptr_worker->getNumberOfIterations(); }
+};
+
+
+//' @title Coordinator of a distributed training
+//'
+//' @description
+//' [DistributedCoordinator] trains a model with the coordinate descent on row
+//' shards owned by [DistributedWorker]s in other processes. The statistics of the
+//' shards are summed up, the coordinator solves the penalized least squares
+//' problem of each factory, selects the base learner with the smallest SSE, and
+//' sends the update to the workers. Without binning, the result equals the
+//' training on all rows. The offset is computed from the mean of the response
+//' for the quadratic, binomial, and multinomial loss. For other losses (e.g. the
+//' absolute loss) and weighted responses, the response of the shards is sent to
+//' the coordinator once.
+//' Custom base learners are not supported.
+//'
+//' @format [S4] object.
+//' @name DistributedCoordinator
+//'
+//' @section Usage:
+//' \preformatted{
+//' DistributedCoordinator$new(factory_list, loss, learning_rate, transport)
+//' }
+//'
+//' @param factory_list ([BlearnerFactoryList])\cr
+//' The registered factories.
+//' @param loss ([LossQuadratic] | [LossBinomial] | ...)\cr
+//' The loss.
+//' @param learning_rate (`numeric(1)`)\cr
+//' The learning rate.
+//' @param transport ([SocketTransport])\cr
+//' The transport with rank 0.
+//'
+//' @section Fields:
+//' This class doesn't contain public fields.
+//'
+//' @section Methods:
+//' * `$train()`: `integer(1) -> ()` Train for the given number of further iterations.
+//' * `$getCurrentIteration()`: `() -> integer(1)`
+//' * `$getNumberOfObservations()`: `() -> numeric(1)` Sum of the rows of all shards.
+//' * `$getOffset()`: `() -> matrix()`
+//' * `$getRisk()`: `() -> numeric()` Risk of the offset and after each iteration.
+//' * `$getSelectedBaselearner()`: `() -> character()`
+//' * `$getEstimatedParameter()`: `() -> list()`
+//' * `$predict()`: `list(Data*) -> matrix()` Scores of new data.
+//' * `$getMemoryReport()`: `() -> data.frame()`
+//'
+//' @examples
+//' \dontrun{
+//' # See `Compboost$trainDistributed()` for the setup of the processes.
+//' }
+//' @export DistributedCoordinator
+class DistributedCoordinatorWrapper
+{
+  private:
+    std::shared_ptr<distributed::Coordinator> sh_ptr_coordinator;
+
+  public:
+    DistributedCoordinatorWrapper (BlearnerFactoryListWrapper& factory_list, LossWrapper& loss,
+      double learning_rate, TransportWrapper& transport)
+    {
+      sh_ptr_coordinator = std::make_shared<distributed::Coordinator>(transport.getTransport(),
+        factory_list.getFactoryList(), loss.getLoss(), learning_rate);
+    }
+
+    void train (unsigned int iterations)
+    {
+      sh_ptr_coordinator->train(iterations);
+    }
+
+    unsigned int             getCurrentIteration     () const { return sh_ptr_coordinator->getCurrentIteration(); }
+    double                   getNumberOfObservations () const { return sh_ptr_coordinator->getNumberOfObservations(); }
+    arma::mat                getOffset               () const { return sh_ptr_coordinator->getOffset(); }
+    arma::vec                getRisk                 () const { return sh_ptr_coordinator->getRisk(); }
+    std::vector<std::string> getSelectedBaselearner  () const { return sh_ptr_coordinator->getSelectedBaselearner(); }
+
+    Rcpp::List getEstimatedParameter () const
+    {
+      Rcpp::List out;
+      for (auto& it : sh_ptr_coordinator->getParameter()) {
+        out[it.first] = it.second;
+      }
+      return out;
+    }
+
+    arma::mat predict (Rcpp::List& newdata)
+    {
+      std::map<std::string, std::shared_ptr<data::Data>> data_map;
+
+      for (unsigned int i = 0; i < newdata.size(); i++) {
+        DataWrapper* temp = newdata[i];
+        data_map[ temp->getDataObj()->getDataIdentifier() ] = temp->getDataObj();
+      }
+      return sh_ptr_coordinator->predict(data_map);
+    }
+
+    Rcpp::DataFrame getMemoryReport () const
+    {
+      memreport::MemoryReport report;
+      sh_ptr_coordinator->reportMemory(report);
+      arma::vec bytes = report.getBytes();
+
+      return Rcpp::DataFrame::create(
+        Rcpp::Named("component") = report.getComponents(),
+        Rcpp::Named("object")    = report.getObjects(),
+        Rcpp::Named("part")      = report.getParts(),
+        Rcpp::Named("bytes")     = Rcpp::NumericVector(bytes.begin(), bytes.end()),
+        Rcpp::Named("stringsAsFactors") = false
+      );
+    }
+};
+
+
+RCPP_EXPOSED_CLASS(CompboostWrapper)
+RCPP_MODULE (compboost_module)
+{
+  using namespace Rcpp;
+
+  class_<CompboostWrapper> ("Compboost_internal")
+    .constructor<ResponseWrapper&, double, bool, BlearnerFactoryListWrapper&, LossWrapper&, LoggerListWrapper&, OptimizerWrapper&> ()
+    .constructor<std::string> ()
+
+    .method("train",                      &CompboostWrapper::train)
+    .method("continueTraining",           &CompboostWrapper::continueTraining)
+    .method("getLearningRate",            &CompboostWrapper::getLearningRate)
+    .method("getPrediction",              &CompboostWrapper::getPrediction)
+    .method("getSelectedBaselearner",     &CompboostWrapper::getSelectedBaselearner)
+    .method("getSelectedBaselearnerPerIteration", &CompboostWrapper::getSelectedBaselearnerPerIteration)
+    .method("getCurrentIteration",        &CompboostWrapper::getCurrentIteration)
+    .method("getLoggerData",              &CompboostWrapper::getLoggerData)
+    .method("getEstimatedParameter",      &CompboostWrapper::getEstimatedParameter)
+    .method("getParameterAtIteration",    &CompboostWrapper::getParameterAtIteration)
     .method("getParameterMatrix",         &CompboostWrapper::getParameterMatrix)
+    .method("getParameterPath",           &CompboostWrapper::getParameterPath)
+    .method("writeParameterPath",         &CompboostWrapper::writeParameterPath)
     .method("predictFactoryTrainData",    &CompboostWrapper::predictFactoryTrainData)
     .method("predictFactoryNewData",      &CompboostWrapper::predictFactoryNewData)
     .method("predictIndividualTrainData", &CompboostWrapper::predictIndividualTrainData)
     .method("predictIndividual",          &CompboostWrapper::predictIndividual)
     .method("predict",                    &CompboostWrapper::predict)
+    .method("predictStaged",              &CompboostWrapper::predictStaged)
+    .method("getStagedRisk",              &CompboostWrapper::getStagedRisk)
     .method("summarizeCompboost",         &CompboostWrapper::summarizeCompboost)
     .method("isTrained",                  &CompboostWrapper::isTrained)
     .method("setToIteration",             &CompboostWrapper::setToIteration)
+    .method("setCheckpointInterval",      &CompboostWrapper::setCheckpointInterval)
     .method("saveJson",                   &CompboostWrapper::saveJson)
     .method("getOffset",                  &CompboostWrapper::getOffset)
     .method("getRiskVector",              &CompboostWrapper::getRiskVector)
@@ -3681,6 +5934,114 @@ RCPP_MODULE (compboost_module)
     .method("useGlobalStopping",          &CompboostWrapper::useGlobalStopping)
     .method("getFactoryMap",              &CompboostWrapper::getFactoryMap)
     .method("getDataMap",                 &CompboostWrapper::getDataMap)
+    .method("getProfile",                 &CompboostWrapper::getProfile)
+    .method("exportProfileTrace",         &CompboostWrapper::exportProfileTrace)
+    .method("getMemoryReport",            &CompboostWrapper::getMemoryReport)
+    .method("getFeatureImportance",       &CompboostWrapper::getFeatureImportance)
+  ;
+
+  class_<CostPlannerWrapper> ("CostPlanner")
+    .constructor<BlearnerFactoryListWrapper&, OptimizerWrapper&, unsigned int, unsigned int> ()
+
+    .method("calibrate",          &CostPlannerWrapper::calibrate)
+    .method("getKernelCosts",     &CostPlannerWrapper::getKernelCosts)
+    .method("getFactoryPlans",    &CostPlannerWrapper::getFactoryPlans)
+    .method("getIterationTime",   &CostPlannerWrapper::getIterationTime)
+    .method("getSetupTime",       &CostPlannerWrapper::getSetupTime)
+    .method("getPeakMemory",      &CostPlannerWrapper::getPeakMemory)
+    .method("recommendThreads",   &CostPlannerWrapper::recommendThreads)
+    .method("getRecommendations", &CostPlannerWrapper::getRecommendations)
+  ;
+
+  class_<CrossValidationWrapper> ("CrossValidation")
+    .constructor<ResponseWrapper&, BlearnerFactoryListWrapper&, LossWrapper&, double, arma::uvec, unsigned int> ()
+
+    .method("train",                  &CrossValidationWrapper::train)
+    .method("getNumberOfFolds",       &CrossValidationWrapper::getNumberOfFolds)
+    .method("getCurrentIteration",    &CrossValidationWrapper::getCurrentIteration)
+    .method("getOptimalIteration",    &CrossValidationWrapper::getOptimalIteration)
+    .method("getInbagRisk",           &CrossValidationWrapper::getInbagRisk)
+    .method("getOobRisk",             &CrossValidationWrapper::getOobRisk)
+    .method("getOobPrediction",       &CrossValidationWrapper::getOobPrediction)
+    .method("getSelectedBaselearner", &CrossValidationWrapper::getSelectedBaselearner)
+    .method("getEstimatedParameter",  &CrossValidationWrapper::getEstimatedParameter)
+    .method("getMemoryReport",        &CrossValidationWrapper::getMemoryReport)
+  ;
+
+  class_<BaggedEnsembleWrapper> ("BaggedEnsemble")
+    .constructor<ResponseWrapper&, BlearnerFactoryListWrapper&, LossWrapper&, double, unsigned int, unsigned int, unsigned int> ()
+
+    .method("train",                  &BaggedEnsembleWrapper::train)
+    .method("getNumberOfReplicates",  &BaggedEnsembleWrapper::getNumberOfReplicates)
+    .method("getCurrentIteration",    &BaggedEnsembleWrapper::getCurrentIteration)
+    .method("getSeed",                &BaggedEnsembleWrapper::getSeed)
+    .method("getCounts",              &BaggedEnsembleWrapper::getCounts)
+    .method("getInbagRisk",           &BaggedEnsembleWrapper::getInbagRisk)
+    .method("getOobRisk",             &BaggedEnsembleWrapper::getOobRisk)
+    .method("getOobPrediction",       &BaggedEnsembleWrapper::getOobPrediction)
+    .method("getSelectedBaselearner", &BaggedEnsembleWrapper::getSelectedBaselearner)
+    .method("getEstimatedParameter",  &BaggedEnsembleWrapper::getEstimatedParameter)
+    .method("predict",                &BaggedEnsembleWrapper::predict)
+    .method("predictMembers",         &BaggedEnsembleWrapper::predictMembers)
+    .method("getMemoryReport",        &BaggedEnsembleWrapper::getMemoryReport)
+  ;
+
+  class_<ModelSweepWrapper> ("ModelSweep")
+    .constructor<ResponseWrapper&, BlearnerFactoryListWrapper&, Rcpp::List, std::vector<double>, unsigned int> ()
+
+    .method("train",                  &ModelSweepWrapper::train)
+    .method("getNumberOfModels",      &ModelSweepWrapper::getNumberOfModels)
+    .method("getCurrentIteration",    &ModelSweepWrapper::getCurrentIteration)
+    .method("getLearningRates",       &ModelSweepWrapper::getLearningRates)
+    .method("getOffset",              &ModelSweepWrapper::getOffset)
+    .method("getRisk",                &ModelSweepWrapper::getRisk)
+    .method("getPrediction",          &ModelSweepWrapper::getPrediction)
+    .method("getSelectedBaselearner", &ModelSweepWrapper::getSelectedBaselearner)
+    .method("getEstimatedParameter",  &ModelSweepWrapper::getEstimatedParameter)
+    .method("predict",                &ModelSweepWrapper::predict)
+    .method("getMemoryReport",        &ModelSweepWrapper::getMemoryReport)
+  ;
+
+  class_<TransportWrapper> ("Transport")
+    .method("getRank",          &TransportWrapper::getRank)
+    .method("getSize",          &TransportWrapper::getSize)
+    .method("getBytesSent",     &TransportWrapper::getBytesSent)
+    .method("getBytesReceived", &TransportWrapper::getBytesReceived)
+  ;
+
+  class_<SocketTransportWrapper> ("SocketTransport")
+    .derives<TransportWrapper> ("Transport")
+    .constructor<std::string, unsigned int, unsigned int, double> ()
+  ;
+
+  class_<DistributedWorkerWrapper> ("DistributedWorker")
+    .constructor<BlearnerFactoryListWrapper&, Rcpp::List, ResponseWrapper&, LossWrapper&, TransportWrapper&> ()
+
+    .method("train",               &DistributedWorkerWrapper::train)
+    .method("getCurrentIteration", &DistributedWorkerWrapper::getCurrentIteration)
+    .method("getPrediction",       &DistributedWorkerWrapper::getPrediction)
+  ;
+
+  class_<FeatureParallelWorkerWrapper> ("FeatureParallelWorker")
+    .constructor<BlearnerFactoryListWrapper&, std::vector<std::string>, TransportWrapper&> ()
+
+    .method("serve",                 &FeatureParallelWorkerWrapper::serve)
+    .method("getOwnedFactories",     &FeatureParallelWorkerWrapper::getOwnedFactories)
+    .method("getNumberOfIterations", &FeatureParallelWorkerWrapper::getNumberOfIterations)
+  ;
+
+  class_<DistributedCoordinatorWrapper> ("DistributedCoordinator")
+    .constructor<BlearnerFactoryListWrapper&, LossWrapper&, double, TransportWrapper&> ()
+
+    .method("train",                   &DistributedCoordinatorWrapper::train)
+    .method("getCurrentIteration",     &DistributedCoordinatorWrapper::getCurrentIteration)
+    .method("getNumberOfObservations", &DistributedCoordinatorWrapper::getNumberOfObservations)
+    .method("getOffset",               &DistributedCoordinatorWrapper::getOffset)
+    .method("getRisk",                 &DistributedCoordinatorWrapper::getRisk)
+    .method("getSelectedBaselearner",  &DistributedCoordinatorWrapper::getSelectedBaselearner)
+    .method("getEstimatedParameter",   &DistributedCoordinatorWrapper::getEstimatedParameter)
+    .method("predict",                 &DistributedCoordinatorWrapper::predict)
+    .method("getMemoryReport",         &DistributedCoordinatorWrapper::getMemoryReport)
   ;
 }
 
@@ -36,6 +36,9 @@ sdata jsonToData (const json& j)
   if (j["Class"] == "CategoricalDataRaw") {
     d = std::make_shared<CategoricalDataRaw>(j);
   }
+  if (j["Class"] == "MappedData") {
+    d = std::make_shared<MappedData>(j);
+  }
   if (d == nullptr) {
     throw std::logic_error("No known class in JSON");
   }
@@ -174,8 +177,14 @@ void Data::setCacheCustom (const std::string ctype, const arma::mat& X)
   _mat_cache = std::make_pair(ctype, X);
 }
 
-void Data::setDenseData  (const arma::mat& X)    { _use_sparse = false; _data_mat = X; }
-void Data::setSparseData (const arma::sp_mat& X) { _use_sparse = true; _sparse_data_mat = X; }
+void Data::setDenseData  (const arma::mat& X)    { releaseExternalMemory(); _use_sparse = false; _data_mat = X; }
+void Data::setSparseData (const arma::sp_mat& X) { releaseExternalMemory(); _use_sparse = true; _sparse_data_mat = X; }
+
+void Data::releaseExternalMemory ()
+{
+  _ptr_external = nullptr;
+  _sh_ptr_owner = nullptr;
+}
 
 void Data::setCache (const std::string cache_type, const arma::mat& xtx)
 {
@@ -226,6 +235,9 @@ arma::mat   Data::getCacheMat  () const
 
 arma::mat Data::getDenseData () const
 {
+  if (_ptr_external) return arma::mat(const_cast<double*>(_ptr_external), _nrows_external, _ncols_external, false, true);
+  // Paths that need the full design (e.g. row subsets) read it from disk:
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->denseDesign();
   if (_use_sparse) {
     arma::mat out(_sparse_data_mat);
     return out;
@@ -234,11 +246,201 @@ arma::mat Data::getDenseData () const
   }
 }
 
-arma::sp_mat        Data::getSparseData    () const { return _sparse_data_mat; }
+arma::sp_mat Data::getSparseData () const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->sparseDesign();
+  return _sparse_data_mat;
+}
+
 arma::uvec          Data::getBinningIndex  () const { return _bin_idx; }
 bool                Data::usesSparseMatrix () const { return _use_sparse; }
 bool                Data::usesBinning      () const { return _use_binning; }
 std::vector<double> Data::getMinMax        () const { return _minmax; }
+bool                Data::usesChunks       () const { return static_cast<bool>(_sh_ptr_chunks); }
+bool                Data::usesExternalMemory () const { return _ptr_external != nullptr; }
+
+std::shared_ptr<chunked::ChunkedDesign> Data::getChunkedDesign () const { return _sh_ptr_chunks; }
+
+// Number of bytes read when the design is used once (e.g. to train a base-learner):
+double Data::getDesignBytes () const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getFileBytes();
+  if (_ptr_external) return static_cast<double>(_nrows_external) * _ncols_external * sizeof(double);
+  double bytes = _bin_idx.n_elem * sizeof(arma::uword);
+  if (_use_sparse) {
+    bytes += _sparse_data_mat.n_nonzero * (sizeof(double) + sizeof(arma::uword));
+  } else {
+    bytes += _data_mat.n_elem * sizeof(double);
+  }
+  return bytes;
+}
+
+// Number of stored elements of the design (non-zeros for sparse matrices):
+double Data::getDesignNElem () const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getNElem();
+  if (_ptr_external) return static_cast<double>(_nrows_external) * _ncols_external;
+  if (_use_sparse) return _sparse_data_mat.n_nonzero;
+  return _data_mat.n_elem;
+}
+
+// Number of unique rows of the design, i.e. the number of bins if binning is used:
+unsigned int Data::getNDesignRows () const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getNRows();
+  if (_ptr_external) return _nrows_external;
+  if (_use_sparse) return _sparse_data_mat.n_cols;
+  return _data_mat.n_rows;
+}
+
+/**
+ * \brief Weights of the design rows for weights of the original rows
+ *
+ * With binning the weights are summed up per bin, hence the result can be shared
+ * by all data objects with the same index vector. As for the binning functions,
+ * a single weight of one means that all weights are one.
+ */
+arma::vec Data::accumulateWeights (const arma::vec& w) const
+{
+  if (_use_binning) return binning::accumulateBinWeights(_bin_idx, w, getNDesignRows());
+  if ((w.size() == 1) && (w(0) == 1)) return arma::vec(getNDesignRows(), arma::fill::ones);
+  return w;
+}
+
+/**
+ * \brief Weighted Gram matrix \f$X^TWX\f$
+ *
+ * \param wcum `arma::vec` Weights of the design rows (see `accumulateWeights`).
+ */
+arma::mat Data::weightedGram (const arma::vec& wcum) const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->weightedGram(wcum);
+  if (_use_sparse) return binning::binnedSparseMatMultWeighted(_sparse_data_mat, wcum);
+  return binning::binnedMatMultWeighted(_data_mat, wcum);
+}
+
+/**
+ * \brief Cross product \f$X^Tr\f$ with one column per column of `r`
+ *
+ * With binning, the rows of `r` are accumulated per bin first. Hence, all
+ * columns are multiplied with the design in one matrix product.
+ */
+arma::mat Data::crossProduct (const arma::mat& r) const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->crossProduct(r);
+  if (! _use_binning) {
+    if (_use_sparse) return arma::mat(_sparse_data_mat * r);
+    return _data_mat.t() * r;
+  }
+  arma::mat rcum = binning::accumulateBinRows(_bin_idx, r, getNDesignRows());
+  if (_use_sparse) return arma::mat(_sparse_data_mat * rcum);
+  return _data_mat.t() * rcum;
+}
+
+/**
+ * \brief Linear predictor \f$X\beta\f$ for the original rows
+ *
+ * The parameter can have multiple columns, e.g. one per model.
+ */
+arma::mat Data::linearPredictor (const arma::mat& param) const
+{
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->linearPredictor(param);
+  arma::mat pred;
+  if (_use_sparse) {
+    pred = (param.t() * _sparse_data_mat).t();
+  } else {
+    pred = _data_mat * param;
+  }
+  if (_use_binning) return pred.rows(_bin_idx);
+  return pred;
+}
+
+/**
+ * \brief Recover the penalty matrix from the cached system
+ *
+ * The cache holds (a decomposition of) \f$A = X^TX + P\f$, subtracting the
+ * Gram matrix gives the penalty \f$P\f$. The unpenalized linear base learner
+ * caches summary statistics and has no penalty. An empty matrix is returned
+ * if the system is unknown (e.g. data of custom base learners).
+ */
+arma::mat Data::impliedPenalty () const
+{
+  const unsigned int p = _use_sparse ? _sparse_data_mat.n_rows : _data_mat.n_cols;
+  const arma::mat& cache = _mat_cache.second;
+
+  arma::mat A;
+  if (_mat_cache.first == "cholesky") A = cache.t() * cache;
+  if (_mat_cache.first == "inverse")  A = arma::inv_sympd(arma::symmatu(cache));
+  if (_mat_cache.first == "identity") {
+    if (cache.n_cols == 2) return arma::mat(p, p, arma::fill::zeros);
+    if (cache.n_cols == 1) A = arma::diagmat(1 / cache.col(0));
+  }
+  if (A.is_empty()) return arma::mat();
+
+  arma::mat P = A - weightedGram(accumulateWeights(arma::vec(1, arma::fill::ones)));
+  return 0.5 * (P + P.t());
+}
+
+/**
+ * \brief Add the heap memory of the data object to the report
+ *
+ * The object is visited just once, hence data shared by multiple factories or
+ * logger is counted for the component which reports it first.
+ */
+void Data::reportMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  if (! report.visit(this)) return;
+
+  std::string obj = _data_identifier + " (" + _type + ")";
+  report.add(component, obj, "design",        memreport::matBytes(_data_mat));
+  report.add(component, obj, "design_sparse", memreport::spMatBytes(_sparse_data_mat));
+  report.add(component, obj, "bin_idx",       memreport::uvecBytes(_bin_idx));
+  report.add(component, obj, "cache",         memreport::matBytes(_mat_cache.second));
+  report.add(component, obj, "minmax",        memreport::stdVecBytes(_minmax));
+  if (_sh_ptr_chunks) report.add(component, obj, "chunk_buffer", _sh_ptr_chunks->getBufferBytes());
+  if (_ptr_external)  report.add(component, obj, "external", getDesignBytes());
+}
+
+/**
+ * \brief Stream the design from disk in blocks of rows
+ *
+ * The design is written into `path` and the memory is released. Afterwards,
+ * `crossProduct()`, `linearPredictor()`, and `weightedGram()` read the blocks
+ * from disk. Binned designs are not spilled since they are already small.
+ *
+ * \param path `std::string` Temporary file of the design.
+ * \param block_rows `unsigned int` Number of rows per block.
+ */
+void Data::spillDesign (const std::string path, const unsigned int block_rows)
+{
+  if (_sh_ptr_chunks) return;
+  if (_use_binning) Rcpp::stop("The binned design of " + _data_identifier + " can't be streamed from disk.");
+
+  if (_use_sparse) {
+    _sh_ptr_chunks   = std::make_shared<chunked::ChunkedDesign>(path, _sparse_data_mat, block_rows);
+    _sparse_data_mat = arma::sp_mat();
+  } else {
+    _sh_ptr_chunks = std::make_shared<chunked::ChunkedDesign>(path, _data_mat, block_rows);
+    _data_mat      = arma::mat();
+  }
+}
+
+/**
+ * \brief Use a design that is already streamed from disk
+ *
+ * Used for designs that are built in blocks of rows, the design in memory is released.
+ */
+void Data::setChunkedDesign (const std::shared_ptr<chunked::ChunkedDesign>& sh_ptr_chunks)
+{
+  releaseExternalMemory();
+  _use_sparse = sh_ptr_chunks->isSparse();
+  if (_use_sparse) {
+    _sparse_data_mat = arma::sp_mat();
+  } else {
+    _data_mat = arma::mat();
+  }
+  _sh_ptr_chunks = sh_ptr_chunks;
+}
 
 json Data::baseToJson (const std::string cln, const bool rm_data) const
 {
@@ -250,8 +452,14 @@ json Data::baseToJson (const std::string cln, const bool rm_data) const
     jdata_sparse = saver::armaSpMatToJson(arma::sp_mat(zero));
     jmcache = saver::armaMatToJson(zero);
     jbin_idx = saver::armaUvecToJson(one);
+  } else if (_sh_ptr_chunks) {
+    // The saved model does not depend on the file of the streamed design:
+    jdata = saver::armaMatToJson(_use_sparse ? _data_mat : _sh_ptr_chunks->denseDesign());
+    jdata_sparse = saver::armaSpMatToJson(_sh_ptr_chunks->sparseDesign());
+    jmcache = saver::armaMatToJson(_mat_cache.second);
+    jbin_idx = saver::armaUvecToJson(_bin_idx);
   } else {
-    jdata = saver::armaMatToJson(_data_mat);
+    jdata = saver::armaMatToJson(_ptr_external ? getDenseData() : _data_mat);
     jdata_sparse = saver::armaSpMatToJson(_sparse_data_mat);
     jmcache = saver::armaMatToJson(_mat_cache.second);
     jbin_idx = saver::armaUvecToJson(_bin_idx);
@@ -294,6 +502,29 @@ InMemoryData::InMemoryData (const std::string data_identifier, const arma::sp_ma
   : Data::Data ( data_identifier, std::string("in_memory"), raw_sp_data )
 { }
 
+/**
+ * \brief Data without a copy of the memory of another object
+ *
+ * \param data_identifier `std::string` Name of the data.
+ * \param ptr `const double*` Column-major memory of the data.
+ * \param nrows `unsigned int` Number of rows.
+ * \param ncols `unsigned int` Number of columns.
+ * \param owner `std::shared_ptr<void>` Keeps the memory alive as long as the data object exists.
+ */
+InMemoryData::InMemoryData (const std::string data_identifier, const double* ptr, const unsigned int nrows,
+  const unsigned int ncols, const std::shared_ptr<void>& owner)
+  : Data::Data ( data_identifier, std::string("in_memory") )
+{
+  _ptr_external   = ptr;
+  _nrows_external = nrows;
+  _ncols_external = ncols;
+  _sh_ptr_owner   = owner;
+  _data_mat.reset();
+
+  const arma::mat x = getDenseData();
+  _minmax = std::vector<double>{x.min(), x.max()};
+}
+
 InMemoryData::InMemoryData (const json& j)
   : Data::Data ( j )
 { }
@@ -305,6 +536,8 @@ arma::mat InMemoryData::getData () const
 
 unsigned int InMemoryData::getNObs () const
 {
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getNRows();
+  if (_ptr_external) return _nrows_external;
   if (_use_sparse) {
     return _sparse_data_mat.n_cols;
   } else {
@@ -314,6 +547,8 @@ unsigned int InMemoryData::getNObs () const
 
 unsigned int InMemoryData::getNCols () const
 {
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getNCols();
+  if (_ptr_external) return _ncols_external;
   if (_use_sparse) {
     return _sparse_data_mat.n_rows;
   } else {
@@ -354,6 +589,7 @@ arma::mat BinnedData::getData () const
 
 unsigned int BinnedData::getNObs () const
 {
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getNRows();
   if (_use_sparse) {
     return _sparse_data_mat.n_cols;
   } else {
@@ -363,6 +599,7 @@ unsigned int BinnedData::getNObs () const
 
 unsigned int BinnedData::getNCols () const
 {
+  if (_sh_ptr_chunks) return _sh_ptr_chunks->getNCols();
   if (_use_sparse) {
     return _sparse_data_mat.n_rows;
   } else {
@@ -370,6 +607,12 @@ unsigned int BinnedData::getNCols () const
   }
 }
 
+// Zero if the data is not binned (as for the attributes of the factories):
+unsigned int BinnedData::getBinRoot () const
+{
+  return _use_binning ? _bin_root : 0;
+}
+
 json BinnedData::toJson (const bool rm_data) const
 {
   json j = Data::baseToJson("BinnedData", rm_data);
@@ -379,6 +622,59 @@ json BinnedData::toJson (const bool rm_data) const
 }
 
 
+// MappedData:
+// ---------------------------------
+
+MappedData::MappedData (const std::string data_identifier, const std::shared_ptr<colstore::ColumnStore>& sh_ptr_store,
+  const std::string column)
+  : Data::Data    ( data_identifier, std::string("mapped"),
+      std::vector<double>{sh_ptr_store->getColumn(column).min, sh_ptr_store->getColumn(column).max} ),
+    _sh_ptr_store ( sh_ptr_store ),
+    _column       ( column )
+{
+  if (_sh_ptr_store->getColumn(column).type != "numeric") {
+    Rcpp::stop("Column \"" + column + "\" is not numeric, use a categorical data source.");
+  }
+}
+
+MappedData::MappedData (const json& j)
+  : Data::Data    ( j ),
+    _sh_ptr_store ( colstore::openColumnStore(j["_store_path"].get<std::string>()) ),
+    _column       ( j["_column"].get<std::string>() )
+{ }
+
+arma::mat MappedData::getData () const
+{
+  // Use the mapped memory without copying (the mapping is private, writes do
+  // not reach the file):
+  return arma::mat(const_cast<double*>(_sh_ptr_store->numericColumn(_column)), _sh_ptr_store->getNRows(), 1, false, false);
+}
+
+unsigned int MappedData::getNObs  () const { return _sh_ptr_store->getNRows(); }
+unsigned int MappedData::getNCols () const { return 1; }
+
+std::shared_ptr<colstore::ColumnStore> MappedData::getStore  () const { return _sh_ptr_store; }
+std::string                            MappedData::getColumn () const { return _column; }
+
+json MappedData::toJson (const bool rm_data) const
+{
+  json j = Data::baseToJson("MappedData", rm_data);
+  j["_store_path"] = _sh_ptr_store->getPath();
+  j["_column"]     = _column;
+
+  return j;
+}
+
+void MappedData::reportMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  if (! report.isVisited(this)) {
+    report.add(component, getDataIdentifier() + " (" + getType() + ")", "mapped_resident",
+      _sh_ptr_store->residentBytes(_column));
+  }
+  Data::reportMemory(report, component);
+}
+
+
 // CategoricalDataRaw:
 // ---------------------------------
 
@@ -387,10 +683,40 @@ CategoricalDataRaw::CategoricalDataRaw (const std::string data_identifier, const
     _raw_data  ( raw_data )
 { }
 
+CategoricalDataRaw::CategoricalDataRaw (const std::string data_identifier,
+  const std::shared_ptr<colstore::ColumnStore>& sh_ptr_store, const std::string column)
+  : Data::Data    ( std::string(data_identifier), std::string("categorical") ),
+    _sh_ptr_store ( sh_ptr_store ),
+    _column       ( column )
+{
+  if (_sh_ptr_store->getColumn(column).type != "categorical") {
+    Rcpp::stop("Column \"" + column + "\" is not categorical, use a numeric data source.");
+  }
+  _ptr_store_codes = _sh_ptr_store->codeColumn(column);
+}
+
+CategoricalDataRaw::CategoricalDataRaw (const std::string data_identifier, const int* codes,
+  const unsigned int n, const std::vector<std::string>& levels, const std::shared_ptr<void>& owner)
+  : Data::Data ( std::string(data_identifier), std::string("categorical") ),
+    _ptr_codes ( codes ),
+    _n_codes   ( n ),
+    _levels    ( levels )
+{
+  _sh_ptr_owner = owner;
+
+  // Missing values get the class "NA" like for strings (a level "NA" is the same class):
+  _na_code = _levels.size();
+  _levels.push_back("NA");
+}
+
 CategoricalDataRaw::CategoricalDataRaw (const json& j)
-  : Data::Data ( json(j) ),
-    _raw_data  ( j["_raw_data"].get<std::vector<std::string>>() )
-{ }
+  : Data::Data    ( json(j) ),
+    _raw_data     ( j.contains("_store_path") ? std::vector<std::string>() : j["_raw_data"].get<std::vector<std::string>>() ),
+    _sh_ptr_store ( j.contains("_store_path") ? colstore::openColumnStore(j["_store_path"].get<std::string>()) : nullptr ),
+    _column       ( j.contains("_column") ? j["_column"].get<std::string>() : "" )
+{
+  if (_sh_ptr_store != nullptr) _ptr_store_codes = _sh_ptr_store->codeColumn(_column);
+}
 
 arma::mat CategoricalDataRaw::getData () const {
   throw std::logic_error("Raw categorical data does not contain a numerical representation, call '$getRawData()' instead");
@@ -400,11 +726,59 @@ arma::mat CategoricalDataRaw::getData () const {
 
 std::vector<std::string> CategoricalDataRaw::getRawData () const
 {
-  return _raw_data;
+  if (! usesCodes()) return _raw_data;
+
+  const std::vector<std::string> levels = getLevels();
+  std::vector<std::string> out(getNObs());
+  for (unsigned int i = 0; i < out.size(); i++) out[i] = levels[getCode(i)];
+  return out;
+}
+
+bool CategoricalDataRaw::usesCodes () const
+{
+  return (_ptr_codes != nullptr) || (_sh_ptr_store != nullptr);
+}
+
+std::vector<std::string> CategoricalDataRaw::getLevels () const
+{
+  if (_sh_ptr_store != nullptr) return _sh_ptr_store->getColumn(_column).levels;
+  return _levels;
+}
+
+unsigned int CategoricalDataRaw::getCode (const unsigned int i) const
+{
+  if (_ptr_codes) {
+    // Codes of an R factor are 1-based, missing values (NA_integer_) are out of range:
+    const int code = _ptr_codes[i];
+    return ((code >= 1) && (static_cast<unsigned int>(code) < _levels.size())) ? code - 1 : _na_code;
+  }
+  if (_ptr_store_codes) return _ptr_store_codes[i];
+  Rcpp::stop("Classes of \"" + getDataIdentifier() + "\" are kept as strings and do not have codes.");
+}
+
+void CategoricalDataRaw::reportMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  if (! report.isVisited(this)) {
+    report.add(component, getDataIdentifier() + " (" + getType() + ")", "raw_strings",
+      memreport::stringVecBytes(_raw_data));
+    if (_sh_ptr_store != nullptr) {
+      report.add(component, getDataIdentifier() + " (" + getType() + ")", "mapped_resident",
+        _sh_ptr_store->residentBytes(_column));
+    }
+    if (_ptr_codes) {
+      report.add(component, getDataIdentifier() + " (" + getType() + ")", "external",
+        static_cast<double>(_n_codes) * sizeof(int));
+      report.add(component, getDataIdentifier() + " (" + getType() + ")", "levels",
+        memreport::stringVecBytes(_levels));
+    }
+  }
+  Data::reportMemory(report, component);
 }
 
 unsigned int CategoricalDataRaw::getNObs () const
 {
+  if (_ptr_codes) return _n_codes;
+  if (_sh_ptr_store != nullptr) return _sh_ptr_store->getNRows();
   return _raw_data.size();
 }
 
@@ -416,12 +790,15 @@ unsigned int CategoricalDataRaw::getNCols () const
 json CategoricalDataRaw::toJson (const bool rm_data) const
 {
   json j = Data::baseToJson("CategoricalDataRaw", rm_data);
-  if (rm_data) {
+  if (_sh_ptr_store != nullptr) {
+    j["_store_path"] = _sh_ptr_store->getPath();
+    j["_column"]     = _column;
+  } else if (rm_data) {
     std::vector<std::string> empty;
     empty.push_back("<REMOVED>");
     j["_raw_data"] = empty;
   } else {
-    j["_raw_data"] = _raw_data;
+    j["_raw_data"] = _ptr_codes ? getRawData() : _raw_data;
   }
 
   return j;
@@ -28,6 +28,9 @@
 #include "splines.h"
 #include "helper.h"
 #include "saver.h"
+#include "memory_report.h"
+#include "column_store.h"
+#include "chunked_design.h"
 
 #include "single_include/nlohmann/json.hpp"
 using json = nlohmann::json;
@@ -60,6 +63,17 @@ protected:
   arma::sp_mat        _sparse_data_mat;
   std::vector<double> _minmax;
 
+  // Design streamed from disk, `_data_mat` and `_sparse_data_mat` are empty then:
+  std::shared_ptr<chunked::ChunkedDesign> _sh_ptr_chunks;
+
+  // Read-only memory of another object (e.g. an R vector) that is kept alive by `_sh_ptr_owner`:
+  const double*         _ptr_external   = nullptr;
+  unsigned int          _nrows_external = 0;
+  unsigned int          _ncols_external = 0;
+  std::shared_ptr<void> _sh_ptr_owner;
+
+  void releaseExternalMemory ();
+
   Data (const std::string, const std::string);
   Data (const std::string, const std::string, const std::vector<double>&);
   Data (const std::string, const std::string, const arma::mat&);
@@ -75,6 +89,7 @@ public:
   virtual unsigned int getNCols () const = 0;
 
   virtual json toJson (const bool = false) const = 0;
+  virtual void reportMemory (memreport::MemoryReport&, const std::string&) const;
 
   // Getter/Setter
   std::string                       getType           () const;
@@ -87,7 +102,23 @@ public:
   arma::uvec                        getBinningIndex   () const;
   bool                              usesSparseMatrix  () const;
   bool                              usesBinning       () const;
+  bool                              usesChunks        () const;
+  bool                              usesExternalMemory () const;
+  std::shared_ptr<chunked::ChunkedDesign> getChunkedDesign () const;
   std::vector<double>               getMinMax         () const;
+  double                            getDesignBytes    () const;
+  double                            getDesignNElem    () const;
+
+  // Products of the design with quantities of the original rows (binning is resolved):
+  unsigned int getNDesignRows   ()                  const;
+  arma::vec    accumulateWeights (const arma::vec&) const;
+  arma::mat    weightedGram      (const arma::vec&) const;
+  arma::mat    crossProduct      (const arma::mat&) const;
+  arma::mat    linearPredictor   (const arma::mat&) const;
+  arma::mat    impliedPenalty    ()                 const;
+
+  void spillDesign       (const std::string, const unsigned int);
+  void setChunkedDesign  (const std::shared_ptr<chunked::ChunkedDesign>&);
 
   void setDenseData   (const arma::mat&);
   void setSparseData  (const arma::sp_mat&);
@@ -118,12 +149,22 @@ sdata extractDataFromMap (const sdata&, const mdata&);
 // InMemoryData:
 // -----------------------
 
+/**
+ * \class InMemoryData
+ *
+ * \brief Data in memory
+ *
+ * The data is either owned or, without a copy, taken from the memory of
+ * another object that is kept alive by the owner pointer (e.g. an R vector).
+ * The external memory is never modified.
+ */
 class InMemoryData : public Data
 {
 public:
   InMemoryData (const std::string);
   InMemoryData (const std::string, const arma::mat&);
   InMemoryData (const std::string, const arma::sp_mat&);
+  InMemoryData (const std::string, const double*, const unsigned int, const unsigned int, const std::shared_ptr<void>&);
   InMemoryData (const json&);
 
   arma::mat getData     () const;
@@ -152,24 +193,82 @@ public:
   BinnedData (const std::string, const unsigned int, const arma::vec&, const arma::vec&);
   BinnedData (const json&);
 
+  arma::mat    getData    () const;
+  unsigned int getNObs    () const;
+  unsigned int getNCols   () const;
+  unsigned int getBinRoot () const;
+
+  json toJson (const bool = false) const;
+};
+
+
+// MappedData:
+// ----------------------------
+
+/**
+ * \class MappedData
+ *
+ * \brief Numeric column of a memory-mapped column store
+ *
+ * `getData()` returns a matrix that uses the mapped memory without a copy.
+ * The minimum and maximum are taken from the header of the store.
+ */
+class MappedData : public Data
+{
+private:
+  const std::shared_ptr<colstore::ColumnStore> _sh_ptr_store;
+  const std::string                            _column;
+
+public:
+  MappedData (const std::string, const std::shared_ptr<colstore::ColumnStore>&, const std::string);
+  MappedData (const json&);
+
   arma::mat    getData  () const;
   unsigned int getNObs  () const;
   unsigned int getNCols () const;
 
-  json toJson (const bool = false) const;
+  std::shared_ptr<colstore::ColumnStore> getStore  () const;
+  std::string                            getColumn () const;
+
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
 // CategoricalDataRaw:
 // ----------------------------
 
+/**
+ * \class CategoricalDataRaw
+ *
+ * \brief Raw classes of a categorical feature
+ *
+ * The classes are either kept as strings or as codes that are translated into
+ * strings by `getRawData()`. The codes are either mapped codes of a column
+ * store or the 1-based integer codes of an R factor, which are used without a
+ * copy (the factor is kept alive by the owner). Missing values of a factor
+ * get the appended level "NA". Factories use the codes directly, the strings are
+ * just materialized by `getRawData()`.
+ */
 class CategoricalDataRaw : public Data
 {
 private:
   std::vector<std::string> _raw_data;
 
+  const std::shared_ptr<colstore::ColumnStore> _sh_ptr_store;
+  const std::string                            _column;
+  const uint32_t*                              _ptr_store_codes = nullptr;
+
+  const int*               _ptr_codes = nullptr;
+  unsigned int             _n_codes   = 0;
+  unsigned int             _na_code   = 0;
+  std::vector<std::string> _levels;
+
 public:
   CategoricalDataRaw (const std::string, const std::vector<std::string>&);
+  CategoricalDataRaw (const std::string, const int*, const unsigned int, const std::vector<std::string>&,
+    const std::shared_ptr<void>&);
+  CategoricalDataRaw (const std::string, const std::shared_ptr<colstore::ColumnStore>&, const std::string);
   CategoricalDataRaw (const json&);
 
   arma::mat                getData    () const;
@@ -177,7 +276,13 @@ public:
   unsigned int             getNCols   () const;
   std::vector<std::string> getRawData () const;
 
-  json toJson (const bool = false) const;
+  // Codes as 0-based index of the levels, not available for classes kept as strings:
+  bool                     usesCodes  () const;
+  std::vector<std::string> getLevels  () const;
+  unsigned int             getCode    (const unsigned int) const;
+
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&, const std::string&) const;
 };
 
 
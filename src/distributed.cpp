@@ -0,0 +1,694 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// ========================================================================== //
+
+#include "distributed.h"
+
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+namespace distributed
+{
+
+// -------------------------------------------------------------------------- //
+// Transport:
+// -------------------------------------------------------------------------- //
+
+double Transport::getBytesSent     () const { return _bytes_sent; }
+double Transport::getBytesReceived () const { return _bytes_received; }
+
+#ifndef _WIN32
+
+static void closeFds (int& listen_fd, std::vector<int>& fds)
+{
+  for (auto& fd : fds) {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+  }
+  if (listen_fd >= 0) ::close(listen_fd);
+  listen_fd = -1;
+}
+
+static void writeAll (const int fd, const char* buf, size_t len)
+{
+  while (len > 0) {
+#ifdef MSG_NOSIGNAL
+    ssize_t n = ::send(fd, buf, len, MSG_NOSIGNAL);
+#else
+    ssize_t n = ::write(fd, buf, len);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      Rcpp::stop("Lost connection while sending: " + std::string(std::strerror(errno)));
+    }
+    buf += n;
+    len -= n;
+  }
+}
+
+static void readAll (const int fd, char* buf, size_t len)
+{
+  while (len > 0) {
+    ssize_t n = ::read(fd, buf, len);
+    if (n == 0) Rcpp::stop("Lost connection, the other process closed the socket.");
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      Rcpp::stop("Lost connection while receiving: " + std::string(std::strerror(errno)));
+    }
+    buf += n;
+    len -= n;
+  }
+}
+
+#endif
+
+/**
+ * \brief Connect the coordinator (rank 0) and the workers
+ *
+ * \param path `std::string` File of the Unix domain socket.
+ * \param rank `unsigned int` Rank of this process, 0 is the coordinator.
+ * \param size `unsigned int` Number of processes (coordinator and workers).
+ * \param timeout `double` Seconds to wait for all connections.
+ */
+SocketTransport::SocketTransport (const std::string path, const unsigned int rank, const unsigned int size,
+  const double timeout)
+  : _path ( path ),
+    _rank ( rank ),
+    _size ( size ),
+    _fds  ( size, -1 )
+{
+#ifdef _WIN32
+  Rcpp::stop("The socket transport is not available on Windows.");
+#else
+  if (size < 2) {
+    Rcpp::stop("The socket transport requires the coordinator and at least one worker.");
+  }
+  if (rank >= size) {
+    Rcpp::stop("Rank " + std::to_string(rank) + " is not available for " + std::to_string(size) + " processes.");
+  }
+  struct sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    Rcpp::stop("The socket path \"" + path + "\" is too long.");
+  }
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+  auto remainingMs = [&deadline] () {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    return ms > 0 ? (int) ms : 0;
+  };
+
+  if (rank == 0) {
+    _listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listen_fd < 0) {
+      Rcpp::stop("Cannot create socket: " + std::string(std::strerror(errno)));
+    }
+    ::unlink(path.c_str());
+    if ((::bind(_listen_fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) || (::listen(_listen_fd, size) < 0)) {
+      std::string msg = std::strerror(errno);
+      closeFds(_listen_fd, _fds);
+      Rcpp::stop("Cannot listen on \"" + path + "\": " + msg);
+    }
+    for (unsigned int k = 1; k < size; k++) {
+      struct pollfd pfd = { _listen_fd, POLLIN, 0 };
+      if (::poll(&pfd, 1, remainingMs()) <= 0) {
+        closeFds(_listen_fd, _fds);
+        ::unlink(path.c_str());
+        Rcpp::stop("Timeout after " + std::to_string(k - 1) + " of " + std::to_string(size - 1) + " workers connected.");
+      }
+      int fd = ::accept(_listen_fd, nullptr, nullptr);
+      if (fd < 0) continue;
+
+      // The first message of a worker is its rank:
+      unsigned int wrank = (unsigned int) recvMat(fd)(0);
+      if ((wrank == 0) || (wrank >= size) || (_fds[wrank] >= 0)) {
+        ::close(fd);
+        closeFds(_listen_fd, _fds);
+        ::unlink(path.c_str());
+        Rcpp::stop("Worker connected with invalid or duplicated rank " + std::to_string(wrank) + ".");
+      }
+      _fds[wrank] = fd;
+    }
+  } else {
+    while (true) {
+      int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      if ((fd >= 0) && (::connect(fd, (struct sockaddr*) &addr, sizeof(addr)) == 0)) {
+        _fds[0] = fd;
+        break;
+      }
+      if (fd >= 0) ::close(fd);
+      if (remainingMs() == 0) {
+        Rcpp::stop("Timeout while connecting to the coordinator at \"" + path + "\".");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    sendMat(_fds[0], arma::mat(1, 1, arma::fill::value(rank)));
+  }
+#endif
+}
+
+unsigned int SocketTransport::getRank () const { return _rank; }
+unsigned int SocketTransport::getSize () const { return _size; }
+
+void SocketTransport::sendMat (const int fd, const arma::mat& m)
+{
+#ifndef _WIN32
+  uint64_t header[2] = { m.n_rows, m.n_cols };
+  writeAll(fd, (const char*) header, sizeof(header));
+  writeAll(fd, (const char*) m.memptr(), m.n_elem * sizeof(double));
+  _bytes_sent += sizeof(header) + m.n_elem * sizeof(double);
+#endif
+}
+
+arma::mat SocketTransport::recvMat (const int fd)
+{
+  arma::mat m;
+#ifndef _WIN32
+  uint64_t header[2];
+  readAll(fd, (char*) header, sizeof(header));
+  m.set_size(header[0], header[1]);
+  readAll(fd, (char*) m.memptr(), m.n_elem * sizeof(double));
+  _bytes_received += sizeof(header) + m.n_elem * sizeof(double);
+#endif
+  return m;
+}
+
+/**
+ * \brief Sum up the matrices of all processes, each process gets the sum
+ *
+ * The coordinator receives the matrices of the workers in the order of the
+ * ranks, hence the sum does not depend on the timing of the workers.
+ */
+void SocketTransport::allReduceSum (arma::mat& m)
+{
+  if (_rank == 0) {
+    for (unsigned int k = 1; k < _size; k++) {
+      arma::mat mk = recvMat(_fds[k]);
+      if (mk.is_empty()) continue;
+      if (m.is_empty()) {
+        m = mk;
+        continue;
+      }
+      if ((mk.n_rows != m.n_rows) || (mk.n_cols != m.n_cols)) {
+        Rcpp::stop("Worker " + std::to_string(k) + " sent a " + std::to_string(mk.n_rows) + "x"
+          + std::to_string(mk.n_cols) + " matrix, expected " + std::to_string(m.n_rows) + "x"
+          + std::to_string(m.n_cols) + ".");
+      }
+      m += mk;
+    }
+    for (unsigned int k = 1; k < _size; k++) sendMat(_fds[k], m);
+  } else {
+    sendMat(_fds[0], m);
+    m = recvMat(_fds[0]);
+  }
+}
+
+void SocketTransport::broadcast (arma::mat& m)
+{
+  if (_rank == 0) {
+    for (unsigned int k = 1; k < _size; k++) sendMat(_fds[k], m);
+  } else {
+    m = recvMat(_fds[0]);
+  }
+}
+
+std::vector<arma::mat> SocketTransport::gather (const arma::mat& m)
+{
+  std::vector<arma::mat> out;
+  if (_rank == 0) {
+    out.push_back(m);
+    for (unsigned int k = 1; k < _size; k++) out.push_back(recvMat(_fds[k]));
+  } else {
+    sendMat(_fds[0], m);
+  }
+  return out;
+}
+
+SocketTransport::~SocketTransport ()
+{
+#ifndef _WIN32
+  closeFds(_listen_fd, _fds);
+  if (_rank == 0) ::unlink(_path.c_str());
+#endif
+}
+
+
+// -------------------------------------------------------------------------- //
+// ShardWorker:
+// -------------------------------------------------------------------------- //
+
+// The unweighted offset of these losses depends on the response just by its column
+// means. The offset of all other losses, and any weighted offset, is computed on the
+// gathered response. `n_weighted` is the number of shards with weights:
+static bool usesMeanOffset (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const double n_weighted)
+{
+  const std::string type = sh_ptr_loss->getType();
+  return (n_weighted == 0) && ((type == "quadratic") || (type == "binomial") || (type == "multinomial"));
+}
+
+ShardWorker::ShardWorker (const std::shared_ptr<Transport>& sh_ptr_transport,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list, const mdata& data_map,
+  const std::shared_ptr<response::Response>& sh_ptr_response, const std::shared_ptr<loss::Loss>& sh_ptr_loss)
+  : _sh_ptr_transport    ( sh_ptr_transport ),
+    _sh_ptr_factory_list ( sh_ptr_factory_list ),
+    _sh_ptr_response     ( sh_ptr_response ),
+    _sh_ptr_loss         ( sh_ptr_loss )
+{
+  if (_sh_ptr_transport->getRank() == 0) {
+    Rcpp::stop("Rank 0 is the coordinator, workers have ranks starting with 1.");
+  }
+  _sh_ptr_response->checkLossCompatibility(_sh_ptr_loss);
+
+  // The factories are ordered by their id, hence all processes use the same order:
+  for (auto& it : _sh_ptr_factory_list->getFactoryMap()) {
+    sdata sh_ptr_data = it.second->instantiateShardData(data_map);
+    if (sh_ptr_data->getNObs() != _sh_ptr_response->getResponse().n_rows) {
+      Rcpp::stop("The shard data of \"" + it.first + "\" has " + std::to_string(sh_ptr_data->getNObs())
+        + " rows but the response has " + std::to_string(_sh_ptr_response->getResponse().n_rows) + ".");
+    }
+    _factory_data.push_back(sh_ptr_data);
+  }
+}
+
+// Sum of the (weighted) loss of the shard:
+double ShardWorker::lossSum () const
+{
+  const arma::mat truth   = _sh_ptr_response->getResponse();
+  const arma::mat weights = _sh_ptr_response->getWeights();
+  if (weights.n_rows == truth.n_rows) return arma::accu(_sh_ptr_loss->weightedLoss(truth, _scores, weights));
+  return arma::accu(_sh_ptr_loss->loss(truth, _scores));
+}
+
+/**
+ * \brief Send the Gram matrices and the response sums, receive the offset
+ *
+ * The response (and the weights) are sent just if the offset of the loss can
+ * not be computed from the unweighted sums, i.e. for losses whose offset is not
+ * based on the mean or if any shard has weights.
+ */
+void ShardWorker::initialize ()
+{
+  const arma::mat truth   = _sh_ptr_response->getResponse();
+  const arma::mat weights = _sh_ptr_response->getWeights();
+  const bool use_weights  = weights.n_rows == truth.n_rows;
+
+  arma::mat packed;
+  for (auto& it : _factory_data) {
+    packed = arma::join_cols(packed, arma::vectorise(it->weightedGram(it->accumulateWeights(arma::vec(1, arma::fill::ones)))));
+  }
+  packed = arma::join_cols(packed, arma::sum(truth, 0).t());
+  packed = arma::join_cols(packed, arma::mat(1, 1, arma::fill::value(use_weights ? 1 : 0)));
+  packed = arma::join_cols(packed, arma::mat(1, 1, arma::fill::value(truth.n_rows)));
+  _sh_ptr_transport->allReduceSum(packed);
+
+  // All processes decide on the all-reduced number of weighted shards:
+  if (! usesMeanOffset(_sh_ptr_loss, packed(packed.n_rows - 2))) {
+    _sh_ptr_transport->gather(use_weights ? arma::join_rows(truth, weights) : truth);
+  }
+  arma::mat offset;
+  _sh_ptr_transport->broadcast(offset);
+  if (offset.n_cols == truth.n_cols) {
+    _scores = arma::repmat(offset, truth.n_rows, 1);
+  } else {
+    _scores = arma::mat(truth.n_rows, truth.n_cols, arma::fill::value(offset[0]));
+  }
+  _is_initialized = true;
+}
+
+/**
+ * \brief Conduct `iterations` iterations on the shard
+ *
+ * Per iteration, the cross products \f$X_w^Tr_w\f$ of all factories and the
+ * loss of the shard are sent in one all-reduce. The update of the selected
+ * factory (already multiplied with the learning rate) is received as
+ * `[factory index, vec(update)]`.
+ */
+void ShardWorker::train (const unsigned int iterations)
+{
+  if (! _is_initialized) initialize();
+
+  const arma::mat truth   = _sh_ptr_response->getResponse();
+  const arma::mat weights = _sh_ptr_response->getWeights();
+  const bool use_weights  = weights.n_rows == truth.n_rows;
+
+  for (unsigned int i = 0; i < iterations; i++) {
+    arma::mat pr = use_weights
+      ? _sh_ptr_loss->calculateWeightedPseudoResiduals(truth, _scores, weights)
+      : _sh_ptr_loss->calculatePseudoResiduals(truth, _scores);
+
+    arma::mat packed;
+    for (auto& it : _factory_data) packed = arma::join_cols(packed, arma::vectorise(it->crossProduct(pr)));
+    packed = arma::join_cols(packed, arma::mat(1, 1, arma::fill::value(lossSum())));
+    _sh_ptr_transport->allReduceSum(packed);
+
+    arma::mat update;
+    _sh_ptr_transport->broadcast(update);
+    const unsigned int j = (unsigned int) update(0);
+    arma::mat param = arma::reshape(update.rows(1, update.n_rows - 1), (update.n_rows - 1) / truth.n_cols, truth.n_cols);
+    _scores += _factory_data[j]->linearPredictor(param);
+  }
+  // Risk of the final scores:
+  arma::mat packed(1, 1, arma::fill::value(lossSum()));
+  _sh_ptr_transport->allReduceSum(packed);
+
+  _current_iter += iterations;
+}
+
+unsigned int ShardWorker::getCurrentIteration () const { return _current_iter; }
+arma::mat    ShardWorker::getPredictionScores () const { return _scores; }
+
+
+// -------------------------------------------------------------------------- //
+// Coordinator:
+// -------------------------------------------------------------------------- //
+
+/**
+ * \brief Coordinator of the workers
+ *
+ * The penalties are recovered from the systems of the factories, hence custom
+ * base learners that do not expose their system are not supported.
+ */
+Coordinator::Coordinator (const std::shared_ptr<Transport>& sh_ptr_transport,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list,
+  const std::shared_ptr<loss::Loss>& sh_ptr_loss, const double learning_rate)
+  : _sh_ptr_transport    ( sh_ptr_transport ),
+    _sh_ptr_factory_list ( sh_ptr_factory_list ),
+    _sh_ptr_loss         ( sh_ptr_loss ),
+    _learning_rate       ( learning_rate ),
+    _blearner_track      ( learning_rate )
+{
+  if (_sh_ptr_transport->getRank() != 0) {
+    Rcpp::stop("The coordinator requires rank 0.");
+  }
+  if (_sh_ptr_factory_list->getFactoryMap().size() == 0) {
+    Rcpp::stop("Could not train without any registered base-learner.");
+  }
+  for (auto& it : _sh_ptr_factory_list->getFactoryMap()) {
+    const std::string model = it.second->getBaseModelName();
+    sdata sh_ptr_data = it.second->getInstantiatedData();
+    if ((model == "custom") || (model == "customcpp") || (sh_ptr_data == nullptr) || sh_ptr_data->impliedPenalty().is_empty()) {
+      Rcpp::stop("Base learner \"" + it.first + "\" does not expose its system and can not be trained distributed.");
+    }
+    _factory_ids.push_back(it.first);
+  }
+}
+
+void Coordinator::recordRisk (const double loss_sum)
+{
+  if (_risk.size() == _current_iter) _risk.push_back(loss_sum / (_nobs * _num_cols));
+}
+
+/**
+ * \brief Set up the systems from the all-reduced Gram matrices and the offset
+ *
+ * For losses whose offset is not a function of the mean response (e.g. the
+ * median of the absolute loss) or with weights, the response of the shards is
+ * gathered once and the (weighted) initializer of the loss is used as in the
+ * training on all rows.
+ */
+void Coordinator::initialize ()
+{
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+
+  arma::mat packed;
+  _sh_ptr_transport->allReduceSum(packed);
+
+  unsigned int pos = 0;
+  for (auto& id : _factory_ids) {
+    arma::mat P = fac_map[id]->getInstantiatedData()->impliedPenalty();
+    const unsigned int p = P.n_rows;
+    arma::mat G = arma::reshape(packed.rows(pos, pos + p * p - 1), p, p);
+    pos += p * p;
+
+    arma::mat A = G + P;
+    arma::mat U;
+    if (arma::chol(U, A)) {
+      _systems.push_back(std::make_pair("cholesky", U));
+    } else {
+      _systems.push_back(std::make_pair("inverse", arma::pinv(A)));
+    }
+    _grams.push_back(G);
+  }
+  _num_cols = packed.n_rows - pos - 2;
+  _nobs     = packed(packed.n_rows - 1);
+
+  if (usesMeanOffset(_sh_ptr_loss, packed(packed.n_rows - 2))) {
+    arma::mat ymean = packed.rows(pos, pos + _num_cols - 1).t() / _nobs;
+    _offset = _sh_ptr_loss->constantInitializer(ymean);
+  } else {
+    // The shards send the response with the weights as additional column:
+    arma::mat truth;
+    for (auto& it : _sh_ptr_transport->gather(arma::mat())) truth = arma::join_cols(truth, it);
+    if (truth.n_cols > _num_cols) {
+      _offset = _sh_ptr_loss->weightedConstantInitializer(truth.cols(0, _num_cols - 1), truth.col(_num_cols));
+    } else {
+      _offset = _sh_ptr_loss->constantInitializer(truth);
+    }
+  }
+  _sh_ptr_transport->broadcast(_offset);
+
+  _is_initialized = true;
+}
+
+/**
+ * \brief Conduct `iterations` iterations of the coordinate descent
+ *
+ * The SSE of a candidate is computed from the statistics,
+ * \f$\|r - X\theta\|^2 = r^Tr - 2\theta^TX^Tr + \theta^TX^TX\theta\f$,
+ * where \f$r^Tr\f$ is the same for all candidates.
+ */
+void Coordinator::train (const unsigned int iterations)
+{
+  if (! _is_initialized) initialize();
+
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+  const unsigned int num_factories = _factory_ids.size();
+
+  for (unsigned int i = 0; i < iterations; i++) {
+    arma::mat packed;
+    _sh_ptr_transport->allReduceSum(packed);
+    recordRisk(packed(packed.n_rows - 1));
+
+    std::vector<arma::mat> params(num_factories);
+    arma::vec sse(num_factories);
+    unsigned int pos = 0;
+    for (unsigned int j = 0; j < num_factories; j++) {
+      const unsigned int p = _grams[j].n_rows;
+      arma::mat xtr = arma::reshape(packed.rows(pos, pos + p * _num_cols - 1), p, _num_cols);
+      pos += p * _num_cols;
+
+      params[j] = helper::cboostSolver(_systems[j], xtr);
+      sse(j) = -2 * arma::accu(params[j] % xtr) + arma::accu(params[j] % (_grams[j] * params[j]));
+    }
+    const unsigned int j = sse.index_min();
+
+    arma::mat update = arma::join_cols(arma::mat(1, 1, arma::fill::value(j)), arma::vectorise(_learning_rate * params[j]));
+    _sh_ptr_transport->broadcast(update);
+
+    std::shared_ptr<blearner::Baselearner> sh_ptr_blearner = fac_map[_factory_ids[j]]->createBaselearner();
+    sh_ptr_blearner->setParameter(params[j]);
+    _blearner_track.insertBaselearner(sh_ptr_blearner, 1);
+    _current_iter++;
+  }
+  arma::mat packed;
+  _sh_ptr_transport->allReduceSum(packed);
+  recordRisk(packed(0));
+}
+
+unsigned int Coordinator::getCurrentIteration     () const { return _current_iter; }
+double       Coordinator::getNumberOfObservations () const { return _nobs; }
+arma::mat    Coordinator::getOffset               () const { return _offset; }
+arma::vec    Coordinator::getRisk                 () const { return arma::vec(_risk); }
+
+std::vector<std::string> Coordinator::getSelectedBaselearner () const
+{
+  return _blearner_track.getSelectedFactoryIds();
+}
+
+std::map<std::string, arma::mat> Coordinator::getParameter () const
+{
+  return _blearner_track.getParameterMap();
+}
+
+arma::mat Coordinator::predict (const mdata& data_map) const
+{
+  if (data_map.size() == 0) {
+    throw std::range_error("Require data in 'data_map' for prediction.");
+  }
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+
+  arma::mat pred(data_map.begin()->second->getNObs(), _num_cols, arma::fill::zeros);
+  if (_offset.n_cols == _num_cols) {
+    pred.each_row() += _offset.row(0);
+  } else {
+    pred.fill(_offset[0]);
+  }
+  for (auto& it : _blearner_track.getParameterMap()) {
+    pred += fac_map.at(it.first)->calculateLinearPredictor(it.second, data_map);
+  }
+  return pred;
+}
+
+void Coordinator::reportMemory (memreport::MemoryReport& report) const
+{
+  double gram_bytes = 0;
+  double system_bytes = 0;
+  for (auto& it : _grams) gram_bytes += memreport::matBytes(it);
+  for (auto& it : _systems) system_bytes += memreport::matBytes(it.second);
+  report.add("distributed", "Coordinator", "grams",   gram_bytes);
+  report.add("distributed", "Coordinator", "systems", system_bytes);
+  _blearner_track.reportMemory(report, "track");
+  _sh_ptr_factory_list->reportMemory(report);
+}
+
+
+// -------------------------------------------------------------------------- //
+// Feature-parallel candidate evaluation:
+// -------------------------------------------------------------------------- //
+
+bool ownsFactory (const unsigned int index, const unsigned int rank, const unsigned int size)
+{
+  return (index % size) == rank;
+}
+
+/**
+ * \brief Best candidate of the owned factories
+ *
+ * \param factory_map `blearner_factory_map` Contains at least the owned factories.
+ * \param factory_ids `std::vector<std::string>` Ids of all factories in the order of the coordinator.
+ */
+Candidate bestCandidate (const blearner_factory_map& factory_map, const std::vector<std::string>& factory_ids,
+  const arma::mat& pr, const unsigned int rank, const unsigned int size)
+{
+  Candidate best;
+  for (unsigned int i = 0; i < factory_ids.size(); i++) {
+    if (! ownsFactory(i, rank, size)) continue;
+
+    std::shared_ptr<blearner::Baselearner> blearner_temp = factory_map.at(factory_ids[i])->createBaselearner();
+    blearner_temp->train(pr);
+    double sse = helper::calculateSumOfSquaredError(pr, blearner_temp->predict());
+    if (sse < best.sse) {
+      best.sse      = sse;
+      best.index    = i;
+      best.blearner = blearner_temp;
+    }
+  }
+  return best;
+}
+
+/**
+ * \brief Pack a candidate as `[sse, index, rows of the parameter, vec(parameter)]`
+ *
+ * A process without factories sends an empty matrix.
+ */
+arma::mat packCandidate (const Candidate& candidate)
+{
+  if (candidate.blearner == nullptr) return arma::mat();
+
+  arma::mat param = candidate.blearner->getParameter();
+  arma::mat head  = { candidate.sse, (double) candidate.index, (double) param.n_rows };
+  return arma::join_cols(head.t(), arma::vectorise(param));
+}
+
+/**
+ * \brief Worker with just the owned factories
+ *
+ * \param sh_ptr_transport `std::shared_ptr<Transport>` Transport with a rank greater than 0.
+ * \param sh_ptr_factory_list `std::shared_ptr<BaselearnerFactoryList>` The owned factories.
+ * \param factory_ids `std::vector<std::string>` Ids of all factories in the order of the coordinator.
+ */
+FeatureWorker::FeatureWorker (const std::shared_ptr<Transport>& sh_ptr_transport,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list,
+  const std::vector<std::string>& factory_ids)
+  : _sh_ptr_transport    ( sh_ptr_transport ),
+    _sh_ptr_factory_list ( sh_ptr_factory_list ),
+    _factory_ids         ( factory_ids )
+{
+  if (_sh_ptr_transport->getRank() == 0) {
+    Rcpp::stop("Rank 0 is the coordinator, workers have ranks starting with 1.");
+  }
+  blearner_factory_map factory_map = _sh_ptr_factory_list->getFactoryMap();
+  for (auto& it : getOwnedFactories()) {
+    if (factory_map.find(it) == factory_map.end()) Rcpp::stop("The worker does not have its factory " + it + ".");
+  }
+}
+
+/**
+ * \brief Answer the requests of the coordinator until it sends an empty matrix
+ *
+ * The first message is the number of factories of the coordinator. Per
+ * iteration, the worker receives the pseudo residuals, sends its best candidate,
+ * receives the index of the winner, and sends the prediction of the winner if it
+ * owns it.
+ */
+void FeatureWorker::serve ()
+{
+  const unsigned int rank = _sh_ptr_transport->getRank();
+  const unsigned int size = _sh_ptr_transport->getSize();
+  blearner_factory_map factory_map = _sh_ptr_factory_list->getFactoryMap();
+
+  arma::mat msg;
+  _sh_ptr_transport->broadcast(msg);
+  if ((! msg.is_empty()) && (msg(0) != _factory_ids.size())) {
+    Rcpp::stop("The coordinator has " + std::to_string((unsigned int) msg(0)) + " factories but the worker knows "
+      + std::to_string(_factory_ids.size()) + ".");
+  }
+  while (! msg.is_empty()) {
+    arma::mat pr;
+    _sh_ptr_transport->broadcast(pr);
+    if (pr.is_empty()) break;
+
+    Candidate best = bestCandidate(factory_map, _factory_ids, pr, rank, size);
+    _sh_ptr_transport->gather(packCandidate(best));
+
+    arma::mat winner;
+    _sh_ptr_transport->broadcast(winner);
+    if ((best.blearner != nullptr) && (best.index == (unsigned int) winner(0))) {
+      _sh_ptr_transport->gather(best.blearner->predict());
+    } else {
+      _sh_ptr_transport->gather(arma::mat());
+    }
+    _num_iterations++;
+  }
+}
+
+std::vector<std::string> FeatureWorker::getOwnedFactories () const
+{
+  std::vector<std::string> out;
+  for (unsigned int i = 0; i < _factory_ids.size(); i++) {
+    if (ownsFactory(i, _sh_ptr_transport->getRank(), _sh_ptr_transport->getSize())) out.push_back(_factory_ids[i]);
+  }
+  return out;
+}
+
+unsigned int FeatureWorker::getNumberOfIterations () const { return _num_iterations; }
+
+} // namespace distributed
@@ -0,0 +1,292 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// ========================================================================== //
+
+/**
+ *  @file    distributed.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Data-parallel training over row shards in multiple processes
+ *
+ *  @section DESCRIPTION
+ *
+ *  Each worker process owns a row shard of the data and the response. The
+ *  coordinate descent just needs sufficient statistics of the shards: the
+ *  Gram matrices \f$X_w^TX_w\f$ once and the cross products \f$X_w^Tr_w\f$ of
+ *  each factory per iteration. The workers compute them on their shard (with
+ *  binning, the residuals are accumulated per bin first), the statistics are
+ *  summed up with an all-reduce, and the coordinator solves the systems,
+ *  selects the base learner with the smallest SSE, and broadcasts the update.
+ *  The workers then update the scores of their rows.
+ *
+ *  For wide data, the factories can be partitioned instead of the rows: with
+ *  `OptimizerFeatureParallel` (see optimizer.h) the coordinator broadcasts the
+ *  pseudo residuals, each `FeatureWorker` returns the best candidate of its
+ *  factories, and just the winning process sends the prediction of the winner.
+ *
+ *  The transport is pluggable. `SocketTransport` connects the processes of
+ *  one host with Unix domain sockets in a star around the coordinator (rank
+ *  0). It is not available on Windows.
+ *
+ */
+
+#ifndef DISTRIBUTED_H_
+#define DISTRIBUTED_H_
+
+#include <RcppArmadillo.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <limits>
+
+#include "baselearner_factory_list.h"
+#include "baselearner_track.h"
+#include "response.h"
+#include "loss.h"
+#include "helper.h"
+#include "memory_report.h"
+
+typedef std::shared_ptr<data::Data> sdata;
+typedef std::map<std::string, sdata> mdata;
+
+namespace distributed
+{
+
+// -------------------------------------------------------------------------- //
+// Transport:
+// -------------------------------------------------------------------------- //
+
+/**
+ * \class Transport
+ *
+ * \brief Collective operations between the coordinator (rank 0) and workers
+ *
+ * An empty matrix passed to `allReduceSum` counts as zero, hence the
+ * coordinator does not need to know the size of the statistics. `gather`
+ * returns the matrices of all ranks on the coordinator and an empty vector
+ * on the workers.
+ */
+class Transport
+{
+protected:
+  double _bytes_sent     = 0;
+  double _bytes_received = 0;
+
+public:
+  virtual unsigned int getRank () const = 0;
+  virtual unsigned int getSize () const = 0;
+
+  virtual void                   allReduceSum (arma::mat&)       = 0;
+  virtual void                   broadcast    (arma::mat&)       = 0;
+  virtual std::vector<arma::mat> gather       (const arma::mat&) = 0;
+
+  double getBytesSent     () const;
+  double getBytesReceived () const;
+
+  virtual ~Transport () { };
+};
+
+/**
+ * \class SocketTransport
+ *
+ * \brief Transport over Unix domain sockets between processes of one host
+ *
+ * The coordinator binds the socket and waits until all workers are
+ * connected, workers retry to connect until the timeout (in seconds) is
+ * reached. Matrices are sent with their dimension as header.
+ */
+class SocketTransport : public Transport
+{
+private:
+  const std::string  _path;
+  const unsigned int _rank;
+  const unsigned int _size;
+
+  int              _listen_fd = -1;
+  std::vector<int> _fds;
+
+  void      sendMat (const int, const arma::mat&);
+  arma::mat recvMat (const int);
+
+public:
+  SocketTransport (const std::string, const unsigned int, const unsigned int, const double);
+
+  unsigned int getRank () const;
+  unsigned int getSize () const;
+
+  void                   allReduceSum (arma::mat&);
+  void                   broadcast    (arma::mat&);
+  std::vector<arma::mat> gather       (const arma::mat&);
+
+  ~SocketTransport ();
+};
+
+
+// -------------------------------------------------------------------------- //
+// Coordinator and workers:
+// -------------------------------------------------------------------------- //
+
+/**
+ * \class ShardWorker
+ *
+ * \brief Scores and sufficient statistics of one row shard
+ *
+ * The design of the shard is obtained from the factories in the same way as
+ * for the prediction of new data, hence all shards share the basis (e.g. the
+ * knots) of the factories. Factories with binning bin the rows of the shard
+ * with their bin root, so the statistics are computed on the bins.
+ */
+class ShardWorker
+{
+private:
+  const std::shared_ptr<Transport>                            _sh_ptr_transport;
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
+  const std::shared_ptr<response::Response>                   _sh_ptr_response;
+  const std::shared_ptr<loss::Loss>                           _sh_ptr_loss;
+
+  std::vector<sdata> _factory_data;
+  arma::mat          _scores;
+  unsigned int       _current_iter = 0;
+  bool               _is_initialized = false;
+
+  void   initialize ();
+  double lossSum    () const;
+
+public:
+  ShardWorker (const std::shared_ptr<Transport>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&,
+    const mdata&, const std::shared_ptr<response::Response>&, const std::shared_ptr<loss::Loss>&);
+
+  void train (const unsigned int);
+
+  unsigned int getCurrentIteration () const;
+  arma::mat    getPredictionScores () const;
+};
+
+/**
+ * \class Coordinator
+ *
+ * \brief Selection and solves on the all-reduced statistics
+ *
+ * The coordinator owns no rows. The penalties of the factories are taken
+ * from the factories of the coordinator, the Gram matrices from the shards.
+ * The offset is the constant initializer of the loss evaluated on the mean
+ * response for losses whose offset depends on the response just by its mean
+ * (quadratic, binomial, multinomial). For all other losses and for weighted
+ * responses, the response of the shards is gathered once on the coordinator
+ * to compute the offset.
+ */
+class Coordinator
+{
+private:
+  const std::shared_ptr<Transport>                            _sh_ptr_transport;
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
+  const std::shared_ptr<loss::Loss>                           _sh_ptr_loss;
+  const double                                                _learning_rate;
+
+  std::vector<std::string>                       _factory_ids;
+  std::vector<arma::mat>                         _grams;
+  std::vector<std::pair<std::string, arma::mat>> _systems;
+
+  double                          _nobs = 0;
+  unsigned int                    _num_cols = 0;
+  arma::mat                       _offset;
+  std::vector<double>             _risk;
+  blearnertrack::BaselearnerTrack _blearner_track;
+  unsigned int                    _current_iter = 0;
+  bool                            _is_initialized = false;
+
+  void initialize ();
+  void recordRisk (const double);
+
+public:
+  Coordinator (const std::shared_ptr<Transport>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&,
+    const std::shared_ptr<loss::Loss>&, const double);
+
+  void train (const unsigned int);
+
+  unsigned int                     getCurrentIteration     () const;
+  double                           getNumberOfObservations () const;
+  arma::mat                        getOffset               () const;
+  arma::vec                        getRisk                 () const;
+  std::vector<std::string>         getSelectedBaselearner  () const;
+  std::map<std::string, arma::mat> getParameter            () const;
+
+  arma::mat predict (const mdata&) const;
+
+  void reportMemory (memreport::MemoryReport&) const;
+};
+
+
+// -------------------------------------------------------------------------- //
+// Feature-parallel candidate evaluation:
+// -------------------------------------------------------------------------- //
+
+/**
+ * \struct Candidate
+ *
+ * \brief Best base learner of the factories owned by one process
+ *
+ * The factory at position `i` of the factory map of the coordinator is owned
+ * by rank `i % size`. The index is this position, it is used to break ties in
+ * the same way as the sequential coordinate descent.
+ */
+struct Candidate
+{
+  double                                 sse   = std::numeric_limits<double>::infinity();
+  unsigned int                           index = 0;
+  std::shared_ptr<blearner::Baselearner> blearner;
+};
+
+bool      ownsFactory   (const unsigned int, const unsigned int, const unsigned int);
+Candidate bestCandidate (const blearner_factory_map&, const std::vector<std::string>&, const arma::mat&, const unsigned int, const unsigned int);
+arma::mat packCandidate (const Candidate&);
+
+/**
+ * \class FeatureWorker
+ *
+ * \brief Evaluates the owned factories of a worker process
+ *
+ * The factory list just contains the factories owned by the worker, the ids
+ * of all factories of the coordinator define the ownership and the index of a
+ * candidate. Hence, a worker instantiates just the data of its factories.
+ */
+class FeatureWorker
+{
+private:
+  const std::shared_ptr<Transport>                            _sh_ptr_transport;
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
+  const std::vector<std::string>                              _factory_ids;
+
+  unsigned int _num_iterations = 0;
+
+public:
+  FeatureWorker (const std::shared_ptr<Transport>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&,
+    const std::vector<std::string>&);
+
+  void serve ();
+
+  std::vector<std::string> getOwnedFactories      () const;
+  unsigned int             getNumberOfIterations  () const;
+};
+
+} // namespace distributed
+
+#endif // DISTRIBUTED_H_
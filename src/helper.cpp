@@ -176,6 +176,18 @@ arma::mat sigmoid (const arma::mat& scores)
   return 1 / (1 + arma::exp(-scores));
 }
 
+/**
+ * \brief Row-wise softmax of the scores, one column per class
+ *
+ * The maximum of each row is subtracted first to avoid overflows.
+ */
+arma::mat softmax (const arma::mat& scores)
+{
+  arma::mat out = arma::exp(scores.each_col() - arma::max(scores, 1));
+  out.each_col() /= arma::sum(out, 1);
+  return out;
+}
+
 arma::mat transformToBinaryResponse (const arma::mat& score_mat, const double& threshold, const double& pos, const double& neg)
 {
   arma::mat out = score_mat;
@@ -207,6 +219,23 @@ arma::vec stringVecToBinaryVec(const std::vector<std::string>& response, const s
   return out;
 }
 
+/**
+ * \brief One-hot encoding of the classes with one column per class of `classes`
+ */
+arma::mat stringVecToOneHotMat (const std::vector<std::string>& response, const std::vector<std::string>& classes)
+{
+  std::map<std::string, unsigned int> class_index;
+  for (unsigned int k = 0; k < classes.size(); k++) class_index[classes[k]] = k;
+
+  arma::mat out(response.size(), classes.size(), arma::fill::zeros);
+  for (unsigned int i = 0; i < response.size(); i++) {
+    auto it = class_index.find(response[i]);
+    if (it == class_index.end()) Rcpp::stop("Unknown class \"" + response[i] + "\".");
+    out(i, it->second) = 1;
+  }
+  return out;
+}
+
 void checkForBinaryClassif (const std::vector<std::string>& response)
 {
   std::map<std::string, unsigned int> class_table = helper::tableResponse(response);
@@ -287,6 +316,40 @@ arma::mat cboostSolver (const std::pair<std::string, arma::mat>& mat_cache, cons
   /* if (mat_cache.first == "inverse")  {*/ return mat_cache.second * y; //}
 }
 
+/**
+ * \brief Product of a transposed sparse design with the response on a subset of rows
+ *
+ * The sparse designs are stored transposed (one column per observation). Hence, only
+ * the columns in `idx` are visited and the non-zero entries are accumulated.
+ *
+ * \param X `arma::sp_mat` Transposed design matrix (p x n).
+ * \param y `arma::mat` Response of the subset, row `j` belongs to observation `idx(j)`.
+ * \param idx `arma::uvec` Observations that are used.
+ *
+ * \returns `arma::mat` Product $X_S^Ty$ of dimension p x ncol(y).
+ */
+arma::mat sparseMatMultResponseSubset (const arma::sp_mat& X, const arma::mat& y, const arma::uvec& idx)
+{
+  arma::mat out(X.n_rows, y.n_cols, arma::fill::zeros);
+  for (unsigned int j = 0; j < idx.size(); j++) {
+    for (arma::sp_mat::const_col_iterator it = X.begin_col(idx(j)); it != X.end_col(idx(j)); ++it) {
+      out.row(it.row()) += (*it) * y.row(j);
+    }
+  }
+  return out;
+}
+
+arma::mat sparsePredictionSubset (const arma::sp_mat& X, const arma::mat& param, const arma::uvec& idx)
+{
+  arma::mat out(idx.size(), param.n_cols, arma::fill::zeros);
+  for (unsigned int j = 0; j < idx.size(); j++) {
+    for (arma::sp_mat::const_col_iterator it = X.begin_col(idx(j)); it != X.end_col(idx(j)); ++it) {
+      out.row(j) += (*it) * param.row(it.row());
+    }
+  }
+  return out;
+}
+
 
 
 
@@ -305,4 +368,18 @@ arma::mat cboostSolver (const std::pair<std::string, arma::mat>& mat_cache, cons
 //   return out;
 // }
 
+/**
+ * \brief Draw an integer uniformly from \f$\{0, \dots, m - 1\}\f$
+ *
+ * Uses the upper 53 bits of the 64 bit Mersenne Twister. In contrast to
+ * `std::uniform_int_distribution` the result is fixed by the standard and
+ * therefore the same for every compiler and platform.
+ */
+unsigned int drawIndex (std::mt19937_64& rng, const unsigned int m)
+{
+  const double u = static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+  const unsigned int out = static_cast<unsigned int>(u * m);
+  return out < m ? out : m - 1;
+}
+
 } // namespace helper
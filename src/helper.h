@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <random>
 
 #include "data.h"
 
@@ -42,10 +43,12 @@ void        assertChoice               (const std::string, const std::vector<std
 Rcpp::List  argHandler                 (Rcpp::List, Rcpp::List, bool);
 double      calculateSumOfSquaredError (const arma::mat&, const arma::mat&);
 arma::mat   sigmoid                    (const arma::mat&);
+arma::mat   softmax                    (const arma::mat&);
 
 std::map<std::string, unsigned int> tableResponse (const std::vector<std::string>&);
 
 arma::vec  stringVecToBinaryVec      (const std::vector<std::string>&, const std::string&);
+arma::mat  stringVecToOneHotMat      (const std::vector<std::string>&, const std::vector<std::string>&);
 arma::mat  transformToBinaryResponse (const arma::mat&, const double&, const double&, const double&);
 void       checkForBinaryClassif     (const std::vector<std::string>&);
 void       checkMatrixDim            (const arma::mat&, const arma::mat&);
@@ -57,6 +60,11 @@ void        printMatStatus  (const arma::mat&, const std::string);
 arma::mat   solveCholesky   (const arma::mat&, const arma::mat&);
 arma::mat   cboostSolver    (const std::pair<std::string, arma::mat>&, const arma::mat&);
 
+arma::mat   sparseMatMultResponseSubset (const arma::sp_mat&, const arma::mat&, const arma::uvec&);
+arma::mat   sparsePredictionSubset      (const arma::sp_mat&, const arma::mat&, const arma::uvec&);
+
+unsigned int drawIndex (std::mt19937_64&, const unsigned int);
+
 // template<typename SH_PTR>
 // inline unsigned int countSharedPointer (const SH_PTR&);
 template<typename SH_PTR>
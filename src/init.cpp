@@ -169,9 +169,22 @@ json CustomCppAttributes::toJson () const
 }
 
 
+static arma::mat polynomialDesign (const arma::mat& x, const std::shared_ptr<PolynomialAttributes>& attributes)
+{
+  arma::mat out;
+  if (attributes->use_intercept) {
+    out = arma::mat(x.n_rows, 1, arma::fill::ones);
+  }
+  for (unsigned int i = 0; i < attributes->degree; i++) {
+    out = arma::join_rows(out, arma::pow(x, i+1));
+  }
+  return out;
+}
+
 sbindata initPolynomialData (const sdata& raw_data, const std::shared_ptr<PolynomialAttributes>& attributes)
 {
-  arma::mat mraw = raw_data->getData();
+  // The raw data may use memory of the data source (e.g. an R vector), hence it is never modified:
+  const arma::mat mraw = raw_data->getData();
   // This is necessary to prevent the program from segfolds... whyever???
   // Copied from: http://lists.r-forge.r-project.org/pipermail/rcpp-devel/2012-November/004796.html
   try {
@@ -184,31 +197,25 @@ sbindata initPolynomialData (const sdata& raw_data, const std::shared_ptr<Polyno
     ::Rf_error( "c++ exception (unknown reason) in initialization of data for BaselearnerPolynomialFactory" );
   }
 
-  sbindata sh_ptr_bindata;
+  sbindata  sh_ptr_bindata;
+  arma::mat bins;
   if (attributes->bin_root == 0) { // don't use binning
     sh_ptr_bindata = std::make_shared<data::BinnedData>(raw_data->getDataIdentifier());
   } else {             // use binning
-    arma::colvec bins = binning::binVectorCustom(mraw, attributes->bin_root, "linear");
+    bins = binning::binVectorCustom(mraw, attributes->bin_root, "linear");
     sh_ptr_bindata = std::make_shared<data::BinnedData>(raw_data->getDataIdentifier(), attributes->bin_root, mraw, bins);
-    mraw = bins;
   }
+  const arma::mat& x = (attributes->bin_root == 0) ? mraw : bins;
 
-  arma::mat   out;
-  if (attributes->use_intercept) {
-    out = arma::mat(mraw.n_rows, 1, arma::fill::ones);
-  }
-  for (unsigned int i = 0; i < attributes->degree; i++) {
-    out = arma::join_rows(out, arma::pow(mraw, i+1));
-  }
-
-  sh_ptr_bindata->setDenseData(out);
+  sh_ptr_bindata->setDenseData(polynomialDesign(x, attributes));
   sh_ptr_bindata->setMinMax(raw_data->getMinMax());
   return sh_ptr_bindata;
 }
 
 sbindata initPSplineData (const sdata& raw_data, const std::shared_ptr<PSplineAttributes>& attributes)
 {
-  auto mraw = raw_data->getData();
+  // The raw data may use memory of the data source (e.g. an R vector), hence it is never modified:
+  const arma::mat mraw = raw_data->getData();
   // This is necessary to prevent the program from segfolds... whyever???
   // Copied from: http://lists.r-forge.r-project.org/pipermail/rcpp-devel/2012-November/004796.html
   try {
@@ -221,33 +228,104 @@ sbindata initPSplineData (const sdata& raw_data, const std::shared_ptr<PSplineAt
     ::Rf_error( "c++ exception (unknown reason) in initialization of data for  BaselearnerPSplineFactory" );
   }
 
-  sbindata sh_ptr_bindata;
+  sbindata  sh_ptr_bindata;
+  arma::mat bins;
   if (attributes->bin_root == 0) { // don't use binning
     sh_ptr_bindata = std::make_shared<data::BinnedData>(raw_data->getDataIdentifier());
   } else {             // use binning
-    arma::colvec bins = binning::binVectorCustom(mraw, attributes->bin_root, "linear");
+    bins = binning::binVectorCustom(mraw, attributes->bin_root, "linear");
     sh_ptr_bindata = std::make_shared<data::BinnedData>(raw_data->getDataIdentifier(), attributes->bin_root, mraw, bins);
-    mraw = bins;
   }
-  sh_ptr_bindata->setSparseData(splines::createSparseSplineBasis (mraw, attributes->degree, attributes->knots).t());
+  const arma::mat& x = (attributes->bin_root == 0) ? mraw : bins;
+  sh_ptr_bindata->setSparseData(splines::createSparseSplineBasis (x, attributes->degree, attributes->knots).t());
   sh_ptr_bindata->setMinMax(raw_data->getMinMax());
 
   return sh_ptr_bindata;
 }
 
+/**
+ * \brief Build the polynomial design in blocks of rows that are written into `path`
+ *
+ * Only the raw data and one block are in memory. Binning is not used since
+ * binned designs are small anyway.
+ */
+sbindata streamPolynomialData (const sdata& raw_data, const std::shared_ptr<PolynomialAttributes>& attributes,
+  const std::string path, const unsigned int block_rows)
+{
+  const arma::mat mraw = raw_data->getData();
+  if (mraw.n_cols > 1) Rcpp::stop("Given data should just have one column.");
+
+  const unsigned int ncols = attributes->degree + static_cast<unsigned int>(attributes->use_intercept);
+  auto sh_ptr_chunks = std::make_shared<chunked::ChunkedDesign>(path, false, mraw.n_rows, ncols, block_rows,
+    [&mraw, &attributes](const unsigned int first, const unsigned int last) {
+      chunked::Block blk;
+      blk.dense = polynomialDesign(mraw.rows(first, last), attributes);
+      return blk;
+    });
+
+  sbindata sh_ptr_bindata = std::make_shared<data::BinnedData>(raw_data->getDataIdentifier());
+  sh_ptr_bindata->setChunkedDesign(sh_ptr_chunks);
+  sh_ptr_bindata->setMinMax(raw_data->getMinMax());
+  return sh_ptr_bindata;
+}
+
+/**
+ * \brief Build the spline basis in blocks of rows that are written into `path`
+ *
+ * The knots must be set before. As for `streamPolynomialData()`, binning is not used.
+ */
+sbindata streamPSplineData (const sdata& raw_data, const std::shared_ptr<PSplineAttributes>& attributes,
+  const std::string path, const unsigned int block_rows)
+{
+  const arma::mat mraw = raw_data->getData();
+  if (mraw.n_cols > 1) Rcpp::stop("Given data should just have one column.");
+
+  const unsigned int ncols = attributes->n_knots + attributes->degree + 1;
+  auto sh_ptr_chunks = std::make_shared<chunked::ChunkedDesign>(path, true, mraw.n_rows, ncols, block_rows,
+    [&mraw, &attributes](const unsigned int first, const unsigned int last) {
+      chunked::Block blk;
+      blk.sparse = splines::createSparseSplineBasis(mraw.rows(first, last), attributes->degree, attributes->knots).t();
+      return blk;
+    });
+
+  sbindata sh_ptr_bindata = std::make_shared<data::BinnedData>(raw_data->getDataIdentifier());
+  sh_ptr_bindata->setChunkedDesign(sh_ptr_chunks);
+  sh_ptr_bindata->setMinMax(raw_data->getMinMax());
+  return sh_ptr_bindata;
+}
+
 sdata initRidgeData (const sdata& raw_data, const std::shared_ptr<RidgeAttributes>& attributes)
 {
   auto sh_ptr_cdata = std::static_pointer_cast<data::CategoricalDataRaw>(raw_data);
-  auto chr_classes = sh_ptr_cdata->getRawData();
-  arma::urowvec classes(chr_classes.size(), arma::fill::zeros);
-  arma::urowvec row_idx(chr_classes.size(), arma::fill::zeros);
+  const unsigned int nobs = sh_ptr_cdata->getNObs();
+  arma::urowvec classes(nobs, arma::fill::zeros);
+  arma::urowvec row_idx(nobs, arma::fill::zeros);
   unsigned int k = 0;
-  for (unsigned int i = 0; i < chr_classes.size(); i++) {
-    auto it = attributes->dictionary.find(chr_classes.at(i));
-    if (it != attributes->dictionary.end()) {
-      classes(i) = it->second;
-      row_idx(k) = i;
-      k += 1;
+  if (sh_ptr_cdata->usesCodes()) {
+    // Look up each level once instead of the class of each observation:
+    const std::vector<std::string> levels = sh_ptr_cdata->getLevels();
+    std::vector<int> level_class(levels.size(), -1);
+    for (unsigned int l = 0; l < levels.size(); l++) {
+      auto it = attributes->dictionary.find(levels[l]);
+      if (it != attributes->dictionary.end()) level_class[l] = it->second;
+    }
+    for (unsigned int i = 0; i < nobs; i++) {
+      const int cls = level_class[sh_ptr_cdata->getCode(i)];
+      if (cls >= 0) {
+        classes(k) = cls;
+        row_idx(k) = i;
+        k += 1;
+      }
+    }
+  } else {
+    auto chr_classes = sh_ptr_cdata->getRawData();
+    for (unsigned int i = 0; i < nobs; i++) {
+      auto it = attributes->dictionary.find(chr_classes.at(i));
+      if (it != attributes->dictionary.end()) {
+        classes(k) = it->second;
+        row_idx(k) = i;
+        k += 1;
+      }
     }
   }
   classes = classes.head_cols(k);
@@ -259,7 +337,7 @@ sdata initRidgeData (const sdata& raw_data, const std::shared_ptr<RidgeAttribute
   arma::umat locations = arma::join_cols(classes, row_idx);
 
   auto sh_ptr_data = std::make_shared<data::InMemoryData>(raw_data->getDataIdentifier());
-  sh_ptr_data->setSparseData(arma::sp_mat(locations, fill, attributes->dictionary.size(), chr_classes.size()));
+  sh_ptr_data->setSparseData(arma::sp_mat(locations, fill, attributes->dictionary.size(), nobs));
   sh_ptr_data->setMinMax(std::vector<double>{1, double(attributes->dictionary.size())});
   return sh_ptr_data;
 }
@@ -267,14 +345,27 @@ sdata initRidgeData (const sdata& raw_data, const std::shared_ptr<RidgeAttribute
 sdata initBinaryData (const sdata& raw_data, const std::shared_ptr<BinaryAttributes>& attributes)
 {
   auto sh_ptr_cdata = std::static_pointer_cast<data::CategoricalDataRaw>(raw_data);
-  auto chr_classes = sh_ptr_cdata->getRawData();
+  const unsigned int nobs = sh_ptr_cdata->getNObs();
 
-  arma::urowvec row_idx(chr_classes.size(), arma::fill::zeros);
+  arma::urowvec row_idx(nobs, arma::fill::zeros);
   unsigned int k = 0;
-  for (unsigned int i = 0; i < chr_classes.size(); i++) {
-    if (attributes->cls == chr_classes.at(i)) {
-      row_idx(k) = i;
-      k += 1;
+  if (sh_ptr_cdata->usesCodes()) {
+    const std::vector<std::string> levels = sh_ptr_cdata->getLevels();
+    std::vector<bool> is_cls(levels.size());
+    for (unsigned int l = 0; l < levels.size(); l++) is_cls[l] = (levels[l] == attributes->cls);
+    for (unsigned int i = 0; i < nobs; i++) {
+      if (is_cls[sh_ptr_cdata->getCode(i)]) {
+        row_idx(k) = i;
+        k += 1;
+      }
+    }
+  } else {
+    auto chr_classes = sh_ptr_cdata->getRawData();
+    for (unsigned int i = 0; i < nobs; i++) {
+      if (attributes->cls == chr_classes.at(i)) {
+        row_idx(k) = i;
+        k += 1;
+      }
     }
   }
   arma::urowvec classes(k, arma::fill::zeros);
@@ -283,7 +374,7 @@ sdata initBinaryData (const sdata& raw_data, const std::shared_ptr<BinaryAttribu
 
   arma::umat locations = arma::join_cols(classes, row_idx);
 
-  arma::sp_mat dm = arma::sp_mat(locations, fill, 1, chr_classes.size());
+  arma::sp_mat dm = arma::sp_mat(locations, fill, 1, nobs);
 
   auto sh_ptr_data = std::make_shared<data::InMemoryData>(raw_data->getDataIdentifier() + "_" + attributes->cls);
   sh_ptr_data->setSparseData(dm);
@@ -349,7 +440,7 @@ sbindata initCenteredData (const sdata& bl_data, const std::shared_ptr<CenteredA
 sdata initCustomData (const sdata& raw_data, Rcpp::Function instantiateDataFun)
 {
   auto sh_ptr_data = std::make_shared<data::InMemoryData>(raw_data->getDataIdentifier());
-  arma::mat temp =  Rcpp::as<arma::mat>(instantiateDataFun(raw_data->getDenseData()));
+  arma::mat temp =  Rcpp::as<arma::mat>(instantiateDataFun(raw_data->getData()));
   sh_ptr_data->setDenseData(temp);
   return sh_ptr_data;
 }
@@ -358,7 +449,7 @@ typedef arma::mat (*instantiateDataFunPtr) (const arma::mat& X);
 sdata initCustomCppData (const sdata& raw_data, const std::shared_ptr<CustomCppAttributes>& attributes)
 {
   auto sh_ptr_data = std::make_shared<data::InMemoryData>(raw_data->getDataIdentifier());
-  sh_ptr_data->setDenseData(attributes->instantiateDataFun(raw_data->getDenseData()));
+  sh_ptr_data->setDenseData(attributes->instantiateDataFun(raw_data->getData()));
   return sh_ptr_data;
 }
 
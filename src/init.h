@@ -124,6 +124,8 @@ struct CustomCppAttributes {
 
 sbindata initPolynomialData (const sdata&, const std::shared_ptr<PolynomialAttributes>&);
 sbindata initPSplineData    (const sdata&, const std::shared_ptr<PSplineAttributes>&);
+sbindata streamPolynomialData (const sdata&, const std::shared_ptr<PolynomialAttributes>&, const std::string, const unsigned int);
+sbindata streamPSplineData    (const sdata&, const std::shared_ptr<PSplineAttributes>&, const std::string, const unsigned int);
 sdata initRidgeData         (const sdata&, const std::shared_ptr<RidgeAttributes>&);
 sdata initBinaryData        (const sdata&, const std::shared_ptr<BinaryAttributes>&);
 sdata initTensorData        (const sdata&, const sdata&);
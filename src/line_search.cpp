@@ -32,16 +32,16 @@ namespace linesearch {
  *
  * \param sh_ptr_loss `std::shared_ptr<loss::Loss>`
  *
- * \param target `arma::vec`
+ * \param target `arma::mat`
  *
- * \param model_prediction `arma::vec`
+ * \param model_prediction `arma::mat`
  *
- * \param baselearner_prediction `arma::vec`
+ * \param baselearner_prediction `arma::mat`
  *
  * \returns `double` Risk evaluated at the given step size
  */
-double calculateRisk (const double step_size, const std::shared_ptr<loss::Loss> sh_ptr_loss, const arma::vec& target, const arma::vec& model_prediction,
-  const arma::vec& baselearner_prediction)
+double calculateRisk (const double step_size, const std::shared_ptr<loss::Loss> sh_ptr_loss, const arma::mat& target, const arma::mat& model_prediction,
+  const arma::mat& baselearner_prediction)
 {
   return arma::accu(sh_ptr_loss->loss(target, model_prediction + step_size * baselearner_prediction)) / model_prediction.size();
 }
@@ -55,16 +55,16 @@ double calculateRisk (const double step_size, const std::shared_ptr<loss::Loss>
  *
  * \param sh_ptr_loss `std::shared_ptr<loss::Loss>`
  *
- * \param target `arma::vec`
+ * \param target `arma::mat`
  *
- * \param model_prediction `arma::vec`
+ * \param model_prediction `arma::mat`
  *
- * \param baselearner_prediction `arma::vec`
+ * \param baselearner_prediction `arma::mat`
  *
  * \returns `double` Optimal step size.
  */
-double findOptimalStepSize (const std::shared_ptr<loss::Loss> sh_ptr_loss, const arma::vec& target, const arma::vec& model_prediction,
-  const arma::vec& baselearner_prediction, const double lower_bound, const double upper_bound)
+double findOptimalStepSize (const std::shared_ptr<loss::Loss> sh_ptr_loss, const arma::mat& target, const arma::mat& model_prediction,
+  const arma::mat& baselearner_prediction, const double lower_bound, const double upper_bound)
 {
   boost::uintmax_t max_iter = 500;
   // boost::math::tools::eps_tolerance<double> tol(30);
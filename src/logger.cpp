@@ -48,6 +48,12 @@ std::shared_ptr<logger::Logger> jsonToLogger (const json& j)
   if (j["Class"] == "LoggerTime") {
     l = std::make_shared<LoggerTime>(j);
   }
+  if (j["Class"] == "LoggerProfile") {
+    l = std::make_shared<LoggerProfile>(j);
+  }
+  if (j["Class"] == "LoggerCandidateMiss") {
+    l = std::make_shared<LoggerCandidateMiss>(j);
+  }
   if (l == nullptr) {
     throw std::logic_error("No known class in JSON");
   }
@@ -133,14 +139,14 @@ LoggerIteration::LoggerIteration (const json& j)
  * \param response `arma::vec` of the given response used for training
  * \param prediction `arma::vec` actual prediction of the boosting model at
  *   iteration `current_iteration`
- * \param sh_ptr_blearner `Baselearner*` pointer to the selected baselearner in
- *   iteration `current_iteration`
+ * \param blearners `std::vector<std::shared_ptr<Baselearner>>` base learners selected in
+ *   iteration `current_iteration` (more than one for block updates)
  * \param offset `double` of the overall offset of the training
  * \param learning_rate `double` lerning rate of the `current_iteration`
  *
  */
 void LoggerIteration::logStep (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner, const double learning_rate, const double step_size,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
   const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
   _iterations.push_back(current_iteration);
@@ -231,6 +237,12 @@ json LoggerIteration::toJson (const bool rm_data) const
   return j;
 }
 
+void LoggerIteration::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  report.add("logger:" + getLoggerId(), getLoggerType(), "logged_data", memreport::stdVecBytes(_iterations));
+}
+
 
 // InbagRisk:
 // -----------------------
@@ -289,15 +301,15 @@ LoggerInbagRisk::LoggerInbagRisk (const json& j)
  *
  * \param current_iteration `unsigned int` of current iteration
  * \param sh_ptr_response `std::shared_ptr<response::Response>` of the given response used for training
- * \param sh_ptr_blearner `std::shared_ptr<Baselearner>` pointer to the selected baselearner in
- *   iteration `current_iteration`
+ * \param blearners `std::vector<std::shared_ptr<Baselearner>>` base learners selected in
+ *   iteration `current_iteration` (more than one for block updates)
  * \param learning_rate `double` lerning rate of the `current_iteration`
  * \param step_size `double` step size of the iteration
  * \param sh_ptr_optimizer `std::shared_ptr<optimizer::Optimizer>` optimizer used to find the best base-learner
  *
  */
 void LoggerInbagRisk::logStep (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner, const double learning_rate, const double step_size,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
   const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
   double temp_risk = sh_ptr_response->calculateEmpiricalRisk(_sh_ptr_loss);
@@ -398,6 +410,12 @@ json LoggerInbagRisk::toJson (const bool rm_data) const
   return j;
 }
 
+void LoggerInbagRisk::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  report.add("logger:" + getLoggerId(), getLoggerType(), "logged_data", memreport::stdVecBytes(_inbag_risk));
+}
+
 // OobRisk:
 // -----------------------
 
@@ -464,15 +482,15 @@ LoggerOobRisk::LoggerOobRisk (const json& j)
  *
  * \param current_iteration `unsigned int` of current iteration
  * \param sh_ptr_response `std::shared_ptr<response::Response>` of the given response used for training
- * \param sh_ptr_blearner `std::shared_ptr<Baselearner>` pointer to the selected baselearner in
- *   iteration `current_iteration`
+ * \param blearners `std::vector<std::shared_ptr<Baselearner>>` base learners selected in
+ *   iteration `current_iteration` (more than one for block updates)
  * \param learning_rate `double` lerning rate of the `current_iteration`
  * \param step_size `double` step size of the iteration
  * \param sh_ptr_optimizer `std::shared_ptr<optimizer::Optimizer>` optimizer used to find the best base-learner
  *
  */
 void LoggerOobRisk::logStep (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner, const double learning_rate, const double step_size,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
   const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
 
@@ -480,21 +498,24 @@ void LoggerOobRisk::logStep (const unsigned int current_iteration, const std::sh
     _sh_ptr_oob_response->constantInitialization(_sh_ptr_loss);
     _sh_ptr_oob_response->initializePrediction();
   }
-  std::string blearner_id = sh_ptr_blearner->getDataIdentifier();
-
   // Get data of corresponding selected baselearner. E.g. iteration 100 linear
-  // baselearner of feature x_7, then get the data of feature x_7:
-  std::string factory_id = sh_ptr_blearner->getDataIdentifier() + "_" + sh_ptr_blearner->getBaselearnerType();
-  auto it_oob_data_inst = _oob_data_map_inst.find(factory_id);
+  // baselearner of feature x_7, then get the data of feature x_7. The update of a
+  // block is the sum of the predictions of all base learners of the block:
+  const blearner_factory_map factory_map = sh_ptr_factory_list->getFactoryMap();
   arma::mat temp_oob_prediction;
-
-  auto itf = sh_ptr_factory_list->getFactoryMap().find(factory_id);
-  if (it_oob_data_inst == _oob_data_map_inst.end()) {
-    auto insert = std::pair<std::string, std::shared_ptr<data::Data>>(factory_id, itf->second->instantiateData(_oob_data_map));
-    _oob_data_map_inst.insert(insert);
-    temp_oob_prediction = sh_ptr_blearner->predict(insert.second);
-  } else {
-    temp_oob_prediction = sh_ptr_blearner->predict(it_oob_data_inst->second);
+  for (auto& sh_ptr_blearner : blearners) {
+    std::string factory_id = sh_ptr_blearner->getDataIdentifier() + "_" + sh_ptr_blearner->getBaselearnerType();
+    auto it_oob_data_inst = _oob_data_map_inst.find(factory_id);
+    if (it_oob_data_inst == _oob_data_map_inst.end()) {
+      auto itf = factory_map.find(factory_id);
+      it_oob_data_inst = _oob_data_map_inst.insert(std::pair<std::string, std::shared_ptr<data::Data>>(factory_id,
+        itf->second->instantiateData(_oob_data_map))).first;
+    }
+    if (temp_oob_prediction.is_empty()) {
+      temp_oob_prediction = sh_ptr_blearner->predict(it_oob_data_inst->second);
+    } else {
+      temp_oob_prediction += sh_ptr_blearner->predict(it_oob_data_inst->second);
+    }
   }
 
   _sh_ptr_oob_response->updatePrediction(sh_ptr_optimizer->calculateUpdate(learning_rate, step_size, temp_oob_prediction,
@@ -601,6 +622,22 @@ json LoggerOobRisk::toJson (const bool rm_data) const
   return j;
 }
 
+void LoggerOobRisk::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+
+  std::string component = "logger:" + getLoggerId();
+  report.add(component, getLoggerType(), "logged_data",    memreport::stdVecBytes(_oob_risk));
+  report.add(component, getLoggerType(), "oob_prediction", memreport::matBytes(_oob_prediction));
+  for (auto& it : _oob_data_map) {
+    it.second->reportMemory(report, component);
+  }
+  for (auto& it : _oob_data_map_inst) {
+    it.second->reportMemory(report, component);
+  }
+  _sh_ptr_oob_response->reportMemory(report, component);
+}
+
 
 
 // LoggerTime:
@@ -663,15 +700,15 @@ LoggerTime::LoggerTime (const json& j)
  *
  * \param current_iteration `unsigned int` of current iteration
  * \param sh_ptr_response `std::shared_ptr<response::Response>` of the given response used for training
- * \param sh_ptr_blearner `std::shared_ptr<Baselearner>` pointer to the selected baselearner in
- *   iteration `current_iteration`
+ * \param blearners `std::vector<std::shared_ptr<Baselearner>>` base learners selected in
+ *   iteration `current_iteration` (more than one for block updates)
  * \param learning_rate `double` lerning rate of the `current_iteration`
  * \param step_size `double` step size of the iteration
  * \param sh_ptr_optimizer `std::shared_ptr<optimizer::Optimizer>` optimizer used to find the best base-learner
  *
  */
 void LoggerTime::logStep (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner, const double learning_rate, const double step_size,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
   const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
   if (_current_time.size() == 0) {
@@ -778,10 +815,218 @@ json LoggerTime::toJson (const bool rm_data) const
   return j;
 }
 
+void LoggerTime::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  report.add("logger:" + getLoggerId(), getLoggerType(), "logged_data", memreport::stdVecBytes(_current_time));
+}
+
 void LoggerTime::reInitializeTime ()
 {
   _init_time = std::chrono::system_clock::now();
   _retrain_drift += _current_time.back();
 }
 
+
+
+// LoggerProfile:
+// -----------------------
+
+/**
+ * \brief Default constructor of class `LoggerProfile`
+ *
+ * \param logger_id `std::string` unique identifier of the logger
+ * \param max_events `unsigned int` maximal number of trace events kept for the
+ *   timeline (the aggregated phase table is not affected by this limit)
+ */
+LoggerProfile::LoggerProfile (const std::string logger_id, const unsigned int max_events)
+  : Logger::Logger   ( false, "profile", logger_id ),
+    _sh_ptr_profiler ( std::make_shared<profiler::Profiler>(max_events) )
+{ }
+
+LoggerProfile::LoggerProfile (const json& j)
+  : Logger::Logger   ( j ),
+    _sh_ptr_profiler ( std::make_shared<profiler::Profiler>(j["_sh_ptr_profiler"]) ),
+    _elapsed_time    ( j["_elapsed_time"].get<std::vector<double>>() )
+{ }
+
+/**
+ * \brief Log current step of compboost iteration for class `LoggerProfile`
+ *
+ * The phases itself are recorded by the profiler while training. Here, just
+ * the elapsed steady clock time is logged.
+ */
+void LoggerProfile::logStep (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
+  const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
+{
+  _elapsed_time.push_back(_sh_ptr_profiler->elapsedMicro(profiler::pclock::now()));
+}
+
+bool LoggerProfile::reachedStopCriteria ()
+{
+  return false;
+}
+
+arma::vec LoggerProfile::getLoggedData () const
+{
+  arma::vec out (_elapsed_time);
+  return out;
+}
+
+/**
+ * \brief Clear the logger data
+ *
+ * Resets the logged time and all recorded phases of the profiler.
+ */
+void LoggerProfile::clearLoggerData ()
+{
+  _elapsed_time.clear();
+  _sh_ptr_profiler->clear();
+}
+
+std::string LoggerProfile::printLoggerStatus () const
+{
+  std::stringstream ss;
+  ss << Logger::getLoggerId() << " = " << std::setprecision(2) << _elapsed_time.back();
+
+  return ss.str();
+}
+
+json LoggerProfile::toJson (const bool rm_data) const
+{
+  json j = Logger::baseToJson("LoggerProfile");
+  j["_sh_ptr_profiler"] = _sh_ptr_profiler->toJson();
+  j["_elapsed_time"]    = _elapsed_time;
+
+  return j;
+}
+
+void LoggerProfile::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+
+  std::string component = "logger:" + getLoggerId();
+  report.add(component, getLoggerType(), "logged_data", memreport::stdVecBytes(_elapsed_time));
+  report.add(component, getLoggerType(), "profiler",    _sh_ptr_profiler->getMemoryBytes());
+}
+
+std::shared_ptr<profiler::Profiler> LoggerProfile::getProfiler () const
+{
+  return _sh_ptr_profiler;
+}
+
+
+
+// LoggerCandidateMiss:
+// -----------------------
+
+/**
+ * \brief Default constructor of class `LoggerCandidateMiss`
+ *
+ * \param logger_id `std::string` unique identifier of the logger
+ * \param check_every `unsigned int` check the candidate sampling every `check_every` iterations
+ */
+LoggerCandidateMiss::LoggerCandidateMiss (const std::string logger_id, const unsigned int check_every)
+  : Logger::Logger ( false, "candidate_miss", logger_id ),
+    _check_every   ( check_every )
+{
+  if (check_every == 0) Rcpp::stop("The candidate miss logger requires 'check_every' > 0.");
+}
+
+LoggerCandidateMiss::LoggerCandidateMiss (const json& j)
+  : Logger::Logger ( j ),
+    _check_every   ( j["_check_every"].get<unsigned int>() ),
+    _missed        ( j["_missed"].get<std::vector<int>>() )
+{ }
+
+/**
+ * \brief Log current step of compboost iteration for class `LoggerCandidateMiss`
+ *
+ * The logger is called after the update of the prediction but before the pseudo
+ * residuals are updated. Hence, the full sweep uses the same pseudo residuals as
+ * the optimizer. The sweep does not touch the state of the optimizer (e.g. the
+ * bounds of the safe screening).
+ */
+void LoggerCandidateMiss::logStep (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
+  const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
+{
+  if ((current_iteration % _check_every != 0) || (! sh_ptr_optimizer->evaluatedSubset(current_iteration))) {
+    _missed.push_back(-1);
+    return;
+  }
+  if (sh_ptr_optimizer->getType() == "agbm") {
+    Rcpp::stop("The candidate miss logger cannot be used with the AGBM optimizer.");
+  }
+  std::shared_ptr<blearner::Baselearner> sh_ptr_best = sh_ptr_optimizer->findBestBaselearnerExhaustive(
+    sh_ptr_response->getPseudoResiduals(), sh_ptr_factory_list->getFactoryMap());
+
+  std::string id_best     = sh_ptr_best->getDataIdentifier() + "_" + sh_ptr_best->getBaselearnerType();
+  // The first base learner of a block is the best one:
+  std::string id_selected = blearners.front()->getDataIdentifier() + "_" + blearners.front()->getBaselearnerType();
+
+  _missed.push_back(id_best == id_selected ? 0 : 1);
+}
+
+bool LoggerCandidateMiss::reachedStopCriteria ()
+{
+  return false;
+}
+
+arma::vec LoggerCandidateMiss::getLoggedData () const
+{
+  arma::vec out(_missed.size());
+  for (unsigned int i = 0; i < _missed.size(); i++) {
+    out(i) = _missed[i] < 0 ? arma::datum::nan : _missed[i];
+  }
+  return out;
+}
+
+void LoggerCandidateMiss::clearLoggerData ()
+{
+  _missed.clear();
+}
+
+std::string LoggerCandidateMiss::printLoggerStatus () const
+{
+  std::stringstream ss;
+  ss << Logger::getLoggerId() << " = " << std::setprecision(2) << getMissRate();
+
+  return ss.str();
+}
+
+json LoggerCandidateMiss::toJson (const bool rm_data) const
+{
+  json j = Logger::baseToJson("LoggerCandidateMiss");
+  j["_check_every"] = _check_every;
+  j["_missed"]      = _missed;
+
+  return j;
+}
+
+void LoggerCandidateMiss::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  report.add("logger:" + getLoggerId(), getLoggerType(), "logged_data", memreport::stdVecBytes(_missed));
+}
+
+/**
+ * \brief Share of the checked iterations in which the best base learner was missed
+ *
+ * \returns `double` miss rate or `NaN` if no iteration was checked
+ */
+double LoggerCandidateMiss::getMissRate () const
+{
+  double n_checked = 0;
+  double n_missed  = 0;
+  for (auto& m : _missed) {
+    if (m < 0) continue;
+    n_checked += 1;
+    n_missed  += m;
+  }
+  if (n_checked == 0) return arma::datum::nan;
+  return n_missed / n_checked;
+}
+
 } // namespace logger
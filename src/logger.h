@@ -96,7 +96,7 @@ protected:
 public:
   // Virtual functions:
   virtual void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
-    const std::shared_ptr<blearner::Baselearner>&, const double, const double,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
     const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&) = 0;
 
   virtual bool         reachedStopCriteria ()       = 0;
@@ -105,6 +105,7 @@ public:
   virtual std::string  printLoggerStatus   () const = 0;
 
   virtual json toJson (const bool = false) const = 0;
+  virtual void reportMemory (memreport::MemoryReport&) const = 0;
 
   // Setter/Getter
   void setIsStopper (const bool);
@@ -144,7 +145,7 @@ public:
   LoggerIteration (const json&);
 
   void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
-    const std::shared_ptr<blearner::Baselearner>&, const double, const double,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
     const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
 
   bool         reachedStopCriteria ();
@@ -152,7 +153,8 @@ public:
   void         clearLoggerData     ();
   std::string  printLoggerStatus   () const;
 
-  json toJson (const bool = false) const;
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&) const;
 
   void updateMaxIterations (const unsigned int&);
 };
@@ -187,7 +189,7 @@ public:
   LoggerInbagRisk (const json&);
 
   void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
-    const std::shared_ptr<blearner::Baselearner>&, const double, const double,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
     const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
 
   bool         reachedStopCriteria ();
@@ -195,7 +197,8 @@ public:
   void         clearLoggerData     ();
   std::string  printLoggerStatus   () const;
 
-  json toJson (const bool = false) const;
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&) const;
 };
 
 
@@ -235,7 +238,7 @@ public:
   LoggerOobRisk (const json&);
 
   void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
-    const std::shared_ptr<blearner::Baselearner>&, const double, const double,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
     const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
 
   bool         reachedStopCriteria ();
@@ -243,7 +246,8 @@ public:
   void         clearLoggerData     ();
   std::string  printLoggerStatus   () const;
 
-  json toJson (const bool = false) const;
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&) const;
 };
 
 
@@ -277,7 +281,7 @@ public:
   LoggerTime (const json&);
 
   void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
-    const std::shared_ptr<blearner::Baselearner>&, const double, const double,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
     const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
 
   bool         reachedStopCriteria ();
@@ -285,12 +289,94 @@ public:
   void         clearLoggerData     ();
   std::string  printLoggerStatus   () const;
 
-  json toJson (const bool = false) const;
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&) const;
 
   void reInitializeTime();
 
 };
 
+
+// LoggerProfile:
+// -----------------------
+
+/**
+ * \class LoggerProfile
+ *
+ * \brief Logger that profiles the phases of the training
+ *
+ * This class owns a `profiler::Profiler` which is picked up by
+ * `Compboost::train` and handed to the optimizer. The profiler records steady
+ * clock timings and counters for each phase and each factory. The logged data
+ * is the elapsed steady clock time in microseconds. The logger is never used
+ * as stopper.
+ */
+class LoggerProfile : public Logger
+{
+private:
+  std::shared_ptr<profiler::Profiler> _sh_ptr_profiler;
+  std::vector<double>                 _elapsed_time;
+
+public:
+  LoggerProfile (const std::string, const unsigned int);
+  LoggerProfile (const json&);
+
+  void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
+    const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
+
+  bool         reachedStopCriteria ();
+  arma::vec    getLoggedData       () const;
+  void         clearLoggerData     ();
+  std::string  printLoggerStatus   () const;
+
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&) const;
+
+  std::shared_ptr<profiler::Profiler> getProfiler () const;
+};
+
+
+// LoggerCandidateMiss:
+// -----------------------
+
+/**
+ * \class LoggerCandidateMiss
+ *
+ * \brief Logger to check the candidate sampling of the optimizer
+ *
+ * If the optimizer evaluates just a subset of the factories, this logger
+ * evaluates all factories on the same pseudo residuals every `_check_every`
+ * iterations and logs if the best base learner was missed (1) or not (0).
+ * Iterations that were not checked, e.g. full sweeps, are stored as -1 and
+ * returned as `NaN`.
+ * Each check costs one full sweep over the factories.
+ */
+class LoggerCandidateMiss : public Logger
+{
+private:
+  const unsigned int _check_every;
+  std::vector<int>   _missed;
+
+public:
+  LoggerCandidateMiss (const std::string, const unsigned int);
+  LoggerCandidateMiss (const json&);
+
+  void logStep (const unsigned int, const std::shared_ptr<response::Response>&,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
+    const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
+
+  bool         reachedStopCriteria ();
+  arma::vec    getLoggedData       () const;
+  void         clearLoggerData     ();
+  std::string  printLoggerStatus   () const;
+
+  json toJson       (const bool = false) const;
+  void reportMemory (memreport::MemoryReport&) const;
+
+  double getMissRate () const;
+};
+
 } // namespace logger
 
 #endif // LOGGER_H_
@@ -92,15 +92,37 @@ ldata LoggerList::getLoggerData () const
 }
 
 void LoggerList::logCurrent (const unsigned int current_iteration, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner, const double learning_rate, const double step_size,
+  const std::vector<std::shared_ptr<blearner::Baselearner>>& blearners, const double learning_rate, const double step_size,
   const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
+  auto sh_ptr_profiler = getProfiler();
   for (auto& it_logger : _logger_list) {
-    it_logger.second->logStep(current_iteration, sh_ptr_response, sh_ptr_blearner,
+    std::string phase;
+    if (sh_ptr_profiler != nullptr) phase = "logger:" + it_logger.first;
+
+    profiler::ScopedTimer timer(sh_ptr_profiler, phase, "logger");
+    it_logger.second->logStep(current_iteration, sh_ptr_response, blearners,
       learning_rate, step_size, sh_ptr_optimizer, sh_ptr_factory_list);
   }
 }
 
+std::shared_ptr<profiler::Profiler> LoggerList::getProfiler () const
+{
+  for (auto& it_logger : _logger_list) {
+    if (it_logger.second->getLoggerType() == "profile") {
+      return std::static_pointer_cast<logger::LoggerProfile>(it_logger.second)->getProfiler();
+    }
+  }
+  return nullptr;
+}
+
+void LoggerList::reportMemory (memreport::MemoryReport& report) const
+{
+  for (auto& it_logger : _logger_list) {
+    it_logger.second->reportMemory(report);
+  }
+}
+
 void LoggerList::printLoggerStatus (const double current_risk) const
 {
   std::stringstream printer;
@@ -56,10 +56,12 @@ public:
   lmap  getLoggerMap     ()           const;
   ldata getLoggerData    ()           const;
 
+  std::shared_ptr<profiler::Profiler> getProfiler () const;
+
 
   // Other member functions
   void logCurrent (const unsigned int, const std::shared_ptr<response::Response>&,
-    const std::shared_ptr<blearner::Baselearner>&, const double, const double,
+    const std::vector<std::shared_ptr<blearner::Baselearner>>&, const double, const double,
     const std::shared_ptr<optimizer::Optimizer>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
 
   void printLoggerStatus     (const double) const;
@@ -69,6 +71,7 @@ public:
   void prepareForRetraining  (const unsigned int);
   void clearMap              ();
   void clearLoggerData       ();
+  void reportMemory          (memreport::MemoryReport&) const;
 
   json toJson (const bool = false) const;
 
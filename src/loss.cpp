@@ -42,6 +42,9 @@ std::shared_ptr<Loss> jsonToLoss (const json& j)
   if (j["Class"] == "LossBinomial") {
     l = std::make_shared<LossBinomial>(j);
   }
+  if (j["Class"] == "LossMultinomial") {
+    l = std::make_shared<LossMultinomial>(j);
+  }
   if (l == nullptr) {
     throw std::logic_error("No known class in JSON");
   }
@@ -89,16 +92,27 @@ std::string Loss::getType () const
 }
 
 
+// Observation weights with one column are applied to all columns of a multi-column response:
 arma::mat Loss::weightedLoss (const arma::mat& true_value, const arma::mat& prediction,
   const arma::mat& weights) const
 {
-  return weights % loss(true_value, prediction);
+  arma::mat out = loss(true_value, prediction);
+  if ((weights.n_cols == 1) && (out.n_cols > 1)) return out.each_col() % weights.col(0);
+  return weights % out;
 }
 
 arma::mat Loss::weightedGradient (const arma::mat& true_value, const arma::mat& prediction,
   const arma::mat& weights) const
 {
-  return weights % gradient(true_value, prediction);
+  arma::mat out = gradient(true_value, prediction);
+  if ((weights.n_cols == 1) && (out.n_cols > 1)) return out.each_col() % weights.col(0);
+  return weights % out;
+}
+
+arma::mat Loss::hessian (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  Rcpp::stop("Loss \"" + _type + "\" does not provide a Hessian.");
+  return arma::mat();
 }
 
 double Loss::calculateEmpiricalRisk (const arma::mat& true_value, const arma::mat& prediction) const
@@ -189,6 +203,11 @@ arma::mat LossQuadratic::gradient (const arma::mat& true_value, const arma::mat&
   return prediction - true_value;
 }
 
+arma::mat LossQuadratic::hessian (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  return arma::mat(prediction.n_rows, prediction.n_cols, arma::fill::ones);
+}
+
 /**
  * \brief Definition of the constant risk initialization (see description of the class)
  *
@@ -446,6 +465,19 @@ arma::mat LossHuber::gradient (const arma::mat& true_value, const arma::mat& pre
   return grad_mat;
 }
 
+/**
+ * \brief Second derivative of the loss, one in the quadratic and zero in the linear part
+ */
+arma::mat LossHuber::hessian (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  arma::mat hess_mat = true_value - prediction;
+  hess_mat.transform( [this](double elem) {
+    return (std::abs(elem) < _delta) ? 1.0 : 0.0;
+  } );
+
+  return hess_mat;
+}
+
 /**
  * \brief Definition of the constant risk initialization (see description of the class)
  *
@@ -532,6 +564,17 @@ arma::mat LossBinomial::gradient (const arma::mat& true_value, const arma::mat&
   return -true_value / (1 + arma::exp(true_value % prediction));
 }
 
+/**
+* \brief Second derivative of the loss, \f$p(1 - p)\f$ with \f$p = 1 / (1 + \exp(-f))\f$
+*
+* Since \f$y^2 = 1\f$ the Hessian does not depend on the label.
+*/
+arma::mat LossBinomial::hessian (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  arma::mat p = 1 / (1 + arma::exp(-prediction));
+  return p % (1 - p);
+}
+
 /**
 * \brief Definition of the constant risk initialization (see description of the class)
 *
@@ -557,6 +600,83 @@ arma::mat LossBinomial::weightedConstantInitializer (const arma::mat& true_value
 
 json LossBinomial::toJson () const { return baseToJson("LossBinomial"); }
 
+// LossMultinomial:
+// -----------------------
+
+LossMultinomial::LossMultinomial ()
+  : Loss::Loss ( std::string("multiclass_classif"), std::string("multinomial") )
+{ }
+
+LossMultinomial::LossMultinomial (const arma::mat& custom_offset)
+  : Loss::Loss ( "multiclass_classif", std::string("multinomial"), custom_offset )
+{ }
+
+LossMultinomial::LossMultinomial (const json& j)
+  : Loss::Loss (j)
+{ }
+
+/**
+* \brief Cross entropy of each observation (see description of the class)
+*
+* \param true_value `arma::mat` One-hot encoded response (one column per class)
+* \param prediction `arma::mat` Scores of the classes
+*
+* \returns `arma::mat` Cross entropy of each row, repeated for each class
+*/
+arma::mat LossMultinomial::loss (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  // log(sum(exp(f))) - sum(y * f) with the maximum of the scores subtracted for stability:
+  arma::vec fmax = arma::max(prediction, 1);
+  arma::vec lse  = fmax + arma::log(arma::sum(arma::exp(prediction.each_col() - fmax), 1));
+  arma::vec ce   = lse - arma::sum(true_value % prediction, 1);
+  return arma::repmat(ce, 1, prediction.n_cols);
+}
+
+/**
+* \brief Gradient w.r.t. the scores of each class (see description of the class)
+*/
+arma::mat LossMultinomial::gradient (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  return helper::softmax(prediction) - true_value;
+}
+
+/**
+* \brief Diagonal of the Hessian w.r.t. the scores, \f$p_k(1 - p_k)\f$
+*/
+arma::mat LossMultinomial::hessian (const arma::mat& true_value, const arma::mat& prediction) const
+{
+  arma::mat p = helper::softmax(prediction);
+  return p % (1 - p);
+}
+
+/**
+* \brief Centered log of the class frequencies (see description of the class)
+*
+* \param true_value `arma::mat` One-hot encoded response (one column per class)
+*
+* \returns `arma::mat` Row vector with the initial score of each class
+*/
+arma::mat LossMultinomial::constantInitializer (const arma::mat& true_value) const
+{
+  if (_use_custom_offset) { return _custom_offset; }
+
+  arma::rowvec p = arma::sum(true_value, 0) / true_value.n_rows;
+  arma::rowvec out = arma::log(arma::clamp(p, 1e-10, 1));
+  return out - arma::mean(out);
+}
+
+arma::mat LossMultinomial::weightedConstantInitializer (const arma::mat& true_value, const arma::mat& weights) const
+{
+  if (_use_custom_offset) { return _custom_offset; }
+
+  arma::mat weighted = true_value.each_col() % weights.col(0);
+  arma::rowvec p = arma::sum(weighted, 0) / arma::accu(weights.col(0));
+  arma::rowvec out = arma::log(arma::clamp(p, 1e-10, 1));
+  return out - arma::mean(out);
+}
+
+json LossMultinomial::toJson () const { return baseToJson("LossMultinomial"); }
+
 // LossCustom:
 // -----------------------
 
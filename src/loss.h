@@ -81,6 +81,9 @@ public:
   virtual arma::mat loss     (const arma::mat&, const arma::mat&) const = 0;
   virtual arma::mat gradient (const arma::mat&, const arma::mat&) const = 0;
 
+  // Second derivative w.r.t. the prediction, required for Newton boosting:
+  virtual arma::mat hessian  (const arma::mat&, const arma::mat&) const;
+
   virtual arma::mat constantInitializer         (const arma::mat&)                   const = 0;
   virtual arma::mat weightedConstantInitializer (const arma::mat&, const arma::mat&) const = 0;
 
@@ -164,6 +167,7 @@ public:
 
   arma::mat loss     (const arma::mat&, const arma::mat&) const;
   arma::mat gradient (const arma::mat&, const arma::mat&) const;
+  arma::mat hessian  (const arma::mat&, const arma::mat&) const;
 
   arma::mat constantInitializer         (const arma::mat&)                   const;
   arma::mat weightedConstantInitializer (const arma::mat&, const arma::mat&) const;
@@ -254,6 +258,7 @@ public:
 
   arma::mat loss     (const arma::mat&, const arma::mat&) const;
   arma::mat gradient (const arma::mat&, const arma::mat&) const;
+  arma::mat hessian  (const arma::mat&, const arma::mat&) const;
 
   arma::mat constantInitializer         (const arma::mat&)                   const;
   arma::mat weightedConstantInitializer (const arma::mat&, const arma::mat&) const;
@@ -285,6 +290,10 @@ public:
  * \f[
  *   \frac{\delta}{\delta f(x)}\ L(y, f(x)) = - \frac{2y}{1 + \exp\left(2yf\right)}
  * \f]
+ * **Hessian** (of the implemented loss \f$\log(1 + \exp(-yf))\f$):
+ * \f[
+ *   \frac{\delta^2}{\delta f(x)^2}\ L(y, f(x)) = \frac{\exp(yf)}{\left(1 + \exp(yf)\right)^2}
+ * \f]
  * **Initialization:**
  * \f[
  *   \hat{f}^{[0]}(x) = \frac{1}{2}\log\left(\frac{p}{1 - p}\right)
@@ -306,6 +315,56 @@ public:
 
   arma::mat loss     (const arma::mat&, const arma::mat&) const;
   arma::mat gradient (const arma::mat&, const arma::mat&) const;
+  arma::mat hessian  (const arma::mat&, const arma::mat&) const;
+
+  arma::mat constantInitializer         (const arma::mat&)                   const;
+  arma::mat weightedConstantInitializer (const arma::mat&, const arma::mat&) const;
+
+  json toJson () const;
+};
+
+// LossMultinomial:
+// -----------------------
+
+/**
+ * \class LossMultinomial
+ *
+ * \brief Cross entropy of the softmax for multiclass classification
+ *
+ * The response is one-hot encoded \f$y \in \{0, 1\}^K\f$ and the model has
+ * one score \f$f_k(x)\f$ per class. The loss of an observation is repeated
+ * for each class, hence the empirical risk is the mean cross entropy.
+ *
+ * **Loss Function:**
+ * \f[
+ *   L(y, f(x)) = \log\left(\sum\limits_{k=1}^K \exp(f_k(x))\right) - \sum\limits_{k=1}^K y_k f_k(x)
+ * \f]
+ * **Gradient:**
+ * \f[
+ *   \frac{\delta}{\delta f_k(x)}\ L(y, f(x)) = p_k(x) - y_k, \qquad
+ *   p_k(x) = \frac{\exp(f_k(x))}{\sum_{l=1}^K \exp(f_l(x))}
+ * \f]
+ * **Hessian** (diagonal):
+ * \f[
+ *   \frac{\delta^2}{\delta f_k(x)^2}\ L(y, f(x)) = p_k(x)(1 - p_k(x))
+ * \f]
+ * **Initialization:**
+ * \f[
+ *   \hat{f}_k^{[0]}(x) = \log(\pi_k) - \frac{1}{K}\sum\limits_{l=1}^K \log(\pi_l)
+ * \f]
+ * with the relative frequency \f$\pi_k\f$ of class \f$k\f$.
+ *
+ */
+class LossMultinomial : public Loss
+{
+public:
+  LossMultinomial ();
+  LossMultinomial (const arma::mat&);
+  LossMultinomial (const json&);
+
+  arma::mat loss     (const arma::mat&, const arma::mat&) const;
+  arma::mat gradient (const arma::mat&, const arma::mat&) const;
+  arma::mat hessian  (const arma::mat&, const arma::mat&) const;
 
   arma::mat constantInitializer         (const arma::mat&)                   const;
   arma::mat weightedConstantInitializer (const arma::mat&, const arma::mat&) const;
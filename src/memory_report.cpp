@@ -0,0 +1,170 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+#include "memory_report.h"
+
+namespace memreport
+{
+
+// -------------------------------------------------------------------------- //
+// MemoryReport:
+// -------------------------------------------------------------------------- //
+
+MemoryReport::MemoryReport () { }
+
+/**
+ * \brief Mark an object as visited
+ *
+ * \returns `true` if the object was not visited before and its memory must be
+ *   added to the report, `false` otherwise.
+ */
+bool MemoryReport::visit (const void* ptr)
+{
+  if (ptr == nullptr) return false;
+  return _visited.insert(ptr).second;
+}
+
+bool MemoryReport::isVisited (const void* ptr) const
+{
+  return _visited.find(ptr) != _visited.end();
+}
+
+void MemoryReport::add (const std::string& component, const std::string& object, const std::string& part,
+  const double bytes)
+{
+  // Skip empty parts to keep the report readable:
+  if (bytes <= 0) return;
+  _entries.push_back(MemoryEntry{ component, object, part, bytes });
+}
+
+std::vector<std::string> MemoryReport::getComponents () const
+{
+  std::vector<std::string> out;
+  for (auto& it : _entries) {
+    out.push_back(it.component);
+  }
+  return out;
+}
+
+std::vector<std::string> MemoryReport::getObjects () const
+{
+  std::vector<std::string> out;
+  for (auto& it : _entries) {
+    out.push_back(it.object);
+  }
+  return out;
+}
+
+std::vector<std::string> MemoryReport::getParts () const
+{
+  std::vector<std::string> out;
+  for (auto& it : _entries) {
+    out.push_back(it.part);
+  }
+  return out;
+}
+
+arma::vec MemoryReport::getBytes () const
+{
+  arma::vec out(_entries.size(), arma::fill::zeros);
+  for (unsigned int i = 0; i < _entries.size(); i++) {
+    out(i) = _entries[i].bytes;
+  }
+  return out;
+}
+
+double MemoryReport::getTotalBytes () const
+{
+  double total = 0;
+  for (auto& it : _entries) {
+    total += it.bytes;
+  }
+  return total;
+}
+
+std::map<std::string, double> MemoryReport::getBytesPerComponent () const
+{
+  std::map<std::string, double> out;
+  for (auto& it : _entries) {
+    out[it.component] += it.bytes;
+  }
+  return out;
+}
+
+json MemoryReport::toJson () const
+{
+  json jentries = json::array();
+  for (auto& it : _entries) {
+    jentries.push_back({
+      {"component", it.component},
+      {"object",    it.object},
+      {"part",      it.part},
+      {"bytes",     it.bytes}
+    });
+  }
+  json j = {
+    {"entries",     jentries},
+    {"total_bytes", getTotalBytes()}
+  };
+  return j;
+}
+
+
+// -------------------------------------------------------------------------- //
+// Helper:
+// -------------------------------------------------------------------------- //
+
+double matBytes (const arma::mat& X)
+{
+  // Armadillo stores small matrices (<= 16 elements) in a member array:
+  if (X.n_elem <= arma::arma_config::mat_prealloc) return 0;
+  // Auxiliary memory (e.g. of an R vector or a mapped file) is not owned:
+  if (X.mem_state != 0) return 0;
+  return X.n_elem * sizeof(double);
+}
+
+double spMatBytes (const arma::sp_mat& X)
+{
+  return X.n_nonzero * (sizeof(double) + sizeof(arma::uword)) + (X.n_cols + 1) * sizeof(arma::uword);
+}
+
+double uvecBytes (const arma::uvec& x)
+{
+  if (x.n_elem <= arma::arma_config::mat_prealloc) return 0;
+  return x.n_elem * sizeof(arma::uword);
+}
+
+double stringBytes (const std::string& s)
+{
+  // Short strings are stored inline (small string optimization):
+  if (s.capacity() < sizeof(std::string)) return 0;
+  return s.capacity() + 1;
+}
+
+double stringVecBytes (const std::vector<std::string>& x)
+{
+  double bytes = x.capacity() * sizeof(std::string);
+  for (auto& it : x) {
+    bytes += stringBytes(it);
+  }
+  return bytes;
+}
+
+} // namespace memreport
@@ -0,0 +1,107 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    memory_report.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Heap footprint of a model
+ *
+ *  @section DESCRIPTION
+ *
+ *  A `MemoryReport` collects entries of the form (component, object, part,
+ *  bytes). The components of a model (data objects, factories, response,
+ *  iteration track, optimizer, logger) add their heap memory to the report.
+ *  Objects which are shared between components (e.g. the same `data::Data`
+ *  used by several factories) are visited just once. Therefore, the sum of
+ *  all entries is the memory of the model and not the sum of the memory each
+ *  component would occupy on its own.
+ *
+ *  The numbers are estimates of the heap allocations of matrices, vectors and
+ *  strings. The allocator overhead is not included.
+ *
+ */
+
+#ifndef MEMORY_REPORT_H_
+#define MEMORY_REPORT_H_
+
+#include <RcppArmadillo.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "single_include/nlohmann/json.hpp"
+using json = nlohmann::json;
+
+namespace memreport
+{
+
+/// Size of the control block of a `std::shared_ptr` (vtable plus two counter)
+const double SH_PTR_CTRL_BYTES = sizeof(void*) + 2 * sizeof(long);
+
+struct MemoryEntry
+{
+  std::string component;
+  std::string object;
+  std::string part;
+  double      bytes;
+};
+
+class MemoryReport
+{
+private:
+  std::vector<MemoryEntry> _entries;
+  std::set<const void*>    _visited;
+
+public:
+  MemoryReport ();
+
+  bool visit     (const void*);
+  bool isVisited (const void*) const;
+  void add       (const std::string&, const std::string&, const std::string&, const double);
+
+  std::vector<std::string>      getComponents         () const;
+  std::vector<std::string>      getObjects            () const;
+  std::vector<std::string>      getParts              () const;
+  arma::vec                     getBytes              () const;
+  double                        getTotalBytes         () const;
+  std::map<std::string, double> getBytesPerComponent  () const;
+
+  json toJson () const;
+};
+
+// Bytes allocated on the heap:
+double matBytes    (const arma::mat&);
+double spMatBytes  (const arma::sp_mat&);
+double uvecBytes   (const arma::uvec&);
+double stringBytes (const std::string&);
+double stringVecBytes (const std::vector<std::string>&);
+
+template<typename T>
+double stdVecBytes (const std::vector<T>& x)
+{
+  return x.capacity() * sizeof(T);
+}
+
+} // namespace memreport
+
+#endif // MEMORY_REPORT_H_
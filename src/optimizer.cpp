@@ -35,6 +35,15 @@ std::shared_ptr<Optimizer> jsonToOptimizer (const json& j, const mdata& mdat)
   if (j["Class"] == "OptimizerCosineAnnealing") {
     op = std::make_shared<OptimizerCosineAnnealing>(j);
   }
+  if (j["Class"] == "OptimizerStochasticCoordinateDescent") {
+    op = std::make_shared<OptimizerStochasticCoordinateDescent>(j);
+  }
+  if (j["Class"] == "OptimizerBlockCoordinateDescent") {
+    op = std::make_shared<OptimizerBlockCoordinateDescent>(j);
+  }
+  if (j["Class"] == "OptimizerNewton") {
+    op = std::make_shared<OptimizerNewton>(j);
+  }
   if (j["Class"] == "OptimizerAGBM") {
     op = std::make_shared<OptimizerAGBM>(j, mdat);
   }
@@ -44,6 +53,29 @@ std::shared_ptr<Optimizer> jsonToOptimizer (const json& j, const mdata& mdat)
   return op;
 }
 
+/**
+ * \brief Record the training of one candidate in the profiler
+ *
+ * The bytes are an estimate: Each evaluation reads the design and the pseudo
+ * residuals once.
+ */
+void profileCandidate (const std::shared_ptr<profiler::Profiler>& sh_ptr_profiler, const std::string& factory_id,
+  const std::shared_ptr<blearnerfactory::BaselearnerFactory>& sh_ptr_factory, const arma::mat& pr,
+  const profiler::pclock::time_point& t_start)
+{
+  if (sh_ptr_profiler == nullptr) return;
+
+  auto t_end = profiler::pclock::now();
+  std::string phase = "candidate:" + factory_id;
+
+  double bytes = pr.n_elem * sizeof(double);
+
+  sdata sh_ptr_data = sh_ptr_factory->getInstantiatedData();
+  if (sh_ptr_data != nullptr) bytes += sh_ptr_data->getDesignBytes();
+
+  sh_ptr_profiler->record(phase, sh_ptr_factory->getBaselearnerType(), t_start, t_end);
+  sh_ptr_profiler->addCounters(phase, 1, bytes);
+}
 
 
 // -------------------------------------------------------------------------- //
@@ -61,49 +93,220 @@ Optimizer::Optimizer (const json& j)
   : _step_sizes  ( j["_step_sizes"].get<std::vector<double>>() ),
     _num_threads ( j["_num_threads"] ),
     _type        ( j["_type"] )
-{ }
+{
+  if (j.contains("_candidate_fraction")) {
+    _candidate_fraction  = j["_candidate_fraction"].get<double>();
+    _candidate_weighting = j["_candidate_weighting"].get<std::string>();
+    _full_sweep_every    = j["_full_sweep_every"].get<unsigned int>();
+    _candidate_seed      = j["_candidate_seed"].get<unsigned int>();
+    _candidate_counts    = j["_candidate_counts"].get<std::map<std::string, unsigned int>>();
+  }
+  if (j.contains("_safe_screening") && j["_safe_screening"].get<bool>()) {
+    _sh_ptr_screening = std::make_shared<screening::SafeScreening>();
+  }
+}
 
-std::map<std::string, arma::mat> Optimizer::getParameterAtIteration (const unsigned int k, const double lr, blearnertrack::BaselearnerTrack& bl_track) const
+std::map<std::string, arma::mat> Optimizer::getParameterAtIteration (const unsigned int k, const double lr, const blearnertrack::BaselearnerTrack& bl_track) const
 {
-  auto bl_vector = bl_track.getBaselearnerVector();
-  if (k > bl_vector.size()) {
+  if (k > bl_track.getNumberOfIterations()) {
     Rcpp::stop ("You can't get parameter of a state higher then the maximal iterations.");
   }
+  // The track stores the step sizes of the optimizer and reconstructs the
+  // parameter from the nearest checkpoint. Since the parameter are linear in
+  // the learning rate, a different learning rate is just a rescaling:
+  std::map<std::string, arma::mat> new_parameter_map = bl_track.getEstimatedParameterOfIteration(k);
+  double track_lr = bl_track.getLearningRate();
+  if ((lr != track_lr) && (track_lr != 0)) {
+    for (auto& it : new_parameter_map) {
+      it.second *= lr / track_lr;
+    }
+  }
+  return new_parameter_map;
+}
 
-  // Create new parameter map:
-  std::map<std::string, arma::mat> new_parameter_map;
-
-  if (k <= bl_vector.size()) {
+std::string Optimizer::getType () const
+{
+  return _type;
+}
 
-    for (unsigned int i = 0; i < k; i++) {
-      std::string insert_id = bl_vector[i]->getDataIdentifier() + "_" + bl_vector[i]->getBaselearnerType();
+unsigned int Optimizer::getNumThreads () const
+{
+  return _num_threads;
+}
 
-      // Check if the baselearner is the first one. If so, the parameter
-      // has to be instantiated with a zero matrix:
-      std::map<std::string, arma::mat>::iterator it = new_parameter_map.find(insert_id);
+/**
+ * \brief Evaluate just a subset of the factories in each iteration
+ *
+ * \param fraction `double` Share of factories evaluated per iteration, 1 evaluates all.
+ * \param weighting `std::string` Either `"uniform"` or `"importance"`. The latter draws
+ *   the factories proportional to the number of times they were selected plus one.
+ * \param full_sweep_every `unsigned int` Evaluate all factories every `full_sweep_every`
+ *   iterations (0 for never). The first iteration is always a full sweep.
+ * \param seed `unsigned int` Seed of the candidate sampling.
+ */
+void Optimizer::setCandidateSampling (const double fraction, const std::string weighting, const unsigned int full_sweep_every,
+  const unsigned int seed)
+{
+  if ((fraction <= 0) || (fraction > 1)) {
+    Rcpp::stop("The candidate fraction must be in (0, 1].");
+  }
+  helper::assertChoice(weighting, {"uniform", "importance"});
 
-      // Prune parameter by multiplying it with the learning rate:
-      arma::mat parameter_temp = lr * getStepSize(i + 1) * bl_vector[i]->getParameter();
+  _candidate_fraction  = fraction;
+  _candidate_weighting = weighting;
+  _full_sweep_every    = full_sweep_every;
+  _candidate_seed      = seed;
+}
 
-      // Check if this is the first parameter entry:
-      if (it == new_parameter_map.end()) {
-        // If this is the first entry, initialize it with zeros:
-        arma::mat init_parameter(parameter_temp.n_rows, parameter_temp.n_cols, arma::fill::zeros);
-        new_parameter_map.insert(std::pair<std::string, arma::mat>(insert_id, init_parameter));
-      }
-      // Accumulating parameter. If there is a nan, then this will be ignored and
-      // the non  nan entries are summed up:
-      new_parameter_map[ insert_id ] += parameter_temp;
+/**
+ * \brief Factories that are evaluated in one iteration
+ *
+ * Draws \f$\lceil \mathrm{fraction} \cdot p \rceil\f$ of the \f$p\f$ factories without
+ * replacement. The weighted draw uses the keys \f$\log(u_j) / w_j\f$ of Efraimidis and
+ * Spirakis and keeps the largest ones. The generator is seeded by the seed and the
+ * iteration, hence calling the function twice in one iteration (e.g. AGBM) returns the
+ * same candidates.
+ *
+ * \param actual_iteration `unsigned int` Iteration (starting at 1).
+ * \param factory_map `blearner_factory_map` All registered factories.
+ *
+ * \returns `blearner_factory_map` The candidates. This is `factory_map` itself if all
+ *   factories are evaluated.
+ */
+const blearner_factory_map& Optimizer::sampleCandidates (const unsigned int actual_iteration, const blearner_factory_map& factory_map)
+{
+  bool full_sweep = (_candidate_fraction >= 1) || (actual_iteration == 1) ||
+    ((_full_sweep_every > 0) && (actual_iteration % _full_sweep_every == 0));
+
+  unsigned int n_candidates = std::ceil(_candidate_fraction * factory_map.size());
+  if (n_candidates < 1) n_candidates = 1;
+  if (n_candidates >= factory_map.size()) full_sweep = true;
+
+  if (full_sweep) {
+    _candidate_iteration = actual_iteration;
+    _candidate_is_subset = false;
+    _candidate_map.clear();
+    return factory_map;
+  }
+  if ((_candidate_iteration == actual_iteration) && _candidate_is_subset) return _candidate_map;
+
+  std::seed_seq seq{_candidate_seed, actual_iteration, 2u};
+  std::mt19937_64 rng(seq);
+
+  std::vector<std::pair<double, blearner_factory_map::const_iterator>> keys;
+  keys.reserve(factory_map.size());
+  for (auto it = factory_map.begin(); it != factory_map.end(); ++it) {
+    double u = (static_cast<double>(rng() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    double w = 1;
+    if (_candidate_weighting == "importance") {
+      auto it_count = _candidate_counts.find(it->first);
+      if (it_count != _candidate_counts.end()) w += it_count->second;
     }
-    return new_parameter_map;
-  } else {
-    return bl_track.getParameterMap();
+    keys.push_back(std::make_pair(std::log(u) / w, it));
+  }
+  std::partial_sort(keys.begin(), keys.begin() + n_candidates, keys.end(),
+    [](const std::pair<double, blearner_factory_map::const_iterator>& l, const std::pair<double, blearner_factory_map::const_iterator>& r) {
+      return l.first > r.first;
+    });
+
+  _candidate_map.clear();
+  for (unsigned int i = 0; i < n_candidates; i++) {
+    _candidate_map.insert(*keys[i].second);
   }
+  _candidate_iteration = actual_iteration;
+  _candidate_is_subset = true;
+
+  return _candidate_map;
 }
 
-std::string Optimizer::getType () const
+void Optimizer::registerSelection (const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner)
 {
-  return _type;
+  _candidate_counts[sh_ptr_blearner->getDataIdentifier() + "_" + sh_ptr_blearner->getBaselearnerType()] += 1;
+}
+
+bool Optimizer::evaluatedSubset (const unsigned int actual_iteration) const
+{
+  return (_candidate_iteration == actual_iteration) && _candidate_is_subset;
+}
+
+/**
+ * \brief Candidate with the smallest SSE on the pseudo residuals `pr`
+ *
+ * All factories are evaluated. In contrast to `findBestBaselearner`, neither the
+ * safe screening nor the profiler are updated, hence the call does not change the
+ * selection or the reports of the optimizer. Ties are broken by the position in
+ * the factory map.
+ */
+std::shared_ptr<blearner::Baselearner> Optimizer::findBestBaselearnerExhaustive (const arma::mat& pr,
+  const blearner_factory_map& factory_map) const
+{
+  std::vector<blearner_factory_map::const_iterator> it_factories;
+  for (auto it = factory_map.begin(); it != factory_map.end(); ++it) {
+    it_factories.push_back(it);
+  }
+  const unsigned int nfactories = it_factories.size();
+
+  std::vector<double> sse(nfactories);
+  std::vector<std::shared_ptr<blearner::Baselearner>> blearners(nfactories);
+
+  #pragma omp parallel for num_threads(_num_threads) schedule(static) if (_num_threads > 1)
+  for (unsigned int i = 0; i < nfactories; i++) {
+    blearners[i] = it_factories[i]->second->createBaselearner();
+    blearners[i]->train(pr);
+    sse[i] = helper::calculateSumOfSquaredError(pr, blearners[i]->predict());
+  }
+  unsigned int best = 0;
+  for (unsigned int i = 1; i < nfactories; i++) {
+    if (sse[i] < sse[best]) best = i;
+  }
+  return blearners[best];
+}
+
+double       Optimizer::getCandidateFraction  () const { return _candidate_fraction; }
+std::string  Optimizer::getCandidateWeighting () const { return _candidate_weighting; }
+unsigned int Optimizer::getFullSweepEvery     () const { return _full_sweep_every; }
+unsigned int Optimizer::getCandidateSeed      () const { return _candidate_seed; }
+
+/**
+ * \brief Turn the safe screening of the candidates on or off
+ *
+ * Just available for the coordinate descent optimizers that select the base learner
+ * by the SSE on all observations.
+ */
+void Optimizer::setSafeScreening (const bool use_screening)
+{
+  if (! use_screening) {
+    _sh_ptr_screening = nullptr;
+    return;
+  }
+  if ((_type != "coo_descent") && (_type != "coo_descent_ls") && (_type != "cosine_ann")) {
+    Rcpp::stop("Safe screening is not available for optimizer type '" + _type + "'.");
+  }
+  if (_sh_ptr_screening == nullptr) _sh_ptr_screening = std::make_shared<screening::SafeScreening>();
+}
+
+std::shared_ptr<screening::SafeScreening> Optimizer::getSafeScreening () const
+{
+  return _sh_ptr_screening;
+}
+
+void Optimizer::setProfiler (const std::shared_ptr<profiler::Profiler>& sh_ptr_profiler)
+{
+  _sh_ptr_profiler = sh_ptr_profiler;
+}
+
+std::shared_ptr<profiler::Profiler> Optimizer::getProfiler () const
+{
+  return _sh_ptr_profiler;
+}
+
+void Optimizer::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  report.add("optimizer", _type, "step_sizes", memreport::stdVecBytes(_step_sizes));
+  if (_sh_ptr_screening != nullptr) {
+    report.add("optimizer", _type, "screening", _sh_ptr_screening->getMemoryBytes());
+  }
 }
 
 json Optimizer::baseToJson (const std::string cln) const
@@ -112,7 +315,13 @@ json Optimizer::baseToJson (const std::string cln) const
     {"Class",        cln},
     {"_step_sizes",  _step_sizes },
     {"_num_threads", _num_threads},
-    {"_type",        _type}
+    {"_type",        _type},
+    {"_candidate_fraction",  _candidate_fraction},
+    {"_candidate_weighting", _candidate_weighting},
+    {"_full_sweep_every",    _full_sweep_every},
+    {"_candidate_seed",      _candidate_seed},
+    {"_candidate_counts",    _candidate_counts},
+    {"_safe_screening",      _sh_ptr_screening != nullptr}
   };
   return j;
 }
@@ -149,6 +358,8 @@ OptimizerCoordinateDescent::OptimizerCoordinateDescent (const json& j)
 std::shared_ptr<blearner::Baselearner> OptimizerCoordinateDescent::findBestBaselearner (std::string iteration_id,
   const std::shared_ptr<response::Response>& sh_ptr_response, const blearner_factory_map& factory_map) const
 {
+  if (_sh_ptr_screening != nullptr) return findBestBaselearnerScreened(iteration_id, sh_ptr_response, factory_map);
+
   std::map<double, std::shared_ptr<blearner::Baselearner>> best_blearner_map;
 
   /* ****************************************************************************************
@@ -171,9 +382,11 @@ std::shared_ptr<blearner::Baselearner> OptimizerCoordinateDescent::findBestBasel
 
       // Create new base-learner out of the actual factory (just the
       // pointer is overwritten):
+      auto t_start  = profiler::pclock::now();
       blearner_temp = it.second->createBaselearner();
       blearner_temp->train(sh_ptr_response->getPseudoResiduals());
       ssq_temp = helper::calculateSumOfSquaredError(sh_ptr_response->getPseudoResiduals(), blearner_temp->predict());
+      profileCandidate(_sh_ptr_profiler, it.first, it.second, sh_ptr_response->getPseudoResiduals(), t_start);
 
 
       // Check if SSE of new temporary base-learner is smaller then SSE of the best
@@ -193,7 +406,9 @@ std::shared_ptr<blearner::Baselearner> OptimizerCoordinateDescent::findBestBasel
   }
   /* **************************************************************************************** */
 
-  #pragma omp parallel num_threads(_num_threads) default(none) shared(iteration_id, sh_ptr_response, factory_map, best_blearner_map)
+  std::shared_ptr<profiler::Profiler> sh_ptr_profiler = _sh_ptr_profiler;
+
+  #pragma omp parallel num_threads(_num_threads) default(none) shared(iteration_id, sh_ptr_response, factory_map, best_blearner_map, sh_ptr_profiler)
   {
     // private per core:
     double ssq_temp;
@@ -214,9 +429,11 @@ std::shared_ptr<blearner::Baselearner> OptimizerCoordinateDescent::findBestBasel
 
       // Create new base-learner out of the actual factory (just the
       // pointer is overwritten):
+      auto t_start  = profiler::pclock::now();
       blearner_temp = it_factory_pair->second->createBaselearner();
       blearner_temp->train(sh_ptr_response->getPseudoResiduals());
       ssq_temp = helper::calculateSumOfSquaredError(sh_ptr_response->getPseudoResiduals(), blearner_temp->predict());
+      profileCandidate(sh_ptr_profiler, it_factory_pair->first, it_factory_pair->second, sh_ptr_response->getPseudoResiduals(), t_start);
 
       // Check if SSE of new temporary base-learner is smaller then SSE of the best
       // base-learner. If so, assign the temporary base-learner with the best
@@ -247,6 +464,81 @@ std::shared_ptr<blearner::Baselearner> OptimizerCoordinateDescent::findBestBasel
   }
 }
 
+/**
+ * \brief Find the best base learner with safe screening
+ *
+ * The candidates are evaluated in decreasing order of the upper bound of their SSE
+ * reduction (unknown bounds first). The search stops as soon as no remaining bound
+ * can beat the best SSE. With more than one thread, the candidates are evaluated
+ * in batches of `_num_threads`. Ties are broken by the position in the factory map,
+ * hence the result is the same as for the sequential full sweep.
+ */
+std::shared_ptr<blearner::Baselearner> OptimizerCoordinateDescent::findBestBaselearnerScreened (const std::string iteration_id,
+  const std::shared_ptr<response::Response>& sh_ptr_response, const blearner_factory_map& factory_map) const
+{
+  arma::mat pr = sh_ptr_response->getPseudoResiduals();
+  const double pr_ssq = arma::accu(arma::square(pr));
+  const double tol    = 1e-10 * pr_ssq;
+
+  _sh_ptr_screening->updateResiduals(pr);
+
+  std::vector<blearner_factory_map::const_iterator> it_factories;
+  std::vector<double> bounds;
+  for (auto it = factory_map.begin(); it != factory_map.end(); ++it) {
+    it_factories.push_back(it);
+    bounds.push_back(_sh_ptr_screening->upperBound(it->first));
+  }
+  const unsigned int nfactories = it_factories.size();
+
+  std::vector<unsigned int> order(nfactories);
+  for (unsigned int i = 0; i < nfactories; i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&bounds](const unsigned int l, const unsigned int r) { return bounds[l] > bounds[r]; });
+
+  const unsigned int batch_size = std::max(1u, _num_threads);
+  std::vector<double> ssq(batch_size);
+  std::vector<std::shared_ptr<blearner::Baselearner>> blearners(batch_size);
+
+  double       ssq_best = std::numeric_limits<double>::infinity();
+  unsigned int i_best   = nfactories;
+  std::shared_ptr<blearner::Baselearner> blearner_best;
+
+  std::shared_ptr<profiler::Profiler> sh_ptr_profiler = _sh_ptr_profiler;
+
+  unsigned int n_evaluated = 0;
+  for (unsigned int start = 0; start < nfactories; start += batch_size) {
+
+    // The bounds are sorted, no remaining candidate can beat the best one:
+    if (pr_ssq - bounds[order[start]] > ssq_best + tol) break;
+
+    unsigned int end = std::min(start + batch_size, nfactories);
+
+    #pragma omp parallel for num_threads(_num_threads) schedule(static) if (_num_threads > 1)
+    for (unsigned int k = start; k < end; k++) {
+      auto it_factory = it_factories[order[k]];
+      auto t_start    = profiler::pclock::now();
+
+      blearners[k - start] = it_factory->second->createBaselearner();
+      blearners[k - start]->train(pr);
+      ssq[k - start] = helper::calculateSumOfSquaredError(pr, blearners[k - start]->predict());
+      profileCandidate(sh_ptr_profiler, it_factory->first, it_factory->second, pr, t_start);
+    }
+    for (unsigned int k = start; k < end; k++) {
+      unsigned int i = order[k];
+      _sh_ptr_screening->tighten(it_factories[i]->first, blearners[k - start], it_factories[i]->second);
+
+      if ((ssq[k - start] < ssq_best) || ((ssq[k - start] == ssq_best) && (i < i_best))) {
+        ssq_best      = ssq[k - start];
+        i_best        = i;
+        blearner_best = blearners[k - start];
+      }
+    }
+    n_evaluated += end - start;
+  }
+  _sh_ptr_screening->recordSearch(nfactories, n_evaluated);
+
+  return blearner_best;
+}
+
 arma::mat OptimizerCoordinateDescent::calculateUpdate (const double learning_rate, const double step_size,
   const arma::mat& blearner_pred, const std::map<std::string, std::shared_ptr<data::Data>>& oob_data, const std::shared_ptr<response::Response>& sh_ptr_oob_response) const
 {
@@ -257,21 +549,31 @@ void OptimizerCoordinateDescent::optimize (const unsigned int actual_iteration,
   blearnertrack::BaselearnerTrack& blearner_track, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
   std::string temp_string = std::to_string(actual_iteration);
-  auto sh_ptr_blearner_selected = findBestBaselearner(temp_string, sh_ptr_response, sh_ptr_factory_list->getFactoryMap());
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner_selected;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner", "optimizer");
+    sh_ptr_blearner_selected = findBestBaselearner(temp_string, sh_ptr_response, sampleCandidates(actual_iteration, sh_ptr_factory_list->getFactoryMap()));
+    registerSelection(sh_ptr_blearner_selected);
+  }
 
   // Prediction is needed more often, use a temp vector to avoid multiple computations:
-  arma::mat blearner_pred_temp = sh_ptr_blearner_selected->predict();
-  calculateStepSize(sh_ptr_loss, sh_ptr_response, blearner_pred_temp);
+  arma::mat blearner_pred_temp;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "step_size", "optimizer");
+    blearner_pred_temp = sh_ptr_blearner_selected->predict();
+    calculateStepSize(sh_ptr_loss, sh_ptr_response, blearner_pred_temp);
+  }
 
   // Insert new base-learner to vector of selected base-learner. The parameter are estimated here, hence
   // the contribution to the old parameter is the estimated parameter times the learning rate times
   // the step size. Therefore we have to pass the step size which changes in each iteration:
+  profiler::ScopedTimer timer(_sh_ptr_profiler, "update_model", "optimizer");
   blearner_track.insertBaselearner(sh_ptr_blearner_selected, getStepSize(actual_iteration));
   sh_ptr_response->updatePrediction(learning_rate * getStepSize(actual_iteration) * blearner_pred_temp);
 }
 
 void OptimizerCoordinateDescent::calculateStepSize (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const arma::vec& baselearner_prediction)
+  const arma::mat& baselearner_prediction)
 {
   // This function does literally nothing!
 }
@@ -314,7 +616,7 @@ OptimizerCoordinateDescentLineSearch::OptimizerCoordinateDescentLineSearch (cons
 
 
 void OptimizerCoordinateDescentLineSearch::calculateStepSize (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const arma::vec& baselearner_prediction)
+  const arma::mat& baselearner_prediction)
 {
   _step_sizes.push_back(linesearch::findOptimalStepSize(sh_ptr_loss, sh_ptr_response->getResponse(), sh_ptr_response->getPredictionScores(), baselearner_prediction));
 }
@@ -341,6 +643,122 @@ json OptimizerCoordinateDescentLineSearch::toJson () const
 }
 
 
+// OptimizerFeatureParallel:
+// ---------------------------------------------------
+
+OptimizerFeatureParallel::OptimizerFeatureParallel (const std::shared_ptr<distributed::Transport>& sh_ptr_transport)
+  : _sh_ptr_transport ( sh_ptr_transport )
+{
+  if (_sh_ptr_transport->getRank() != 0) {
+    Rcpp::stop("The feature parallel optimizer requires rank 0.");
+  }
+  _type = "feature_parallel";
+}
+
+void OptimizerFeatureParallel::optimize (const unsigned int actual_iteration, const double learning_rate, const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  blearnertrack::BaselearnerTrack& blearner_track, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
+{
+  if (_is_stopped) {
+    OptimizerCoordinateDescent::optimize(actual_iteration, learning_rate, sh_ptr_loss, sh_ptr_response, blearner_track, sh_ptr_factory_list);
+    return;
+  }
+  const unsigned int size = _sh_ptr_transport->getSize();
+  blearner_factory_map factory_map = sh_ptr_factory_list->getFactoryMap();
+
+  if (! _is_connected) {
+    arma::mat num_factories(1, 1, arma::fill::value(factory_map.size()));
+    _sh_ptr_transport->broadcast(num_factories);
+    _is_connected = true;
+  }
+
+  distributed::Candidate best;
+  std::vector<arma::mat> candidates;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner", "optimizer");
+    arma::mat pr = sh_ptr_response->getPseudoResiduals();
+    _sh_ptr_transport->broadcast(pr);
+
+    best = distributed::bestCandidate(factory_map, sh_ptr_factory_list->getRegisteredFactoryNames(), pr, 0, size);
+    candidates = _sh_ptr_transport->gather(distributed::packCandidate(best));
+  }
+
+  // Smallest SSE, ties are broken by the position in the factory map:
+  bool         has_best  = best.blearner != nullptr;
+  unsigned int rank_best = 0;
+  double       sse_best  = best.sse;
+  unsigned int idx_best  = best.index;
+  for (unsigned int k = 1; k < candidates.size(); k++) {
+    if (candidates[k].is_empty()) continue;
+    const double       sse = candidates[k](0);
+    const unsigned int idx = candidates[k](1);
+    if ((! has_best) || (sse < sse_best) || ((sse == sse_best) && (idx < idx_best))) {
+      has_best  = true;
+      rank_best = k;
+      sse_best  = sse;
+      idx_best  = idx;
+    }
+  }
+  if (! has_best) Rcpp::stop("No process evaluated a base learner.");
+
+  arma::mat winner(1, 1, arma::fill::value(idx_best));
+  _sh_ptr_transport->broadcast(winner);
+  std::vector<arma::mat> preds = _sh_ptr_transport->gather(arma::mat());
+
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner_selected;
+  arma::mat blearner_pred_temp;
+  if (rank_best == 0) {
+    sh_ptr_blearner_selected = best.blearner;
+    blearner_pred_temp       = sh_ptr_blearner_selected->predict();
+  } else {
+    auto it_factory = factory_map.begin();
+    std::advance(it_factory, idx_best);
+
+    const arma::mat& msg = candidates[rank_best];
+    const unsigned int nrows = msg(2);
+    arma::mat param = arma::reshape(msg.rows(3, msg.n_rows - 1), nrows, (msg.n_rows - 3) / nrows);
+
+    sh_ptr_blearner_selected = it_factory->second->createBaselearner();
+    sh_ptr_blearner_selected->setParameter(param);
+    blearner_pred_temp = preds[rank_best];
+  }
+  registerSelection(sh_ptr_blearner_selected);
+
+  profiler::ScopedTimer timer(_sh_ptr_profiler, "update_model", "optimizer");
+  blearner_track.insertBaselearner(sh_ptr_blearner_selected, getStepSize(actual_iteration));
+  sh_ptr_response->updatePrediction(learning_rate * getStepSize(actual_iteration) * blearner_pred_temp);
+}
+
+/**
+ * \brief Send the stop message to the workers
+ *
+ * Further iterations evaluate all factories in the coordinator.
+ */
+void OptimizerFeatureParallel::stopWorkers ()
+{
+  if (_is_stopped) return;
+  arma::mat stop;
+  _sh_ptr_transport->broadcast(stop);
+  _is_stopped = true;
+}
+
+bool OptimizerFeatureParallel::isStopped () const { return _is_stopped; }
+
+json OptimizerFeatureParallel::toJson () const
+{
+  // The transport can not be restored, a loaded model continues with the
+  // coordinate descent on all factories:
+  json j = Optimizer::baseToJson("OptimizerCoordinateDescent");
+  j["_type"] = "coo_descent";
+  return j;
+}
+
+OptimizerFeatureParallel::~OptimizerFeatureParallel ()
+{
+  try {
+    stopWorkers();
+  } catch (...) { }
+}
+
 // OptimizerCosineAnnealing:
 // ---------------------------------------------------
 
@@ -398,7 +816,7 @@ OptimizerCosineAnnealing::OptimizerCosineAnnealing (const json& j)
 { }
 
 void OptimizerCosineAnnealing::calculateStepSize (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const arma::vec& baselearner_prediction)
+  const arma::mat& baselearner_prediction)
 {
   if (_current_iter > _anneal_iter_max) {
     _step_sizes.push_back(_nu_min);
@@ -442,6 +860,618 @@ json OptimizerCosineAnnealing::toJson () const
   return j;
 }
 
+// OptimizerStochasticCoordinateDescent:
+// ---------------------------------------------------
+
+OptimizerStochasticCoordinateDescent::OptimizerStochasticCoordinateDescent ()
+  : _sample_fraction ( 0.2 ),
+    _seed            ( 0 ),
+    _sampling        ( "random" )
+{
+  _step_sizes.assign(1, 1.0);
+  _type = "stoch_coo_descent";
+}
+
+OptimizerStochasticCoordinateDescent::OptimizerStochasticCoordinateDescent (const double sample_fraction,
+  const unsigned int seed, const std::string sampling, const unsigned int num_threads)
+  : OptimizerCoordinateDescent::OptimizerCoordinateDescent ( num_threads ),
+    _sample_fraction ( sample_fraction ),
+    _seed            ( seed ),
+    _sampling        ( sampling )
+{
+  if ((sample_fraction <= 0) || (sample_fraction > 1)) {
+    Rcpp::stop("The sample fraction must be in (0, 1].");
+  }
+  helper::assertChoice(sampling, {"random", "cycle"});
+  _type = "stoch_coo_descent";
+}
+
+OptimizerStochasticCoordinateDescent::OptimizerStochasticCoordinateDescent (const json& j)
+  : OptimizerCoordinateDescent::OptimizerCoordinateDescent ( j ),
+    _sample_fraction ( j["_sample_fraction"].get<double>() ),
+    _seed            ( j["_seed"].get<unsigned int>() ),
+    _sampling        ( j["_sampling"].get<std::string>() )
+{ }
+
+/**
+ * \brief Rows used to fit the candidates in one iteration
+ *
+ * Both strategies use \f$\lceil \mathrm{fraction} \cdot n \rceil\f$ rows. With
+ * `"random"` the rows are drawn without replacement (Floyd's algorithm) from a
+ * generator seeded by the seed and the iteration. With `"cycle"` the rows are
+ * permuted once per epoch and the iterations of the epoch visit the blocks of the
+ * permutation, hence each observation is used once per epoch. The returned
+ * indices are sorted to keep the memory access of the kernels sequential.
+ *
+ * \param actual_iteration `unsigned int` Iteration (starting at 1).
+ * \param nobs `unsigned int` Number of observations.
+ *
+ * \returns `arma::uvec` Sorted row indices.
+ */
+arma::uvec OptimizerStochasticCoordinateDescent::drawSubset (const unsigned int actual_iteration, const unsigned int nobs)
+{
+  unsigned int nsub = std::ceil(_sample_fraction * nobs);
+  if (nsub < 1)    nsub = 1;
+  if (nsub > nobs) nsub = nobs;
+
+  if (_sampling == "cycle") {
+    const unsigned int nblocks = std::ceil(nobs / static_cast<double>(nsub));
+    const unsigned int epoch   = (actual_iteration - 1) / nblocks + 1;
+    const unsigned int block   = (actual_iteration - 1) % nblocks;
+
+    if ((_permutation_epoch != epoch) || (_permutation.size() != nobs)) {
+      std::seed_seq seq{_seed, epoch, 1u};
+      std::mt19937_64 rng(seq);
+
+      _permutation = arma::regspace<arma::uvec>(0, nobs - 1);
+      for (unsigned int i = nobs - 1; i > 0; i--) {
+        std::swap(_permutation(i), _permutation(helper::drawIndex(rng, i + 1)));
+      }
+      _permutation_epoch = epoch;
+    }
+    const unsigned int first = block * nsub;
+    const unsigned int last  = std::min(first + nsub, nobs) - 1;
+
+    return arma::sort(_permutation.subvec(first, last));
+  }
+
+  std::seed_seq seq{_seed, actual_iteration, 0u};
+  std::mt19937_64 rng(seq);
+
+  std::vector<bool> selected(nobs, false);
+  for (unsigned int j = nobs - nsub; j < nobs; j++) {
+    unsigned int t = helper::drawIndex(rng, j + 1);
+    if (selected[t]) t = j;
+    selected[t] = true;
+  }
+  arma::uvec idx(nsub);
+  unsigned int k = 0;
+  for (unsigned int i = 0; i < nobs; i++) {
+    if (selected[i]) idx(k++) = i;
+  }
+  return idx;
+}
+
+/**
+ * \brief Fit and compare all candidates on a row subset
+ *
+ * The SSE of each candidate is stored by the position of its factory and the
+ * first minimum is selected. Therefore, the selected base learner does not depend
+ * on the number of threads.
+ */
+std::shared_ptr<blearner::Baselearner> OptimizerStochasticCoordinateDescent::findBestBaselearnerSubset (const arma::mat& pr,
+  const arma::uvec& idx, const blearner_factory_map& factory_map) const
+{
+  std::vector<blearner_factory_map::const_iterator> it_factories;
+  for (auto it = factory_map.begin(); it != factory_map.end(); ++it) {
+    it_factories.push_back(it);
+  }
+  const unsigned int nfactories = it_factories.size();
+
+  arma::mat pr_sub = pr.rows(idx);
+  std::vector<double> ssq(nfactories, std::numeric_limits<double>::infinity());
+  std::vector<std::shared_ptr<blearner::Baselearner>> blearners(nfactories);
+
+  std::shared_ptr<profiler::Profiler> sh_ptr_profiler = _sh_ptr_profiler;
+
+  #pragma omp parallel for num_threads(_num_threads) schedule(static) if (_num_threads > 1)
+  for (unsigned int i = 0; i < nfactories; i++) {
+    auto t_start = profiler::pclock::now();
+    blearners[i] = it_factories[i]->second->createBaselearner();
+    blearners[i]->trainSubset(pr, idx);
+    ssq[i] = helper::calculateSumOfSquaredError(pr_sub, blearners[i]->predictSubset(idx));
+    profileCandidate(sh_ptr_profiler, it_factories[i]->first, it_factories[i]->second, pr_sub, t_start);
+  }
+
+  unsigned int i_best = 0;
+  for (unsigned int i = 1; i < nfactories; i++) {
+    if (ssq[i] < ssq[i_best]) i_best = i;
+  }
+  return blearners[i_best];
+}
+
+void OptimizerStochasticCoordinateDescent::optimize (const unsigned int actual_iteration, const double learning_rate, const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  blearnertrack::BaselearnerTrack& blearner_track, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
+{
+  arma::mat  pr = sh_ptr_response->getPseudoResiduals();
+  if (pr.n_cols > 1) {
+    Rcpp::stop("The stochastic coordinate descent requires pseudo residuals with one column.");
+  }
+  arma::uvec idx;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "sample_rows", "optimizer");
+    idx = drawSubset(actual_iteration, pr.n_rows);
+  }
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner_selected;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner", "optimizer");
+    sh_ptr_blearner_selected = findBestBaselearnerSubset(pr, idx, sampleCandidates(actual_iteration, sh_ptr_factory_list->getFactoryMap()));
+    registerSelection(sh_ptr_blearner_selected);
+  }
+
+  // The selected base learner was fitted on the subset but is applied to all observations:
+  profiler::ScopedTimer timer(_sh_ptr_profiler, "update_model", "optimizer");
+  blearner_track.insertBaselearner(sh_ptr_blearner_selected, getStepSize(actual_iteration));
+  sh_ptr_response->updatePrediction(learning_rate * getStepSize(actual_iteration) * sh_ptr_blearner_selected->predict());
+}
+
+double OptimizerStochasticCoordinateDescent::getSampleFraction () const
+{
+  return _sample_fraction;
+}
+
+unsigned int OptimizerStochasticCoordinateDescent::getSeed () const
+{
+  return _seed;
+}
+
+std::string OptimizerStochasticCoordinateDescent::getSampling () const
+{
+  return _sampling;
+}
+
+void OptimizerStochasticCoordinateDescent::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  report.add("optimizer", _type, "step_sizes", memreport::stdVecBytes(_step_sizes));
+  report.add("optimizer", _type, "permutation", memreport::uvecBytes(_permutation));
+}
+
+json OptimizerStochasticCoordinateDescent::toJson () const
+{
+  json j = Optimizer::baseToJson("OptimizerStochasticCoordinateDescent");
+  j["_sample_fraction"] = _sample_fraction;
+  j["_seed"]            = _seed;
+  j["_sampling"]        = _sampling;
+
+  return j;
+}
+
+
+// OptimizerBlockCoordinateDescent:
+// ---------------------------------------------------
+
+OptimizerBlockCoordinateDescent::OptimizerBlockCoordinateDescent ()
+  : _block_size      ( 2 ),
+    _max_correlation ( 0.5 ),
+    _backtracking    ( true )
+{
+  _step_sizes.assign(1, 1.0);
+  _type = "block_coo_descent";
+}
+
+OptimizerBlockCoordinateDescent::OptimizerBlockCoordinateDescent (const unsigned int block_size,
+  const double max_correlation, const bool backtracking, const unsigned int num_threads)
+  : Optimizer::Optimizer ( num_threads ),
+    _block_size      ( block_size ),
+    _max_correlation ( max_correlation ),
+    _backtracking    ( backtracking )
+{
+  if (block_size == 0) {
+    Rcpp::stop("The block size must be greater than zero.");
+  }
+  if ((max_correlation < 0) || (max_correlation > 1)) {
+    Rcpp::stop("The maximal correlation must be in [0, 1].");
+  }
+  _step_sizes.assign(1, 1.0);
+  _type = "block_coo_descent";
+}
+
+OptimizerBlockCoordinateDescent::OptimizerBlockCoordinateDescent (const json& j)
+  : Optimizer::Optimizer ( j ),
+    _block_size      ( j["_block_size"].get<unsigned int>() ),
+    _max_correlation ( j["_max_correlation"].get<double>() ),
+    _backtracking    ( j["_backtracking"].get<bool>() )
+{ }
+
+double OptimizerBlockCoordinateDescent::getStepSize (const unsigned int actual_iteration) const
+{
+  return 1;
+}
+
+std::vector<double> OptimizerBlockCoordinateDescent::getStepSize () const
+{
+  return _step_sizes;
+}
+
+/**
+ * \brief Fit all candidates and sort them by their SSE
+ *
+ * Ties are kept in the order of the factory map, hence the first entry is the
+ * base learner the coordinate descent would select.
+ */
+std::vector<std::pair<double, std::shared_ptr<blearner::Baselearner>>> OptimizerBlockCoordinateDescent::rankBaselearner (const arma::mat& pr,
+  const blearner_factory_map& factory_map) const
+{
+  std::vector<blearner_factory_map::const_iterator> it_factories;
+  for (auto it = factory_map.begin(); it != factory_map.end(); ++it) {
+    it_factories.push_back(it);
+  }
+  const unsigned int nfactories = it_factories.size();
+
+  std::vector<std::pair<double, std::shared_ptr<blearner::Baselearner>>> ranked(nfactories);
+  std::shared_ptr<profiler::Profiler> sh_ptr_profiler = _sh_ptr_profiler;
+
+  #pragma omp parallel for num_threads(_num_threads) schedule(static) if (_num_threads > 1)
+  for (unsigned int i = 0; i < nfactories; i++) {
+    auto t_start = profiler::pclock::now();
+    ranked[i].second = it_factories[i]->second->createBaselearner();
+    ranked[i].second->train(pr);
+    ranked[i].first = helper::calculateSumOfSquaredError(pr, ranked[i].second->predict());
+    profileCandidate(sh_ptr_profiler, it_factories[i]->first, it_factories[i]->second, pr, t_start);
+  }
+  std::stable_sort(ranked.begin(), ranked.end(), [] (const std::pair<double, std::shared_ptr<blearner::Baselearner>>& l,
+    const std::pair<double, std::shared_ptr<blearner::Baselearner>>& r) { return l.first < r.first; });
+
+  return ranked;
+}
+
+std::shared_ptr<blearner::Baselearner> OptimizerBlockCoordinateDescent::findBestBaselearner (const std::string iteration_id,
+  const std::shared_ptr<response::Response>& sh_ptr_response, const blearner_factory_map& factory_map) const
+{
+  return rankBaselearner(sh_ptr_response->getPseudoResiduals(), factory_map).front().second;
+}
+
+/**
+ * \brief Select the base learners that are updated in this iteration
+ *
+ * The correlation of two candidates is measured by the cosine similarity of
+ * their predictions. This is the cross Gram entry
+ * \f$\hat{\beta}_j^T X_j^T X_l \hat{\beta}_l\f$ normalized by the norm of both
+ * predictions and costs one pass over the observations. Candidates with a zero
+ * prediction would not change the model and are skipped. The sum of the
+ * predictions of the block is returned in `update`.
+ */
+std::vector<std::shared_ptr<blearner::Baselearner>> OptimizerBlockCoordinateDescent::selectBlock (const double learning_rate,
+  const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  const blearner_factory_map& factory_map, arma::mat& update) const
+{
+  auto ranked = rankBaselearner(sh_ptr_response->getPseudoResiduals(), factory_map);
+
+  std::vector<std::shared_ptr<blearner::Baselearner>> block;
+  std::vector<arma::mat> preds;
+  std::vector<double>    norms;
+  for (auto& it : ranked) {
+    if (block.size() == _block_size) break;
+
+    arma::mat pred = it.second->predict();
+    double    norm = arma::norm(arma::vectorise(pred), 2);
+    bool      weak = (norm > 0) || block.empty();
+    for (unsigned int s = 0; weak && (s < preds.size()); s++) {
+      weak = std::abs(arma::accu(pred % preds[s])) <= _max_correlation * norm * norms[s];
+    }
+    if (weak) {
+      block.push_back(it.second);
+      preds.push_back(pred);
+      norms.push_back(norm);
+    }
+  }
+
+  update = preds[0];
+  for (unsigned int s = 1; s < preds.size(); s++) update += preds[s];
+
+  // Remove base learners from the end while the block is worse than the best
+  // base learner on its own:
+  if (_backtracking && (block.size() > 1)) {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "backtracking", "optimizer");
+
+    const arma::mat scores = sh_ptr_response->getPredictionScores();
+    const double    risk_single = sh_ptr_response->calculateEmpiricalRisk(sh_ptr_loss, scores + learning_rate * preds[0]);
+
+    while ((block.size() > 1) && (sh_ptr_response->calculateEmpiricalRisk(sh_ptr_loss, scores + learning_rate * update) > risk_single)) {
+      update -= preds.back();
+      preds.pop_back();
+      block.pop_back();
+    }
+  }
+  return block;
+}
+
+arma::mat OptimizerBlockCoordinateDescent::calculateUpdate (const double learning_rate, const double step_size,
+  const arma::mat& blearner_pred, const std::map<std::string, std::shared_ptr<data::Data>>& oob_data, const std::shared_ptr<response::Response>& sh_ptr_oob_response) const
+{
+  return learning_rate * step_size * blearner_pred;
+}
+
+void OptimizerBlockCoordinateDescent::calculateStepSize (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  const arma::mat& baselearner_prediction)
+{ }
+
+void OptimizerBlockCoordinateDescent::optimize (const unsigned int actual_iteration, const double learning_rate, const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  blearnertrack::BaselearnerTrack& blearner_track, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
+{
+  std::vector<std::shared_ptr<blearner::Baselearner>> block;
+  arma::mat update;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner", "optimizer");
+    block = selectBlock(learning_rate, sh_ptr_loss, sh_ptr_response, sampleCandidates(actual_iteration, sh_ptr_factory_list->getFactoryMap()), update);
+    for (auto& it : block) registerSelection(it);
+  }
+
+  profiler::ScopedTimer timer(_sh_ptr_profiler, "update_model", "optimizer");
+  blearner_track.insertBaselearnerBlock(block, getStepSize(actual_iteration));
+  sh_ptr_response->updatePrediction(learning_rate * getStepSize(actual_iteration) * update);
+}
+
+unsigned int OptimizerBlockCoordinateDescent::getBlockSize      () const { return _block_size; }
+double       OptimizerBlockCoordinateDescent::getMaxCorrelation () const { return _max_correlation; }
+bool         OptimizerBlockCoordinateDescent::getBacktracking   () const { return _backtracking; }
+
+json OptimizerBlockCoordinateDescent::toJson () const
+{
+  json j = Optimizer::baseToJson("OptimizerBlockCoordinateDescent");
+  j["_block_size"]      = _block_size;
+  j["_max_correlation"] = _max_correlation;
+  j["_backtracking"]    = _backtracking;
+
+  return j;
+}
+
+
+// OptimizerNewton:
+// ---------------------------------------------------
+
+OptimizerNewton::OptimizerNewton ()
+  : _min_hessian ( 1e-4 )
+{
+  _step_sizes.assign(1, 1.0);
+  _type = "newton";
+}
+
+OptimizerNewton::OptimizerNewton (const double min_hessian, const unsigned int num_threads)
+  : Optimizer::Optimizer ( num_threads ),
+    _min_hessian ( min_hessian )
+{
+  if (min_hessian <= 0) {
+    Rcpp::stop("The minimal Hessian must be greater than zero.");
+  }
+  _step_sizes.assign(1, 1.0);
+  _type = "newton";
+}
+
+OptimizerNewton::OptimizerNewton (const json& j)
+  : Optimizer::Optimizer ( j ),
+    _min_hessian ( j["_min_hessian"].get<double>() )
+{ }
+
+double OptimizerNewton::getStepSize (const unsigned int actual_iteration) const
+{
+  return 1;
+}
+
+std::vector<double> OptimizerNewton::getStepSize () const
+{
+  return _step_sizes;
+}
+
+/**
+ * \brief Penalty of the factory, empty if the system of the base learner is unknown
+ */
+arma::mat OptimizerNewton::impliedPenalty (const std::shared_ptr<blearnerfactory::BaselearnerFactory>& sh_ptr_factory) const
+{
+  const std::string model = sh_ptr_factory->getBaseModelName();
+  sdata sh_ptr_data = sh_ptr_factory->getInstantiatedData();
+  if ((model == "custom") || (model == "customcpp") || (sh_ptr_data == nullptr)) return arma::mat();
+
+  return sh_ptr_data->impliedPenalty();
+}
+
+/**
+ * \brief Compute the penalties of new factories and the bin weights of this iteration
+ *
+ * Runs sequentially before the candidates are fitted in parallel. The bin weights
+ * are keyed by the data identifier and the number of bins and therefore computed
+ * only once for all factories of the same binned feature.
+ */
+void OptimizerNewton::prepareCandidates (const arma::vec& h, const blearner_factory_map& factory_map) const
+{
+  for (auto& it : factory_map) {
+    if (_penalty_cache.find(it.first) == _penalty_cache.end()) {
+      _penalty_cache[it.first] = impliedPenalty(it.second);
+    }
+    sdata sh_ptr_data = it.second->getInstantiatedData();
+    if ((sh_ptr_data == nullptr) || (! sh_ptr_data->usesBinning())) continue;
+
+    std::string key = sh_ptr_data->getDataIdentifier() + "_" + std::to_string(sh_ptr_data->getNDesignRows());
+    if (_bin_weights.find(key) == _bin_weights.end()) {
+      _bin_weights[key] = sh_ptr_data->accumulateWeights(h);
+    }
+  }
+}
+
+/**
+ * \brief Fit one candidate to the Newton step
+ *
+ * Requires that `prepareCandidates` was called for the factory in this iteration.
+ * Base learners without a known system (e.g. custom ones) cannot be weighted
+ * and are fitted to the unweighted Newton step `pr / h` they are ranked on.
+ */
+std::shared_ptr<blearner::Baselearner> OptimizerNewton::fitCandidate (const std::string& factory_id,
+  const std::shared_ptr<blearnerfactory::BaselearnerFactory>& sh_ptr_factory, const arma::mat& pr, const arma::vec& h) const
+{
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner = sh_ptr_factory->createBaselearner();
+
+  const arma::mat& P = _penalty_cache.at(factory_id);
+  if (P.is_empty()) {
+    sh_ptr_blearner->train(pr.each_col() / h);
+    return sh_ptr_blearner;
+  }
+
+  sdata sh_ptr_data = sh_ptr_factory->getInstantiatedData();
+  arma::mat xtwx;
+  if (sh_ptr_data->usesBinning()) {
+    xtwx = sh_ptr_data->weightedGram(_bin_weights.at(sh_ptr_data->getDataIdentifier() + "_" + std::to_string(sh_ptr_data->getNDesignRows())));
+  } else {
+    xtwx = sh_ptr_data->weightedGram(h);
+  }
+  arma::mat A = xtwx + P;
+  arma::mat U;
+  std::pair<std::string, arma::mat> system;
+  if (arma::chol(U, A)) {
+    system = std::make_pair("cholesky", U);
+  } else {
+    system = std::make_pair("inverse", arma::pinv(A));
+  }
+  sh_ptr_blearner->setParameter(helper::cboostSolver(system, sh_ptr_data->crossProduct(pr)));
+  return sh_ptr_blearner;
+}
+
+/**
+ * \brief Select the candidate with the smallest Hessian weighted error
+ *
+ * Without a Hessian of the current iteration (e.g. when called from outside of
+ * `optimize`) all weights are one.
+ */
+std::shared_ptr<blearner::Baselearner> OptimizerNewton::findBestBaselearner (const std::string iteration_id,
+  const std::shared_ptr<response::Response>& sh_ptr_response, const blearner_factory_map& factory_map) const
+{
+  const arma::mat pr = sh_ptr_response->getPseudoResiduals();
+
+  arma::vec h;
+  if (_hessian.n_rows == pr.n_rows) {
+    h = _hessian.col(0);
+  } else {
+    h = arma::vec(pr.n_rows, arma::fill::ones);
+    _bin_weights.clear();
+  }
+  prepareCandidates(h, factory_map);
+
+  return selectCandidate(pr, h, factory_map, _sh_ptr_profiler);
+}
+
+/**
+ * \brief Full sweep with the Hessian weighted error of the current iteration
+ *
+ * Just the per-iteration caches of the penalties and bin weights are filled.
+ * Without a Hessian, the Newton step equals the pseudo residuals and the sweep
+ * of the base class is used.
+ */
+std::shared_ptr<blearner::Baselearner> OptimizerNewton::findBestBaselearnerExhaustive (const arma::mat& pr,
+  const blearner_factory_map& factory_map) const
+{
+  if (_hessian.n_rows != pr.n_rows) return Optimizer::findBestBaselearnerExhaustive(pr, factory_map);
+
+  const arma::vec h = _hessian.col(0);
+  prepareCandidates(h, factory_map);
+
+  return selectCandidate(pr, h, factory_map, nullptr);
+}
+
+std::shared_ptr<blearner::Baselearner> OptimizerNewton::selectCandidate (const arma::mat& pr, const arma::vec& h,
+  const blearner_factory_map& factory_map, const std::shared_ptr<profiler::Profiler>& sh_ptr_profiler) const
+{
+  const arma::vec z = pr.col(0) / h;
+
+  std::vector<blearner_factory_map::const_iterator> it_factories;
+  for (auto it = factory_map.begin(); it != factory_map.end(); ++it) {
+    it_factories.push_back(it);
+  }
+  const unsigned int nfactories = it_factories.size();
+
+  std::vector<double> scores(nfactories);
+  std::vector<std::shared_ptr<blearner::Baselearner>> blearners(nfactories);
+
+  #pragma omp parallel for num_threads(_num_threads) schedule(static) if (_num_threads > 1)
+  for (unsigned int i = 0; i < nfactories; i++) {
+    auto t_start = profiler::pclock::now();
+    blearners[i] = fitCandidate(it_factories[i]->first, it_factories[i]->second, pr, h);
+    scores[i]    = arma::accu(h % arma::square(z - arma::vectorise(blearners[i]->predict())));
+    profileCandidate(sh_ptr_profiler, it_factories[i]->first, it_factories[i]->second, pr, t_start);
+  }
+  unsigned int best = 0;
+  for (unsigned int i = 1; i < nfactories; i++) {
+    if (scores[i] < scores[best]) best = i;
+  }
+  return blearners[best];
+}
+
+arma::mat OptimizerNewton::calculateUpdate (const double learning_rate, const double step_size,
+  const arma::mat& blearner_pred, const std::map<std::string, std::shared_ptr<data::Data>>& oob_data, const std::shared_ptr<response::Response>& sh_ptr_oob_response) const
+{
+  return learning_rate * step_size * blearner_pred;
+}
+
+void OptimizerNewton::calculateStepSize (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  const arma::mat& baselearner_prediction)
+{ }
+
+void OptimizerNewton::optimize (const unsigned int actual_iteration, const double learning_rate, const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
+  blearnertrack::BaselearnerTrack& blearner_track, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
+{
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "hessian", "optimizer");
+    arma::mat truth = sh_ptr_response->getResponse();
+    if (truth.n_cols > 1) {
+      Rcpp::stop("The Newton optimizer requires a response with one column.");
+    }
+    _hessian = sh_ptr_loss->hessian(truth, sh_ptr_response->getPredictionScores());
+
+    arma::mat weights = sh_ptr_response->getWeights();
+    if (weights.n_rows == _hessian.n_rows) _hessian %= weights;
+    _hessian.clamp(_min_hessian, arma::datum::inf);
+    _bin_weights.clear();
+  }
+
+  std::string temp_string = std::to_string(actual_iteration);
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner_selected;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner", "optimizer");
+    sh_ptr_blearner_selected = findBestBaselearner(temp_string, sh_ptr_response, sampleCandidates(actual_iteration, sh_ptr_factory_list->getFactoryMap()));
+    registerSelection(sh_ptr_blearner_selected);
+  }
+
+  profiler::ScopedTimer timer(_sh_ptr_profiler, "update_model", "optimizer");
+  blearner_track.insertBaselearner(sh_ptr_blearner_selected, getStepSize(actual_iteration));
+  sh_ptr_response->updatePrediction(learning_rate * getStepSize(actual_iteration) * sh_ptr_blearner_selected->predict());
+}
+
+double OptimizerNewton::getMinHessian () const
+{
+  return _min_hessian;
+}
+
+void OptimizerNewton::reportMemory (memreport::MemoryReport& report) const
+{
+  if (! report.visit(this)) return;
+  double penalty_bytes = 0;
+  for (auto& it : _penalty_cache) penalty_bytes += memreport::matBytes(it.second);
+  double weight_bytes = memreport::matBytes(_hessian);
+  for (auto& it : _bin_weights) weight_bytes += memreport::matBytes(it.second);
+
+  report.add("optimizer", _type, "step_sizes", memreport::stdVecBytes(_step_sizes));
+  report.add("optimizer", _type, "penalty", penalty_bytes);
+  report.add("optimizer", _type, "bin_weights", weight_bytes);
+}
+
+json OptimizerNewton::toJson () const
+{
+  json j = Optimizer::baseToJson("OptimizerNewton");
+  j["_min_hessian"] = _min_hessian;
+
+  return j;
+}
+
+
 // OptimizerAGBM:
 // ---------------------------------------------------
 
@@ -514,9 +1544,11 @@ std::shared_ptr<blearner::Baselearner> OptimizerAGBM::findBestBaselearner (std::
       std::string id = "(" + iteration_id + ") " + it.second->getBaselearnerType();
       // Create new base-learner out of the actual factory (just the
       // pointer is overwritten):
+      auto t_start  = profiler::pclock::now();
       blearner_temp = it.second->createBaselearner();
       blearner_temp->train(pr);
       ssq_temp = helper::calculateSumOfSquaredError(pr, blearner_temp->predict());
+      profileCandidate(_sh_ptr_profiler, it.first, it.second, pr, t_start);
 
       // Check if SSE of new temporary base-learner is smaller then SSE of the best
       // base-learner. If so, assign the temporary base-learner with the best
@@ -534,7 +1566,9 @@ std::shared_ptr<blearner::Baselearner> OptimizerAGBM::findBestBaselearner (std::
     return blearner_best;
   }
   /* **************************************************************************************** */
-  #pragma omp parallel num_threads(_num_threads) default(none) shared(iteration_id, pr, factory_map, best_blearner_map)
+  std::shared_ptr<profiler::Profiler> sh_ptr_profiler = _sh_ptr_profiler;
+
+  #pragma omp parallel num_threads(_num_threads) default(none) shared(iteration_id, pr, factory_map, best_blearner_map, sh_ptr_profiler)
   {
     // private per core:
     double ssq_temp;
@@ -555,9 +1589,11 @@ std::shared_ptr<blearner::Baselearner> OptimizerAGBM::findBestBaselearner (std::
 
       // Create new base-learner out of the actual factory (just the
       // pointer is overwritten):
+      auto t_start  = profiler::pclock::now();
       blearner_temp = it_factory_pair->second->createBaselearner();
       blearner_temp->train(pr);
       ssq_temp = helper::calculateSumOfSquaredError(pr, blearner_temp->predict());
+      profileCandidate(sh_ptr_profiler, it_factory_pair->first, it_factory_pair->second, pr, t_start);
 
       // Check if SSE of new temporary base-learner is smaller then SSE of the best
       // base-learner. If so, assign the temporary base-learner with the best
@@ -591,22 +1627,30 @@ std::shared_ptr<blearner::Baselearner> OptimizerAGBM::findBestBaselearner (std::
 void OptimizerAGBM::optimize (const unsigned int actual_iteration, const double learning_rate, const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
   blearnertrack::BaselearnerTrack& blearner_track, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list)
 {
-  arma::mat prediction_scores = sh_ptr_response->getPredictionScores();
+  arma::mat prediction_scores;
+  arma::mat pr_aggr;
   double weight_param = 2.0 / ((double)actual_iteration + 1.0);
-  if (actual_iteration == 1) {
-    _pred_momentum = prediction_scores;
-    _pred_aggr     = _pred_momentum;
-  } else {
-    _pred_aggr = (1 - weight_param) * prediction_scores + weight_param * _pred_momentum;
-    updateAggrParameter(weight_param, blearner_track);
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "aggregate_prediction", "optimizer");
+    prediction_scores = sh_ptr_response->getPredictionScores();
+    if (actual_iteration == 1) {
+      _pred_momentum = prediction_scores;
+      _pred_aggr     = _pred_momentum;
+    } else {
+      _pred_aggr = (1 - weight_param) * prediction_scores + weight_param * _pred_momentum;
+      updateAggrParameter(weight_param, blearner_track);
+    }
+    pr_aggr = sh_ptr_loss->calculatePseudoResiduals(sh_ptr_response->getResponse(), _pred_aggr);
   }
 
-  std::string temp_string;
-  arma::mat pr_aggr = sh_ptr_loss->calculatePseudoResiduals(sh_ptr_response->getResponse(), _pred_aggr);
-
   // Find best base-learner w.r.t. pr_aggr
-  temp_string = std::to_string(actual_iteration);
-  auto sh_ptr_blearner_selected = findBestBaselearner(temp_string, pr_aggr, sh_ptr_factory_list->getFactoryMap());
+  std::string temp_string = std::to_string(actual_iteration);
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner_selected;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner", "optimizer");
+    sh_ptr_blearner_selected = findBestBaselearner(temp_string, pr_aggr, sampleCandidates(actual_iteration, sh_ptr_factory_list->getFactoryMap()));
+    registerSelection(sh_ptr_blearner_selected);
+  }
 
   blearner_track.insertBaselearner(sh_ptr_blearner_selected, getStepSize(actual_iteration));
 
@@ -619,12 +1663,25 @@ void OptimizerAGBM::optimize (const unsigned int actual_iteration, const double
   if (actual_iteration == 1) {
     _pr_corr = pr_aggr;
   } else {
-    _pr_corr = pr_aggr + (double)actual_iteration / ((double)actual_iteration + 1) * (_pr_corr - _momentum_blearnertrack.getBaselearnerVector().at(actual_iteration - 2)->predict());
-;
+    // The momentum base learner of the previous iteration is the last one in the
+    // momentum track. Its prediction is recalculated by the factory from the
+    // stored parameter:
+    unsigned int m = _momentum_blearnertrack.getNumberOfIterations();
+    blearner_factory_map factory_map = sh_ptr_factory_list->getFactoryMap();
+    auto it_factory = factory_map.find(_momentum_blearnertrack.getFactoryIdOfIteration(m - 1));
+    if (it_factory == factory_map.end()) {
+      Rcpp::stop("Factory " + _momentum_blearnertrack.getFactoryIdOfIteration(m - 1) + " of the momentum track is not registered.");
+    }
+    arma::mat pred_mom = it_factory->second->calculateLinearPredictor(_momentum_blearnertrack.getParameterOfIteration(m - 1));
+    _pr_corr = pr_aggr + (double)actual_iteration / ((double)actual_iteration + 1) * (_pr_corr - pred_mom);
   }
 
   // Find best base-learner w.r.t. _pr_corr
-  auto sh_ptr_blearner_mom = findBestBaselearner(temp_string, _pr_corr, sh_ptr_factory_list->getFactoryMap());
+  std::shared_ptr<blearner::Baselearner> sh_ptr_blearner_mom;
+  {
+    profiler::ScopedTimer timer(_sh_ptr_profiler, "find_best_baselearner_momentum", "optimizer");
+    sh_ptr_blearner_mom = findBestBaselearner(temp_string, _pr_corr, sampleCandidates(actual_iteration, sh_ptr_factory_list->getFactoryMap()));
+  }
   //_momentum_blearner.push_back(sh_ptr_blearner_mom);
 
   // Update momentum model
@@ -648,8 +1705,8 @@ void OptimizerAGBM::optimize (const unsigned int actual_iteration, const double
 arma::mat OptimizerAGBM::calculateUpdate (const double learning_rate, const double step_size,
   const arma::mat& blearner_pred, const std::map<std::string, std::shared_ptr<data::Data>>& oob_data, const std::shared_ptr<response::Response>& sh_ptr_oob_response) const
 {
-  unsigned int m = _momentum_blearnertrack.getBaselearnerVector().size();
-  std::shared_ptr<blearner::Baselearner> momentum_blearner = _momentum_blearnertrack.getBaselearnerVector().at(m-1);
+  unsigned int m = _momentum_blearnertrack.getNumberOfIterations();
+  std::shared_ptr<blearner::Baselearner> momentum_blearner = _momentum_blearnertrack.getLastBaselearner();
 
   arma::mat pred_scores = sh_ptr_oob_response->getPredictionScores();
   if (m == 1) {
@@ -682,7 +1739,7 @@ arma::mat OptimizerAGBM::calculateUpdate (const double learning_rate, const doub
 }
 
 void OptimizerAGBM::calculateStepSize (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const std::shared_ptr<response::Response>& sh_ptr_response,
-  const arma::vec& baselearner_prediction)
+  const arma::mat& baselearner_prediction)
 {
   // This function does literally nothing!
 }
@@ -700,14 +1757,7 @@ std::map<std::string, arma::mat> OptimizerAGBM::getMomentumParameter () const
 
 std::vector<std::string> OptimizerAGBM::getSelectedMomentumBaselearner () const
 {
-  std::vector<std::string> out;
-  std::vector<std::shared_ptr<blearner::Baselearner>> mom_blearnertrack = _momentum_blearnertrack.getBaselearnerVector();
-  std::string id;
-  for (unsigned int i = 0; i < mom_blearnertrack.size(); i++) {
-    id = mom_blearnertrack.at(i)->getDataIdentifier() + "_" + mom_blearnertrack.at(i)->getBaselearnerType();
-    out.push_back(id);
-  }
-  return out;
+  return _momentum_blearnertrack.getSelectedFactoryIds();
 }
 
 
@@ -747,22 +1797,35 @@ std::map<std::string, arma::mat> OptimizerAGBM::addParamMaps (const std::map<std
 
 void OptimizerAGBM::updateAggrParameter (double weight_parameter, blearnertrack::BaselearnerTrack& blearner_track)
 {
-  if (blearner_track.getBaselearnerVector().size() > 0) {
+  if (blearner_track.getNumberOfIterations() > 0) {
     blearner_track.setParameterMap(addParamMaps(blearner_track.getParameterMap(),
       _momentum_blearnertrack.getParameterMap(), weight_parameter));
   }
 }
 
-std::map<std::string, arma::mat> OptimizerAGBM::getParameterAtIteration (const unsigned int k, const double lr, blearnertrack::BaselearnerTrack& bl_track) const
+std::map<std::string, arma::mat> OptimizerAGBM::getParameterAtIteration (const unsigned int k, const double lr, const blearnertrack::BaselearnerTrack& bl_track) const
 {
   std::map<std::string, arma::mat> mmod;
   std::map<std::string, arma::mat> mmom;
 
-  auto blvec     =                bl_track.getBaselearnerVector();
-  auto blvec_mom = _momentum_blearnertrack.getBaselearnerVector();
+  if (k <= bl_track.getNumberOfIterations()) {
 
-  if (k <= blvec.size()) {
-    for (unsigned int i = 0; i < k; i++) {
+    // The aggregation of model and momentum parameter is a recursion and cannot
+    // be split into deltas. Hence, the states are cached every `m` iterations
+    // while replaying and later requests start at the nearest cached state:
+    unsigned int m = _momentum_blearnertrack.getCheckpointInterval();
+    if ((lr != _replay_lr) || (_replay_checkpoints.size() * m > bl_track.getNumberOfIterations())) {
+      _replay_checkpoints.clear();
+      _replay_lr = lr;
+    }
+    unsigned int n_checkpoints = std::min<unsigned int>(k / m, _replay_checkpoints.size());
+    unsigned int start = 0;
+    if (n_checkpoints > 0) {
+      mmod  = _replay_checkpoints[n_checkpoints - 1].first;
+      mmom  = _replay_checkpoints[n_checkpoints - 1].second;
+      start = n_checkpoints * m;
+    }
+    for (unsigned int i = start; i < k; i++) {
 
       double weight_param = 2.0 / ((double)i + 2.0);
       double lr_mom;
@@ -773,15 +1836,15 @@ std::map<std::string, arma::mat> OptimizerAGBM::getParameterAtIteration (const u
         lr_mom = _momentum * lr / weight_param;
       }
 
-      std::string insert_id     =     blvec[i]->getDataIdentifier() + "_" +     blvec[i]->getBaselearnerType();
-      std::string insert_id_mom = blvec_mom[i]->getDataIdentifier() + "_" + blvec_mom[i]->getBaselearnerType();
+      std::string insert_id     =                bl_track.getFactoryIdOfIteration(i);
+      std::string insert_id_mom = _momentum_blearnertrack.getFactoryIdOfIteration(i);
 
       std::map<std::string, arma::mat>::iterator it     = mmod.find(insert_id);
       std::map<std::string, arma::mat>::iterator it_mom = mmom.find(insert_id_mom);
 
       // Prune parameter by multiplying it with the learning rate:
-      arma::mat param_temp     = lr     * blvec[i]->getParameter();
-      arma::mat param_temp_mom = lr_mom * blvec_mom[i]->getParameter();
+      arma::mat param_temp     = lr     *                bl_track.getParameterOfIteration(i);
+      arma::mat param_temp_mom = lr_mom * _momentum_blearnertrack.getParameterOfIteration(i);
 
       // Check if this is the first parameter entry for the id:
       if (it == mmod.end()) {
@@ -800,6 +1863,10 @@ std::map<std::string, arma::mat> OptimizerAGBM::getParameterAtIteration (const u
       mmod = addParamMaps(mmod, mmom, weight_param);
       mmod[ insert_id ]     += param_temp;
       mmom[ insert_id_mom ] += param_temp_mom;
+
+      if (((i + 1) % m == 0) && ((i + 1) / m > _replay_checkpoints.size())) {
+        _replay_checkpoints.push_back(std::make_pair(mmod, mmom));
+      }
     }
     return mmod;
   } else {
@@ -807,6 +1874,36 @@ std::map<std::string, arma::mat> OptimizerAGBM::getParameterAtIteration (const u
   }
 }
 
+void OptimizerAGBM::reportMemory (memreport::MemoryReport& report) const
+{
+  if (report.isVisited(this)) return;
+  Optimizer::reportMemory(report);
+
+  double pmap_bytes = 0;
+  for (auto& it : _aggr_parameter_map) {
+    pmap_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, arma::mat>)
+      + memreport::stringBytes(it.first) + memreport::matBytes(it.second);
+  }
+  report.add("optimizer", _type, "prediction_buffer", memreport::matBytes(_pred_momentum)
+    + memreport::matBytes(_pred_aggr) + memreport::matBytes(_pr_corr));
+  report.add("optimizer", _type, "aggr_parameter_map", pmap_bytes);
+
+  double replay_bytes = memreport::stdVecBytes(_replay_checkpoints);
+  for (auto& it_cp : _replay_checkpoints) {
+    for (auto& it : it_cp.first) {
+      replay_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, arma::mat>)
+        + memreport::stringBytes(it.first) + memreport::matBytes(it.second);
+    }
+    for (auto& it : it_cp.second) {
+      replay_bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, arma::mat>)
+        + memreport::stringBytes(it.first) + memreport::matBytes(it.second);
+    }
+  }
+  report.add("optimizer", _type, "replay_checkpoints", replay_bytes);
+  report.add("optimizer", _type, "bl_unique_id", memreport::stringVecBytes(_bl_unique_id));
+  _momentum_blearnertrack.reportMemory(report, "optimizer");
+}
+
 json OptimizerAGBM::toJson () const
 {
   json j = Optimizer::baseToJson("OptimizerAGBM");
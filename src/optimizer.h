@@ -25,6 +25,8 @@
 #include <memory>
 #include <map>
 #include <limits>
+#include <random>
+#include <algorithm>
 #include <math.h>
 
 #include <RcppArmadillo.h>
@@ -36,6 +38,9 @@
 #include "line_search.h"
 #include "helper.h"
 #include "saver.h"
+#include "profiler.h"
+#include "screening.h"
+#include "distributed.h"
 
 #include "single_include/nlohmann/json.hpp"
 using json = nlohmann::json;
@@ -60,6 +65,22 @@ protected:
   const unsigned int  _num_threads = 1;
   std::string         _type;
 
+  // Candidate sampling, with a fraction of 1 all factories are evaluated:
+  double       _candidate_fraction  = 1;
+  std::string  _candidate_weighting = "uniform";
+  unsigned int _full_sweep_every    = 0;
+  unsigned int _candidate_seed      = 0;
+
+  std::map<std::string, unsigned int> _candidate_counts;
+  unsigned int                        _candidate_iteration = 0;
+  bool                                _candidate_is_subset = false;
+  blearner_factory_map                _candidate_map;
+
+  // Safe screening of the candidates, nullptr if not used:
+  std::shared_ptr<screening::SafeScreening> _sh_ptr_screening;
+
+  std::shared_ptr<profiler::Profiler> _sh_ptr_profiler;
+
   Optimizer ();
   Optimizer (const unsigned int);
   Optimizer (const json&);
@@ -72,6 +93,11 @@ public:
   virtual std::shared_ptr<blearner::Baselearner> findBestBaselearner (std::string,
     const std::shared_ptr<response::Response>&, const blearner_factory_map&) const = 0;
 
+  // Full sweep with the selection criterion of the optimizer that does not touch the
+  // screening or the profiler (e.g. for loggers that compare with the selection):
+  virtual std::shared_ptr<blearner::Baselearner> findBestBaselearnerExhaustive (const arma::mat&,
+    const blearner_factory_map&) const;
+
   virtual void optimize (const unsigned int, const double, const std::shared_ptr<loss::Loss>&,
     const std::shared_ptr<response::Response>&, blearnertrack::BaselearnerTrack&,
     const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&) = 0;
@@ -79,14 +105,31 @@ public:
   virtual arma::mat calculateUpdate   (const double, const double, const arma::mat&,
     const std::map<std::string, std::shared_ptr<data::Data>>&, const std::shared_ptr<response::Response>&) const = 0;
 
-  virtual void calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::vec&) = 0;
+  virtual void calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&) = 0;
+
+  virtual std::map<std::string, arma::mat> getParameterAtIteration (const unsigned int, const double, const blearnertrack::BaselearnerTrack&) const;
 
-  virtual std::map<std::string, arma::mat> getParameterAtIteration (const unsigned int, const double, blearnertrack::BaselearnerTrack&) const;
+  std::string  getType       ()                  const;
+  unsigned int getNumThreads ()                  const;
+  json         baseToJson    (const std::string) const;
 
-  std::string getType ()                  const;
-  json baseToJson     (const std::string) const;
+  void                        setCandidateSampling  (const double, const std::string, const unsigned int, const unsigned int);
+  const blearner_factory_map& sampleCandidates      (const unsigned int, const blearner_factory_map&);
+  void                        registerSelection     (const std::shared_ptr<blearner::Baselearner>&);
+  bool                        evaluatedSubset       (const unsigned int) const;
+  double                      getCandidateFraction  () const;
+  std::string                 getCandidateWeighting () const;
+  unsigned int                getFullSweepEvery     () const;
+  unsigned int                getCandidateSeed      () const;
 
-  virtual json toJson () const = 0;
+  void                                      setSafeScreening (const bool);
+  std::shared_ptr<screening::SafeScreening> getSafeScreening () const;
+
+  void                                setProfiler (const std::shared_ptr<profiler::Profiler>&);
+  std::shared_ptr<profiler::Profiler> getProfiler () const;
+
+  virtual void reportMemory (memreport::MemoryReport&) const;
+  virtual json toJson       () const = 0;
 
   // Destructor
   virtual ~Optimizer ();
@@ -104,6 +147,10 @@ std::shared_ptr<Optimizer> jsonToOptimizer (const json&, const mdata&);
 
 class OptimizerCoordinateDescent : public Optimizer
 {
+protected:
+  std::shared_ptr<blearner::Baselearner> findBestBaselearnerScreened (const std::string,
+    const std::shared_ptr<response::Response>&, const blearner_factory_map&) const;
+
 public:
   OptimizerCoordinateDescent ();
   OptimizerCoordinateDescent (const unsigned int);
@@ -121,7 +168,7 @@ public:
 
   arma::mat calculateUpdate   (const double, const double, const arma::mat&,
     const std::map<std::string, std::shared_ptr<data::Data>>&, const std::shared_ptr<response::Response>&) const;
-  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::vec&);
+  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&);
 
   json toJson () const;
 };
@@ -133,7 +180,7 @@ public:
   OptimizerCoordinateDescentLineSearch (const unsigned int);
   OptimizerCoordinateDescentLineSearch (const json&);
 
-  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::vec&);
+  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&);
 
   double              getStepSize (const unsigned int) const;
   std::vector<double> getStepSize ()                   const;
@@ -142,6 +189,46 @@ public:
 };
 
 
+/**
+ * \class OptimizerFeatureParallel
+ *
+ * \brief Coordinate descent with the factories partitioned over processes
+ *
+ * The optimizer runs in the coordinator (rank 0 of the transport). Each
+ * iteration, the pseudo residuals are broadcasted, each process evaluates the
+ * factories it owns (see `distributed::FeatureWorker`), and the best candidate
+ * over all processes is selected with the same tie breaking as the sequential
+ * coordinate descent. Just the process of the winner sends its prediction. The
+ * base learner of the track is created from the factory of the coordinator and
+ * gets the parameter of the winner.
+ *
+ * After `stopWorkers()`, all factories are evaluated locally. Candidate
+ * sampling and safe screening are not used while the workers are active.
+ */
+class OptimizerFeatureParallel : public OptimizerCoordinateDescent
+{
+private:
+  const std::shared_ptr<distributed::Transport> _sh_ptr_transport;
+
+  bool _is_connected = false;
+  bool _is_stopped   = false;
+
+public:
+  OptimizerFeatureParallel (const std::shared_ptr<distributed::Transport>&);
+
+  void optimize (const unsigned int, const double, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<response::Response>&, blearnertrack::BaselearnerTrack&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
+
+  void stopWorkers ();
+  bool isStopped   () const;
+
+  json toJson () const;
+
+  ~OptimizerFeatureParallel ();
+};
+
+
 class OptimizerCosineAnnealing : public OptimizerCoordinateDescent
 {
 private:
@@ -160,7 +247,7 @@ public:
   OptimizerCosineAnnealing (const double, const double, const unsigned int, const unsigned int, const unsigned int);
   OptimizerCosineAnnealing (const json&);
 
-  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::vec&);
+  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&);
 
   double              getStepSize (const unsigned int) const;
   std::vector<double> getStepSize ()                   const;
@@ -169,6 +256,170 @@ public:
 };
 
 
+// Stochastic coordinate descent:
+// -------------------------------------------
+
+/**
+ * \class OptimizerStochasticCoordinateDescent
+ *
+ * \brief Coordinate descent with candidates fitted on a row subset
+ *
+ * In each iteration a subset of `_sample_fraction` of the observations is drawn
+ * (`_sampling = "random"`) or taken as the next block of a permutation of the rows
+ * (`_sampling = "cycle"`). All candidates are fitted and compared on this subset,
+ * the update of the selected base learner is then applied to all observations. The
+ * subset is drawn with an own generator seeded by the seed and the iteration and
+ * does not depend on the number of threads or R's random number generator.
+ * Pseudo residuals with more than one column (e.g. multiclass) are not supported.
+ */
+class OptimizerStochasticCoordinateDescent : public OptimizerCoordinateDescent
+{
+private:
+  const double       _sample_fraction;
+  const unsigned int _seed;
+  const std::string  _sampling;
+
+  // Permutation of the current epoch for the "cycle" sampling. Just a cache
+  // that is recreated from the seed and the epoch if required:
+  unsigned int _permutation_epoch = 0;
+  arma::uvec   _permutation;
+
+public:
+  OptimizerStochasticCoordinateDescent ();
+  OptimizerStochasticCoordinateDescent (const double, const unsigned int, const std::string, const unsigned int);
+  OptimizerStochasticCoordinateDescent (const json&);
+
+  arma::uvec drawSubset (const unsigned int, const unsigned int);
+
+  std::shared_ptr<blearner::Baselearner> findBestBaselearnerSubset (const arma::mat&, const arma::uvec&,
+    const blearner_factory_map&) const;
+
+  void optimize (const unsigned int, const double, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<response::Response>&, blearnertrack::BaselearnerTrack&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
+
+  double       getSampleFraction () const;
+  unsigned int getSeed           () const;
+  std::string  getSampling       () const;
+
+  void reportMemory (memreport::MemoryReport&) const;
+  json toJson       () const;
+};
+
+
+// Block coordinate descent:
+// -------------------------------------------
+
+/**
+ * \class OptimizerBlockCoordinateDescent
+ *
+ * \brief Coordinate descent that updates up to `_block_size` base learners per iteration
+ *
+ * All candidates are fitted to the pseudo residuals and ranked by their SSE. The
+ * block is filled greedily with the best candidates whose prediction has an absolute
+ * cosine similarity of at most `_max_correlation` to all base learners already in
+ * the block. With `_backtracking`, base learners are removed from the end of the
+ * block as long as the risk of the block update is larger than the risk of the
+ * update of the best base learner alone. All base learners of the block are stored
+ * as one iteration in the base learner track.
+ */
+class OptimizerBlockCoordinateDescent : public Optimizer
+{
+private:
+  const unsigned int _block_size;
+  const double       _max_correlation;
+  const bool         _backtracking;
+
+public:
+  OptimizerBlockCoordinateDescent ();
+  OptimizerBlockCoordinateDescent (const unsigned int, const double, const bool, const unsigned int);
+  OptimizerBlockCoordinateDescent (const json&);
+
+  double              getStepSize  (const unsigned int) const;
+  std::vector<double> getStepSize  ()                   const;
+
+  std::vector<std::pair<double, std::shared_ptr<blearner::Baselearner>>> rankBaselearner (const arma::mat&,
+    const blearner_factory_map&) const;
+
+  std::shared_ptr<blearner::Baselearner> findBestBaselearner (const std::string,
+    const std::shared_ptr<response::Response>&, const blearner_factory_map&) const;
+
+  std::vector<std::shared_ptr<blearner::Baselearner>> selectBlock (const double, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<response::Response>&, const blearner_factory_map&, arma::mat&) const;
+
+  void optimize (const unsigned int, const double, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<response::Response>&, blearnertrack::BaselearnerTrack&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
+
+  arma::mat calculateUpdate   (const double, const double, const arma::mat&,
+    const std::map<std::string, std::shared_ptr<data::Data>>&, const std::shared_ptr<response::Response>&) const;
+  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&);
+
+  unsigned int getBlockSize      () const;
+  double       getMaxCorrelation () const;
+  bool         getBacktracking   () const;
+
+  json toJson () const;
+};
+
+/**
+ * \class OptimizerNewton
+ *
+ * \brief Second-order boosting that fits the base learners to the Newton step
+ *
+ * Each candidate solves the weighted penalized least squares problem
+ * \f$(X^THX + P)\beta = X^Tr\f$ with the Hessian \f$H = \mathrm{diag}(h)\f$ of the
+ * loss and the pseudo residuals \f$r\f$. The candidate with the smallest weighted
+ * error \f$\sum_i h_i(r_i / h_i - \hat{f}_i)^2\f$ is selected. The penalty
+ * \f$P\f$ is recovered once per factory from the cached system of the data.
+ * The Hessian weights are accumulated per bin once per iteration and shared
+ * between all factories that use the same binned feature. Custom base learners
+ * do not expose their system and are fitted to the pseudo residuals.
+ */
+class OptimizerNewton : public Optimizer
+{
+private:
+  const double _min_hessian;
+  arma::mat    _hessian;
+
+  mutable std::map<std::string, arma::mat> _penalty_cache;
+  mutable std::map<std::string, arma::vec> _bin_weights;
+
+  arma::mat impliedPenalty     (const std::shared_ptr<blearnerfactory::BaselearnerFactory>&) const;
+  void      prepareCandidates  (const arma::vec&, const blearner_factory_map&) const;
+  std::shared_ptr<blearner::Baselearner> fitCandidate (const std::string&,
+    const std::shared_ptr<blearnerfactory::BaselearnerFactory>&, const arma::mat&, const arma::vec&) const;
+  std::shared_ptr<blearner::Baselearner> selectCandidate (const arma::mat&, const arma::vec&,
+    const blearner_factory_map&, const std::shared_ptr<profiler::Profiler>&) const;
+
+public:
+  OptimizerNewton ();
+  OptimizerNewton (const double, const unsigned int);
+  OptimizerNewton (const json&);
+
+  double              getStepSize  (const unsigned int) const;
+  std::vector<double> getStepSize  ()                   const;
+
+  std::shared_ptr<blearner::Baselearner> findBestBaselearner (const std::string,
+    const std::shared_ptr<response::Response>&, const blearner_factory_map&) const;
+  std::shared_ptr<blearner::Baselearner> findBestBaselearnerExhaustive (const arma::mat&,
+    const blearner_factory_map&) const;
+
+  void optimize (const unsigned int, const double, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<response::Response>&, blearnertrack::BaselearnerTrack&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&);
+
+  arma::mat calculateUpdate   (const double, const double, const arma::mat&,
+    const std::map<std::string, std::shared_ptr<data::Data>>&, const std::shared_ptr<response::Response>&) const;
+  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&);
+
+  double getMinHessian () const;
+
+  void reportMemory (memreport::MemoryReport&) const;
+  json toJson       () const;
+};
+
+
 // Accelerated Gradient Boosting:
 // -----------------------------------------------------------
 
@@ -185,6 +436,10 @@ private:
   std::map<std::string, arma::mat> _aggr_parameter_map;
   blearnertrack::BaselearnerTrack  _momentum_blearnertrack = blearnertrack::BaselearnerTrack(1.0);
 
+  // Cached states of the parameter replay in `getParameterAtIteration`:
+  mutable double _replay_lr = -1;
+  mutable std::vector<std::pair<std::map<std::string, arma::mat>, std::map<std::string, arma::mat>>> _replay_checkpoints;
+
 public:
   OptimizerAGBM ();
   OptimizerAGBM (const double);
@@ -204,7 +459,7 @@ public:
   arma::mat calculateUpdate   (const double, const double, const arma::mat&,
     const std::map<std::string, std::shared_ptr<data::Data>>&, const std::shared_ptr<response::Response>&) const;
 
-  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::vec&);
+  void      calculateStepSize (const std::shared_ptr<loss::Loss>&, const std::shared_ptr<response::Response>&, const arma::mat&);
 
   double                                         getStepSize (const unsigned int)  const;
   std::vector<double>                            getStepSize ()                    const;
@@ -217,9 +472,10 @@ public:
   //void updateAggrParameter (std::shared_ptr<blearner::Baselearner>&, double, double, blearnertrack::BaselearnerTrack&);
   std::map<std::string, arma::mat> addParamMaps (const std::map<std::string, arma::mat>&, const std::map<std::string, arma::mat>&, const double) const;
   void updateAggrParameter (double, blearnertrack::BaselearnerTrack&);
-   std::map<std::string, arma::mat> getParameterAtIteration (const unsigned int, const double, blearnertrack::BaselearnerTrack&) const;
+   std::map<std::string, arma::mat> getParameterAtIteration (const unsigned int, const double, const blearnertrack::BaselearnerTrack&) const;
 
-   json toJson () const;
+   void reportMemory (memreport::MemoryReport&) const;
+   json toJson       () const;
 };
 
 
@@ -0,0 +1,319 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+#include "planner.h"
+
+namespace planner
+{
+
+// Median run time in nanoseconds of `fun` over `reps` repetitions:
+template<typename FUN>
+double probeKernel (FUN fun, const unsigned int reps)
+{
+  std::vector<double> times;
+  fun();
+  for (unsigned int i = 0; i < reps; i++) {
+    auto t_start = std::chrono::steady_clock::now();
+    fun();
+    times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t_start).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// -------------------------------------------------------------------------- //
+// CostPlanner:
+// -------------------------------------------------------------------------- //
+
+CostPlanner::CostPlanner (const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list,
+  const std::shared_ptr<optimizer::Optimizer>& sh_ptr_optimizer, const unsigned int n_obs,
+  const unsigned int num_logger)
+  : _sh_ptr_factory_list ( sh_ptr_factory_list ),
+    _sh_ptr_optimizer    ( sh_ptr_optimizer ),
+    _n_obs               ( n_obs ),
+    _num_logger          ( num_logger )
+{
+  for (auto& it : _sh_ptr_factory_list->getFactoryMap()) {
+    FactoryPlan fp;
+    fp.factory_id = it.first;
+    fp.model_name = it.second->getBaseModelName();
+    fp.n_obs      = it.second->getVecDataSource()[0]->getNObs();
+    fp.n_params   = it.second->getPenaltyMat().n_rows;
+
+    std::shared_ptr<data::Data> sh_ptr_data = it.second->getInstantiatedData();
+    fp.n_elem       = sh_ptr_data->getDesignNElem();
+    fp.bytes        = sh_ptr_data->getDesignBytes();
+    fp.uses_sparse  = it.second->usesSparse();
+    fp.uses_binning = sh_ptr_data->usesBinning();
+    fp.can_bin      = (fp.model_name == "polynomial") || (fp.model_name == "pspline");
+
+    _factory_plans.push_back(fp);
+  }
+}
+
+/**
+ * \brief Measure the time per elementary operation of the kernels
+ *
+ * Each kernel is called on small synthetic data `reps` times (the median is
+ * used). The sizes are chosen to take a few milliseconds in total.
+ */
+void CostPlanner::calibrate (const unsigned int reps)
+{
+  const unsigned int m = 20000;
+  const unsigned int p = 20;
+  const unsigned int p_solve = 40;
+  const unsigned int p_decomp = 100;
+
+  arma::mat X(m, p, arma::fill::randn);
+  arma::vec r(m, arma::fill::randn);
+  arma::mat out;
+
+  _costs.dense_mv = probeKernel([&]() { out = X.t() * r; }, reps) / (m * p);
+
+  // Sparse design as used by the P-splines (transposed, degree + 1 non-zeros per observation):
+  arma::sp_mat Xs = arma::sprandu<arma::sp_mat>(p, m, 4.0 / p);
+  _costs.sparse_mv = probeKernel([&]() { out = Xs * r; }, reps) / std::max<double>(Xs.n_nonzero, 1);
+
+  arma::vec xbin = arma::randu<arma::vec>(m);
+  arma::vec bins = binning::binVector(xbin);
+  arma::uvec idx = binning::calculateIndexVector(xbin, bins);
+  arma::mat  Xb(bins.n_elem, 1, arma::fill::ones);
+  arma::vec  w(1, arma::fill::ones);
+  _costs.bin = probeKernel([&]() { out = binning::binnedMatMultResponse(Xb, r, idx, w); }, reps) / m;
+
+  arma::mat A(p_solve, p_solve, arma::fill::randn);
+  A = A.t() * A + arma::eye(p_solve, p_solve);
+  arma::vec b(p_solve, arma::fill::randn);
+  std::pair<std::string, arma::mat> cache("cholesky", arma::chol(A));
+  _costs.solve = probeKernel([&]() { out = helper::cboostSolver(cache, b); }, reps) / (p_solve * p_solve);
+
+  arma::vec y(m, arma::fill::randn);
+  _costs.elem = probeKernel([&]() { out = y - r; }, reps) / m;
+
+  arma::mat D(p_decomp, p_decomp, arma::fill::randn);
+  D = D.t() * D + arma::eye(p_decomp, p_decomp);
+  arma::mat R;
+  _costs.chol = probeKernel([&]() { R = arma::chol(D); }, reps) / std::pow(p_decomp, 3);
+
+  arma::vec eigval;
+  arma::mat eigvec;
+  _costs.eig = probeKernel([&]() { arma::eig_sym(eigval, eigvec, D); }, reps) / std::pow(p_decomp, 3);
+
+#ifdef _OPENMP
+  _costs.fork = probeKernel([&]() {
+    unsigned int nthreads = 0;
+    #pragma omp parallel reduction(+:nthreads)
+    { nthreads += 1; }
+    r(0) += 0 * nthreads;
+  }, reps);
+#endif
+
+  _costs.calibrated = true;
+}
+
+KernelCosts CostPlanner::getKernelCosts () const
+{
+  return _costs;
+}
+
+std::vector<FactoryPlan> CostPlanner::getFactoryPlans () const
+{
+  return _factory_plans;
+}
+
+// Stored design elements of the factory with `_n_obs` observations. The number
+// of bins grows with the square root of the observations (`bin_root = 2`):
+double CostPlanner::scaleElements (const FactoryPlan& fp) const
+{
+  double ratio = static_cast<double>(_n_obs) / fp.n_obs;
+  if (fp.uses_binning) return fp.n_elem * std::sqrt(ratio);
+  return fp.n_elem * ratio;
+}
+
+// Time in nanoseconds to train one candidate and calculate its SSE:
+double CostPlanner::candidateTime (const FactoryPlan& fp) const
+{
+  double n_elem = scaleElements(fp);
+  double t = n_elem * (fp.uses_sparse ? _costs.sparse_mv : _costs.dense_mv);
+  t += fp.n_params * fp.n_params * _costs.solve;
+
+  // Aggregation of the pseudo residuals into the bins and expanding the
+  // prediction of the bins to all observations:
+  if (fp.uses_binning) t += 2 * _n_obs * _costs.bin;
+
+  // Prediction and SSE:
+  t += n_elem * (fp.uses_sparse ? _costs.sparse_mv : _costs.dense_mv) + 2 * _n_obs * _costs.elem;
+  return t;
+}
+
+/**
+ * \brief Predicted time of one iteration in microseconds per component
+ *
+ * Components are `factory:<id>` for the candidate search of each factory (the
+ * wall time share when running with `num_threads`), `pseudo_residuals`,
+ * `update_model`, `risk`, `logger`, and `parallel_overhead`.
+ */
+std::map<std::string, double> CostPlanner::iterationTime (const unsigned int num_threads) const
+{
+  std::map<std::string, double> out;
+
+  // AGBM searches the best base learner twice per iteration:
+  double n_search = _sh_ptr_optimizer->getType() == "agbm" ? 2 : 1;
+
+  // The stochastic coordinate descent fits the candidates just on a share of the rows:
+  double row_share = 1;
+  auto sh_ptr_stoch = std::dynamic_pointer_cast<optimizer::OptimizerStochasticCoordinateDescent>(_sh_ptr_optimizer);
+  if (sh_ptr_stoch != nullptr) row_share = sh_ptr_stoch->getSampleFraction();
+
+  double threads = std::max(1u, std::min<unsigned int>(num_threads, _factory_plans.size()));
+  double t_max = 0;
+  for (auto& fp : _factory_plans) {
+    double t = candidateTime(fp) * n_search * row_share;
+    out["factory:" + fp.factory_id] = t / threads / 1000;
+    if (t > t_max) t_max = t;
+  }
+  out["pseudo_residuals"]  = 3 * _n_obs * _costs.elem / 1000;
+  out["update_model"]      = n_search * (t_max / 2 + 2 * _n_obs * _costs.elem) / 1000;
+  out["risk"]              = 2 * _n_obs * _costs.elem / 1000;
+  out["logger"]            = _num_logger * _n_obs * _costs.elem / 1000;
+  out["parallel_overhead"] = num_threads > 1 ? n_search * _costs.fork / 1000 : 0;
+
+  return out;
+}
+
+/**
+ * \brief Predicted setup time in microseconds per factory
+ *
+ * Includes the cross product of the design, the Demmler-Reinsch
+ * orthogonalization to get the penalty from the degrees of freedom, the
+ * cholesky decomposition for the cache, and, for tensors, the row-wise
+ * Kronecker product.
+ */
+std::map<std::string, double> CostPlanner::setupTime () const
+{
+  std::map<std::string, double> out;
+  for (auto& fp : _factory_plans) {
+    double n_elem = scaleElements(fp);
+    double p3     = std::pow(fp.n_params, 3);
+
+    double t = n_elem * (fp.uses_sparse ? 4 * _costs.sparse_mv : fp.n_params * _costs.dense_mv);
+    t += p3 * (_costs.eig + _costs.chol);
+    if (fp.model_name == "tensor") t += n_elem * _costs.dense_mv;
+    if (fp.uses_binning) t += _n_obs * std::log2(std::max<double>(_n_obs, 2)) * _costs.elem;
+
+    out["factory:" + fp.factory_id] = t / 1000;
+  }
+  return out;
+}
+
+/**
+ * \brief Predicted peak memory in bytes per component
+ *
+ * Components are `factories` (design, binning index, cache, and attributes),
+ * `response`, `track`, `optimizer`, `logger`, and `temporaries` (the
+ * predictions of the candidates that are hold in parallel).
+ */
+std::map<std::string, double> CostPlanner::peakMemory (const unsigned int iterations) const
+{
+  std::map<std::string, double> out;
+
+  memreport::MemoryReport report;
+  _sh_ptr_factory_list->reportMemory(report);
+  double bytes_design = 0, bytes_design_scaled = 0, p_mean = 0;
+  for (auto& fp : _factory_plans) {
+    bytes_design        += fp.bytes;
+    bytes_design_scaled += fp.bytes * scaleElements(fp) / std::max(fp.n_elem, 1.0);
+    p_mean              += fp.n_params / _factory_plans.size();
+  }
+  double ratio = _factory_plans.size() > 0 ? static_cast<double>(_n_obs) / _factory_plans[0].n_obs : 1;
+
+  // The raw data sources scale with the number of observations, the design as
+  // defined by `scaleElements`, the attributes (penalty matrices) not at all:
+  double bytes_other = report.getTotalBytes() - bytes_design;
+  out["factories"] = bytes_design_scaled + std::max(bytes_other, 0.0) * ratio;
+
+  bool is_agbm = _sh_ptr_optimizer->getType() == "agbm";
+  out["response"] = (is_agbm ? 7 : 5) * _n_obs * sizeof(double);
+
+  double bytes_bl = sizeof(blearner::Baselearner) + 2 * sizeof(std::shared_ptr<data::Data>) + memreport::SH_PTR_CTRL_BYTES
+    + sizeof(std::shared_ptr<blearner::Baselearner>) + (p_mean > arma::arma_config::mat_prealloc ? p_mean * sizeof(double) : 0);
+  out["track"]     = iterations * (bytes_bl + sizeof(double));
+  out["optimizer"] = iterations * sizeof(double) + (is_agbm ? iterations * bytes_bl + 3 * _n_obs * sizeof(double) : 0);
+  out["logger"]    = _num_logger * iterations * sizeof(double);
+
+  double threads = std::max(1u, std::min<unsigned int>(_sh_ptr_optimizer->getNumThreads(), _factory_plans.size()));
+  out["temporaries"] = threads * 2 * _n_obs * sizeof(double);
+
+  return out;
+}
+
+/// Number of threads with the smallest predicted time per iteration
+unsigned int CostPlanner::recommendThreads () const
+{
+  unsigned int max_threads = 1;
+#ifdef _OPENMP
+  max_threads = omp_get_num_procs();
+#endif
+  unsigned int best = 1;
+  double t_best = std::numeric_limits<double>::infinity();
+  for (unsigned int k = 1; k <= max_threads; k++) {
+    double t = 0;
+    for (auto& it : iterationTime(k)) t += it.second;
+    // Require at least 5 % improvement per additional thread:
+    if (t < t_best * (1 - 0.05 * (k - best))) {
+      t_best = t;
+      best   = k;
+    }
+  }
+  return best;
+}
+
+std::vector<std::string> CostPlanner::recommendations () const
+{
+  std::vector<std::string> out;
+
+  for (auto& fp : _factory_plans) {
+    if (fp.can_bin && (! fp.uses_binning) && (_n_obs >= 50000)) {
+      FactoryPlan fp_bin = fp;
+      fp_bin.uses_binning = true;
+      fp_bin.n_elem       = fp.n_elem / std::sqrt(fp.n_obs);
+      double saving = 1 - candidateTime(fp_bin) / candidateTime(fp);
+      if (saving > 0.1) {
+        out.push_back("Use binning with bin_root = 2 for factory '" + fp.factory_id + "' (estimated "
+          + std::to_string(static_cast<int>(100 * saving)) + "% less time per candidate).");
+      }
+    }
+    if (fp.uses_binning && (_n_obs < 10000)) {
+      out.push_back("Binning for factory '" + fp.factory_id + "' is not required for " + std::to_string(_n_obs)
+        + " observations.");
+    }
+  }
+  unsigned int threads = recommendThreads();
+  if (threads != _sh_ptr_optimizer->getNumThreads()) {
+    out.push_back("Use " + std::to_string(threads) + " thread(s) for the optimizer instead of "
+      + std::to_string(_sh_ptr_optimizer->getNumThreads()) + ".");
+  }
+  if (! _costs.calibrated) {
+    out.push_back("Kernel costs are not calibrated, call 'calibrate()' to measure them on this machine.");
+  }
+  return out;
+}
+
+} // namespace planner
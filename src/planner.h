@@ -0,0 +1,131 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    planner.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Estimate the cost of a training before it starts
+ *
+ *  @section DESCRIPTION
+ *
+ *  The `CostPlanner` predicts the time per iteration (split into the
+ *  candidate search of each factory and the remaining steps of an
+ *  iteration), the setup time of the factories, and the peak memory of a
+ *  training with `n` observations and a given number of iterations. The
+ *  prediction uses the metadata of the registered factories (number of
+ *  parameters, stored design elements, sparse or binned design) and the
+ *  time per elementary operation of the kernels. The latter are measured by
+ *  short timed probes of the actual kernels on the host (`calibrate()`),
+ *  without calibration conservative default values are used.
+ *
+ *  The factories can be registered on a subsample of the data. In that
+ *  case, the design is scaled from the number of observations of the
+ *  factories to `n`.
+ *
+ */
+
+#ifndef PLANNER_H_
+#define PLANNER_H_
+
+#include <RcppArmadillo.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "baselearner_factory_list.h"
+#include "optimizer.h"
+#include "binning.h"
+#include "helper.h"
+#include "memory_report.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace planner
+{
+
+/// Time in nanoseconds per elementary operation of the kernels
+struct KernelCosts
+{
+  double dense_mv   = 2.0;   ///< per element of a dense transposed matrix vector product
+  double sparse_mv  = 4.0;   ///< per non-zero of a sparse matrix vector product
+  double bin        = 3.0;   ///< per observation to aggregate a vector into bins
+  double solve      = 1.5;   ///< per squared number of parameters for the cached solve
+  double elem       = 1.0;   ///< per element of an element-wise vector operation
+  double chol       = 0.5;   ///< per cubed number of parameters for a cholesky decomposition
+  double eig        = 5.0;   ///< per cubed number of parameters for a symmetric eigen decomposition
+  double fork       = 5000;  ///< per parallel region
+  bool   calibrated = false;
+};
+
+/// Planning information about one factory
+struct FactoryPlan
+{
+  std::string  factory_id;
+  std::string  model_name;
+  double       n_obs;
+  double       n_params;
+  double       n_elem;
+  double       bytes;
+  bool         uses_sparse;
+  bool         uses_binning;
+  bool         can_bin;
+};
+
+class CostPlanner
+{
+private:
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
+  const std::shared_ptr<optimizer::Optimizer>                 _sh_ptr_optimizer;
+  const unsigned int                                          _n_obs;
+  const unsigned int                                          _num_logger;
+
+  std::vector<FactoryPlan> _factory_plans;
+  KernelCosts              _costs;
+
+  double candidateTime (const FactoryPlan&) const;
+  double scaleElements (const FactoryPlan&) const;
+
+public:
+  CostPlanner (const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&,
+    const std::shared_ptr<optimizer::Optimizer>&, const unsigned int, const unsigned int);
+
+  void calibrate (const unsigned int);
+
+  KernelCosts                   getKernelCosts   () const;
+  std::vector<FactoryPlan>      getFactoryPlans  () const;
+  std::map<std::string, double> iterationTime    (const unsigned int) const;
+  std::map<std::string, double> setupTime        () const;
+  std::map<std::string, double> peakMemory       (const unsigned int) const;
+  unsigned int                  recommendThreads () const;
+  std::vector<std::string>      recommendations  () const;
+};
+
+} // namespace planner
+
+#endif // PLANNER_H_
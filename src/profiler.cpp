@@ -0,0 +1,282 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+#include "profiler.h"
+
+namespace profiler
+{
+
+// -------------------------------------------------------------------------- //
+// Profiler:
+// -------------------------------------------------------------------------- //
+
+Profiler::Profiler () { }
+
+Profiler::Profiler (const unsigned int max_events)
+  : _max_events ( max_events )
+{ }
+
+Profiler::Profiler (const json& j)
+  : _current_iter ( j["_current_iter"].get<unsigned int>() ),
+    _max_events   ( j["_max_events"].get<unsigned int>() )
+{
+  for (auto& jp : j["_phases"].items()) {
+    PhaseRecord pr;
+    pr.category    = jp.value()["category"].get<std::string>();
+    pr.calls       = jp.value()["calls"].get<unsigned int>();
+    pr.total_us    = jp.value()["total_us"].get<double>();
+    pr.min_us      = jp.value()["min_us"].get<double>();
+    pr.max_us      = jp.value()["max_us"].get<double>();
+    pr.evaluations = jp.value()["evaluations"].get<double>();
+    pr.bytes       = jp.value()["bytes"].get<double>();
+    _phases[jp.key()] = pr;
+  }
+  for (auto& je : j["_events"]) {
+    TraceEvent ev{ je["name"].get<std::string>(), je["cat"].get<std::string>(), je["ts"].get<double>(),
+      je["dur"].get<double>(), je["tid"].get<unsigned int>(), je["iter"].get<unsigned int>() };
+    _events.push_back(ev);
+
+    // The clock of a loaded profiler starts again at zero. Shift new events
+    // behind the last stored event to keep the timeline monotone:
+    if (ev.ts + ev.dur > _ts_drift) _ts_drift = ev.ts + ev.dur;
+  }
+}
+
+void Profiler::setIteration (const unsigned int iter)
+{
+  _current_iter = iter;
+}
+
+double Profiler::elapsedMicro (const pclock::time_point& tp) const
+{
+  return std::chrono::duration<double, std::micro>(tp - _origin).count() + _ts_drift;
+}
+
+void Profiler::record (const std::string& phase, const std::string& category,
+  const pclock::time_point& start, const pclock::time_point& end)
+{
+  double dur = std::chrono::duration<double, std::micro>(end - start).count();
+  double ts  = elapsedMicro(start);
+
+  unsigned int tid = 0;
+#ifdef _OPENMP
+  tid = omp_get_thread_num();
+#endif
+
+  // Candidates may be trained in parallel by `findBestBaselearner`:
+  #pragma omp critical (cboost_profiler)
+  {
+    PhaseRecord& pr = _phases[phase];
+    pr.category  = category;
+    pr.calls    += 1;
+    pr.total_us += dur;
+    if (dur < pr.min_us) pr.min_us = dur;
+    if (dur > pr.max_us) pr.max_us = dur;
+
+    if (_events.size() < _max_events) {
+      _events.push_back(TraceEvent{ phase, category, ts, dur, tid, _current_iter });
+    }
+  }
+}
+
+void Profiler::addCounters (const std::string& phase, const double evaluations, const double bytes)
+{
+  #pragma omp critical (cboost_profiler)
+  {
+    PhaseRecord& pr = _phases[phase];
+    pr.evaluations += evaluations;
+    pr.bytes       += bytes;
+  }
+}
+
+void Profiler::clear ()
+{
+  _phases.clear();
+  _events.clear();
+  _origin       = pclock::now();
+  _ts_drift     = 0;
+  _current_iter = 0;
+}
+
+std::vector<std::string> Profiler::getPhaseNames () const
+{
+  std::vector<std::string> out;
+  for (auto& it : _phases) {
+    out.push_back(it.first);
+  }
+  return out;
+}
+
+std::vector<std::string> Profiler::getPhaseCategories () const
+{
+  std::vector<std::string> out;
+  for (auto& it : _phases) {
+    out.push_back(it.second.category);
+  }
+  return out;
+}
+
+/**
+ * \brief Aggregated phase table
+ *
+ * One row per phase (same order as `getPhaseNames()`) with the columns
+ * `calls`, `total_us`, `mean_us`, `min_us`, `max_us`, `evaluations` and `bytes`.
+ */
+arma::mat Profiler::getPhaseMatrix () const
+{
+  arma::mat out(_phases.size(), 7, arma::fill::zeros);
+  unsigned int i = 0;
+  for (auto& it : _phases) {
+    const PhaseRecord& pr = it.second;
+    out(i, 0) = pr.calls;
+    out(i, 1) = pr.total_us;
+    out(i, 2) = pr.calls > 0 ? pr.total_us / pr.calls : 0;
+    out(i, 3) = pr.calls > 0 ? pr.min_us : 0;
+    out(i, 4) = pr.max_us;
+    out(i, 5) = pr.evaluations;
+    out(i, 6) = pr.bytes;
+    i++;
+  }
+  return out;
+}
+
+unsigned int Profiler::getNumberOfEvents () const
+{
+  return _events.size();
+}
+
+double Profiler::getMemoryBytes () const
+{
+  double bytes = memreport::stdVecBytes(_events);
+  for (auto& ev : _events) {
+    bytes += memreport::stringBytes(ev.name) + memreport::stringBytes(ev.category);
+  }
+  for (auto& it : _phases) {
+    bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, PhaseRecord>)
+      + memreport::stringBytes(it.first) + memreport::stringBytes(it.second.category);
+  }
+  return bytes;
+}
+
+/**
+ * \brief Timeline in the Chrome trace event format
+ *
+ * Each phase is a complete event (`"ph": "X"`) with time stamp and duration
+ * in microseconds. The result can be loaded into `chrome://tracing` or
+ * Perfetto.
+ */
+json Profiler::toTraceJson () const
+{
+  json jevents = json::array();
+  for (auto& ev : _events) {
+    jevents.push_back({
+      {"name", ev.name},
+      {"cat",  ev.category},
+      {"ph",   "X"},
+      {"ts",   ev.ts},
+      {"dur",  ev.dur},
+      {"pid",  0},
+      {"tid",  ev.tid},
+      {"args", { {"iteration", ev.iteration} }}
+    });
+  }
+  json j = {
+    {"traceEvents",     jevents},
+    {"displayTimeUnit", "ms"}
+  };
+  return j;
+}
+
+void Profiler::exportTrace (const std::string file) const
+{
+  std::ofstream out(file);
+  if (! out.is_open()) {
+    throw std::runtime_error("Cannot open file '" + file + "' to write the trace.");
+  }
+  out << toTraceJson().dump();
+  out.close();
+}
+
+json Profiler::toJson () const
+{
+  json jphases;
+  for (auto& it : _phases) {
+    const PhaseRecord& pr = it.second;
+    jphases[it.first] = {
+      {"category",    pr.category},
+      {"calls",       pr.calls},
+      {"total_us",    pr.total_us},
+      {"min_us",      pr.calls > 0 ? pr.min_us : 0},
+      {"max_us",      pr.max_us},
+      {"evaluations", pr.evaluations},
+      {"bytes",       pr.bytes}
+    };
+  }
+  json jevents = json::array();
+  for (auto& ev : _events) {
+    jevents.push_back({
+      {"name", ev.name},
+      {"cat",  ev.category},
+      {"ts",   ev.ts},
+      {"dur",  ev.dur},
+      {"tid",  ev.tid},
+      {"iter", ev.iteration}
+    });
+  }
+  json j = {
+    {"_phases",       jphases.is_null() ? json::object() : jphases},
+    {"_events",       jevents},
+    {"_current_iter", _current_iter},
+    {"_max_events",   _max_events}
+  };
+  return j;
+}
+
+
+// -------------------------------------------------------------------------- //
+// ScopedTimer:
+// -------------------------------------------------------------------------- //
+
+ScopedTimer::ScopedTimer (const std::shared_ptr<Profiler>& sh_ptr_profiler, const std::string& phase,
+  const std::string& category)
+  : _profiler ( sh_ptr_profiler.get() )
+{
+  if (_profiler != nullptr) {
+    _phase    = phase;
+    _category = category;
+    _start    = pclock::now();
+  }
+}
+
+ScopedTimer::~ScopedTimer ()
+{
+  if (_profiler != nullptr) {
+    _profiler->record(_phase, _category, _start, pclock::now());
+  }
+}
+
+void ScopedTimer::addCounters (const double evaluations, const double bytes)
+{
+  if (_profiler != nullptr) {
+    _profiler->addCounters(_phase, evaluations, bytes);
+  }
+}
+
+} // namespace profiler
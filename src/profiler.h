@@ -0,0 +1,150 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    profiler.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Phase profiler used while training
+ *
+ *  @section DESCRIPTION
+ *
+ *  The profiler collects steady clock timings and simple counters for the
+ *  phases of one boosting iteration (pseudo residuals, candidate training per
+ *  factory, step size, prediction update, logging, risk). Phases are keyed
+ *  by name and aggregated. Additionally, each timed phase is stored as trace
+ *  event which can be exported into the Chrome trace event format.
+ *
+ *  The profiler is owned by a `LoggerProfile` and handed to the optimizer by
+ *  `Compboost::train`. If no profiler is registered, all timers are no-ops
+ *  (`ScopedTimer` just checks a null pointer).
+ *
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <RcppArmadillo.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <limits>
+#include <fstream>
+
+#include "memory_report.h"
+
+#include "single_include/nlohmann/json.hpp"
+using json = nlohmann::json;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace profiler
+{
+
+typedef std::chrono::steady_clock pclock;
+
+struct PhaseRecord
+{
+  std::string  category;
+  unsigned int calls       = 0;
+  double       total_us    = 0;
+  double       min_us      = std::numeric_limits<double>::infinity();
+  double       max_us      = 0;
+  double       evaluations = 0;
+  double       bytes       = 0;
+};
+
+struct TraceEvent
+{
+  std::string  name;
+  std::string  category;
+  double       ts;
+  double       dur;
+  unsigned int tid;
+  unsigned int iteration;
+};
+
+class Profiler
+{
+private:
+  std::map<std::string, PhaseRecord> _phases;
+  std::vector<TraceEvent>            _events;
+
+  pclock::time_point _origin      = pclock::now();
+  double             _ts_drift    = 0;
+  unsigned int       _current_iter = 0;
+  unsigned int       _max_events  = 100000;
+
+public:
+  Profiler ();
+  Profiler (const unsigned int);
+  Profiler (const json&);
+
+  void   setIteration (const unsigned int);
+  double elapsedMicro (const pclock::time_point&) const;
+
+  void record      (const std::string&, const std::string&, const pclock::time_point&, const pclock::time_point&);
+  void addCounters (const std::string&, const double, const double);
+  void clear       ();
+
+  std::vector<std::string> getPhaseNames      () const;
+  std::vector<std::string> getPhaseCategories () const;
+  arma::mat                getPhaseMatrix     () const;
+  unsigned int             getNumberOfEvents  () const;
+  double                   getMemoryBytes     () const;
+
+  json toTraceJson () const;
+  void exportTrace (const std::string) const;
+  json toJson      () const;
+};
+
+
+/**
+ * \class ScopedTimer
+ *
+ * \brief Measure the time of the enclosing scope
+ *
+ * The timer records the phase on destruction. Counters can be attached to the
+ * phase while the timer is alive. If the profiler is a `nullptr`, nothing is
+ * recorded and the phase name is never copied.
+ */
+class ScopedTimer
+{
+private:
+  Profiler*          _profiler;
+  std::string        _phase;
+  std::string        _category;
+  pclock::time_point _start;
+
+public:
+  ScopedTimer (const std::shared_ptr<Profiler>&, const std::string&, const std::string&);
+  ~ScopedTimer ();
+
+  void addCounters (const double, const double);
+};
+
+} // namespace profiler
+
+#endif // PROFILER_H_
@@ -0,0 +1,522 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+#include "resampling.h"
+
+namespace resampling
+{
+
+// -------------------------------------------------------------------------- //
+// Abstract 'ReplicateTrainer' class:
+// -------------------------------------------------------------------------- //
+
+ReplicateTrainer::ReplicateTrainer (const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::shared_ptr<loss::Loss>& sh_ptr_loss,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list,
+  const double learning_rate, const unsigned int num_threads)
+  : _sh_ptr_response     ( sh_ptr_response ),
+    _sh_ptr_loss         ( sh_ptr_loss ),
+    _sh_ptr_factory_list ( sh_ptr_factory_list ),
+    _learning_rate       ( learning_rate ),
+    _num_threads         ( num_threads ),
+    _truth               ( sh_ptr_response->getResponse() ),
+    _weights             ( sh_ptr_response->getWeights() ),
+    _use_weights         ( _weights.n_rows == _truth.n_rows )
+{
+  _sh_ptr_response->checkLossCompatibility(_sh_ptr_loss);
+  if (_sh_ptr_factory_list->getFactoryMap().size() == 0) {
+    Rcpp::stop("Could not train replicates without any registered base-learner.");
+  }
+}
+
+ReplicateTrainer::~ReplicateTrainer () { }
+
+/**
+ * \brief Register a replicate by the counts of the rows
+ *
+ * A replicate must use at least one and can not use all rows for training
+ * without having held out rows, if the out of bag risk should be available.
+ */
+void ReplicateTrainer::addReplicate (const arma::vec& counts)
+{
+  if (counts.n_elem != _truth.n_rows) {
+    Rcpp::stop("Number of counts (" + std::to_string(counts.n_elem) + ") does not match the number of observations ("
+      + std::to_string(_truth.n_rows) + ").");
+  }
+  if (arma::accu(counts) == 0) {
+    Rcpp::stop("Replicate " + std::to_string(_replicates.size() + 1) + " does not use any observation for training.");
+  }
+  ReplicateState rs;
+  rs.counts = counts;
+  _replicates.push_back(rs);
+}
+
+/**
+ * \brief Build the systems and the offset of all replicates
+ *
+ * The penalty of each factory is recovered once from the cached system of the
+ * full data. The counts of a replicate are accumulated once per binned feature
+ * and shared by all factories of this feature.
+ */
+void ReplicateTrainer::initialize ()
+{
+  std::vector<arma::mat> penalties;
+  for (auto& it : _sh_ptr_factory_list->getFactoryMap()) {
+    const std::string model = it.second->getBaseModelName();
+    sdata sh_ptr_data = it.second->getInstantiatedData();
+
+    arma::mat P;
+    if ((model != "custom") && (model != "customcpp") && (sh_ptr_data != nullptr)) P = sh_ptr_data->impliedPenalty();
+    if (P.is_empty()) {
+      Rcpp::stop("Base learner \"" + it.first + "\" does not expose its system and can not be trained on replicates.");
+    }
+    _factory_ids.push_back(it.first);
+    _factory_data.push_back(sh_ptr_data);
+    penalties.push_back(P);
+  }
+
+  // The offset is computed outside of the parallel region since the loss may use R.
+  // Rows are repeated by their counts to get the offset of the duplicated data:
+  for (auto& rs : _replicates) {
+    std::vector<arma::uword> rows;
+    for (unsigned int i = 0; i < rs.counts.n_elem; i++) {
+      for (unsigned int c = 0; c < rs.counts(i); c++) rows.push_back(i);
+    }
+    arma::uvec idx(rows);
+    rs.offset = _use_weights
+      ? _sh_ptr_loss->weightedConstantInitializer(_truth.rows(idx), _weights.rows(idx))
+      : _sh_ptr_loss->constantInitializer(_truth.rows(idx));
+    if (rs.offset.n_rows == _truth.n_rows) {
+      rs.scores = rs.offset;
+    } else {
+      rs.scores = arma::mat(_truth.n_rows, _truth.n_cols);
+      rs.scores.fill(rs.offset[0]);
+    }
+  }
+
+  const unsigned int num_threads = numThreads();
+
+  #pragma omp parallel for num_threads(num_threads) schedule(static) if (num_threads > 1)
+  for (unsigned int r = 0; r < _replicates.size(); r++) {
+    ReplicateState& rs = _replicates[r];
+
+    std::map<std::string, arma::vec> wcum;
+    for (unsigned int j = 0; j < _factory_data.size(); j++) {
+      const sdata& sh_ptr_data = _factory_data[j];
+      std::string key = sh_ptr_data->getDataIdentifier() + "_" + std::to_string(sh_ptr_data->getNDesignRows());
+      if (wcum.find(key) == wcum.end()) wcum[key] = sh_ptr_data->accumulateWeights(rs.counts);
+
+      arma::mat A = sh_ptr_data->weightedGram(wcum[key]) + penalties[j];
+      arma::mat U;
+      if (arma::chol(U, A)) {
+        rs.systems.push_back(std::make_pair("cholesky", U));
+      } else {
+        rs.systems.push_back(std::make_pair("inverse", arma::pinv(A)));
+      }
+    }
+    rs.inbag_risk.push_back(calculateRisk(rs.scores, rs.counts));
+    rs.oob_risk.push_back(calculateRisk(rs.scores, arma::conv_to<arma::vec>::from(rs.counts == 0)));
+  }
+  _is_initialized = true;
+}
+
+// Losses that call back into R are evaluated with one thread:
+unsigned int ReplicateTrainer::numThreads () const
+{
+  const std::string type = _sh_ptr_loss->getType();
+  return ((type == "custom") || (type == "custom_cpp")) ? 1 : _num_threads;
+}
+
+/**
+ * \brief Risk of the rows weighted by `counts`, i.e. the risk on the duplicated rows
+ *
+ * Returns `NaN` if no row has a positive count (e.g. no out of bag rows).
+ */
+double ReplicateTrainer::calculateRisk (const arma::mat& scores, const arma::vec& counts) const
+{
+  const double n = arma::accu(counts) * _truth.n_cols;
+  if (n == 0) return arma::datum::nan;
+
+  arma::mat loss = _use_weights
+    ? _sh_ptr_loss->weightedLoss(_truth, scores, _weights)
+    : _sh_ptr_loss->loss(_truth, scores);
+  loss.each_col() %= counts;
+
+  return arma::accu(loss) / n;
+}
+
+/**
+ * \brief Conduct `iterations` iterations of the coordinate descent on one replicate
+ *
+ * The SSE of the pseudo residuals \f$r\f$ is weighted with the counts, hence
+ * the parameter is \f$(X^TCX + P)^{-1}X^TCr\f$ as for the duplicated rows.
+ */
+void ReplicateTrainer::trainReplicate (ReplicateState& rs, const unsigned int iterations) const
+{
+  const arma::vec oob = arma::conv_to<arma::vec>::from(rs.counts == 0);
+
+  for (unsigned int i = 0; i < iterations; i++) {
+    arma::mat pr = _use_weights
+      ? _sh_ptr_loss->calculateWeightedPseudoResiduals(_truth, rs.scores, _weights)
+      : _sh_ptr_loss->calculatePseudoResiduals(_truth, rs.scores);
+    arma::mat cpr = pr;
+    cpr.each_col() %= rs.counts;
+
+    double       sse_best = std::numeric_limits<double>::infinity();
+    unsigned int j_best   = 0;
+    arma::mat    param_best;
+    arma::mat    pred_best;
+    for (unsigned int j = 0; j < _factory_data.size(); j++) {
+      arma::mat param = helper::cboostSolver(rs.systems[j], _factory_data[j]->crossProduct(cpr));
+      arma::mat pred  = _factory_data[j]->linearPredictor(param);
+
+      arma::mat res = arma::square(pr - pred);
+      res.each_col() %= rs.counts;
+      double sse = arma::accu(res);
+      if (sse < sse_best) {
+        sse_best   = sse;
+        j_best     = j;
+        param_best = param;
+        pred_best  = pred;
+      }
+    }
+    const std::string& id = _factory_ids[j_best];
+    if (rs.parameter.find(id) == rs.parameter.end()) {
+      rs.parameter[id] = _learning_rate * param_best;
+    } else {
+      rs.parameter[id] += _learning_rate * param_best;
+    }
+    rs.selected.push_back(id);
+    rs.scores += _learning_rate * pred_best;
+
+    rs.inbag_risk.push_back(calculateRisk(rs.scores, rs.counts));
+    rs.oob_risk.push_back(calculateRisk(rs.scores, oob));
+  }
+}
+
+/**
+ * \brief Train all replicates for `iterations` further iterations
+ *
+ * The replicates are distributed over the threads.
+ */
+void ReplicateTrainer::train (const unsigned int iterations)
+{
+  if (! _is_initialized) initialize();
+
+  const unsigned int num_threads = numThreads();
+
+  #pragma omp parallel for num_threads(num_threads) schedule(static) if (num_threads > 1)
+  for (unsigned int r = 0; r < _replicates.size(); r++) {
+    trainReplicate(_replicates[r], iterations);
+  }
+  _current_iter += iterations;
+}
+
+unsigned int ReplicateTrainer::getNumberOfReplicates () const { return _replicates.size(); }
+unsigned int ReplicateTrainer::getCurrentIteration   () const { return _current_iter; }
+
+// Risk of the offset and after each iteration (rows) per replicate (columns):
+arma::mat ReplicateTrainer::getInbagRisk () const
+{
+  arma::mat out(_current_iter + 1, _replicates.size(), arma::fill::zeros);
+  if (! _is_initialized) return out;
+  for (unsigned int r = 0; r < _replicates.size(); r++) out.col(r) = arma::vec(_replicates[r].inbag_risk);
+  return out;
+}
+
+arma::mat ReplicateTrainer::getOobRisk () const
+{
+  arma::mat out(_current_iter + 1, _replicates.size(), arma::fill::zeros);
+  if (! _is_initialized) return out;
+  for (unsigned int r = 0; r < _replicates.size(); r++) out.col(r) = arma::vec(_replicates[r].oob_risk);
+  return out;
+}
+
+// Counts of the rows (rows) per replicate (columns):
+arma::mat ReplicateTrainer::getCounts () const
+{
+  arma::mat out(_truth.n_rows, _replicates.size());
+  for (unsigned int r = 0; r < _replicates.size(); r++) out.col(r) = _replicates[r].counts;
+  return out;
+}
+
+std::vector<std::vector<std::string>> ReplicateTrainer::getSelectedBaselearner () const
+{
+  std::vector<std::vector<std::string>> out;
+  for (auto& rs : _replicates) out.push_back(rs.selected);
+  return out;
+}
+
+std::map<std::string, arma::mat> ReplicateTrainer::getParameter (const unsigned int replicate) const
+{
+  if (replicate >= _replicates.size()) {
+    Rcpp::stop("Replicate " + std::to_string(replicate + 1) + " is not available, there are "
+      + std::to_string(_replicates.size()) + " replicates.");
+  }
+  return _replicates[replicate].parameter;
+}
+
+/**
+ * \brief Add the heap memory to the report
+ *
+ * The data of the factories is shared by all replicates and reported once.
+ */
+void ReplicateTrainer::reportMemory (memreport::MemoryReport& report) const
+{
+  _sh_ptr_response->reportMemory(report);
+  _sh_ptr_factory_list->reportMemory(report);
+  report.add("resampling", "ReplicateTrainer", "response", memreport::matBytes(_truth) + memreport::matBytes(_weights));
+  for (unsigned int r = 0; r < _replicates.size(); r++) {
+    const ReplicateState& rs = _replicates[r];
+    std::string obj = "replicate_" + std::to_string(r + 1);
+
+    double system_bytes = 0;
+    for (auto& it : rs.systems) system_bytes += memreport::matBytes(it.second);
+    double param_bytes = 0;
+    for (auto& it : rs.parameter) param_bytes += memreport::matBytes(it.second);
+
+    report.add("replicates", obj, "counts",    memreport::matBytes(rs.counts));
+    report.add("replicates", obj, "systems",   system_bytes);
+    report.add("replicates", obj, "scores",    memreport::matBytes(rs.scores) + memreport::matBytes(rs.offset));
+    report.add("replicates", obj, "parameter", param_bytes);
+    report.add("replicates", obj, "selected",  memreport::stringVecBytes(rs.selected));
+  }
+}
+
+
+// -------------------------------------------------------------------------- //
+// Replicate implementations:
+// -------------------------------------------------------------------------- //
+
+// CrossValidation:
+// -----------------------
+
+/**
+ * \brief Constructor of the cross validation
+ *
+ * \param folds `arma::uvec` Fold of each row of the response, the folds are
+ *   numbered \f$0, \dots, K - 1\f$. The rows of a fold are held out when
+ *   training the model of this fold.
+ */
+CrossValidation::CrossValidation (const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::shared_ptr<loss::Loss>& sh_ptr_loss,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list,
+  const double learning_rate, const arma::uvec& folds, const unsigned int num_threads)
+  : ReplicateTrainer::ReplicateTrainer ( sh_ptr_response, sh_ptr_loss, sh_ptr_factory_list, learning_rate, num_threads ),
+    _folds ( folds )
+{
+  if (_folds.n_elem != _truth.n_rows) {
+    Rcpp::stop("Number of fold assignments (" + std::to_string(_folds.n_elem) + ") does not match the number of observations ("
+      + std::to_string(_truth.n_rows) + ").");
+  }
+  const unsigned int num_folds = _folds.max() + 1;
+  if (num_folds < 2) {
+    Rcpp::stop("Cross validation requires at least two folds.");
+  }
+  for (unsigned int k = 0; k < num_folds; k++) {
+    unsigned int n_test = arma::accu(_folds == k);
+    if ((n_test == 0) || (n_test == _folds.n_elem)) {
+      Rcpp::stop("Fold " + std::to_string(k + 1) + " must hold out at least one and not all observations.");
+    }
+    addReplicate(arma::conv_to<arma::vec>::from(_folds != k));
+  }
+}
+
+unsigned int CrossValidation::getNumberOfFolds () const
+{
+  return _replicates.size();
+}
+
+/**
+ * \brief Iteration with the smallest out of bag risk averaged over the folds
+ */
+unsigned int CrossValidation::getOptimalIteration () const
+{
+  if (! _is_initialized) return 0;
+  arma::vec mean_risk = arma::mean(getOobRisk(), 1);
+  return mean_risk.index_min();
+}
+
+/**
+ * \brief Prediction scores of each row by the model of the fold it is held out
+ */
+arma::mat CrossValidation::getOobPrediction () const
+{
+  arma::mat out;
+  if (! _is_initialized) return out;
+
+  out = arma::mat(arma::size(_replicates[0].scores), arma::fill::zeros);
+  for (auto& rs : _replicates) {
+    arma::uvec idx_test = arma::find(rs.counts == 0);
+    out.rows(idx_test) = rs.scores.rows(idx_test);
+  }
+  return out;
+}
+
+
+// BaggedEnsemble:
+// -----------------------
+
+/**
+ * \brief Constructor of the ensemble
+ *
+ * The bootstrap samples are drawn with the 64 bit Mersenne Twister seeded by
+ * `seed`, hence the ensemble is reproducible on every platform.
+ */
+BaggedEnsemble::BaggedEnsemble (const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::shared_ptr<loss::Loss>& sh_ptr_loss,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list,
+  const double learning_rate, const unsigned int num_replicates, const unsigned int seed,
+  const unsigned int num_threads)
+  : ReplicateTrainer::ReplicateTrainer ( sh_ptr_response, sh_ptr_loss, sh_ptr_factory_list, learning_rate, num_threads ),
+    _seed ( seed )
+{
+  if (num_replicates == 0) {
+    Rcpp::stop("The ensemble requires at least one replicate.");
+  }
+  const unsigned int n = _truth.n_rows;
+
+  std::mt19937_64 rng(seed);
+  for (unsigned int r = 0; r < num_replicates; r++) {
+    arma::vec counts(n, arma::fill::zeros);
+    for (unsigned int i = 0; i < n; i++) counts(helper::drawIndex(rng, n)) += 1;
+    addReplicate(counts);
+  }
+}
+
+unsigned int BaggedEnsemble::getSeed () const
+{
+  return _seed;
+}
+
+/**
+ * \brief Parameters of all members side by side (one column per member)
+ *
+ * Members that never selected a factory have a zero column.
+ */
+std::map<std::string, arma::mat> BaggedEnsemble::stackParameter () const
+{
+  std::map<std::string, arma::mat> out;
+  for (unsigned int r = 0; r < _replicates.size(); r++) {
+    for (auto& it : _replicates[r].parameter) {
+      if (out.find(it.first) == out.end()) out[it.first] = arma::mat(it.second.n_elem, _replicates.size(), arma::fill::zeros);
+      out[it.first].col(r) = arma::vectorise(it.second);
+    }
+  }
+  return out;
+}
+
+// Offsets of the members for `n` new observations, custom offsets of the training rows are ignored:
+arma::mat BaggedEnsemble::stackOffset (const unsigned int n) const
+{
+  arma::mat out(n, _replicates.size(), arma::fill::zeros);
+  for (unsigned int r = 0; r < _replicates.size(); r++) {
+    if (_replicates[r].offset.n_rows == 1) out.col(r).fill(_replicates[r].offset[0]);
+  }
+  return out;
+}
+
+/**
+ * \brief Prediction of the members for new data (one column per member)
+ *
+ * The basis of each factory is computed once and multiplied with the
+ * parameters of all members.
+ */
+arma::mat BaggedEnsemble::predictMembers (const mdata& data_map, const bool as_response) const
+{
+  if (data_map.size() == 0) {
+    throw std::range_error("Require data in 'data_map' for prediction.");
+  }
+  if (_truth.n_cols > 1) {
+    Rcpp::stop("Prediction of the members requires a response with one column.");
+  }
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+
+  arma::mat pred = stackOffset(data_map.begin()->second->getNObs());
+  for (auto& it : stackParameter()) {
+    pred += fac_map.at(it.first)->calculateLinearPredictor(it.second, data_map);
+  }
+  if (as_response) pred = _sh_ptr_response->getPredictionTransform(pred);
+  return pred;
+}
+
+/**
+ * \brief Mean prediction of the members for new data
+ *
+ * The models are linear in the parameters, hence the mean of the scores is
+ * the prediction with the averaged parameters. With `as_response` the mean
+ * score is transformed.
+ */
+arma::mat BaggedEnsemble::predict (const mdata& data_map, const bool as_response) const
+{
+  if (data_map.size() == 0) {
+    throw std::range_error("Require data in 'data_map' for prediction.");
+  }
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+  const double R = _replicates.size();
+
+  arma::mat pred(data_map.begin()->second->getNObs(), _truth.n_cols, arma::fill::zeros);
+  double offset = 0;
+  for (auto& rs : _replicates) {
+    if (rs.offset.n_rows == 1) offset += rs.offset[0] / R;
+  }
+  pred.fill(offset);
+
+  std::map<std::string, arma::mat> mean_parameter;
+  for (auto& rs : _replicates) {
+    for (auto& it : rs.parameter) {
+      if (mean_parameter.find(it.first) == mean_parameter.end()) {
+        mean_parameter[it.first] = it.second / R;
+      } else {
+        mean_parameter[it.first] += it.second / R;
+      }
+    }
+  }
+  for (auto& it : mean_parameter) {
+    pred += fac_map.at(it.first)->calculateLinearPredictor(it.second, data_map);
+  }
+  if (as_response) pred = _sh_ptr_response->getPredictionTransform(pred);
+  return pred;
+}
+
+/**
+ * \brief Mean score of each training row over the members it is out of bag
+ *
+ * Rows that are used by every member are `NaN`.
+ */
+arma::mat BaggedEnsemble::getOobPrediction () const
+{
+  arma::mat out;
+  if (! _is_initialized) return out;
+
+  out = arma::mat(arma::size(_replicates[0].scores), arma::fill::zeros);
+  arma::vec n_oob(out.n_rows, arma::fill::zeros);
+  for (auto& rs : _replicates) {
+    arma::vec oob = arma::conv_to<arma::vec>::from(rs.counts == 0);
+    arma::mat scores = rs.scores;
+    scores.each_col() %= oob;
+    out   += scores;
+    n_oob += oob;
+  }
+  out.each_col() /= n_oob;
+  return out;
+}
+
+} // namespace resampling
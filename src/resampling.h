@@ -0,0 +1,199 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    resampling.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Cross validation and bagging on shared factory data
+ *
+ *  @section DESCRIPTION
+ *
+ *  The factories are built once on the full data. A replicate (a fold of the
+ *  cross validation or a bootstrap sample) is represented by integer count
+ *  weights of the rows: zero for held out rows, one for training rows of a
+ *  fold, and the number of draws for a bootstrap sample. Training on the
+ *  weights is the same as training on the duplicated rows. The design,
+ *  binning index, and penalty are shared by all replicates. Each replicate
+ *  just holds its own decomposition of the system \f$X^TCX + P\f$ with the
+ *  counts \f$C\f$, which is obtained from the weighted binned Gram matrix, its
+ *  prediction scores, and its parameters. Because the scores are computed for
+ *  all rows, the out of bag risk of each iteration comes for free. The
+ *  replicates are trained in parallel.
+ *
+ *  In contrast to independent models, the spline bases, bins, and penalties
+ *  are the ones of the full data. Custom base learners are not supported
+ *  since their system is unknown.
+ *
+ */
+
+#ifndef RESAMPLING_H_
+#define RESAMPLING_H_
+
+#include <RcppArmadillo.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <limits>
+
+#include "baselearner_factory_list.h"
+#include "response.h"
+#include "loss.h"
+#include "helper.h"
+#include "memory_report.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+typedef std::shared_ptr<data::Data> sdata;
+typedef std::map<std::string, sdata> mdata;
+
+namespace resampling
+{
+
+/**
+ * \brief Training state of one replicate
+ */
+struct ReplicateState
+{
+  arma::vec  counts;    ///< number of times each row is used for training
+  arma::mat  offset;    ///< constant initialization of the replicate
+  arma::mat  scores;    ///< prediction scores of all rows
+
+  std::vector<std::pair<std::string, arma::mat>> systems;   ///< cached system per factory
+
+  std::vector<std::string>         selected;
+  std::map<std::string, arma::mat> parameter;
+  std::vector<double>              inbag_risk;
+  std::vector<double>              oob_risk;
+};
+
+/**
+ * \class ReplicateTrainer
+ *
+ * \brief Coordinate descent on count weighted replicates of the data
+ *
+ * Derived classes define the replicates by calling `addReplicate` in their
+ * constructor.
+ */
+class ReplicateTrainer
+{
+protected:
+  const std::shared_ptr<response::Response>                   _sh_ptr_response;
+  const std::shared_ptr<loss::Loss>                           _sh_ptr_loss;
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
+  const double                                                _learning_rate;
+  const unsigned int                                          _num_threads;
+
+  // Copied once from the response, the getters of the response return copies:
+  const arma::mat _truth;
+  const arma::mat _weights;
+  const bool      _use_weights;
+
+  unsigned int _current_iter = 0;
+  bool         _is_initialized = false;
+
+  std::vector<std::string>  _factory_ids;
+  std::vector<sdata>        _factory_data;
+  std::vector<ReplicateState> _replicates;
+
+  ReplicateTrainer (const std::shared_ptr<response::Response>&, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&, const double, const unsigned int);
+
+  void         addReplicate   (const arma::vec&);
+  void         initialize     ();
+  void         trainReplicate (ReplicateState&, const unsigned int) const;
+  double       calculateRisk  (const arma::mat&, const arma::vec&) const;
+  unsigned int numThreads     () const;
+
+public:
+  void train (const unsigned int);
+
+  unsigned int getNumberOfReplicates () const;
+  unsigned int getCurrentIteration   () const;
+  arma::mat    getInbagRisk          () const;
+  arma::mat    getOobRisk            () const;
+  arma::mat    getCounts             () const;
+
+  std::vector<std::vector<std::string>> getSelectedBaselearner () const;
+  std::map<std::string, arma::mat>      getParameter           (const unsigned int) const;
+
+  void reportMemory (memreport::MemoryReport&) const;
+
+  virtual ~ReplicateTrainer ();
+};
+
+/**
+ * \class CrossValidation
+ *
+ * \brief One replicate per fold with the rows of the fold held out
+ */
+class CrossValidation : public ReplicateTrainer
+{
+private:
+  const arma::uvec _folds;
+
+public:
+  CrossValidation (const std::shared_ptr<response::Response>&, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&, const double, const arma::uvec&,
+    const unsigned int);
+
+  unsigned int getNumberOfFolds    () const;
+  unsigned int getOptimalIteration () const;
+  arma::mat    getOobPrediction    () const;
+};
+
+/**
+ * \class BaggedEnsemble
+ *
+ * \brief One replicate per bootstrap sample
+ *
+ * All members use the same factories, hence the mean prediction of the
+ * ensemble is the prediction with the averaged parameters and costs one
+ * pass over the data. The predictions of all members are computed with one
+ * matrix product per factory.
+ */
+class BaggedEnsemble : public ReplicateTrainer
+{
+private:
+  const unsigned int _seed;
+
+  std::map<std::string, arma::mat> stackParameter () const;
+  arma::mat                        stackOffset    (const unsigned int) const;
+
+public:
+  BaggedEnsemble (const std::shared_ptr<response::Response>&, const std::shared_ptr<loss::Loss>&,
+    const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&, const double, const unsigned int,
+    const unsigned int, const unsigned int);
+
+  unsigned int getSeed () const;
+
+  arma::mat predict          (const mdata&, const bool) const;
+  arma::mat predictMembers   (const mdata&, const bool) const;
+  arma::mat getOobPrediction () const;
+};
+
+} // namespace resampling
+
+#endif // RESAMPLING_H_
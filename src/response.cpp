@@ -34,6 +34,12 @@ std::shared_ptr<Response> jsonToResponse (const json& j)
   if (j["Class"].get<std::string>() == "ResponseBinaryClassif") {
     r = std::make_shared<ResponseBinaryClassif>(j);
   }
+  if (j["Class"].get<std::string>() == "ResponseMulticlass") {
+    r = std::make_shared<ResponseMulticlass>(j);
+  }
+  if (j["Class"].get<std::string>() == "ResponseFDA") {
+    r = std::make_shared<ResponseFDA>(j);
+  }
   if (r == nullptr) {
     throw std::logic_error("No known class in JSON");
   }
@@ -68,6 +74,17 @@ Response::Response (const std::string target_name, const std::string task_id,
     _prediction_scores ( arma::mat(response.n_rows, response.n_cols, arma::fill::zeros) )
 { }
 
+// Read-only view of external memory, the response is only replaced via `replaceResponse`:
+Response::Response (const std::string target_name, const std::string task_id, const double* ptr,
+  const unsigned int nrows, const unsigned int ncols, const std::shared_ptr<void>& owner)
+  : _target_name       ( target_name ),
+    _task_id           ( task_id ),
+    _response          ( const_cast<double*>(ptr), nrows, ncols, false, false ),
+    _sh_ptr_owner      ( owner ),
+    _pseudo_residuals  ( arma::mat(nrows, ncols, arma::fill::zeros) ),
+    _prediction_scores ( arma::mat(nrows, ncols, arma::fill::zeros) )
+{ }
+
 Response::Response (const json& j)
   : _target_name       ( j["_target_name"].get<std::string>() ),
     _task_id           ( j["_task_id"].get<std::string>() ),
@@ -110,9 +127,12 @@ arma::mat   Response::getWeights               () const { return _weights; }
 arma::mat   Response::getInitialization        () const { return _initialization; }
 arma::mat   Response::getPseudoResiduals       () const { return _pseudo_residuals; }
 arma::mat   Response::getPredictionScores      () const { return _prediction_scores; }
+double      Response::getLastUpdateNorm        () const { return _update_norm; }
 arma::mat   Response::getPredictionScoresTemp1 () const { return _prediction_scores_temp1; }
 arma::mat   Response::getPredictionScoresTemp2 () const { return _prediction_scores_temp2; }
 
+unsigned int Response::getResponseNCols () const { return _response.n_cols; }
+
 
 void Response::checkLossCompatibility (const std::shared_ptr<loss::Loss>& sh_ptr_loss) const
 {
@@ -133,14 +153,30 @@ void Response::updatePseudoResiduals (const std::shared_ptr<loss::Loss>& sh_ptr_
   }
 }
 
+/**
+ * \brief Replace the response without writing into external memory
+ *
+ * Assigning to a view of external memory with the same number of elements
+ * would overwrite the memory of the owner. Hence, the view is detached first.
+ */
+void Response::replaceResponse (const arma::mat& response)
+{
+  arma::mat response_new = response;
+  _response.reset();
+  _response     = response_new;
+  _sh_ptr_owner = nullptr;
+}
+
 void Response::updatePrediction (const arma::mat& update)
 {
   _prediction_scores += update;
+  _update_norm        = std::sqrt(arma::accu(arma::square(update)));
 }
 
 void Response::updatePrediction (const double learning_rate, const double step_size, const arma::mat& update)
 {
   _prediction_scores += learning_rate * step_size * update;
+  _update_norm        = std::abs(learning_rate * step_size) * std::sqrt(arma::accu(arma::square(update)));
 }
 
 
@@ -172,14 +208,39 @@ void Response::constantInitialization (const arma::mat& init_mat)
 
 
 double Response::calculateEmpiricalRisk (const std::shared_ptr<loss::Loss>& sh_ptr_loss) const
+{
+  return calculateEmpiricalRisk(sh_ptr_loss, _prediction_scores);
+}
+
+/**
+ * \brief Empirical risk of other prediction scores, e.g. of a proposed update
+ */
+double Response::calculateEmpiricalRisk (const std::shared_ptr<loss::Loss>& sh_ptr_loss, const arma::mat& prediction_scores) const
 {
   checkLossCompatibility(sh_ptr_loss);
   if (_use_weights) {
     //return sh_ptr_loss->calculateWeightedEmpiricalRisk(_response, getPredictionTransform(), _weights);
-    return sh_ptr_loss->calculateWeightedEmpiricalRisk(_response, _prediction_scores, _weights);
+    return sh_ptr_loss->calculateWeightedEmpiricalRisk(_response, prediction_scores, _weights);
   } else {
-    return sh_ptr_loss->calculateEmpiricalRisk(_response, _prediction_scores);
+    return sh_ptr_loss->calculateEmpiricalRisk(_response, prediction_scores);
+  }
+}
+
+void Response::reportMemory (memreport::MemoryReport& report, const std::string& component) const
+{
+  if (! report.visit(this)) return;
+
+  std::string obj = _target_name + " (" + _task_id + ")";
+  report.add(component, obj, "response",          memreport::matBytes(_response));
+  if (_response.mem_state != 0) {
+    report.add(component, obj, "external", static_cast<double>(_response.n_elem) * sizeof(double));
   }
+  report.add(component, obj, "weights",           memreport::matBytes(_weights));
+  report.add(component, obj, "initialization",    memreport::matBytes(_initialization));
+  report.add(component, obj, "pseudo_residuals",  memreport::matBytes(_pseudo_residuals));
+  report.add(component, obj, "prediction_scores", memreport::matBytes(_prediction_scores));
+  report.add(component, obj, "prediction_temp",   memreport::matBytes(_prediction_scores_temp1)
+    + memreport::matBytes(_prediction_scores_temp2));
 }
 
 arma::mat Response::getPredictionTransform () const { return getPredictionTransform(_prediction_scores); }
@@ -246,6 +307,11 @@ ResponseRegr::ResponseRegr (const std::string target_name, const arma::mat& resp
   helper::checkMatrixDim(response, weights);
 }
 
+ResponseRegr::ResponseRegr (const std::string target_name, const double* ptr, const unsigned int nrows,
+  const unsigned int ncols, const std::shared_ptr<void>& owner)
+  : Response::Response ( target_name, "regression", ptr, nrows, ncols, owner )
+{ }
+
 ResponseRegr::ResponseRegr (const json& j)
   : Response::Response(j)
 { }
@@ -304,7 +370,7 @@ arma::mat ResponseRegr::getPredictionResponse (const arma::mat& pred_scores) con
 
 void ResponseRegr::filter (const arma::uvec& idx)
 {
-  _response = _response.elem(idx);
+  replaceResponse(_response.elem(idx));
   if (_use_weights) {
     _weights = _weights.elem(idx);
   }
@@ -397,7 +463,7 @@ std::map<std::string, unsigned int> ResponseBinaryClassif::getClassTable () cons
 
 void ResponseBinaryClassif::filter (const arma::uvec& idx)
 {
-  _response = _response.elem(idx);
+  replaceResponse(_response.elem(idx));
   if (_use_weights) {
     _weights = _weights.elem(idx);
   }
@@ -426,92 +492,294 @@ json ResponseBinaryClassif::toJson(const bool rm_data) const
 }
 
 
-// Functional Data Response
+// ResponseMulticlass
 // ------------------------------------
 
-// ResponseFDA::ResponseFDA (const std::string& target_name0, const arma::mat& response0, const arma::mat& grid0)
-// {
-//   target_name = target_name0;
-//   response = response0;
-//   task_id = "regression"; // set parent
-//   arma::mat temp_mat(response.n_rows, response.n_cols, arma::fill::zeros);
-//   prediction_scores = temp_mat; // set parent
-//   pseudo_residuals = temp_mat;  // set parent
-//   // FDA specifics
-//   grid = grid0;
-//   arma::mat temp_mat_1(response.n_rows, response.n_cols, arma::fill::ones);
-//   weights = temp_mat_1;
-//   trapez_weights = tensors::trapezWeights(grid0);
-// }
-//
-// ResponseFDA::ResponseFDA (const std::string& target_name0, const arma::mat& response0, const arma::mat& weights0, const arma::mat& grid0)
-// {
-//   helper::checkMatrixDim(response0, weights0);
-//   target_name = target_name0;
-//   response = response0;
-//   weights = weights0;
-//   task_id = "regression"; // set parent
-//   arma::mat temp_mat(response.n_rows, response.n_cols, arma::fill::zeros);
-//   prediction_scores = temp_mat; // set parent
-//   pseudo_residuals = temp_mat;  // set parent
-//   // FDA specifics
-//   grid = grid0;
-//   trapez_weights = tensors::trapezWeights(grid0);
-// }
-//
-// arma::mat ResponseFDA::calculateInitialPrediction (const arma::mat& response) const
-// {
-//   arma::mat init(response.n_rows, response.n_cols, arma::fill::zeros);
-//
-//   if (! _is_initialized) {
-//     Rcpp::stop("Response is not initialized, call 'constantInitialization()' first.");
-//   }
-//   // Use just first element to correctly use .fill:
-//   init.fill(initialization[0]);
-//   return init;
-// }
-//
-// void ResponseFDA::initializePrediction ()
-// {
-//   if (_is_initialized) {
-//     if (! _is_model_initialized) {
-//       prediction_scores = calculateInitialPrediction(response);
-//       _is_model_initialized = true;
-//     } else {
-//       Rcpp::stop("Prediction is already initialized.");
-//     }
-//   } else {
-//     Rcpp::stop("Initialize constant initialization first by calling 'constantInitialization()'.");
-//   }
-// }
-//
-// void ResponseFDA::updatePseudoResiduals (std::shared_ptr<loss::Loss> sh_ptr_loss)
-// {
-//   checkLossCompatibility(sh_ptr_loss);
-//   weights = weights.each_row() % trapez_weights.t();
-//   pseudo_residuals = sh_ptr_loss->calculateWeightedPseudoResiduals(response, prediction_scores, weights);
-// }
-//
-//
-// arma::mat ResponseFDA::getPredictionTransform (const arma::mat& pred_scores) const
-// {
-//   // No transformation is done in regression
-//   return pred_scores;
-// }
-//
-// arma::mat ResponseFDA::getPredictionResponse (const arma::mat& pred_scores) const
-// {
-//   return pred_scores;
-// }
-//
-// void ResponseFDA::filter (const arma::uvec& idx)
-// {
-//   response = response.elem(idx);
-//   if (_use_weights) {
-//     weights = weights.elem(idx);
-//   }
-//   pseudo_residuals = pseudo_residuals.elem(idx);
-//   prediction_scores = prediction_scores.elem(idx);
-// }
+// The classes are the sorted unique labels:
+static std::vector<std::string> classesOfTable (const std::map<std::string, unsigned int>& class_table)
+{
+  std::vector<std::string> out;
+  for (auto& it : class_table) out.push_back(it.first);
+  return out;
+}
+
+ResponseMulticlass::ResponseMulticlass (const std::string target_name, const std::vector<std::string>& response)
+  : ResponseMulticlass ( target_name, response, helper::tableResponse(response) )
+{ }
+
+ResponseMulticlass::ResponseMulticlass (const std::string target_name, const std::vector<std::string>& response, const arma::mat& weights)
+  : ResponseMulticlass ( target_name, response, weights, helper::tableResponse(response) )
+{ }
+
+// The class table is counted once by the public constructors:
+ResponseMulticlass::ResponseMulticlass (const std::string target_name, const std::vector<std::string>& response,
+  const std::map<std::string, unsigned int>& class_table)
+  : Response::Response ( target_name, "multiclass_classif",
+      helper::stringVecToOneHotMat(response, classesOfTable(class_table)) ),
+    _classes     ( classesOfTable(class_table) ),
+    _class_table ( class_table )
+{
+  if (_classes.size() < 2) {
+    Rcpp::stop("Multiclass classification requires at least two classes.");
+  }
+}
+
+ResponseMulticlass::ResponseMulticlass (const std::string target_name, const std::vector<std::string>& response,
+  const arma::mat& weights, const std::map<std::string, unsigned int>& class_table)
+  : Response::Response ( target_name, "multiclass_classif",
+      helper::stringVecToOneHotMat(response, classesOfTable(class_table)), weights ),
+    _classes     ( classesOfTable(class_table) ),
+    _class_table ( class_table )
+{
+  if (_classes.size() < 2) {
+    Rcpp::stop("Multiclass classification requires at least two classes.");
+  }
+  if ((weights.n_rows != _response.n_rows) || (weights.n_cols != 1)) {
+    Rcpp::stop("Weights must have one column and " + std::to_string(_response.n_rows) + " rows.");
+  }
+}
+
+ResponseMulticlass::ResponseMulticlass (const json& j)
+  : Response::Response(j),
+    _classes     ( j["_classes"].get<std::vector<std::string>>() ),
+    _class_table ( j["_class_table"].get<std::map<std::string, unsigned int>>() )
+{ }
+
+// The initialization is a row vector with one score per class:
+arma::mat ResponseMulticlass::calculateInitialPrediction (const arma::mat& response) const
+{
+  if (! _is_initialized) {
+     Rcpp::stop("Response is not initialized, call 'constantInitialization()' first.");
+  }
+  if (_initialization.n_rows > 1) {
+    return _initialization;
+  }
+  return arma::repmat(_initialization, response.n_rows, 1);
+}
+
+void ResponseMulticlass::initializePrediction ()
+{
+  if (_is_initialized) {
+    if (! _is_model_initialized) {
+      _prediction_scores = calculateInitialPrediction(_response);
+      _is_model_initialized = true;
+    } else {
+      Rcpp::stop("Prediction is already initialized.");
+    }
+  } else {
+    Rcpp::stop("Response is not initialized, call 'constantInitialization()' first.");
+  }
+}
+
+arma::mat ResponseMulticlass::getPredictionTransform (const arma::mat& pred_scores) const
+{
+  return helper::softmax(pred_scores);
+}
+
+// Index of the most probable class, starting with 1:
+arma::mat ResponseMulticlass::getPredictionResponse (const arma::mat& pred_scores) const
+{
+  arma::ucolvec idx = arma::index_max(pred_scores, 1);
+  return arma::conv_to<arma::mat>::from(idx) + 1;
+}
+
+std::vector<std::string>            ResponseMulticlass::getClasses    () const { return _classes; }
+std::map<std::string, unsigned int> ResponseMulticlass::getClassTable () const { return _class_table; }
+
+void ResponseMulticlass::filter (const arma::uvec& idx)
+{
+  replaceResponse(_response.rows(idx));
+  if (_use_weights) {
+    _weights = _weights.rows(idx);
+  }
+  _pseudo_residuals  = _pseudo_residuals.rows(idx);
+  _prediction_scores = _prediction_scores.rows(idx);
+}
+
+json ResponseMulticlass::toJson (const bool rm_data) const
+{
+  json j = baseToJson("ResponseMulticlass", rm_data);
+  j["_classes"]     = _classes;
+  j["_class_table"] = _class_table;
+
+  return j;
+}
+
+// ResponseFDA
+// ------------------------------------
+
+// Trapezoidal integration weights of the grid, scaled to mean one such that
+// the risk stays on the scale of the pointwise loss:
+static arma::rowvec trapezWeights (const arma::vec& grid)
+{
+  if (grid.n_elem < 2) {
+    Rcpp::stop("The grid of a functional response requires at least two points.");
+  }
+  if (arma::any(arma::diff(grid) <= 0)) {
+    Rcpp::stop("The grid of a functional response must be strictly increasing.");
+  }
+  arma::rowvec w(grid.n_elem, arma::fill::zeros);
+  arma::vec d = arma::diff(grid);
+  w.head(grid.n_elem - 1) += 0.5 * d.t();
+  w.tail(grid.n_elem - 1) += 0.5 * d.t();
+
+  return w * grid.n_elem / arma::accu(w);
+}
+
+// Observation weights times the integration weights of the grid:
+static arma::mat functionalWeights (const arma::mat& response, const arma::mat& weights, const arma::vec& grid)
+{
+  if (response.n_cols != grid.n_elem) {
+    Rcpp::stop("The response has " + std::to_string(response.n_cols) + " columns but the grid has "
+      + std::to_string(grid.n_elem) + " points.");
+  }
+  if ((weights.n_rows != response.n_rows) || (weights.n_cols != 1)) {
+    Rcpp::stop("Weights must have one column and " + std::to_string(response.n_rows) + " rows.");
+  }
+  return weights.col(0) * trapezWeights(grid);
+}
+
+static arma::mat timeBasis (const arma::vec& grid, const unsigned int degree, const unsigned int n_knots)
+{
+  return splines::createSplineBasis(grid, degree, splines::createKnots(grid, n_knots, degree));
+}
+
+// The penalty is either given or found by the Demmler-Reinsch
+// orthogonalization for the degrees of freedom `df > 0`:
+static double timePenalty (const arma::mat& basis, const arma::vec& grid, const double penalty, const double df,
+  const unsigned int differences)
+{
+  if (df <= 0) return penalty;
+
+  arma::mat btwb = basis.t() * (basis.each_col() % trapezWeights(grid).t());
+  return dro::demmlerReinsch(btwb, splines::penaltyMat(basis.n_cols, differences), df);
+}
+
+// Smoother G^{-1} B^T with G = B^T W B + lambda P:
+static arma::mat timeSmoother (const arma::mat& basis, const arma::vec& grid, const double penalty,
+  const unsigned int differences)
+{
+  arma::mat btwb = basis.t() * (basis.each_col() % trapezWeights(grid).t());
+  return arma::solve(btwb + penalty * splines::penaltyMat(basis.n_cols, differences), basis.t());
+}
+
+ResponseFDA::ResponseFDA (const std::string target_name, const arma::mat& response, const arma::vec& grid,
+  const unsigned int degree, const unsigned int n_knots, const double penalty, const double df,
+  const unsigned int differences)
+  : Response::Response ( target_name, "functional_regr", response,
+      functionalWeights(response, arma::mat(response.n_rows, 1, arma::fill::ones), grid) ),
+    _grid          ( grid ),
+    _time_basis    ( timeBasis(grid, degree, n_knots) ),
+    _penalty       ( timePenalty(_time_basis, grid, penalty, df, differences) ),
+    _time_smoother ( timeSmoother(_time_basis, grid, _penalty, differences) )
+{ }
+
+ResponseFDA::ResponseFDA (const std::string target_name, const arma::mat& response, const arma::mat& weights,
+  const arma::vec& grid, const unsigned int degree, const unsigned int n_knots, const double penalty,
+  const double df, const unsigned int differences)
+  : Response::Response ( target_name, "functional_regr", response, functionalWeights(response, weights, grid) ),
+    _grid          ( grid ),
+    _time_basis    ( timeBasis(grid, degree, n_knots) ),
+    _penalty       ( timePenalty(_time_basis, grid, penalty, df, differences) ),
+    _time_smoother ( timeSmoother(_time_basis, grid, _penalty, differences) )
+{ }
+
+ResponseFDA::ResponseFDA (const json& j)
+  : Response::Response(j),
+    _grid          ( arma::vec(saver::jsonToArmaMat(j["_grid"])) ),
+    _time_basis    ( saver::jsonToArmaMat(j["_time_basis"]) ),
+    _penalty       ( j["_penalty"].get<double>() ),
+    _time_smoother ( saver::jsonToArmaMat(j["_time_smoother"]) )
+{ }
+
+// Functional responses are fitted with the pointwise regression losses:
+void ResponseFDA::checkLossCompatibility (const std::shared_ptr<loss::Loss>& sh_ptr_loss) const
+{
+  std::string task = sh_ptr_loss->getTaskId();
+  if ((task != "regression") && (task != "custom")) {
+    Rcpp::stop("Loss task '" + task + "' is not compatible with the response class task '" + _task_id + "'.");
+  }
+}
+
+/**
+ * \brief Weighted pseudo residuals smoothed over the time axis
+ *
+ * The (integration) weighted residuals are projected once on the time basis
+ * and mapped back to the grid. This costs \f$\mathcal{O}(nTp_t)\f$ per
+ * iteration and is shared by all base learners.
+ */
+void ResponseFDA::updatePseudoResiduals (const std::shared_ptr<loss::Loss>& sh_ptr_loss)
+{
+  Response::updatePseudoResiduals(sh_ptr_loss);
+  _pseudo_residuals = smoothOverTime(_pseudo_residuals);
+}
+
+arma::mat ResponseFDA::smoothOverTime (const arma::mat& residuals) const
+{
+  return (residuals * _time_basis) * _time_smoother;
+}
+
+arma::mat ResponseFDA::calculateInitialPrediction (const arma::mat& response) const
+{
+  if (! _is_initialized) {
+     Rcpp::stop("Response is not initialized, call 'constantInitialization()' first.");
+  }
+  if (_initialization.n_rows > 1) {
+    return _initialization;
+  }
+  if (_initialization.n_cols == response.n_cols) {
+    return arma::repmat(_initialization, response.n_rows, 1);
+  }
+  arma::mat init(response.n_rows, response.n_cols);
+  init.fill(_initialization[0]);
+  return init;
+}
+
+void ResponseFDA::initializePrediction ()
+{
+  if (_is_initialized) {
+    if (! _is_model_initialized) {
+      _prediction_scores = calculateInitialPrediction(_response);
+      _is_model_initialized = true;
+    } else {
+      Rcpp::stop("Prediction is already initialized.");
+    }
+  } else {
+    Rcpp::stop("Initialize constant initialization first by calling 'constantInitialization()'.");
+  }
+}
+
+arma::mat ResponseFDA::getPredictionTransform (const arma::mat& pred_scores) const
+{
+  return pred_scores;
+}
+
+arma::mat ResponseFDA::getPredictionResponse (const arma::mat& pred_scores) const
+{
+  return pred_scores;
+}
+
+void ResponseFDA::filter (const arma::uvec& idx)
+{
+  replaceResponse(_response.rows(idx));
+  _weights  = _weights.rows(idx);
+  _pseudo_residuals  = _pseudo_residuals.rows(idx);
+  _prediction_scores = _prediction_scores.rows(idx);
+}
+
+arma::vec ResponseFDA::getGrid        () const { return _grid; }
+arma::mat ResponseFDA::getTimeBasis   () const { return _time_basis; }
+double    ResponseFDA::getTimePenalty () const { return _penalty; }
+
+json ResponseFDA::toJson (const bool rm_data) const
+{
+  json j = baseToJson("ResponseFDA", rm_data);
+  j["_grid"]          = saver::armaMatToJson(_grid);
+  j["_time_basis"]    = saver::armaMatToJson(_time_basis);
+  j["_penalty"]       = _penalty;
+  j["_time_smoother"] = saver::armaMatToJson(_time_smoother);
+
+  return j;
+}
 
 } // namespace response
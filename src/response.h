@@ -25,6 +25,9 @@
 #include "loss.h"
 #include "helper.h"
 #include "saver.h"
+#include "memory_report.h"
+#include "splines.h"
+#include "demmler_reinsch.h"
 
 #include "single_include/nlohmann/json.hpp"
 using json = nlohmann::json;
@@ -43,8 +46,10 @@ protected:
   const std::string _task_id;
   const bool        _use_weights = false;
 
-  arma::mat _response;
-  arma::mat _weights;
+  // The response may use memory of an R vector, `_sh_ptr_owner` keeps it alive:
+  arma::mat             _response;
+  std::shared_ptr<void> _sh_ptr_owner;
+  arma::mat             _weights;
   arma::mat _initialization;
 
   arma::mat _pseudo_residuals;
@@ -53,14 +58,21 @@ protected:
   arma::mat _prediction_scores_temp1;
   arma::mat _prediction_scores_temp2;
 
+  // L2 norm of the last update added to the prediction scores:
+  double _update_norm = 0;
+
   unsigned int _iteration = 0;
   bool         _is_initialized = false;
   bool         _is_model_initialized = false;
 
   Response (const std::string, const std::string, const arma::mat&);
   Response (const std::string, const std::string, const arma::mat&, const arma::mat&);
+  Response (const std::string, const std::string, const double*, const unsigned int, const unsigned int,
+    const std::shared_ptr<void>&);
   Response (const json&);
 
+  void replaceResponse (const arma::mat&);
+
 public:
   Response ();
 
@@ -89,10 +101,13 @@ public:
   arma::mat   getPredictionResponse    () const;
   arma::mat   getPredictionScoresTemp1 () const;
   arma::mat   getPredictionScoresTemp2 () const;
+  double      getLastUpdateNorm        () const;
+
+  unsigned int getResponseNCols () const;
 
   // Other methods
-  void checkLossCompatibility (const std::shared_ptr<loss::Loss>&) const;
-  void updatePseudoResiduals  (const std::shared_ptr<loss::Loss>&);
+  virtual void checkLossCompatibility (const std::shared_ptr<loss::Loss>&) const;
+  virtual void updatePseudoResiduals  (const std::shared_ptr<loss::Loss>&);
   void updatePrediction       (const arma::mat&);
   void updatePrediction       (const double, const double, const arma::mat&);
   void constantInitialization (const std::shared_ptr<loss::Loss>&);
@@ -101,6 +116,8 @@ public:
   json baseToJson (const std::string, const bool = false) const;
 
   double calculateEmpiricalRisk (const std::shared_ptr<loss::Loss>&) const;
+  double calculateEmpiricalRisk (const std::shared_ptr<loss::Loss>&, const arma::mat&) const;
+  void   reportMemory           (memreport::MemoryReport&, const std::string& = "response") const;
 
   // Destructor
   virtual ~Response () { };
@@ -121,6 +138,7 @@ class ResponseRegr : public Response
 public:
   ResponseRegr (const std::string, const arma::mat&);
   ResponseRegr (const std::string, const arma::mat&, const arma::mat&);
+  ResponseRegr (const std::string, const double*, const unsigned int, const unsigned int, const std::shared_ptr<void>&);
   ResponseRegr (const json&);
 
   void      initializePrediction       ();
@@ -160,24 +178,100 @@ public:
   std::map<std::string, unsigned int> getClassTable    () const;
 };
 
-// -----------------------------------------------------------------------------------------------------------------
-// class ResponseFDA : public Response
-// {
-//
-// public:
-//   arma::mat grid;
-//   arma::mat trapez_weights;
-//
-//   ResponseFDA (const std::string&, const arma::mat&, const arma::mat&);
-//   ResponseFDA (const std::string&, const arma::mat&, const arma::mat&, const arma::mat&);
-//
-//   arma::mat calculateInitialPrediction (const arma::mat&) const;
-//   void initializePrediction ();
-//   void updatePseudoResiduals (std::shared_ptr<loss::Loss>);
-//   arma::mat getPredictionTransform (const arma::mat&) const;
-//   arma::mat getPredictionResponse (const arma::mat&) const;
-//   void filter (const arma::uvec&);
-// };
+// ResponseMulticlass
+// ------------------------------------
+
+/**
+ * \class ResponseMulticlass
+ *
+ * \brief Response of a multiclass classification task
+ *
+ * The response is one-hot encoded with one column per class, hence the
+ * scores and pseudo residuals are \f$n \times K\f$ matrices and each base
+ * learner is fitted for all classes at once. Observation weights have one
+ * column and are used for all classes.
+ */
+class ResponseMulticlass : public Response
+{
+private:
+  const std::vector<std::string>            _classes;
+  const std::map<std::string, unsigned int> _class_table;
+
+  ResponseMulticlass (const std::string, const std::vector<std::string>&, const std::map<std::string, unsigned int>&);
+  ResponseMulticlass (const std::string, const std::vector<std::string>&, const arma::mat&,
+    const std::map<std::string, unsigned int>&);
+
+public:
+  ResponseMulticlass (const std::string, const std::vector<std::string>&);
+  ResponseMulticlass (const std::string, const std::vector<std::string>&, const arma::mat&);
+  ResponseMulticlass (const json&);
+
+  void      initializePrediction       ();
+  void      filter                     (const arma::uvec&);
+  arma::mat calculateInitialPrediction (const arma::mat&)   const;
+  arma::mat getPredictionTransform     (const arma::mat&)   const;
+  arma::mat getPredictionResponse      (const arma::mat&)   const;
+  json      toJson                     (const bool = false) const;
+
+  std::vector<std::string>            getClasses    () const;
+  std::map<std::string, unsigned int> getClassTable () const;
+};
+
+// ResponseFDA
+// ------------------------------------
+
+/**
+ * \class ResponseFDA
+ *
+ * \brief Functional response with curves observed on a common grid
+ *
+ * The response is a \f$n \times T\f$ matrix with one curve per row. The
+ * time axis enters the model through a fixed P-spline basis \f$B_t\f$ with
+ * penalty \f$P_t\f$, the loss is integrated over the grid with trapezoidal
+ * weights \f$W\f$. Instead of fitting the row wise Kronecker design
+ * \f$X \odot B_t\f$ with \f$nT\f$ rows, the pseudo residuals are smoothed
+ * over time once per iteration:
+ * \f[
+ *   \tilde{R} = R\,W B_t\, G^{-1} B_t^T, \qquad G = B_t^T W B_t + \lambda_t P_t.
+ * \f]
+ * Every base learner then solves its cached system for all \f$T\f$ columns,
+ * \f$(X^TX + \lambda P)^{-1}X^T\tilde{R} = \Theta B_t^T\f$, which is the
+ * array (GLAM) solution of the tensor system with matrix
+ * \f$(X^TX + \lambda P) \otimes G\f$. The parameters are stored as the
+ * coefficient surface \f$\Theta B_t^T\f$ on the grid, hence the prediction
+ * of a base learner is already the \f$n \times T\f$ curve. Time and memory
+ * are \f$\mathcal{O}(nT)\f$ per base learner instead of
+ * \f$\mathcal{O}(nTp_t)\f$.
+ */
+class ResponseFDA : public Response
+{
+private:
+  const arma::vec _grid;
+  const arma::mat _time_basis;
+  const double    _penalty;
+  const arma::mat _time_smoother;
+
+public:
+  ResponseFDA (const std::string, const arma::mat&, const arma::vec&, const unsigned int, const unsigned int,
+    const double, const double, const unsigned int);
+  ResponseFDA (const std::string, const arma::mat&, const arma::mat&, const arma::vec&, const unsigned int,
+    const unsigned int, const double, const double, const unsigned int);
+  ResponseFDA (const json&);
+
+  void      checkLossCompatibility     (const std::shared_ptr<loss::Loss>&) const;
+  void      updatePseudoResiduals      (const std::shared_ptr<loss::Loss>&);
+  void      initializePrediction       ();
+  void      filter                     (const arma::uvec&);
+  arma::mat calculateInitialPrediction (const arma::mat&)   const;
+  arma::mat getPredictionTransform     (const arma::mat&)   const;
+  arma::mat getPredictionResponse      (const arma::mat&)   const;
+  json      toJson                     (const bool = false) const;
+
+  arma::vec getGrid        () const;
+  arma::mat getTimeBasis   () const;
+  double    getTimePenalty () const;
+  arma::mat smoothOverTime (const arma::mat&) const;
+};
 
 
 } // namespace response
@@ -0,0 +1,141 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+#include "screening.h"
+
+namespace screening
+{
+
+/**
+ * \brief Smallest and largest eigenvalue of the system matrix from the data cache
+ *
+ * - `"cholesky"`: The cache is the upper triangular \f$U\f$ with \f$A = U^TU\f$.
+ * - `"inverse"`: The cache is \f$A^{-1}\f$.
+ * - `"identity"` with one column: The cache is the diagonal of \f$A^{-1}\f$ (categorical
+ *   base learners).
+ *
+ * \returns `arma::vec` with \f$\lambda_\mathrm{min}(A)\f$ and \f$\lambda_\mathrm{max}(A)\f$
+ *   or an empty vector if the cache does not represent the system matrix.
+ */
+arma::vec cacheEigenvalues (const std::pair<std::string, arma::mat>& mat_cache)
+{
+  arma::vec out;
+  arma::vec eigval;
+  if (mat_cache.first == "cholesky") {
+    if (! arma::eig_sym(eigval, mat_cache.second.t() * mat_cache.second)) return out;
+    out = { eigval.min(), eigval.max() };
+  }
+  if (mat_cache.first == "inverse") {
+    if (! arma::eig_sym(eigval, arma::symmatu(mat_cache.second))) return out;
+    out = { 1 / eigval.max(), 1 / eigval.min() };
+  }
+  if ((mat_cache.first == "identity") && (mat_cache.second.n_cols == 1)) {
+    out = { 1 / mat_cache.second.max(), 1 / mat_cache.second.min() };
+  }
+  return out;
+}
+
+SafeScreening::SafeScreening () { }
+
+/**
+ * \brief Inflate all bounds by the change of the pseudo residuals
+ *
+ * Uses \f$\|X^Tr'\| \leq \|X^Tr\| + \sqrt{\lambda_\mathrm{max}(A)}\|r' - r\|\f$. Since the
+ * real difference is used, this is valid for every loss and also after retraining.
+ */
+void SafeScreening::updateResiduals (const arma::mat& pr)
+{
+  if ((_pr_last.n_rows == pr.n_rows) && (_pr_last.n_cols == pr.n_cols)) {
+    double delta = arma::norm(pr - _pr_last, "fro");
+    if (delta > 0) {
+      for (auto& it : _bounds) {
+        if (it.second.screenable) it.second.xtr_norm += std::sqrt(it.second.lambda_max) * delta;
+      }
+    }
+  } else {
+    // No valid reference, all bounds are unknown:
+    for (auto& it : _bounds) it.second.xtr_norm = std::numeric_limits<double>::infinity();
+  }
+  _pr_last = pr;
+}
+
+/**
+ * \brief Upper bound of the SSE reduction a factory can achieve
+ *
+ * \returns `double` bound or infinity if unknown or the factory can not be screened
+ */
+double SafeScreening::upperBound (const std::string& factory_id) const
+{
+  auto it = _bounds.find(factory_id);
+  if ((it == _bounds.end()) || (! it->second.screenable)) return std::numeric_limits<double>::infinity();
+
+  return 2 * it->second.xtr_norm * it->second.xtr_norm / it->second.lambda_min;
+}
+
+/**
+ * \brief Set the exact norm after a base learner was trained
+ *
+ * The eigenvalues are computed once per factory. A factory is not screened if the
+ * base learner does not report \f$\|X^Tr\|\f$ or the cache has no usable eigenvalues.
+ */
+void SafeScreening::tighten (const std::string& factory_id, const std::shared_ptr<blearner::Baselearner>& sh_ptr_blearner,
+  const std::shared_ptr<blearnerfactory::BaselearnerFactory>& sh_ptr_factory)
+{
+  FactoryBound& fb = _bounds[factory_id];
+  double xtr_norm = sh_ptr_blearner->getResponseCrossNorm();
+
+  if (! fb.checked) {
+    fb.checked = true;
+    if (xtr_norm >= 0) {
+      std::shared_ptr<data::Data> sh_ptr_data = sh_ptr_factory->getInstantiatedData();
+      arma::vec eigval;
+      if (sh_ptr_data != nullptr) eigval = cacheEigenvalues(sh_ptr_data->getCache());
+      if ((eigval.size() == 2) && (eigval(0) > 0) && std::isfinite(eigval(1))) {
+        fb.lambda_min = eigval(0);
+        fb.lambda_max = eigval(1);
+        fb.screenable = true;
+      }
+    }
+  }
+  if (xtr_norm < 0) fb.screenable = false;
+  fb.xtr_norm = xtr_norm;
+}
+
+void SafeScreening::recordSearch (const unsigned int n_candidates, const unsigned int n_evaluated)
+{
+  _n_candidates += n_candidates;
+  _n_evaluated  += n_evaluated;
+  _pruned_share.push_back(n_candidates > 0 ? 1 - n_evaluated / static_cast<double>(n_candidates) : 0);
+}
+
+double              SafeScreening::getNumberOfCandidates () const { return _n_candidates; }
+double              SafeScreening::getNumberOfEvaluated  () const { return _n_evaluated; }
+std::vector<double> SafeScreening::getPrunedShare        () const { return _pruned_share; }
+
+double SafeScreening::getMemoryBytes () const
+{
+  double bytes = memreport::matBytes(_pr_last) + memreport::stdVecBytes(_pruned_share);
+  for (auto& it : _bounds) {
+    bytes += 4 * sizeof(void*) + sizeof(std::pair<const std::string, FactoryBound>) + memreport::stringBytes(it.first);
+  }
+  return bytes;
+}
+
+} // namespace screening
@@ -0,0 +1,100 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    screening.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Safe screening of base learner candidates
+ *
+ *  @section DESCRIPTION
+ *
+ *  For a base learner with design \f$X\f$, penalty \f$P\f$, and system matrix
+ *  \f$A = X^TX + P\f$, the parameter \f$\theta = A^{-1}X^Tr\f$ reduces the SSE of
+ *  the pseudo residuals \f$r\f$ by
+ *  \f[
+ *    R = 2\theta^TX^Tr - \theta^TX^TX\theta = b^TA^{-1}b + \theta^TP\theta \leq 2 b^TA^{-1}b \leq
+ *    \frac{2\|b\|^2}{\lambda_\mathrm{min}(A)}, \qquad b = X^Tr.
+ *  \f]
+ *  The norm \f$\|b\|\f$ is exact after each evaluation of the base learner. If
+ *  the residuals change to \f$r'\f$, the bound is updated without touching the
+ *  data by \f$\|X^Tr'\| \leq \|X^Tr\| + \sqrt{\lambda_\mathrm{max}(A)}\|r' - r\|\f$.
+ *  Candidates whose bound can not beat the best evaluated SSE are pruned, hence
+ *  the selected base learner is the same as for a full sweep.
+ *
+ */
+
+#ifndef SCREENING_H_
+#define SCREENING_H_
+
+#include <RcppArmadillo.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <limits>
+
+#include "baselearner.h"
+#include "baselearner_factory.h"
+#include "memory_report.h"
+
+namespace screening
+{
+
+struct FactoryBound
+{
+  double xtr_norm   = std::numeric_limits<double>::infinity();
+  double lambda_min = 0;
+  double lambda_max = 0;
+  bool   screenable = false;
+  bool   checked    = false;
+};
+
+arma::vec cacheEigenvalues (const std::pair<std::string, arma::mat>&);
+
+class SafeScreening
+{
+private:
+  std::map<std::string, FactoryBound> _bounds;
+  arma::mat                           _pr_last;
+
+  double              _n_candidates = 0;
+  double              _n_evaluated  = 0;
+  std::vector<double> _pruned_share;
+
+public:
+  SafeScreening ();
+
+  void   updateResiduals (const arma::mat&);
+  double upperBound      (const std::string&) const;
+  void   tighten         (const std::string&, const std::shared_ptr<blearner::Baselearner>&,
+    const std::shared_ptr<blearnerfactory::BaselearnerFactory>&);
+  void   recordSearch    (const unsigned int, const unsigned int);
+
+  double              getNumberOfCandidates () const;
+  double              getNumberOfEvaluated  () const;
+  std::vector<double> getPrunedShare        () const;
+  double              getMemoryBytes        () const;
+};
+
+} // namespace screening
+
+#endif // SCREENING_H_
@@ -0,0 +1,270 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+#include "sweep.h"
+
+namespace sweep
+{
+
+/**
+ * \brief Constructor of the sweep
+ *
+ * \param losses `std::vector<std::shared_ptr<loss::Loss>>` Loss of each model.
+ * \param learning_rates `std::vector<double>` Learning rate of each model.
+ */
+ModelSweep::ModelSweep (const std::shared_ptr<response::Response>& sh_ptr_response,
+  const std::vector<std::shared_ptr<loss::Loss>>& losses, const std::vector<double>& learning_rates,
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList>& sh_ptr_factory_list, const unsigned int num_threads)
+  : _sh_ptr_response     ( sh_ptr_response ),
+    _losses              ( losses ),
+    _learning_rates      ( learning_rates ),
+    _sh_ptr_factory_list ( sh_ptr_factory_list ),
+    _num_threads         ( num_threads )
+{
+  if (_losses.size() == 0) {
+    Rcpp::stop("The sweep requires at least one model.");
+  }
+  if (_losses.size() != _learning_rates.size()) {
+    Rcpp::stop("Number of losses (" + std::to_string(_losses.size()) + ") does not match the number of learning rates ("
+      + std::to_string(_learning_rates.size()) + ").");
+  }
+  if (_sh_ptr_response->getResponse().n_cols > 1) {
+    Rcpp::stop("The sweep requires a response with one column.");
+  }
+  for (auto& it : _losses) _sh_ptr_response->checkLossCompatibility(it);
+
+  if (_sh_ptr_factory_list->getFactoryMap().size() == 0) {
+    Rcpp::stop("Could not train the sweep without any registered base-learner.");
+  }
+}
+
+/**
+ * \brief Set up the shared systems, the offsets, and the tracks
+ *
+ * Factories that cache a decomposition of their system use it directly. The
+ * system of the others (e.g. the closed form of linear base learners) is
+ * decomposed once here.
+ */
+void ModelSweep::initialize ()
+{
+  for (auto& it : _sh_ptr_factory_list->getFactoryMap()) {
+    const std::string model = it.second->getBaseModelName();
+    sdata sh_ptr_data = it.second->getInstantiatedData();
+
+    if ((model == "custom") || (model == "customcpp") || (sh_ptr_data == nullptr)) {
+      Rcpp::stop("Base learner \"" + it.first + "\" does not expose its system and can not be used in a sweep.");
+    }
+    std::pair<std::string, arma::mat> system = sh_ptr_data->getCache();
+    if ((system.first != "cholesky") && (system.first != "inverse")) {
+      arma::mat P = sh_ptr_data->impliedPenalty();
+      if (P.is_empty()) {
+        Rcpp::stop("Base learner \"" + it.first + "\" does not expose its system and can not be used in a sweep.");
+      }
+      arma::mat A = sh_ptr_data->weightedGram(sh_ptr_data->accumulateWeights(arma::vec(1, arma::fill::ones))) + P;
+      arma::mat U;
+      if (arma::chol(U, A)) {
+        system = std::make_pair("cholesky", U);
+      } else {
+        system = std::make_pair("inverse", arma::pinv(A));
+      }
+    }
+    _factory_ids.push_back(it.first);
+    _factory_data.push_back(sh_ptr_data);
+    _systems.push_back(system);
+  }
+
+  const arma::mat truth   = _sh_ptr_response->getResponse();
+  const arma::mat weights = _sh_ptr_response->getWeights();
+  const bool use_weights  = weights.n_rows == truth.n_rows;
+
+  _scores = arma::mat(truth.n_rows, _losses.size());
+  for (unsigned int m = 0; m < _losses.size(); m++) {
+    arma::mat offset = use_weights
+      ? _losses[m]->weightedConstantInitializer(truth, weights)
+      : _losses[m]->constantInitializer(truth);
+    if (offset.n_rows == truth.n_rows) {
+      _scores.col(m) = offset.col(0);
+    } else {
+      _scores.col(m).fill(offset[0]);
+    }
+    _offsets.push_back(offset);
+    _risk.push_back({ _sh_ptr_response->calculateEmpiricalRisk(_losses[m], _scores.col(m)) });
+    _tracks.push_back(blearnertrack::BaselearnerTrack(_learning_rates[m]));
+  }
+  _is_initialized = true;
+}
+
+// Pseudo residuals of all models, one column per model. The losses may use R, hence no threads:
+arma::mat ModelSweep::calculatePseudoResiduals () const
+{
+  const arma::mat truth   = _sh_ptr_response->getResponse();
+  const arma::mat weights = _sh_ptr_response->getWeights();
+  const bool use_weights  = weights.n_rows == truth.n_rows;
+
+  arma::mat pr(arma::size(_scores));
+  for (unsigned int m = 0; m < _losses.size(); m++) {
+    pr.col(m) = use_weights
+      ? _losses[m]->calculateWeightedPseudoResiduals(truth, _scores.col(m), weights)
+      : _losses[m]->calculatePseudoResiduals(truth, _scores.col(m));
+  }
+  return pr;
+}
+
+/**
+ * \brief Conduct `iterations` iterations of all models
+ *
+ * In each iteration, a factory solves its system for the pseudo residuals of
+ * all models at once. Each model selects the factory with the smallest SSE.
+ * The models that select the same factory are predicted with one product.
+ */
+void ModelSweep::train (const unsigned int iterations)
+{
+  if (! _is_initialized) initialize();
+
+  const unsigned int num_models    = _losses.size();
+  const unsigned int num_factories = _factory_data.size();
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+
+  for (unsigned int i = 0; i < iterations; i++) {
+    arma::mat pr = calculatePseudoResiduals();
+
+    std::vector<arma::mat> params(num_factories);
+    arma::mat sse(num_factories, num_models);
+
+    #pragma omp parallel for num_threads(_num_threads) schedule(dynamic) if (_num_threads > 1)
+    for (unsigned int j = 0; j < num_factories; j++) {
+      params[j] = helper::cboostSolver(_systems[j], _factory_data[j]->crossProduct(pr));
+      sse.row(j) = arma::sum(arma::square(pr - _factory_data[j]->linearPredictor(params[j])), 0);
+    }
+
+    // The first factory with the smallest SSE wins, as in the coordinate descent:
+    arma::urowvec selected = arma::index_min(sse, 0);
+    for (unsigned int j = 0; j < num_factories; j++) {
+      arma::uvec models = arma::find(selected == j);
+      if (models.n_elem == 0) continue;
+
+      arma::mat param = params[j].cols(models);
+      _scores.cols(models) += _factory_data[j]->linearPredictor(param)
+        * arma::diagmat(arma::conv_to<arma::vec>::from(_learning_rates).elem(models));
+
+      for (unsigned int k = 0; k < models.n_elem; k++) {
+        std::shared_ptr<blearner::Baselearner> sh_ptr_blearner = fac_map[_factory_ids[j]]->createBaselearner();
+        sh_ptr_blearner->setParameter(param.col(k));
+        _tracks[models(k)].insertBaselearner(sh_ptr_blearner, 1);
+      }
+    }
+    for (unsigned int m = 0; m < num_models; m++) {
+      _risk[m].push_back(_sh_ptr_response->calculateEmpiricalRisk(_losses[m], _scores.col(m)));
+    }
+  }
+  _current_iter += iterations;
+}
+
+unsigned int        ModelSweep::getNumberOfModels   () const { return _losses.size(); }
+unsigned int        ModelSweep::getCurrentIteration () const { return _current_iter; }
+std::vector<double> ModelSweep::getLearningRates    () const { return _learning_rates; }
+
+std::vector<arma::mat> ModelSweep::getOffsets () const
+{
+  return _offsets;
+}
+
+// Risk of the offset and after each iteration (rows) per model (columns):
+arma::mat ModelSweep::getRisk () const
+{
+  arma::mat out(_current_iter + 1, _losses.size(), arma::fill::zeros);
+  if (! _is_initialized) return out;
+  for (unsigned int m = 0; m < _risk.size(); m++) out.col(m) = arma::vec(_risk[m]);
+  return out;
+}
+
+arma::mat ModelSweep::getPredictionScores () const
+{
+  return _scores;
+}
+
+std::vector<std::vector<std::string>> ModelSweep::getSelectedBaselearner () const
+{
+  std::vector<std::vector<std::string>> out;
+  for (auto& it : _tracks) out.push_back(it.getSelectedFactoryIds());
+  return out;
+}
+
+std::map<std::string, arma::mat> ModelSweep::getParameter (const unsigned int model) const
+{
+  if (model >= _tracks.size()) {
+    Rcpp::stop("Model " + std::to_string(model + 1) + " is not available, the sweep has "
+      + std::to_string(_losses.size()) + " trained models.");
+  }
+  return _tracks[model].getParameterMap();
+}
+
+/**
+ * \brief Prediction of all models for new data (one column per model)
+ *
+ * The parameters of all models are stacked per factory, hence the basis of
+ * each factory is computed once.
+ */
+arma::mat ModelSweep::predict (const mdata& data_map, const bool as_response) const
+{
+  if (data_map.size() == 0) {
+    throw std::range_error("Require data in 'data_map' for prediction.");
+  }
+  auto fac_map = _sh_ptr_factory_list->getFactoryMap();
+
+  arma::mat pred(data_map.begin()->second->getNObs(), _losses.size(), arma::fill::zeros);
+  for (unsigned int m = 0; m < _offsets.size(); m++) {
+    if (_offsets[m].n_rows == 1) pred.col(m).fill(_offsets[m][0]);
+  }
+
+  std::map<std::string, arma::mat> stacked;
+  for (unsigned int m = 0; m < _tracks.size(); m++) {
+    for (auto& it : _tracks[m].getParameterMap()) {
+      if (stacked.find(it.first) == stacked.end()) stacked[it.first] = arma::mat(it.second.n_elem, _tracks.size(), arma::fill::zeros);
+      stacked[it.first].col(m) = arma::vectorise(it.second);
+    }
+  }
+  for (auto& it : stacked) {
+    pred += fac_map.at(it.first)->calculateLinearPredictor(it.second, data_map);
+  }
+  if (as_response) pred = _sh_ptr_response->getPredictionTransform(pred);
+  return pred;
+}
+
+/**
+ * \brief Add the heap memory to the report
+ *
+ * The data of the factories is shared by all models and reported once.
+ */
+void ModelSweep::reportMemory (memreport::MemoryReport& report) const
+{
+  _sh_ptr_response->reportMemory(report);
+  _sh_ptr_factory_list->reportMemory(report);
+
+  double system_bytes = 0;
+  for (auto& it : _systems) system_bytes += memreport::matBytes(it.second);
+  report.add("sweep", "ModelSweep", "systems", system_bytes);
+  report.add("sweep", "ModelSweep", "scores",  memreport::matBytes(_scores));
+  for (unsigned int m = 0; m < _tracks.size(); m++) {
+    _tracks[m].reportMemory(report, "track:model_" + std::to_string(m + 1));
+  }
+}
+
+} // namespace sweep
@@ -0,0 +1,124 @@
+// ========================================================================== //
+//                                 ___.                          __           //
+//        ____  ____   _____ ______\_ |__   ____   ____  _______/  |_         //
+//      _/ ___\/  _ \ /     \\____ \| __ \ /  _ \ /  _ \/  ___/\   __\        //
+//      \  \__(  <_> )  Y Y  \  |_> > \_\ (  <_> |  <_> )___ \  |  |          //
+//       \___  >____/|__|_|  /   __/|___  /\____/ \____/____  > |__|          //
+//           \/            \/|__|       \/                  \/                //
+//                                                                            //
+// ========================================================================== //
+//
+// Compboost is free software: you can redistribute it and/or modify
+// it under the terms of the LGPL-3 License.
+// Compboost is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// LGPL-3 License for more details. You should have received a copy of
+// the license along with compboost.
+//
+// =========================================================================== #
+
+/**
+ *  @file    sweep.h
+ *  @author  Daniel Schalk (github: schalkdaniel)
+ *
+ *  @brief Training of multiple model configurations in lockstep
+ *
+ *  @section DESCRIPTION
+ *
+ *  Sweeping over learning rates or losses on the same base learners fits the
+ *  same candidates on different pseudo residuals. The sweep trains \f$M\f$
+ *  configurations at once. The pseudo residuals of all models are stacked to
+ *  an \f$n \times M\f$ matrix \f$R\f$. Each factory computes \f$X^TR\f$ with
+ *  one matrix product and solves its system for all \f$M\f$ columns with one
+ *  triangular solve. The system is set up once and shared by all models. Each
+ *  model selects its base learner, updates its own scores, and keeps its own
+ *  `BaselearnerTrack`. Custom base learners are not supported since their
+ *  system is unknown.
+ *
+ */
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include <RcppArmadillo.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <limits>
+
+#include "baselearner_factory_list.h"
+#include "baselearner_track.h"
+#include "response.h"
+#include "loss.h"
+#include "helper.h"
+#include "memory_report.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+typedef std::shared_ptr<data::Data> sdata;
+typedef std::map<std::string, sdata> mdata;
+
+namespace sweep
+{
+
+/**
+ * \class ModelSweep
+ *
+ * \brief Coordinate descent of multiple configurations on shared systems
+ *
+ * A configuration is a loss and a learning rate. All models use the same
+ * response, observation weights, and factories.
+ */
+class ModelSweep
+{
+private:
+  const std::shared_ptr<response::Response>                   _sh_ptr_response;
+  const std::vector<std::shared_ptr<loss::Loss>>              _losses;
+  const std::vector<double>                                   _learning_rates;
+  const std::shared_ptr<blearnerlist::BaselearnerFactoryList> _sh_ptr_factory_list;
+  const unsigned int                                          _num_threads;
+
+  unsigned int _current_iter = 0;
+  bool         _is_initialized = false;
+
+  std::vector<std::string>                        _factory_ids;
+  std::vector<sdata>                              _factory_data;
+  std::vector<std::pair<std::string, arma::mat>>  _systems;
+
+  std::vector<arma::mat>                       _offsets;
+  arma::mat                                    _scores;
+  std::vector<std::vector<double>>             _risk;
+  std::vector<blearnertrack::BaselearnerTrack> _tracks;
+
+  void      initialize               ();
+  arma::mat calculatePseudoResiduals () const;
+
+public:
+  ModelSweep (const std::shared_ptr<response::Response>&, const std::vector<std::shared_ptr<loss::Loss>>&,
+    const std::vector<double>&, const std::shared_ptr<blearnerlist::BaselearnerFactoryList>&, const unsigned int);
+
+  void train (const unsigned int);
+
+  unsigned int           getNumberOfModels   () const;
+  unsigned int           getCurrentIteration () const;
+  std::vector<double>    getLearningRates    () const;
+  std::vector<arma::mat> getOffsets          () const;
+  arma::mat              getRisk             () const;
+  arma::mat              getPredictionScores () const;
+
+  std::vector<std::vector<std::string>> getSelectedBaselearner () const;
+  std::map<std::string, arma::mat>      getParameter           (const unsigned int) const;
+
+  arma::mat predict (const mdata&, const bool) const;
+
+  void reportMemory (memreport::MemoryReport&) const;
+};
+
+} // namespace sweep
+
+#endif // SWEEP_H_